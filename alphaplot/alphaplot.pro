@@ -5,7 +5,7 @@ DEFINES += QCUSTOMPLOT_USE_OPENGL
 
 # Qt modules
 QT += core gui widgets opengl network svg
-QT += script scripttools printsupport datavisualization
+QT += script scripttools printsupport datavisualization concurrent
 
 # enable C++14 support
 CONFIG += c++14
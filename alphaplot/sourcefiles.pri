@@ -49,6 +49,7 @@ HEADERS  += src/ApplicationWindow.h \
             src/analysis/Filter.h\
             src/analysis/FFTFilter.h\
             src/analysis/FFT.h\
+            src/analysis/FFTPlan.h\
             src/analysis/Convolution.h\
             src/analysis/Correlation.h\
             src/analysis/Differentiation.h\
@@ -57,8 +58,11 @@ HEADERS  += src/ApplicationWindow.h \
             src/analysis/Interpolation.h\
             src/analysis/InterpolationDialog.h\
             src/analysis/SmoothFilter.h\
+            src/analysis/SmoothEngine.h\
             src/analysis/SmoothCurveDialog.h\
             src/analysis/Fit.h\
+            src/analysis/FitBlocks.h\
+            src/analysis/FitModel.h\
             src/analysis/fit_gsl.h\
             src/analysis/PolynomialFit.h\
             src/analysis/PolynomFitDialog.h\
@@ -97,6 +101,8 @@ HEADERS  += src/ApplicationWindow.h \
             src/ui/TableFontSettings.h \
             src/About.h \
             src/core/AprojHandler.h \
+            src/core/AutosaveEngine.h \
+            src/core/GzipDevice.h \
             src/future/lib/XmlStreamWriter.h \
 
 
@@ -145,6 +151,7 @@ SOURCES  += src/ApplicationWindow.cpp \
             src/analysis/Filter.cpp\
             src/analysis/FFTFilter.cpp\
             src/analysis/FFT.cpp\
+            src/analysis/FFTPlan.cpp\
             src/analysis/Convolution.cpp\
             src/analysis/Correlation.cpp\
             src/analysis/Differentiation.cpp\
@@ -153,8 +160,11 @@ SOURCES  += src/ApplicationWindow.cpp \
             src/analysis/Interpolation.cpp\
             src/analysis/InterpolationDialog.cpp\
             src/analysis/SmoothFilter.cpp\
+            src/analysis/SmoothEngine.cpp\
             src/analysis/SmoothCurveDialog.cpp\
             src/analysis/Fit.cpp\
+            src/analysis/FitBlocks.cpp\
+            src/analysis/FitModel.cpp\
             src/analysis/fit_gsl.cpp\
             src/analysis/PolynomialFit.cpp\
             src/analysis/PolynomFitDialog.cpp\
@@ -195,6 +205,8 @@ SOURCES  += src/ApplicationWindow.cpp \
             src/About.cpp \
             src/main.cpp \
             src/core/AprojHandler.cpp \
+            src/core/AutosaveEngine.cpp \
+            src/core/GzipDevice.cpp \
             src/future/lib/XmlStreamWriter.cpp \
 
 ###################### FORMS ##############################################
@@ -235,6 +247,8 @@ HEADERS     += src/future/core/AbstractAspect.h \
                src/future/core/ControlWidget.h \
                src/future/core/column/Column.h \
                src/future/core/column/ColumnPrivate.h \
+               src/future/core/column/ColumnStatistics.h \
+               src/future/core/column/NumericColumnView.h \
                src/future/core/column/columncommands.h \
                src/future/core/AbstractFilter.h \
                src/future/core/AbstractSimpleFilter.h \
@@ -254,10 +268,12 @@ HEADERS     += src/future/core/AbstractAspect.h \
                src/future/core/datatypes/String2MonthFilter.h \
                src/future/lib/macros.h \
                src/future/lib/XmlStreamReader.h \
+               src/future/lib/XmlPagedData.h \
                src/future/lib/ActionManager.h \
                src/future/lib/ConfigPageWidget.h \
                src/future/lib/Interval.h \
                src/future/lib/IntervalAttribute.h \
+               src/future/lib/DateTimeVector.h \
                src/future/matrix/future_Matrix.h \
                src/future/matrix/MatrixModel.h \
                src/future/matrix/MatrixView.h \
@@ -270,6 +286,7 @@ HEADERS     += src/future/core/AbstractAspect.h \
                src/future/table/TableItemDelegate.h \
                src/future/table/TableCommentsHeaderModel.h \
                src/future/table/future_SortDialog.h \
+               src/future/table/RowSort.h \
                src/future/table/AsciiTableImportFilter.h \
                src/future/core/AbstractImportFilter.h \
                src/future/core/interfaces.h \
@@ -283,6 +300,7 @@ SOURCES     += src/future/core/AbstractAspect.cpp \
                src/future/core/ControlWidget.cpp \
                src/future/core/column/Column.cpp \
                src/future/core/column/ColumnPrivate.cpp \
+               src/future/core/column/ColumnStatistics.cpp \
                src/future/core/column/columncommands.cpp \
                src/future/core/datatypes/DateTime2StringFilter.cpp \
                src/future/core/datatypes/String2DateTimeFilter.cpp \
@@ -293,6 +311,7 @@ SOURCES     += src/future/core/AbstractAspect.cpp \
                src/future/core/AbstractFilter.cpp \
                src/future/core/ProjectConfigPage.cpp \
                src/future/lib/XmlStreamReader.cpp \
+               src/future/lib/XmlPagedData.cpp \
                src/future/lib/ActionManager.cpp \
                src/future/lib/ConfigPageWidget.cpp \
                src/future/matrix/future_Matrix.cpp \
@@ -307,6 +326,7 @@ SOURCES     += src/future/core/AbstractAspect.cpp \
                src/future/table/TableItemDelegate.cpp \
                src/future/table/TableCommentsHeaderModel.cpp \
                src/future/table/future_SortDialog.cpp \
+               src/future/table/RowSort.cpp \
                src/future/table/AsciiTableImportFilter.cpp \
 
 ##############################################################
@@ -346,6 +366,7 @@ HEADERS     += src/2Dplot/widgets/LayoutButton2D.h \
                src/2Dplot/StatBox2D.h \
                src/2Dplot/Vector2D.h \
                src/2Dplot/DataManager2D.h \
+               src/2Dplot/HistogramEngine.h \
                src/2Dplot/Curve2D.h \
                src/2Dplot/Pie2D.h \
                src/2Dplot/ColorMap2D.h \
@@ -378,6 +399,7 @@ SOURCES     += src/2Dplot/widgets/LayoutButton2D.cpp \
                src/2Dplot/StatBox2D.cpp \
                src/2Dplot/Vector2D.cpp \
                src/2Dplot/DataManager2D.cpp \
+               src/2Dplot/HistogramEngine.cpp \
                src/2Dplot/Curve2D.cpp \
                src/2Dplot/Pie2D.cpp \
                src/2Dplot/ColorMap2D.cpp \
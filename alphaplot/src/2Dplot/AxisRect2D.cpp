@@ -20,6 +20,8 @@
 #include <gsl/gsl_statistics.h>
 
 #include <QMenu>
+#include <cmath>
+#include <functional>
 
 #include "Channel2D.h"
 #include "ColorMap2D.h"
@@ -45,6 +47,7 @@
 #include "core/IconLoader.h"
 #include "core/Utilities.h"
 #include "future/core/column/Column.h"
+#include "future/core/column/ColumnStatistics.h"
 #include "future/core/datatypes/DateTime2StringFilter.h"
 #include "future/lib/XmlStreamWriter.h"
 
@@ -134,56 +137,78 @@ void AxisRect2D::refresh() {
   emit addedOrRemoved();
 }
 
+namespace {
+// fill the box and whisker bounds from the statistics and quantiles
+void setBoxWhiskerDataBounds(StatBox2D::BoxWhiskerData &statBoxData,
+                             const double min, const double max,
+                             const std::function<double(double)> &quantile) {
+  statBoxData.boxWhiskerDataBounds.sd_lower = statBoxData.mean - statBoxData.sd;
+  statBoxData.boxWhiskerDataBounds.sd_upper = statBoxData.mean + statBoxData.sd;
+  statBoxData.boxWhiskerDataBounds.se_lower = statBoxData.mean - statBoxData.se;
+  statBoxData.boxWhiskerDataBounds.se_upper = statBoxData.mean + statBoxData.se;
+  statBoxData.boxWhiskerDataBounds.perc_1 = quantile(0.01);
+  statBoxData.boxWhiskerDataBounds.perc_5 = quantile(0.05);
+  statBoxData.boxWhiskerDataBounds.perc_10 = quantile(0.10);
+  statBoxData.boxWhiskerDataBounds.perc_25 = quantile(0.25);
+  statBoxData.boxWhiskerDataBounds.perc_75 = quantile(0.75);
+  statBoxData.boxWhiskerDataBounds.perc_90 = quantile(0.90);
+  statBoxData.boxWhiskerDataBounds.perc_95 = quantile(0.95);
+  statBoxData.boxWhiskerDataBounds.perc_99 = quantile(0.99);
+  statBoxData.boxWhiskerDataBounds.max = max;
+  statBoxData.boxWhiskerDataBounds.min = min;
+}
+}  // namespace
+
 StatBox2D::BoxWhiskerData AxisRect2D::generateBoxWhiskerData(Table *table,
                                                              Column *colData,
                                                              const int from,
                                                              const int to,
                                                              const int key) {
+  StatBox2D::BoxWhiskerData statBoxData;
+  statBoxData.table_ = table;
+  statBoxData.column_ = colData;
+  statBoxData.from_ = from;
+  statBoxData.to_ = to;
+  statBoxData.key = key;
+  statBoxData.name = colData->name();
+
+  if (from == 0 && to == colData->rowCount() - 1) {
+    // the whole column: use its cached statistics, which only recompute the
+    // rows changed since the last regeneration
+    ColumnStatistics *stats = colData->statistics();
+    const ColumnStatistics::Summary summary = stats->summary();
+    if (summary.count > 0) {
+      statBoxData.mean = summary.mean;
+      statBoxData.median = stats->quantile(0.5);
+      statBoxData.sd = std::sqrt(summary.variance);
+      statBoxData.se =
+          statBoxData.sd / sqrt(static_cast<double>(summary.count));
+      setBoxWhiskerDataBounds(statBoxData, summary.min, summary.max,
+                              [stats](double p) { return stats->quantile(p); });
+      return statBoxData;
+    }
+  }
+
   size_t size = static_cast<size_t>((to - from) + 1);
 
   double *sbdata = new double[size];
 
   for (int i = 0, j = from; j < to + 1; i++, j++) {
-    sbdata[i] = colData->valueAt(i);
+    sbdata[i] = colData->valueAt(j);
   }
   // sort the data
   gsl_sort(sbdata, 1, size);
 
-  StatBox2D::BoxWhiskerData statBoxData;
-  statBoxData.table_ = table;
-  statBoxData.column_ = colData;
-  statBoxData.from_ = from;
-  statBoxData.to_ = to;
-  statBoxData.key = key;
   // basic stats
   statBoxData.mean = gsl_stats_mean(sbdata, 1, size);
   statBoxData.median = gsl_stats_median_from_sorted_data(sbdata, 1, size);
   statBoxData.sd = gsl_stats_sd(sbdata, 1, size);
   statBoxData.se = statBoxData.sd / sqrt(static_cast<double>(size));
-  // data bounds
-  statBoxData.boxWhiskerDataBounds.sd_lower = statBoxData.mean - statBoxData.sd;
-  statBoxData.boxWhiskerDataBounds.sd_upper = statBoxData.mean + statBoxData.sd;
-  statBoxData.boxWhiskerDataBounds.se_lower = statBoxData.mean - statBoxData.se;
-  statBoxData.boxWhiskerDataBounds.se_upper = statBoxData.mean + statBoxData.se;
-  statBoxData.boxWhiskerDataBounds.perc_1 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.01);
-  statBoxData.boxWhiskerDataBounds.perc_5 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.05);
-  statBoxData.boxWhiskerDataBounds.perc_10 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.10);
-  statBoxData.boxWhiskerDataBounds.perc_25 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.25);
-  statBoxData.boxWhiskerDataBounds.perc_75 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.75);
-  statBoxData.boxWhiskerDataBounds.perc_90 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.90);
-  statBoxData.boxWhiskerDataBounds.perc_95 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.95);
-  statBoxData.boxWhiskerDataBounds.perc_99 =
-      gsl_stats_quantile_from_sorted_data(sbdata, 1, size, 0.99);
-  statBoxData.boxWhiskerDataBounds.max = sbdata[size - 1];
-  statBoxData.boxWhiskerDataBounds.min = sbdata[0];
-  statBoxData.name = colData->name();
+  setBoxWhiskerDataBounds(statBoxData, sbdata[0], sbdata[size - 1],
+                          [sbdata, size](double p) {
+                            return gsl_stats_quantile_from_sorted_data(
+                                sbdata, 1, size, p);
+                          });
 
   // delete the double data pointer
   delete[] sbdata;
@@ -1072,11 +1097,14 @@ LayoutInset2D *AxisRect2D::addLayoutInset2D() {
   return inset;
 }
 
-bool AxisRect2D::updateData(Table *table, const QString &name) {
+bool AxisRect2D::updateData(Table *table, const QString &name,
+                            const int first, const int last) {
   if (!table) return false;
   Column *col = table->column(table->colIndex(name));
   if (!col) return false;
   bool modified = false;
+  // only rows first to last changed, patch these instead of regenerating
+  const bool ranged = (first <= last);
   QString plotname;
   foreach (LineSpecial2D *ls, lsvec_) {
     PlotData::AssociatedData *data =
@@ -1085,9 +1113,12 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
       DataBlockError *xerror = ls->getxerrorbar_lsplot()->getdatablock_error();
       if (xerror->gettable() == table) {
         if (xerror->geterrorcolumn() == col) {
-          ls->getxerrorbar_lsplot()->setErrorData(
-              xerror->gettable(), xerror->geterrorcolumn(), xerror->getfrom(),
-              xerror->getto());
+          if (ranged)
+            ls->getxerrorbar_lsplot()->updateErrorData(first, last);
+          else
+            ls->getxerrorbar_lsplot()->setErrorData(
+                xerror->gettable(), xerror->geterrorcolumn(), xerror->getfrom(),
+                xerror->getto());
           modified = true;
         }
       }
@@ -1096,9 +1127,12 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
       DataBlockError *yerror = ls->getyerrorbar_lsplot()->getdatablock_error();
       if (yerror->gettable() == table) {
         if (yerror->geterrorcolumn() == col) {
-          ls->getyerrorbar_lsplot()->setErrorData(
-              yerror->gettable(), yerror->geterrorcolumn(), yerror->getfrom(),
-              yerror->getto());
+          if (ranged)
+            ls->getyerrorbar_lsplot()->updateErrorData(first, last);
+          else
+            ls->getyerrorbar_lsplot()->setErrorData(
+                yerror->gettable(), yerror->geterrorcolumn(), yerror->getfrom(),
+                yerror->getto());
           modified = true;
         }
       }
@@ -1111,8 +1145,11 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
           plotname = ls->name();
           removeLineSpecial2D(ls);
         } else {
-          ls->setGraphData(data->table, data->xcol, data->ycol, data->from,
-                           data->to);
+          if (ranged)
+            ls->updateGraphData(first, last);
+          else
+            ls->setGraphData(data->table, data->xcol, data->ycol, data->from,
+                             data->to);
           modified = true;
         }
       }
@@ -1135,10 +1172,15 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
           plotname = channel.first->name() + "_" + data2->ycol->name();
           removeChannel2D(channelvec_.at(i));
         } else {
-          channel.first->setGraphData(data1->table, data1->xcol, data1->ycol,
-                                      data1->from, data1->to);
-          channel.second->setGraphData(data2->table, data2->xcol, data2->ycol,
-                                       data2->from, data2->to);
+          if (ranged) {
+            channel.first->updateGraphData(first, last);
+            channel.second->updateGraphData(first, last);
+          } else {
+            channel.first->setGraphData(data1->table, data1->xcol, data1->ycol,
+                                        data1->from, data1->to);
+            channel.second->setGraphData(data2->table, data2->xcol,
+                                         data2->ycol, data2->from, data2->to);
+          }
           modified = true;
         }
       }
@@ -1153,9 +1195,12 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             curve->getxerrorbar_curveplot()->getdatablock_error();
         if (xerror->gettable() == table) {
           if (xerror->geterrorcolumn() == col) {
-            curve->getxerrorbar_curveplot()->setErrorData(
-                xerror->gettable(), xerror->geterrorcolumn(), xerror->getfrom(),
-                xerror->getto());
+            if (ranged)
+              curve->getxerrorbar_curveplot()->updateErrorData(first, last);
+            else
+              curve->getxerrorbar_curveplot()->setErrorData(
+                  xerror->gettable(), xerror->geterrorcolumn(),
+                  xerror->getfrom(), xerror->getto());
             modified = true;
           }
         }
@@ -1165,9 +1210,12 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             curve->getyerrorbar_curveplot()->getdatablock_error();
         if (yerror->gettable() == table) {
           if (yerror->geterrorcolumn() == col) {
-            curve->getyerrorbar_curveplot()->setErrorData(
-                yerror->gettable(), yerror->geterrorcolumn(), yerror->getfrom(),
-                yerror->getto());
+            if (ranged)
+              curve->getyerrorbar_curveplot()->updateErrorData(first, last);
+            else
+              curve->getyerrorbar_curveplot()->setErrorData(
+                  yerror->gettable(), yerror->geterrorcolumn(),
+                  yerror->getfrom(), yerror->getto());
             modified = true;
           }
         }
@@ -1184,8 +1232,11 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             plotname = curve->name();
             removeCurve2D(curve);
           } else {
-            curve->setCurveData(data->table, data->xcol, data->ycol, data->from,
-                                data->to);
+            if (ranged)
+              curve->updateCurveData(first, last);
+            else
+              curve->setCurveData(data->table, data->xcol, data->ycol,
+                                  data->from, data->to);
             modified = true;
           }
         }
@@ -1225,9 +1276,12 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             bar->getxerrorbar_barplot()->getdatablock_error();
         if (xerror->gettable() == table) {
           if (xerror->geterrorcolumn() == col) {
-            bar->getxerrorbar_barplot()->setErrorData(
-                xerror->gettable(), xerror->geterrorcolumn(), xerror->getfrom(),
-                xerror->getto());
+            if (ranged)
+              bar->getxerrorbar_barplot()->updateErrorData(first, last);
+            else
+              bar->getxerrorbar_barplot()->setErrorData(
+                  xerror->gettable(), xerror->geterrorcolumn(),
+                  xerror->getfrom(), xerror->getto());
             modified = true;
           }
         }
@@ -1237,9 +1291,12 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             bar->getyerrorbar_barplot()->getdatablock_error();
         if (yerror->gettable() == table) {
           if (yerror->geterrorcolumn() == col) {
-            bar->getyerrorbar_barplot()->setErrorData(
-                yerror->gettable(), yerror->geterrorcolumn(), yerror->getfrom(),
-                yerror->getto());
+            if (ranged)
+              bar->getyerrorbar_barplot()->updateErrorData(first, last);
+            else
+              bar->getyerrorbar_barplot()->setErrorData(
+                  yerror->gettable(), yerror->geterrorcolumn(),
+                  yerror->getfrom(), yerror->getto());
             modified = true;
           }
         }
@@ -1252,8 +1309,11 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             plotname = bar->name();
             removeBar2D(bar);
           } else {
-            bar->setBarData(data->table, data->xcol, data->ycol, data->from,
-                            data->to);
+            if (ranged)
+              bar->updateBarData(first, last);
+            else
+              bar->setBarData(data->table, data->xcol, data->ycol, data->from,
+                              data->to);
             modified = true;
           }
         }
@@ -1268,10 +1328,13 @@ bool AxisRect2D::updateData(Table *table, const QString &name) {
             plotname = bar->name();
             removeBar2D(bar);
           } else {
-            bar->setBarData(bar->getdatablock_histplot()->gettable(),
-                            bar->getdatablock_histplot()->getcolumn(),
-                            bar->getdatablock_histplot()->getfrom(),
-                            bar->getdatablock_histplot()->getto());
+            if (ranged)
+              bar->updateHistData(first, last);
+            else
+              bar->setBarData(bar->getdatablock_histplot()->gettable(),
+                              bar->getdatablock_histplot()->getcolumn(),
+                              bar->getdatablock_histplot()->getfrom(),
+                              bar->getdatablock_histplot()->getto());
             modified = true;
           }
         }
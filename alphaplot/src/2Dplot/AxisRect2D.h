@@ -171,7 +171,9 @@ class AxisRect2D : public QCPAxisRect {
   LineItem2D *addArrowItem2D();
   ImageItem2D *addImageItem2D(const QString &filename);
   LayoutInset2D *addLayoutInset2D();
-  bool updateData(Table *table, const QString &name);
+  // update plots of column name, only rows first to last if first <= last
+  bool updateData(Table *table, const QString &name, const int first = 0,
+                  const int last = -1);
   bool updateDataCheck(Table *table, const QString &name);
   bool axisColumTypeCompatibilityCheck(Axis2D *axis, Column *col,
                                        const int from, const int to);
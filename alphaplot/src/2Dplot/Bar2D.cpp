@@ -283,6 +283,10 @@ void Bar2D::setBarData(Table *table, Column *xcol, Column *ycol, int from,
   setData(bardata_->data());
 }
 
+void Bar2D::updateBarData(int first, int last) {
+  bardata_->updateDataBlock(first, last);
+}
+
 void Bar2D::setBarData(Table *table, Column *col, int from, int to) {
   histdata_->regenerateDataBlock(table, col, from, to);
   setData(histdata_->data());
@@ -291,6 +295,14 @@ void Bar2D::setBarData(Table *table, Column *col, int from, int to) {
              histdata_->data()->at(0)->mainKey());
 }
 
+void Bar2D::updateHistData(int first, int last) {
+  histdata_->updateDataBlock(first, last);
+  setData(histdata_->data());
+  if (!histdata_->data().isNull() && histdata_->data()->size() > 1)
+    setWidth(histdata_->data()->at(1)->mainKey() -
+             histdata_->data()->at(0)->mainKey());
+}
+
 void Bar2D::save(XmlStreamWriter *xmlwriter, int xaxis, int yaxis) {
   xmlwriter->writeStartElement("bar");
   // axis
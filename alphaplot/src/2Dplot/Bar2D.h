@@ -70,6 +70,8 @@ class Bar2D : public QCPBars {
   void setHistEnd(const double end);
   void setBarData(Table *table, Column *xcol, Column *ycol, int from, int to);
   void setBarData(Table *table, Column *col, int from, int to);
+  void updateHistData(int first, int last);
+  void updateBarData(int first, int last);
 
   void save(XmlStreamWriter *xmlwriter, int xaxis, int yaxis);
   bool load(XmlStreamReader *xmlreader);
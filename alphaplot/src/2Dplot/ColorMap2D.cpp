@@ -72,17 +72,14 @@ void ColorMap2D::setColorMapData(Matrix *matrix) {
   data_->setSize(matrix_->numRows(), matrix_->numCols());
   data_->setRange(QCPRange(matrix_->xStart(), matrix_->xEnd()),
                   QCPRange(matrix_->yStart(), matrix_->yEnd()));
-  double datamin = matrix_->cell(0, 0);
-  double datamax = matrix_->cell(0, 0);
-  double value = datamin;
-  for (int i = 0; i < matrix_->numRows(); i++) {
-    for (int j = 0; j < matrix_->numCols(); j++) {
-      value = matrix_->cell(i, j);
-      data_->setCell(i, j, value);
-      datamin = qMin(datamin, value);
-    }
-    datamax = qMax(datamax, value);
+  // the cells are read column by column, straight from the matrix buffer
+  for (int j = 0; j < columns_; j++) {
+    const future::Matrix::Span column = matrix_->d_future_matrix->columnSpan(j);
+    for (int i = 0; i < column.size(); i++) data_->setCell(i, j, column.at(i));
   }
+  double datamin = 0.0;
+  double datamax = 0.0;
+  matrix_->range(&datamin, &datamax);
   setDataRange(QCPRange(datamin, datamax));
 }
 
@@ -313,6 +313,12 @@ void Curve2D::setCurveData(Table *table, Column *xcol, Column *ycol, int from,
   if (curve2dtype_ == Curve2DType::Spline) loadSplineData();
 }
 
+void Curve2D::updateCurveData(int first, int last) {
+  if (type_ == Graph2DCommon::PlotType::Function) return;
+  curvedata_->updateDataBlock(first, last);
+  if (curve2dtype_ == Curve2DType::Spline) loadSplineData();
+}
+
 int Curve2D::getlinetype_cplot() const {
   switch (lineStyle()) {
     case LineStyle::lsNone:
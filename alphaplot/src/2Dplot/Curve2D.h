@@ -34,6 +34,7 @@ class Curve2D : public QCPCurve {
 
   void setGraphData(QVector<double> *xdata, QVector<double> *ydata);
   void setCurveData(Table *table, Column *xcol, Column *ycol, int from, int to);
+  void updateCurveData(int first, int last);
 
   // Getters
   int getlinetype_cplot() const;
@@ -1,13 +1,164 @@
 #include "DataManager2D.h"
 
-#include <gsl/gsl_histogram.h>
-#include <gsl/gsl_vector.h>
-
 #include "Table.h"
 #include "core/Utilities.h"
 #include "future/core/column/Column.h"
 #include "future/core/datatypes/DateTime2StringFilter.h"
 
+// plot values of a column for all rows in runs, the data type and the
+// date-time format are resolved once per column instead of once per row
+static QVector<double> plotValues(const Column *col,
+                                  const QList<Interval<int>> &runs,
+                                  const int start_row) {
+  int count = 0;
+  foreach (const Interval<int> &run, runs) count += run.size();
+  QVector<double> values;
+  values.reserve(count);
+  switch (col->dataType()) {
+    case AlphaPlot::ColumnDataType::TypeDouble:
+      foreach (const Interval<int> &run, runs)
+        for (int row = run.start(); row <= run.end(); row++)
+          values.append(col->valueAt(row));
+      break;
+    case AlphaPlot::ColumnDataType::TypeDateTime: {
+      // the raw msecs are used directly unless the display format drops
+      // fields which have to be stripped first
+      const QString fmt =
+          static_cast<DateTime2StringFilter *>(col->outputFilter())->format();
+      if (Utilities::isLosslessDateTimeFormat(fmt)) {
+        foreach (const Interval<int> &run, runs)
+          for (int row = run.start(); row <= run.end(); row++) {
+            const qint64 msecs = col->dateTimeMSecsAt(row);
+            values.append((msecs == DateTimeVector::invalidMSecs())
+                              ? std::numeric_limits<double>::quiet_NaN()
+                              : msecs / 1000.0);
+          }
+      } else {
+        foreach (const Interval<int> &run, runs)
+          for (int row = run.start(); row <= run.end(); row++)
+            values.append(QCPAxisTickerDateTime::dateTimeToKey(
+                Utilities::stripDateTimeToFormat(col->dateTimeAt(row), fmt)));
+      }
+    } break;
+    case AlphaPlot::ColumnDataType::TypeString:
+      foreach (const Interval<int> &run, runs)
+        for (int row = run.start(); row <= run.end(); row++)
+          values.append(row - start_row);
+      break;
+    default:
+      values.fill(std::numeric_limits<double>::quiet_NaN(), count);
+      break;
+  }
+  return values;
+}
+
+// values of a histogram column; shared with the column if it stores doubles,
+// text is parsed and cells which are no numbers count as invalid
+static NumericColumnView histogramValues(const Column *col) {
+  const NumericColumnView view = col->numericView();
+  if (!view.isNull()) return view;
+  QVector<double> values(col->rowCount(), 0.0);
+  QList<Interval<int>> invalid = col->invalidIntervals();
+  if (col->dataType() == AlphaPlot::TypeString) {
+    IntervalAttribute<bool> validity(invalid);
+    foreach (const Interval<int> &run,
+             validity.unsetIntervals(Interval<int>(0, values.size() - 1)))
+      for (int row = run.start(); row <= run.end(); row++) {
+        bool valid_data = true;
+        values[row] = QLocale().toDouble(col->textAt(row), &valid_data);
+        if (!valid_data) invalid << Interval<int>(row, row);
+      }
+  }
+  return NumericColumnView(values, IntervalAttribute<bool>(invalid));
+}
+
+// whether the keys are in ascending order, so the container can skip sorting
+static bool keysSorted(const QVector<double> &keys) {
+  for (int i = 1; i < keys.size(); i++)
+    if (!(keys.at(i - 1) <= keys.at(i))) return false;
+  return true;
+}
+
+// runs of rows between from and to for which both columns have valid content
+static QList<Interval<int>> validRows(const Column *xcol, const Column *ycol,
+                                      const int from, const int to) {
+  IntervalAttribute<bool> invalid(xcol->invalidIntervals() +
+                                  ycol->invalidIntervals());
+  return invalid.unsetIntervals(Interval<int>(from, to));
+}
+
+// number of rows of the runs which lie before row
+static int rowsBefore(const QList<Interval<int>> &runs, const int row) {
+  int count = 0;
+  foreach (const Interval<int> &run, runs) {
+    if (run.start() >= row) break;
+    count += qMin(run.end(), row - 1) - run.start() + 1;
+  }
+  return count;
+}
+
+// axis ranges of a data block
+template <class Container>
+static void setMinMax(Container *data,
+                      PlotData::AssociatedData *associateddata) {
+  bool available = false;
+  QCPRange xrange = data->keyRange(available);
+  if (!available) {
+    qDebug() << "xrange min max assignment failure";
+    xrange = QCPRange(0, 0);
+  }
+  QCPRange yrange = data->valueRange(available);
+  if (!available) {
+    qDebug() << "yrange min max assignment failure";
+    yrange = QCPRange(0, 0);
+  }
+  associateddata->minmax.maxx = xrange.upper;
+  associateddata->minmax.minx = xrange.lower;
+  associateddata->minmax.maxy = yrange.upper;
+  associateddata->minmax.miny = yrange.lower;
+}
+
+// replace the count points starting at index (which belong to the changed
+// rows) by points, or append them if they are a new tail. This is only
+// possible while the container is in row order, false is returned if the
+// block has to be regenerated instead.
+template <class DataType>
+static bool patchPoints(QCPDataContainer<DataType> *data, bool *roworder,
+                        const int index, const int count,
+                        const QVector<DataType> &points) {
+  if (!*roworder || index + count > data->size()) return false;
+  bool ascending = true;
+  for (int i = 1; i < points.size() && ascending; i++)
+    ascending = (points.at(i - 1).sortKey() <= points.at(i).sortKey());
+  if (count == points.size()) {
+    if (points.isEmpty()) return true;
+    std::copy(points.constBegin(), points.constEnd(), data->begin() + index);
+    // the patched points have to fit between their neighbours
+    bool inorder = ascending;
+    if (inorder && index > 0)
+      inorder = ((data->constBegin() + index - 1)->sortKey() <=
+                 points.first().sortKey());
+    if (inorder && index + count < data->size())
+      inorder = (points.last().sortKey() <=
+                 (data->constBegin() + index + count)->sortKey());
+    if (!inorder) {
+      data->sort();
+      *roworder = false;
+    }
+    return true;
+  }
+  if (count == 0 && index == data->size()) {
+    // rows appended at the tail go straight onto the container's end
+    bool inorder = ascending;
+    if (inorder && index > 0 && !points.isEmpty())
+      inorder = ((data->constEnd() - 1)->sortKey() <= points.first().sortKey());
+    data->add(points, ascending);
+    *roworder = inorder;
+    return true;
+  }
+  return false;
+}
+
 DataBlockGraph::DataBlockGraph(Table *table, Column *xcolumn, Column *ycolumn,
                                const int from, const int to)
     : data_(new QCPGraphDataContainer),
@@ -42,66 +193,51 @@ void DataBlockGraph::regenerateDataBlock(Table *table, Column *xcolumn,
   if (end_row >= xcol->rowCount()) end_row = xcol->rowCount() - 1;
   if (end_row >= ycol->rowCount()) end_row = ycol->rowCount() - 1;
 
-  // determine rows for which all columns have valid content
-  for (int i = 0, row = start_row; row <= end_row; row++) {
-    if (!xcol->isInvalid(row) && !ycol->isInvalid(row)) {
-      double xdata = std::numeric_limits<double>::quiet_NaN();
-      double ydata = std::numeric_limits<double>::quiet_NaN();
-      switch (xcol->dataType()) {
-        case AlphaPlot::ColumnDataType::TypeDouble:
-          xdata = xcol->valueAt(row);
-          break;
-        case AlphaPlot::ColumnDataType::TypeDateTime: {
-          QString fmt =
-              static_cast<DateTime2StringFilter *>(xcol->outputFilter())
-                  ->format();
-          xdata = QCPAxisTickerDateTime::dateTimeToKey(
-              Utilities::stripDateTimeToFormat(xcol->dateTimeAt(row), fmt));
-        } break;
-        case AlphaPlot::ColumnDataType::TypeString:
-          xdata = i;
-          break;
-        default:
-          break;
-      }
-      switch (ycol->dataType()) {
-        case AlphaPlot::ColumnDataType::TypeDouble:
-          ydata = ycol->valueAt(row);
-          break;
-        case AlphaPlot::ColumnDataType::TypeDateTime: {
-          QString fmt =
-              static_cast<DateTime2StringFilter *>(ycol->outputFilter())
-                  ->format();
-          ydata = QCPAxisTickerDateTime::dateTimeToKey(
-              Utilities::stripDateTimeToFormat(ycol->dateTimeAt(row), fmt));
-        } break;
-        case AlphaPlot::ColumnDataType::TypeString:
-          ydata = i;
-          break;
-        default:
-          break;
-      }
-      QCPGraphData data(xdata, ydata);
-      data_.data()->add(data);
-    }
-    i++;
-  }
+  // determine rows for which all columns have valid content and read them
+  // in bulk, the container is then filled with a single set()
+  const QList<Interval<int>> runs = validRows(xcol, ycol, start_row, end_row);
+  const QVector<double> xdata = plotValues(xcol, runs, start_row);
+  const QVector<double> ydata = plotValues(ycol, runs, start_row);
+  QVector<QCPGraphData> data(xdata.size());
+  for (int j = 0; j < data.size(); j++)
+    data[j] = QCPGraphData(xdata.at(j), ydata.at(j));
+  roworder_ = keysSorted(xdata);
+  data_->set(data, roworder_);
+  runs_ = runs;
   // minmax adjust
-  bool available = false;
-  QCPRange xrange = data_.data()->keyRange(available);
-  if (!available) {
-    qDebug() << "xrange min max assignment failure";
-    xrange = QCPRange(0, 0);
-  }
-  QCPRange yrange = data_.data()->valueRange(available);
-  if (!available) {
-    qDebug() << "yrange min max assignment failure";
-    yrange = QCPRange(0, 0);
+  setMinMax(data_.data(), associateddata_);
+}
+
+void DataBlockGraph::updateDataBlock(const int first, const int last) {
+  Column *xcol = this->getxcolumn();
+  Column *ycol = this->getycolumn();
+  int start_row = this->getfrom();
+  int end_row = this->getto();
+
+  // strip unused end rows
+  if (end_row >= xcol->rowCount()) end_row = xcol->rowCount() - 1;
+  if (end_row >= ycol->rowCount()) end_row = ycol->rowCount() - 1;
+
+  const int patch_row = qMax(first, start_row);
+  if (patch_row > qMin(last, this->getto())) return;
+
+  // points of the changed rows before the change and after it
+  const int index = rowsBefore(runs_, patch_row);
+  const int count = rowsBefore(runs_, last + 1) - index;
+  const QList<Interval<int>> runs =
+      validRows(xcol, ycol, patch_row, qMin(last, end_row));
+  const QVector<double> xdata = plotValues(xcol, runs, start_row);
+  const QVector<double> ydata = plotValues(ycol, runs, start_row);
+  QVector<QCPGraphData> data(xdata.size());
+  for (int j = 0; j < data.size(); j++)
+    data[j] = QCPGraphData(xdata.at(j), ydata.at(j));
+  if (!patchPoints(data_.data(), &roworder_, index, count, data)) {
+    regenerateDataBlock(this->gettable(), xcol, ycol, this->getfrom(),
+                        this->getto());
+    return;
   }
-  associateddata_->minmax.maxx = xrange.upper;
-  associateddata_->minmax.minx = xrange.lower;
-  associateddata_->minmax.maxy = yrange.upper;
-  associateddata_->minmax.miny = yrange.lower;
+  runs_ = validRows(xcol, ycol, start_row, end_row);
+  setMinMax(data_.data(), associateddata_);
 }
 
 bool DataBlockGraph::movedatafromtable(const double key, const double value,
@@ -176,68 +312,56 @@ void DataBlockCurve::regenerateDataBlock(Table *table, Column *xcolumn,
   if (end_row >= xcol->rowCount()) end_row = xcol->rowCount() - 1;
   if (end_row >= ycol->rowCount()) end_row = ycol->rowCount() - 1;
 
-  // determine rows for which all columns have valid content
-  for (int i = 0, row = start_row; row <= end_row; row++) {
-    if (!xcol->isInvalid(row) && !ycol->isInvalid(row)) {
-      double xdata = std::numeric_limits<double>::quiet_NaN();
-      double ydata = std::numeric_limits<double>::quiet_NaN();
-      switch (xcol->dataType()) {
-        case AlphaPlot::ColumnDataType::TypeDouble:
-          xdata = xcol->valueAt(row);
-          break;
-        case AlphaPlot::ColumnDataType::TypeDateTime: {
-          QString fmt =
-              static_cast<DateTime2StringFilter *>(xcol->outputFilter())
-                  ->format();
-          xdata = QCPAxisTickerDateTime::dateTimeToKey(
-              Utilities::stripDateTimeToFormat(xcol->dateTimeAt(row), fmt));
-        } break;
-        case AlphaPlot::ColumnDataType::TypeString:
-          xdata = i;
-          break;
-        default:
-          break;
-      }
-      switch (ycol->dataType()) {
-        case AlphaPlot::ColumnDataType::TypeDouble:
-          ydata = ycol->valueAt(row);
-          break;
-        case AlphaPlot::ColumnDataType::TypeDateTime: {
-          QString fmt =
-              static_cast<DateTime2StringFilter *>(ycol->outputFilter())
-                  ->format();
-          ydata = QCPAxisTickerDateTime::dateTimeToKey(
-              Utilities::stripDateTimeToFormat(ycol->dateTimeAt(row), fmt));
-        } break;
-        case AlphaPlot::ColumnDataType::TypeString:
-          ydata = i;
-          break;
-        default:
-          break;
-      }
-
-      QCPCurveData data(i, xdata, ydata);
-      data_->add(data);
-    }
-    i++;
-  }
+  // determine rows for which all columns have valid content and read them
+  // in bulk, the container is then filled with a single set()
+  const QList<Interval<int>> runs = validRows(xcol, ycol, start_row, end_row);
+  const QVector<double> xdata = plotValues(xcol, runs, start_row);
+  const QVector<double> ydata = plotValues(ycol, runs, start_row);
+  QVector<QCPCurveData> data(xdata.size());
+  int j = 0;
+  foreach (const Interval<int> &run, runs)
+    for (int row = run.start(); row <= run.end(); row++, j++)
+      data[j] = QCPCurveData(row - start_row, xdata.at(j), ydata.at(j));
+  data_->set(data, true);
+  roworder_ = true;
+  runs_ = runs;
 
   // minmax adjust
-  bool available = false;
-  QCPRange xrange = data_.data()->keyRange(available);
-  if (!available) {
-    qDebug() << "xrange min max assignment failure";
-    xrange = QCPRange(0, 0);
-  }
-  QCPRange yrange = data_.data()->valueRange(available);
-  if (!available) {
-    qDebug() << "yrange min max assignment failure";
-    yrange = QCPRange(0, 0);
+  setMinMax(data_.data(), associateddata_);
+}
+
+void DataBlockCurve::updateDataBlock(const int first, const int last) {
+  Column *xcol = this->getxcolumn();
+  Column *ycol = this->getycolumn();
+  int start_row = this->getfrom();
+  int end_row = this->getto();
+
+  // strip unused end rows
+  if (end_row >= xcol->rowCount()) end_row = xcol->rowCount() - 1;
+  if (end_row >= ycol->rowCount()) end_row = ycol->rowCount() - 1;
+
+  const int patch_row = qMax(first, start_row);
+  if (patch_row > qMin(last, this->getto())) return;
+
+  // points of the changed rows before the change and after it
+  const int index = rowsBefore(runs_, patch_row);
+  const int count = rowsBefore(runs_, last + 1) - index;
+  const QList<Interval<int>> runs =
+      validRows(xcol, ycol, patch_row, qMin(last, end_row));
+  const QVector<double> xdata = plotValues(xcol, runs, start_row);
+  const QVector<double> ydata = plotValues(ycol, runs, start_row);
+  QVector<QCPCurveData> data(xdata.size());
+  int j = 0;
+  foreach (const Interval<int> &run, runs)
+    for (int row = run.start(); row <= run.end(); row++, j++)
+      data[j] = QCPCurveData(row - start_row, xdata.at(j), ydata.at(j));
+  if (!patchPoints(data_.data(), &roworder_, index, count, data)) {
+    regenerateDataBlock(this->gettable(), xcol, ycol, this->getfrom(),
+                        this->getto());
+    return;
   }
-  associateddata_->minmax.maxx = xrange.upper;
-  associateddata_->minmax.minx = xrange.lower;
-  associateddata_->minmax.maxy = yrange.upper;
-  associateddata_->minmax.miny = yrange.lower;
+  runs_ = validRows(xcol, ycol, start_row, end_row);
+  setMinMax(data_.data(), associateddata_);
 }
 
 bool DataBlockCurve::movedatafromtable(const double key, const double value,
@@ -310,66 +434,52 @@ void DataBlockBar::regenerateDataBlock(Table *table, Column *xcolumn,
   if (end_row >= xcolumn->rowCount()) end_row = xcolumn->rowCount() - 1;
   if (end_row >= ycolumn->rowCount()) end_row = ycolumn->rowCount() - 1;
 
-  // determine rows for which all columns have valid content
-  for (int i = 0, row = start_row; row <= end_row; row++) {
-    if (!xcolumn->isInvalid(row) && !ycolumn->isInvalid(row)) {
-      double xdata = std::numeric_limits<double>::quiet_NaN();
-      double ydata = std::numeric_limits<double>::quiet_NaN();
-      switch (xcolumn->dataType()) {
-        case AlphaPlot::ColumnDataType::TypeDouble:
-          xdata = xcolumn->valueAt(row);
-          break;
-        case AlphaPlot::ColumnDataType::TypeDateTime: {
-          QString fmt =
-              static_cast<DateTime2StringFilter *>(xcolumn->outputFilter())
-                  ->format();
-          xdata = QCPAxisTickerDateTime::dateTimeToKey(
-              Utilities::stripDateTimeToFormat(xcolumn->dateTimeAt(row), fmt));
-        } break;
-        case AlphaPlot::ColumnDataType::TypeString:
-          xdata = i;
-          break;
-        default:
-          break;
-      }
-      switch (ycolumn->dataType()) {
-        case AlphaPlot::ColumnDataType::TypeDouble:
-          ydata = ycolumn->valueAt(row);
-          break;
-        case AlphaPlot::ColumnDataType::TypeDateTime: {
-          QString fmt =
-              static_cast<DateTime2StringFilter *>(ycolumn->outputFilter())
-                  ->format();
-          ydata = QCPAxisTickerDateTime::dateTimeToKey(
-              Utilities::stripDateTimeToFormat(ycolumn->dateTimeAt(row), fmt));
-        } break;
-        case AlphaPlot::ColumnDataType::TypeString:
-          ydata = i;
-          break;
-        default:
-          break;
-      }
-      QCPBarsData data(xdata, ydata);
-      data_->add(data);
-    }
-    i++;
-  }
+  // determine rows for which all columns have valid content and read them
+  // in bulk, the container is then filled with a single set()
+  const QList<Interval<int>> runs =
+      validRows(xcolumn, ycolumn, start_row, end_row);
+  const QVector<double> xdata = plotValues(xcolumn, runs, start_row);
+  const QVector<double> ydata = plotValues(ycolumn, runs, start_row);
+  QVector<QCPBarsData> data(xdata.size());
+  for (int j = 0; j < data.size(); j++)
+    data[j] = QCPBarsData(xdata.at(j), ydata.at(j));
+  roworder_ = keysSorted(xdata);
+  data_->set(data, roworder_);
+  runs_ = runs;
   // minmax adjust
-  bool available = false;
-  QCPRange xrange = data_.data()->keyRange(available);
-  if (!available) {
-    qDebug() << "xrange min max assignment failure";
-    xrange = QCPRange(0, 0);
-  }
-  QCPRange yrange = data_.data()->valueRange(available);
-  if (!available) {
-    qDebug() << "yrange min max assignment failure";
-    yrange = QCPRange(0, 0);
+  setMinMax(data_.data(), associateddata_);
+}
+
+void DataBlockBar::updateDataBlock(const int first, const int last) {
+  Column *xcol = this->getxcolumn();
+  Column *ycol = this->getycolumn();
+  int start_row = this->getfrom();
+  int end_row = this->getto();
+
+  // strip unused end rows
+  if (end_row >= xcol->rowCount()) end_row = xcol->rowCount() - 1;
+  if (end_row >= ycol->rowCount()) end_row = ycol->rowCount() - 1;
+
+  const int patch_row = qMax(first, start_row);
+  if (patch_row > qMin(last, this->getto())) return;
+
+  // points of the changed rows before the change and after it
+  const int index = rowsBefore(runs_, patch_row);
+  const int count = rowsBefore(runs_, last + 1) - index;
+  const QList<Interval<int>> runs =
+      validRows(xcol, ycol, patch_row, qMin(last, end_row));
+  const QVector<double> xdata = plotValues(xcol, runs, start_row);
+  const QVector<double> ydata = plotValues(ycol, runs, start_row);
+  QVector<QCPBarsData> data(xdata.size());
+  for (int j = 0; j < data.size(); j++)
+    data[j] = QCPBarsData(xdata.at(j), ydata.at(j));
+  if (!patchPoints(data_.data(), &roworder_, index, count, data)) {
+    regenerateDataBlock(this->gettable(), xcol, ycol, this->getfrom(),
+                        this->getto());
+    return;
   }
-  associateddata_->minmax.maxx = xrange.upper;
-  associateddata_->minmax.minx = xrange.lower;
-  associateddata_->minmax.maxy = yrange.upper;
-  associateddata_->minmax.miny = yrange.lower;
+  runs_ = validRows(xcol, ycol, start_row, end_row);
+  setMinMax(data_.data(), associateddata_);
 }
 
 bool DataBlockBar::movedatafromtable(const double key, const double value,
@@ -450,9 +560,30 @@ void DataBlockError::regenerateDataBlock(Table *table, Column *errorcolumn,
   }
 }
 
+void DataBlockError::updateDataBlock(const int first, const int last) {
+  int start_row = from_;
+  int end_row = to_;
+
+  // strip unused end rows
+  if (end_row >= errorcolumn_->rowCount())
+    end_row = errorcolumn_->rowCount() - 1;
+
+  // one error value per row, rows may have been appended or removed
+  data_->resize(qMax(0, end_row - start_row + 1));
+  for (int row = qMax(first, start_row); row <= qMin(last, end_row); row++) {
+    (*data_)[row - start_row] =
+        QCPErrorBarsData(errorcolumn_->isInvalid(row)
+                             ? std::numeric_limits<double>::quiet_NaN()
+                             : errorcolumn_->valueAt(row));
+  }
+}
+
 DataBlockHist::DataBlockHist(Table *table, Column *col, const int from,
                              const int to)
-    : data_(new QCPBarsDataContainer), histdata_(new PlotData::HistData) {
+    : data_(new QCPBarsDataContainer),
+      histdata_(new PlotData::HistData),
+      countedto_(-1),
+      followsend_(false) {
   histdata_->table = table;
   histdata_->col = col;
   histdata_->from = from;
@@ -469,101 +600,64 @@ void DataBlockHist::regenerateDataBlock(Table *table, Column *col,
   setcolumn(col);
   setfrom(from);
   setto(to);
-  int d_end_row = to;
-  int d_start_row = from;
-
-  double d_mean = 0.0;
-  double d_standard_deviation = 0.0;
-  double d_min = 0.0;
-  double d_max = 0.0;
-
-  int r = abs(d_end_row - d_start_row) + 1;
-  QVarLengthArray<double> Y(r);
-
-  Column *y_col_ptr = col;
-  int yColType = table->columnType(table->colIndex(col->name()));
-  int size = 0;
-  for (int row = d_start_row; row <= d_end_row && row < y_col_ptr->rowCount();
-       row++) {
-    if (!y_col_ptr->isInvalid(row)) {
-      if (yColType == Table::Text) {
-        QString yval = y_col_ptr->textAt(row);
-        bool valid_data = true;
-        Y[size] = QLocale().toDouble(yval, &valid_data);
-        if (!valid_data) continue;
-      } else
-        Y[size] = y_col_ptr->valueAt(row);
-      size++;
-    }
-  }
-
-  if (size < 2 || (size == 2 && Y[0] == Y[1])) {  // non valid histogram
-    double X[2];
-    Y.resize(2);
-    for (int i = 0; i < 2; i++) {
-      Y[i] = 0;
-      X[i] = 0;
-    }
-    return;
-  }
+  countedto_ = -1;
 
-  int n;
-  gsl_histogram *h;
+  const NumericColumnView values = histogramValues(col);
+  const int last = qMin(to, values.size() - 1);
+  followsend_ = (to >= values.size() - 1);
   if (histdata_->autobin) {
-    n = 10;
-    h = gsl_histogram_alloc(n);
-    if (!h) return;
-
-    gsl_vector *v = gsl_vector_alloc(size);
-    for (int i = 0; i < size; i++) gsl_vector_set(v, i, Y[i]);
-
-    double min, max;
-    gsl_vector_minmax(v, &min, &max);
-    gsl_vector_free(v);
-
-    histdata_->begin = floor(min);
-    histdata_->end = ceil(max);
-    histdata_->binsize =
-        (histdata_->end - histdata_->begin) / static_cast<double>(n);
-
-    gsl_histogram_set_ranges_uniform(h, floor(min), ceil(max));
+    if (!histogram_.autoBin(values, from, last)) return;
+    histdata_->begin = histogram_.begin();
+    histdata_->end = histogram_.end();
+    histdata_->binsize = histogram_.binsize();
   } else {
-    n = static_cast<int>(
+    int valid = 0;
+    foreach (const Interval<int> &run,
+             values.validIntervals(Interval<int>(from, last)))
+      valid += run.size();
+    if (valid < 2 || !(histdata_->binsize > 0)) return;
+    const int n = static_cast<int>(
         (histdata_->end - histdata_->begin) / histdata_->binsize + 1);
-    h = gsl_histogram_alloc(n);
-    if (!h) return;
+    histogram_.reset(histdata_->begin, histdata_->binsize, n);
+  }
 
-    double *range = new double[n + 2];
-    for (int i = 0; i <= n + 1; i++)
-      range[i] = histdata_->begin + i * histdata_->binsize;
+  histogram_.add(values, from, last);
+  countedto_ = qMax(last, from - 1);
+  setbars();
+}
 
-    gsl_histogram_set_ranges(h, range, n + 1);
-    delete[] range;
+void DataBlockHist::updateDataBlock(const int first, const int last) {
+  if (followsend_ && last > histdata_->to) setto(last);
+  if (last < histdata_->from || first > histdata_->to) return;
+  Column *col = histdata_->col;
+  if (countedto_ < 0 || first <= countedto_) {
+    regenerateDataBlock(histdata_->table, col, histdata_->from,
+                        histdata_->to);
+    return;
   }
 
-  for (int i = 0; i < size; i++) gsl_histogram_increment(h, Y[i]);
+  // appended rows; automatic bins are kept as long as the new values fit
+  const NumericColumnView values = histogramValues(col);
+  const int begin = countedto_ + 1;
+  const int end = qMin(histdata_->to, values.size() - 1);
+  if (begin > end) return;
+  if (histdata_->autobin && !histogram_.covers(values, begin, end)) {
+    regenerateDataBlock(histdata_->table, col, histdata_->from,
+                        histdata_->to);
+    return;
+  }
+  histogram_.add(values, begin, end);
+  countedto_ = end;
+  setbars();
+}
 
-  // double X[n];  // stores ranges (x) and bins (y)
-  Y.resize(n);
+void DataBlockHist::setbars() {
+  QVector<QCPBarsData> bars(histogram_.bins());
+  for (int i = 0; i < bars.size(); i++)
+    bars[i] = QCPBarsData(histogram_.lower(i),
+                          static_cast<double>(histogram_.count(i)));
   QSharedPointer<QCPBarsDataContainer> cont =
       QSharedPointer<QCPBarsDataContainer>(new QCPBarsDataContainer);
-  for (int i = 0; i < n; i++) {
-    QCPBarsData dat;
-    Y[i] = gsl_histogram_get(h, i);
-    dat.value = gsl_histogram_get(h, i);
-    double lower, upper;
-    gsl_histogram_get_range(h, i, &lower, &upper);
-    // X[i] = lower;
-    dat.key = lower;
-    cont.data()->add(dat);
-  }
-
+  cont->set(bars, true);
   data_ = cont;
-
-  d_mean = gsl_histogram_mean(h);
-  d_standard_deviation = gsl_histogram_sigma(h);
-  d_min = gsl_histogram_min_val(h);
-  d_max = gsl_histogram_max_val(h);
-
-  gsl_histogram_free(h);
 }
@@ -6,6 +6,8 @@
 
 #include "../3rdparty/qcustomplot/qcustomplot.h"
 #include "Graph2DCommon.h"
+#include "HistogramEngine.h"
+#include "future/lib/Interval.h"
 
 class Table;
 class Column;
@@ -17,6 +19,9 @@ class DataBlockGraph {
   ~DataBlockGraph();
   void regenerateDataBlock(Table *table, Column *xcolumn, Column *ycolumn,
                            const int start_row, const int end_row);
+  // update only the points of rows first to last, falls back to
+  // regenerateDataBlock() if the rows can not be patched in place
+  void updateDataBlock(const int first, const int last);
 
   // getters
   int size() const { return data_->size(); }
@@ -41,6 +46,9 @@ class DataBlockGraph {
  private:
   QSharedPointer<QCPGraphDataContainer> data_;
   PlotData::AssociatedData *associateddata_;
+  // valid rows at the last update and whether the points are in row order
+  QList<Interval<int>> runs_;
+  bool roworder_;
 };
 
 class DataBlockCurve {
@@ -50,6 +58,9 @@ class DataBlockCurve {
   ~DataBlockCurve();
   void regenerateDataBlock(Table *table, Column *xcolumn, Column *ycolumn,
                            const int from, const int to);
+  // update only the points of rows first to last, falls back to
+  // regenerateDataBlock() if the rows can not be patched in place
+  void updateDataBlock(const int first, const int last);
 
   // getters
   int size() const { return data_->size(); }
@@ -74,6 +85,9 @@ class DataBlockCurve {
  private:
   QSharedPointer<QCPCurveDataContainer> data_;
   PlotData::AssociatedData *associateddata_;
+  // valid rows at the last update and whether the points are in row order
+  QList<Interval<int>> runs_;
+  bool roworder_;
 };
 
 class DataBlockBar {
@@ -83,6 +97,9 @@ class DataBlockBar {
   ~DataBlockBar();
   void regenerateDataBlock(Table *table, Column *xcolumn, Column *ycolumn,
                            const int from, const int to);
+  // update only the points of rows first to last, falls back to
+  // regenerateDataBlock() if the rows can not be patched in place
+  void updateDataBlock(const int first, const int last);
 
   // getters
   int size() const { return data_->size(); }
@@ -107,6 +124,9 @@ class DataBlockBar {
  private:
   QSharedPointer<QCPBarsDataContainer> data_;
   PlotData::AssociatedData *associateddata_;
+  // valid rows at the last update and whether the points are in row order
+  QList<Interval<int>> runs_;
+  bool roworder_;
 };
 
 class DataBlockHist {
@@ -115,6 +135,10 @@ class DataBlockHist {
   ~DataBlockHist();
   void regenerateDataBlock(Table *table, Column *col, const int from,
                            const int to);
+  // rows first to last changed; rows after the counted ones are added to the
+  // bins, anything else falls back to regenerateDataBlock(). Rows appended
+  // to a column plotted up to its end extend the range
+  void updateDataBlock(const int first, const int last);
 
   // getters
   int size() const { return data_->size(); }
@@ -141,8 +165,17 @@ class DataBlockHist {
   void setend(const double end) { histdata_->end = end; }
 
  private:
+  // replace data_ with the bins of histogram_
+  void setbars();
+
   QSharedPointer<QCPBarsDataContainer> data_;
   PlotData::HistData *histdata_;
+  HistogramEngine histogram_;
+  // last row counted into histogram_, -1 if it holds no valid histogram
+  int countedto_;
+  // the range reached the end of the column, so rows appended to the column
+  // extend it
+  bool followsend_;
 };
 
 class DataBlockError {
@@ -151,6 +184,8 @@ class DataBlockError {
   ~DataBlockError();
   void regenerateDataBlock(Table *table, Column *errorcolumn, const int from,
                            const int to);
+  // update only the error values of rows first to last
+  void updateDataBlock(const int first, const int last);
 
   // getters
   int size() const { return data_->size(); }
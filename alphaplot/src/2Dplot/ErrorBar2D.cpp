@@ -106,6 +106,10 @@ void ErrorBar2D::setErrorData(Table *table, Column *errorcol, int from,
   setData(errordata_->data());
 }
 
+void ErrorBar2D::updateErrorData(int first, int last) {
+  errordata_->updateDataBlock(first, last);
+}
+
 bool ErrorBar2D::getfillstatus_errorbar() const {
   if (brush().style() == Qt::NoBrush) {
     return false;
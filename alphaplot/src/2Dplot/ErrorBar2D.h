@@ -35,6 +35,7 @@ class ErrorBar2D : public QCPErrorBars {
   QString getItemTooltip();
 
   void setErrorData(Table *table, Column *errorcol, int from, int to);
+  void updateErrorData(int first, int last);
   bool getfillstatus_errorbar() const;
   QCPErrorBars::ErrorType geterrortype_errorbar() { return errortype_; }
   LineSpecial2D *getlinespecial2d_errorbar() { return linespecial_; }
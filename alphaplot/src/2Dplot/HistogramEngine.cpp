@@ -0,0 +1,217 @@
+#include "HistogramEngine.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "future/core/column/NumericColumnView.h"
+
+namespace {
+// rows per part below which splitting the work is not worth a thread
+const int part_rows = 1 << 16;
+// bins of the fine histogram the quartiles are estimated from
+const int quartile_bins = 1 << 12;
+// upper limit of automatically chosen bins
+const int max_bins = 1 << 12;
+// bins if the rules fail, as the histogram used to have
+const int default_bins = 10;
+}  // namespace
+
+HistogramEngine::HistogramEngine() : begin_(0.0), binsize_(1.0) {}
+
+void HistogramEngine::reset(const double begin, const double binsize,
+                            const int bins) {
+  begin_ = begin;
+  binsize_ = binsize;
+  counts_.fill(0, qMax(0, bins));
+}
+
+bool HistogramEngine::autoBin(const NumericColumnView &values,
+                              const int first, const int last,
+                              const BinRule rule) {
+  // count, extrema and sums of the deviations from the part's first finite
+  // value per part; the parts are then merged in order (Chan et al.).
+  // NaN and infinite values fall into no bin and are left out here as well
+  struct Moments {
+    qint64 count;
+    double min;
+    double max;
+    double shift;
+    double sum;
+    double sum2;
+  };
+  QVector<Moments> moments(parts(first, last),
+                           Moments{0, 0.0, 0.0, 0.0, 0.0, 0.0});
+  forEachPart(values, first, last,
+              [&](int part, const double *begin, const double *end) {
+                Moments &m = moments[part];
+                if (m.count == 0) {
+                  while (begin != end && !std::isfinite(*begin)) begin++;
+                  if (begin == end) return;
+                  m.min = m.max = m.shift = *begin;
+                }
+                qint64 count = 0;
+                double min = m.min, max = m.max, sum = 0.0, sum2 = 0.0;
+                for (const double *value = begin; value != end; value++) {
+                  if (!std::isfinite(*value)) continue;
+                  const double deviation = *value - m.shift;
+                  min = std::min(min, *value);
+                  max = std::max(max, *value);
+                  sum += deviation;
+                  sum2 += deviation * deviation;
+                  count++;
+                }
+                m.count += count;
+                m.min = min;
+                m.max = max;
+                m.sum += sum;
+                m.sum2 += sum2;
+              });
+  qint64 count = 0;
+  double min = 0.0, max = 0.0, mean = 0.0, m2 = 0.0;
+  for (const Moments &m : moments) {
+    if (m.count == 0) continue;
+    const double n_b = static_cast<double>(m.count);
+    const double mean_b = m.shift + m.sum / n_b;
+    const double m2_b = std::max(0.0, m.sum2 - m.sum * m.sum / n_b);
+    if (count == 0) {
+      min = m.min;
+      max = m.max;
+      mean = mean_b;
+      m2 = m2_b;
+    } else {
+      const double n_a = static_cast<double>(count);
+      const double delta = mean_b - mean;
+      mean += delta * n_b / (n_a + n_b);
+      m2 += m2_b + delta * delta * n_a * n_b / (n_a + n_b);
+      min = std::min(min, m.min);
+      max = std::max(max, m.max);
+    }
+    count += m.count;
+  }
+  if (count < 2 || (count == 2 && min == max)) return false;
+
+  const double begin = std::floor(min);
+  const double end = std::max(std::ceil(max), begin + 1.0);
+  const double n = static_cast<double>(count);
+
+  double width = 0.0;
+  if (rule == BinRule::FreedmanDiaconis && max > min) {
+    // the quartiles from a fine histogram over min ... max, interpolated
+    // within the bin they fall into; accurate to a fraction of a fine bin,
+    // which is plenty for choosing the bin width
+    reset(min, (max - min) / quartile_bins, quartile_bins);
+    add(values, first, last);
+    // max itself lies on the upper edge of the last bin
+    counts_[quartile_bins - 1] += count - std::accumulate(
+        counts_.constBegin(), counts_.constEnd(), qint64(0));
+    auto quantile = [&](double p) {
+      const double rank = p * n;
+      double below = 0.0;
+      for (int bin = 0; bin < quartile_bins; bin++) {
+        const double in_bin = static_cast<double>(counts_.at(bin));
+        if (below + in_bin >= rank && in_bin > 0)
+          return lower(bin) + binsize_ * (rank - below) / in_bin;
+        below += in_bin;
+      }
+      return max;
+    };
+    width = 2.0 * (quantile(0.75) - quantile(0.25)) / std::cbrt(n);
+  }
+  if (!(width > 0.0))
+    width = 3.49 * std::sqrt(m2 / (n - 1.0)) / std::cbrt(n);
+  if (!(width > 0.0) || !std::isfinite(width))
+    width = (end - begin) / default_bins;
+
+  int bins = static_cast<int>(
+      std::min<double>(max_bins, std::ceil((end - begin) / width)));
+  bins = std::max(1, bins);
+  if (bins == max_bins) width = (end - begin) / bins;
+  // the largest value has to fall into the last bin, not onto its edge
+  while (begin + bins * width <= max) bins++;
+  reset(begin, width, bins);
+  return true;
+}
+
+void HistogramEngine::add(const NumericColumnView &values, const int first,
+                          const int last) {
+  const int bins = counts_.size();
+  if (bins == 0) return;
+  QVector<QVector<qint64>> partials(parts(first, last));
+  forEachPart(values, first, last,
+              [&](int part, const double *begin, const double *end) {
+                QVector<qint64> &partial = partials[part];
+                if (partial.isEmpty()) partial.fill(0, bins);
+                qint64 *counts = partial.data();
+                for (const double *value = begin; value != end; value++) {
+                  const int bin = binOf(*value);
+                  if (bin >= 0) counts[bin]++;
+                }
+              });
+  qint64 *counts = counts_.data();
+  for (const QVector<qint64> &partial : partials)
+    for (int bin = 0; bin < partial.size(); bin++) counts[bin] += partial[bin];
+}
+
+bool HistogramEngine::covers(const NumericColumnView &values, const int first,
+                             const int last) const {
+  QVector<char> outside(parts(first, last), 0);
+  forEachPart(values, first, last,
+              [&](int part, const double *begin, const double *end) {
+                for (const double *value = begin; value != end; value++)
+                  if (binOf(*value) < 0) outside[part] = 1;
+              });
+  return !outside.contains(1);
+}
+
+int HistogramEngine::binOf(const double value) const {
+  const int bins = counts_.size();
+  const double position = (value - begin_) / binsize_;
+  if (!(position >= 0.0 && position < bins + 1.0)) return -1;
+  int bin = static_cast<int>(position);
+  // the division may round across a bin edge; the edges themselves are
+  // what lower() returns
+  if (bin > 0 && value < lower(bin))
+    bin--;
+  else if (value >= lower(bin + 1))
+    bin++;
+  return bin < bins ? bin : -1;
+}
+
+void HistogramEngine::forEachPart(
+    const NumericColumnView &values, const int first, const int last,
+    const std::function<void(int, const double *, const double *)>
+        &function) {
+  const int end = std::min(last, values.size() - 1);
+  if (first > end) return;
+  const int count = parts(first, end);
+  const int rows = end - first + 1;
+  auto part = [&](const int &index) {
+    const int begin = first + static_cast<int>(
+                                  static_cast<qint64>(rows) * index / count);
+    const int next = first + static_cast<int>(static_cast<qint64>(rows) *
+                                              (index + 1) / count);
+    if (begin >= next) return;
+    const double *data = values.data();
+    for (const Interval<int> &run :
+         values.validIntervals(Interval<int>(begin, next - 1)))
+      function(index, data + run.start(), data + run.end() + 1);
+  };
+  if (count == 1) {
+    part(0);
+    return;
+  }
+  QVector<int> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+  QtConcurrent::blockingMap(indices, part);
+}
+
+int HistogramEngine::parts(const int first, const int last) {
+  const int rows = std::max(0, last - first + 1);
+  const int threads =
+      std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+  return std::max(1, std::min(threads, rows / part_rows));
+}
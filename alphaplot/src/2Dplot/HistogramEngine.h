@@ -0,0 +1,61 @@
+#ifndef HISTOGRAMENGINE_H
+#define HISTOGRAMENGINE_H
+
+#include <QVector>
+#include <functional>
+
+class NumericColumnView;
+
+// Histogram with uniform bins of the valid values of a range of rows.
+// A value is binned with a single division instead of a search over the bin
+// edges. Large ranges are split into parts which are counted on the global
+// thread pool into partial histograms and summed afterwards, so the counts
+// do not depend on the number of threads.
+class HistogramEngine {
+ public:
+  enum class BinRule { FreedmanDiaconis, Scott };
+
+  HistogramEngine();
+
+  // clear the counts and use the bins [begin + i * binsize,
+  // begin + (i + 1) * binsize) for i = 0 ... bins - 1
+  void reset(const double begin, const double binsize, const int bins);
+  // choose the bins for the valid values of rows first to last and clear the
+  // counts; the range is widened to whole numbers like before and the bin
+  // width follows the rule, falling back to Scott's rule if the quartiles
+  // coincide and to 10 bins if all values are equal. Returns false if there
+  // are not enough values for a histogram.
+  bool autoBin(const NumericColumnView &values, const int first,
+               const int last,
+               const BinRule rule = BinRule::FreedmanDiaconis);
+  // count the valid values of rows first to last, values outside of the bins
+  // are skipped
+  void add(const NumericColumnView &values, const int first, const int last);
+  // whether all valid values of rows first to last fall into the bins
+  bool covers(const NumericColumnView &values, const int first,
+              const int last) const;
+
+  int bins() const { return counts_.size(); }
+  double begin() const { return begin_; }
+  double binsize() const { return binsize_; }
+  double end() const { return lower(bins()); }
+  double lower(const int bin) const { return begin_ + bin * binsize_; }
+  qint64 count(const int bin) const { return counts_.at(bin); }
+
+ private:
+  // the bin holding value, -1 if it lies outside of all bins
+  int binOf(const double value) const;
+  // call function(part, begin, end) for the valid runs of rows first to last,
+  // split into at most parts(first, last) parts, on the thread pool
+  static void forEachPart(
+      const NumericColumnView &values, const int first, const int last,
+      const std::function<void(int, const double *, const double *)>
+          &function);
+  static int parts(const int first, const int last);
+
+  double begin_;
+  double binsize_;
+  QVector<qint64> counts_;
+};
+
+#endif  // HISTOGRAMENGINE_H
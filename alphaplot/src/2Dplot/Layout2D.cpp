@@ -1028,10 +1028,15 @@ void Layout2D::updateData(Matrix *matrix) {
 }
 
 void Layout2D::updateData(Table *table, const QString &name) {
+  updateData(table, name, 0, -1);
+}
+
+void Layout2D::updateData(Table *table, const QString &name, int first,
+                          int last) {
   if (!currentAxisRect_) return;
   bool modified = false;
   foreach (AxisRect2D *axisrect, getAxisRectList()) {
-    bool status = axisrect->updateData(table, name);
+    bool status = axisrect->updateData(table, name, first, last);
     if (status) modified = true;
   }
   if (modified)
@@ -116,6 +116,7 @@ class Layout2D : public MyWidget {
                                 const QString &selected_filter);
   void updateData(Matrix *matrix);
   void updateData(Table *table, const QString &name);
+  void updateData(Table *table, const QString &name, int first, int last);
   void removeMatrix(Matrix *matrix);
   void removeColumn(Table *table, const QString &name);
   QList<MyWidget *> dependentTableMatrix();
@@ -99,6 +99,10 @@ void LineSpecial2D::setGraphData(Table *table, Column *xcol, Column *ycol,
   setData(graphdata_->data());
 }
 
+void LineSpecial2D::updateGraphData(int first, int last) {
+  graphdata_->updateDataBlock(first, last);
+}
+
 void LineSpecial2D::removeXerrorBar() {
   if (!xerroravailable_) return;
 
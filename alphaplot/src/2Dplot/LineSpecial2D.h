@@ -26,6 +26,7 @@ class LineSpecial2D : public QCPGraph {
   void setXerrorBar(Table *table, Column *errorcol, int from, int to);
   void setYerrorBar(Table *table, Column *errorcol, int from, int to);
   void setGraphData(Table *table, Column *xcol, Column *ycol, int from, int to);
+  void updateGraphData(int first, int last);
   void removeXerrorBar();
   void removeYerrorBar();
   // Getters
@@ -427,10 +427,11 @@ void DataBlockScatter3D::regenerateDataBlockModel() {
   QScatterDataItem *ptrToDataArray = &valueDataArray_->first();
 
   for (int i = 0; i < matrix_->numRows(); i++) {
-    for (int j = 0; j < matrix_->numCols(); j++) {
+    const future::Matrix::Span row = matrix_->d_future_matrix->rowSpan(i);
+    for (int j = 0; j < row.size(); j++) {
       double x = i;
       double y = j;
-      double z = matrix_->cell(i, j);
+      double z = row.at(j);
       ptrToDataArray->setPosition(QVector3D(y, z, x));
       ptrToDataArray++;
     }
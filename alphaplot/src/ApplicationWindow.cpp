@@ -53,10 +53,12 @@
 #include "analysis/SmoothFilter.h"
 #include "core/AppearanceManager.h"
 #include "core/AprojHandler.h"
+#include "core/AutosaveEngine.h"
 #include "core/IconLoader.h"
 #include "core/Project.h"
 #include "core/column/Column.h"
 #include "globals.h"
+#include "lib/XmlPagedData.h"
 #include "lib/XmlStreamReader.h"
 #include "table/future_Table.h"
 #include "ui/CharacterMapWidget.h"
@@ -95,6 +97,7 @@
 #include <QPixmapCache>
 #include <QPrintDialog>
 #include <QPrinter>
+#include <QProgressBar>
 #include <QProgressDialog>
 #include <QScriptValue>
 #include <QSettings>
@@ -104,6 +107,7 @@
 #include <QStatusBar>
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QTimer>
 #include <QToolBar>
 #include <QToolButton>
 #include <QTranslator>
@@ -191,6 +195,9 @@ ApplicationWindow::ApplicationWindow()
           new QAction(tr("No Selection"), groupplot3dselectionmode_)),
       d_plot_mapper(new QSignalMapper(this)),
       statusBarInfo(new QLabel(this)),
+      autosave_(new AutosaveEngine(this)),
+      autosaveprogress_(new QProgressBar(this)),
+      autosaveclean_(false),
       actionShowPropertyEditor(new QAction(this)),
       actionShowProjectExplorer(new QAction(this)),
       actionShowResultsLog(new QAction(this)),
@@ -940,6 +947,16 @@ ApplicationWindow::ApplicationWindow()
   connect(statusBarInfo, &QLabel::customContextMenuRequested, this,
           &ApplicationWindow::showStatusBarContextMenu);
   statusBar()->addWidget(statusBarInfo, 1);
+  autosaveprogress_->setMaximumWidth(150);
+  autosaveprogress_->setFormat(tr("Autosave %p%"));
+  autosaveprogress_->hide();
+  statusBar()->addPermanentWidget(autosaveprogress_);
+  connect(autosave_, &AutosaveEngine::progress, autosaveprogress_,
+          &QProgressBar::setValue);
+  connect(autosave_, &AutosaveEngine::finished, this,
+          &ApplicationWindow::autoSaveFinished);
+  connect(XmlPagedDataErrors::instance(), &XmlPagedDataErrors::failed, this,
+          &ApplicationWindow::pagedDataFailed, Qt::QueuedConnection);
 
   // Create central MdiArea
   d_workspace->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
@@ -2173,6 +2190,8 @@ TableStatistics *ApplicationWindow::newTableStatistics(Table *base, int type,
   d_project->addChild(statTable->d_future_table);
   connect(base, SIGNAL(modifiedData(Table *, const QString &)), statTable,
           SLOT(update(Table *, const QString &)));
+  connect(base, SIGNAL(modifiedRows(Table *, const QString &, int, int)),
+          statTable, SLOT(update(Table *, const QString &)));
   connect(base, SIGNAL(changedColHeader(const QString &, const QString &)),
           statTable, SLOT(renameCol(const QString &, const QString &)));
   connect(base, SIGNAL(removedCol(const QString &)), statTable,
@@ -2507,6 +2526,18 @@ void ApplicationWindow::updateCurves(Table *t, const QString &name) {
   }
 }
 
+void ApplicationWindow::updateCurves(Table *t, const QString &name, int first,
+                                     int last) {
+  QList<QMdiSubWindow *> subwindowlist = subWindowsList();
+  foreach (QMdiSubWindow *subwindow, subwindowlist) {
+    if (isActiveSubWindow(subwindow, SubWindowType::Plot2DSubWindow)) {
+      Layout2D *layout2d = qobject_cast<Layout2D *>(subwindow);
+      if (layout2d) layout2d->updateData(t, name, first, last);
+    } else if (isActiveSubWindow(subwindow, SubWindowType::Plot3DSubWindow)) {
+    }
+  }
+}
+
 void ApplicationWindow::showPreferencesDialog() {
   std::unique_ptr<SettingsDialog> settings_(new SettingsDialog);
   connect(settings_.get(), &SettingsDialog::generalapplicationsettingsupdates,
@@ -2949,6 +2980,16 @@ void ApplicationWindow::importASCII() {
               import_dialog->decimalSeparators());
 }
 
+void ApplicationWindow::showImportThroughput(Table *table,
+                                             const QString &file) {
+  if (table->importThroughput() <= 0.0) return;
+  statusBar()->showMessage(
+      tr("Imported %1 at %2 MB/s")
+          .arg(QFileInfo(file).fileName())
+          .arg(QLocale().toString(table->importThroughput(), 'f', 1)),
+      5000);
+}
+
 void ApplicationWindow::importASCII(const QStringList &files, int import_mode,
                                     const QString &local_column_separator,
                                     int local_ignored_lines,
@@ -2971,6 +3012,7 @@ void ApplicationWindow::importASCII(const QStringList &files, int import_mode,
                           local_strip_spaces, local_simplify_spaces,
                           local_convert_to_numeric, local_numeric_locale);
       if (!w) continue;
+      showImportThroughput(w, sorted_files.at(i));
       w->setCaptionPolicy(MyWidget::Both);
       setListViewLabel(w->name(), sorted_files[i]);
       if (i == 0) {
@@ -2994,6 +3036,7 @@ void ApplicationWindow::importASCII(const QStringList &files, int import_mode,
                   local_simplify_spaces, local_convert_to_numeric,
                   local_numeric_locale, "temp", 0, 0, Qt::Widget);
     if (!temp) continue;
+    showImportThroughput(temp, file);
 
     // need to check data types of columns for append/overwrite
     if (import_mode == ImportASCIIDialog::NewRows ||
@@ -4139,7 +4182,13 @@ bool ApplicationWindow::saveProject() {
   }
 
   const QString filename = projectname;
-  aprojhandler_->saveproject(filename, projectFolder());
+  // let a running autosave finish first, it writes to the same file
+  autosave_->waitForFinished();
+  if (!aprojhandler_->saveproject(filename, projectFolder())) {
+    QMessageBox::critical(this, tr("Save Error"),
+                          aprojhandler_->errorString());
+    return false;
+  }
 
   setWindowTitle("AlphaPlot - " + projectname);
   savedProject();
@@ -4176,6 +4225,7 @@ void ApplicationWindow::saveProjectAs() {
     }
     projectname = filename;
 
+    autosave_->waitForFinished();
     if (aprojhandler_->saveproject(filename, projectFolder())) {
       recentProjects.removeAll(filename);
       recentProjects.push_front(filename);
@@ -4188,11 +4238,8 @@ void ApplicationWindow::saveProjectAs() {
       item->setText(0, baseName);
       item->folder()->setName(baseName);
     } else {
-      QMessageBox::critical(
-          this, tr("Export Error"),
-          tr("Could not write to file: <br><h4> %1 </h4><p>Please verify "
-             "that you have the right to write to this location!")
-              .arg(filename));
+      QMessageBox::critical(this, tr("Save Error"),
+                            aprojhandler_->errorString());
     }
   }
 }
@@ -4234,11 +4281,8 @@ void ApplicationWindow::saveAsTemplate() {
 
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
     if (!aprojhandler_->saveTemplate(filename, mywidget)) {
-      QMessageBox::critical(
-          this, tr("Export Error"),
-          tr("Could not write to file: <br><h4> %1 </h4><p>Please verify "
-             "that you have the right to write to this location!")
-              .arg(filename));
+      QMessageBox::critical(this, tr("Save Error"),
+                            aprojhandler_->errorString());
     }
     QApplication::restoreOverrideCursor();
   }
@@ -5527,13 +5571,17 @@ MyWidget *ApplicationWindow::clone(MyWidget *widget) {
 
 void ApplicationWindow::undo() {
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+  d_project->setUndoingOrRedoing(true);
   d_project->undoStack()->undo();
+  d_project->setUndoingOrRedoing(false);
   QApplication::restoreOverrideCursor();
 }
 
 void ApplicationWindow::redo() {
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+  d_project->setUndoingOrRedoing(true);
   d_project->undoStack()->redo();
+  d_project->setUndoingOrRedoing(false);
   QApplication::restoreOverrideCursor();
 }
 
@@ -5753,6 +5801,7 @@ void ApplicationWindow::savedProject() {
 void ApplicationWindow::modifiedProject() {
   ui_->actionSaveProject->setEnabled(true);
   saved = false;
+  autosaveclean_ = false;
 }
 
 void ApplicationWindow::modifiedProject(MyWidget *widget) {
@@ -5764,12 +5813,60 @@ void ApplicationWindow::modifiedProject(MyWidget *widget) {
 
 void ApplicationWindow::timerEvent(QTimerEvent *event) {
   if (event->timerId() == savingTimerId) {
-    saveProject();
+    autoSaveProject();
   } else {
     QWidget::timerEvent(event);
   }
 }
 
+void ApplicationWindow::autoSaveProject() {
+  if (projectname == "untitled") {
+    saveProject();
+    return;
+  }
+  // skip this round if the previous autosave is still being written
+  if (autosave_->isRunning()) return;
+
+  autosaveclean_ = true;
+  autosaveprogress_->setValue(0);
+  autosaveprogress_->show();
+  autosave_->start(aprojhandler_, projectFolder(), projectname);
+}
+
+void ApplicationWindow::autoSaveFinished(bool ok, const QString &filename) {
+  autosaveprogress_->hide();
+  if (!ok) {
+    statusBar()->showMessage(tr("Autosave of %1 failed").arg(filename), 5000);
+    return;
+  }
+  // changes made while the autosave was running are not in the file
+  if (filename != projectname || !autosaveclean_) return;
+  setWindowTitle("AlphaPlot - " + projectname);
+  savedProject();
+  ui_->actionUndo->setEnabled(false);
+  ui_->actionRedo->setEnabled(false);
+}
+
+void ApplicationWindow::pagedDataFailed(const QString &message) {
+  // the columns of a table mostly fail together and every autosave runs
+  // into the same data again, so each message is shown once, several in
+  // one box
+  if (pageddatafailures_.contains(message)) return;
+  pageddatafailures_.insert(message);
+  pendingpageddatafailures_ << message;
+  if (pendingpageddatafailures_.size() > 1) return;
+  QTimer::singleShot(0, this, [this]() {
+    QStringList messages = pendingpageddatafailures_;
+    pendingpageddatafailures_.clear();
+    const int more = messages.size() - 5;
+    if (more > 0) {
+      messages = messages.mid(0, 5);
+      messages << tr("... and %n more.", nullptr, more);
+    }
+    QMessageBox::warning(this, tr("Project data"), messages.join("\n\n"));
+  });
+}
+
 void ApplicationWindow::dropEvent(QDropEvent *event) {
   if (event->mimeData()->hasUrls()) {
     QStringList asciiFiles;
@@ -6777,8 +6874,11 @@ void ApplicationWindow::connectTable(Table *table) {
           SLOT(removeCurves(Table *, const QString &)));
   connect(table, SIGNAL(modifiedData(Table *, const QString &)), this,
           SLOT(updateCurves(Table *, const QString &)));
+  connect(table, SIGNAL(modifiedRows(Table *, const QString &, int, int)),
+          this, SLOT(updateCurves(Table *, const QString &, int, int)));
   connect(table, SIGNAL(modifiedWindow(MyWidget *)), this,
           SLOT(modifiedProject(MyWidget *)));
+  connect(table, &Table::formulaWarning, this, &ApplicationWindow::updateLog);
   connect(table->d_future_table, SIGNAL(requestRowStatistics()), this,
           SLOT(showRowStatistics()));
   connect(table->d_future_table, SIGNAL(requestColumnStatistics()), this,
@@ -7488,6 +7588,9 @@ void ApplicationWindow::saveAsProject() {
       recentProjects.removeAll(filename);
       recentProjects.push_front(filename);
       updateRecentProjectsList();
+    } else {
+      QMessageBox::critical(this, tr("Save Error"),
+                            aprojhandler_->errorString());
     }
   }
 }
@@ -9270,9 +9373,11 @@ void ApplicationWindow::showUndoRedoHistory() {
   layout.addWidget(&button_box);
 
   dialog.setWindowTitle(tr("Undo/Redo History"));
-  if (dialog.exec() == QDialog::Accepted) return;
-
-  d_project->undoStack()->setIndex(index);
+  // selecting an entry of the history undoes or redoes up to it
+  d_project->setUndoingOrRedoing(true);
+  if (dialog.exec() != QDialog::Accepted)
+    d_project->undoStack()->setIndex(index);
+  d_project->setUndoingOrRedoing(false);
 }
 
 QStringList ApplicationWindow::tableWindows() {
@@ -29,6 +29,7 @@
 #include <QDesktopServices>
 #include <QFile>
 #include <QLocale>
+#include <QSet>
 
 #include "Table.h"
 
@@ -49,6 +50,7 @@ class QDockWidget;
 class QAction;
 class QActionGroup;
 class QLineEdit;
+class QProgressBar;
 class QTranslator;
 class QToolButton;
 class QShortcut;
@@ -78,6 +80,7 @@ class AbstractAspect;
 class ConsoleWidget;
 class IconLoader;
 class AprojHandler;
+class AutosaveEngine;
 class SettingsDialog;
 class PropertiesDialog;
 class PropertyBrowser;
@@ -393,6 +396,8 @@ class ApplicationWindow : public QMainWindow,
                    int local_ignored_lines, bool local_rename_columns,
                    bool local_strip_spaces, bool local_simplify_spaces,
                    bool local_convert_to_numeric, QLocale local_numeric_locale);
+  //! Show the MB/s the parallel reader imported 'file' into 'table' at
+  void showImportThroughput(Table* table, const QString& file);
   void exportAllTables(const QString& sep, bool colNames, bool expSelection);
   void exportASCII(const QString& tableName, const QString& sep, bool colNames,
                    bool expSelection);
@@ -496,6 +501,7 @@ class ApplicationWindow : public QMainWindow,
   void setListViewLabel(const QString& caption, const QString& label);
   //@}
   void updateCurves(Table* t, const QString& name);
+  void updateCurves(Table* t, const QString& name, int first, int last);
 
   void showTable(const QString& curve);
 
@@ -1103,6 +1109,14 @@ class ApplicationWindow : public QMainWindow,
   QSignalMapper* d_plot_mapper;
 
   QLabel* statusBarInfo;
+  //! Writes autosaves without blocking the ui
+  AutosaveEngine* autosave_;
+  QProgressBar* autosaveprogress_;
+  //! Whether the project is unchanged since the running autosave started
+  bool autosaveclean_;
+  //! Project data read failures shown so far, and those still to be shown
+  QSet<QString> pageddatafailures_;
+  QStringList pendingpageddatafailures_;
 
   Project *d_project;
   // SettingsDialog* settings_;
@@ -1143,6 +1157,11 @@ class ApplicationWindow : public QMainWindow,
   void handleAspectAdded(const AbstractAspect* aspect, int index);
   void handleAspectAboutToBeRemoved(const AbstractAspect* aspect, int index);
   void lockToolbars(const bool status);
+  //! Start writing the project in the background
+  void autoSaveProject();
+  void autoSaveFinished(bool ok, const QString& filename);
+  //! Tell about project data which could not be read back from its file
+  void pagedDataFailed(const QString& message);
 
  public slots:
   Table* getTableHandle();
@@ -51,9 +51,11 @@
 #include <QPrinter>
 #include <QShortcut>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QVBoxLayout>
 #include <QVarLengthArray>
 #include <QXmlStreamWriter>
+#include <QtConcurrent>
 #include <QtDebug>
 #include <QtGlobal>
 
@@ -61,6 +63,104 @@
 #include "future/matrix/MatrixView.h"
 #include "scripting/ScriptEdit.h"
 
+namespace {
+//! Minimum number of cells evaluated by one thread in Matrix::recalculate()
+const int min_fill_band_cells = 4096;
+//! Cells of a band evaluated with one call into the script
+const int fill_tile_cells = 1 << 16;
+
+//! Selected cells and coordinates shared by the bands of a formula fill
+struct MatrixFill {
+  //! the selected rows of the columns first_col, first_col + 1, ...
+  QList<QList<Interval<int> > > selection;
+  int first_col;
+  double x_start, dx;
+  double y_start, dy;
+  //! the new cells, column by column, stride rows
+  double *cells;
+  int rows;
+};
+
+//! Rows of a formula fill evaluated by one worker thread with its own script
+struct MatrixFillBand {
+  const MatrixFill *fill;
+  Script *script;
+  int first_row;
+  int last_row;
+  bool ok = false;
+  //! Message of the error the band stopped at
+  QString error;
+};
+
+//! Evaluate the selected cells of a band, in row tiles
+/**
+ * The variables of the cells of a tile are passed as arrays, so the formula
+ * is evaluated in bulk if the script supports it. The results go straight
+ * into the cell buffer; bands cover different rows, so they never write the
+ * same cell. Errors aren't emitted by the script, but kept in the band to be
+ * reported once all bands are done.
+ */
+void fillMatrixBand(MatrixFillBand &band) {
+  const MatrixFill &fill = *band.fill;
+  const int columns = fill.selection.size();
+  const int tile_rows = qMax(1, fill_tile_cells / qMax(1, columns));
+  QVector<double> rows, cols, results;
+  for (int first = band.first_row; first <= band.last_row;
+       first += tile_rows) {
+    const Interval<int> tile(first,
+                             qMin(band.last_row, first + tile_rows - 1));
+    rows.clear();
+    cols.clear();
+    for (int k = 0; k < columns; k++)
+      foreach (const Interval<int> &run, fill.selection.at(k)) {
+        const Interval<int> cells = Interval<int>::intersection(run, tile);
+        for (int row = cells.start(); row <= cells.end(); row++) {
+          rows << row + 1;
+          cols << fill.first_col + k + 1;
+        }
+      }
+    const int count = rows.size();
+    if (count == 0) continue;
+
+    QVector<double> y(count), x(count);
+    for (int n = 0; n < count; n++) {
+      y[n] = fill.y_start + (rows.at(n) - 1) * fill.dy;
+      x[n] = fill.x_start + (cols.at(n) - 1) * fill.dx;
+    }
+    QMap<QByteArray, QVector<double> > variables;
+    variables["i"] = variables["row"] = rows;
+    variables["j"] = variables["col"] = cols;
+    variables["y"] = y;
+    variables["x"] = x;
+    results.resize(count);
+    if (!band.script->evalBulk(variables, results)) {
+      for (int n = 0; n < count; n++) {
+        const int row = static_cast<int>(rows.at(n));
+        const int col = static_cast<int>(cols.at(n));
+        band.script->setInt(row, "i");
+        band.script->setInt(row, "row");
+        band.script->setDouble(y.at(n), "y");
+        band.script->setInt(col, "j");
+        band.script->setInt(col, "col");
+        band.script->setDouble(x.at(n), "x");
+        const QVariant ret = band.script->eval();
+        if (!ret.isValid()) {
+          band.error = band.script->lastError();
+          return;
+        }
+        results[n] = ret.toDouble();
+      }
+    }
+    for (int n = 0; n < count; n++) {
+      const qint64 col = static_cast<qint64>(cols.at(n)) - 1;
+      fill.cells[col * fill.rows + static_cast<int>(rows.at(n)) - 1] =
+          results.at(n);
+    }
+  }
+  band.ok = true;
+}
+}  // namespace
+
 Matrix::Matrix(ScriptingEnv *env, int r, int c, const QString &label,
                QWidget *parent, const char *name, Qt::WindowFlags f)
     : MatrixView(label, parent, name, f), scripted(env) {
@@ -249,17 +349,18 @@ double Matrix::determinant() {
 
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-  gsl_matrix *A = gsl_matrix_alloc(rows, cols);
+  // the cells are stored column by column, so GSL sees the transposed
+  // matrix, which has the same determinant; the decomposition works on a
+  // copy of the buffer
+  QVector<double> cells = d_future_matrix->data();
+  gsl_matrix_view A = gsl_matrix_view_array(cells.data(), cols, rows);
   int i;
-  for (i = 0; i < rows; i++)
-    for (int j = 0; j < cols; j++) gsl_matrix_set(A, i, j, cell(i, j));
 
   gsl_permutation *p = gsl_permutation_alloc(rows);
-  gsl_linalg_LU_decomp(A, p, &i);
+  gsl_linalg_LU_decomp(&A.matrix, p, &i);
 
-  double det = gsl_linalg_LU_det(A, i);
+  double det = gsl_linalg_LU_det(&A.matrix, i);
 
-  gsl_matrix_free(A);
   gsl_permutation_free(p);
 
   QApplication::restoreOverrideCursor();
@@ -278,28 +379,26 @@ void Matrix::invert() {
 
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-  gsl_matrix *A = gsl_matrix_alloc(rows, cols);
+  // GSL sees the transposed matrix (see determinant()), whose inverse is
+  // the transposed inverse, which is again the inverse column by column
+  QVector<double> cells = d_future_matrix->data();
+  gsl_matrix_view A = gsl_matrix_view_array(cells.data(), cols, rows);
   int i;
-  for (i = 0; i < rows; i++) {
-    for (int j = 0; j < cols; j++) gsl_matrix_set(A, i, j, cell(i, j));
-  }
 
   gsl_permutation *p = gsl_permutation_alloc(cols);
-  gsl_linalg_LU_decomp(A, p, &i);
+  gsl_linalg_LU_decomp(&A.matrix, p, &i);
 
-  gsl_matrix *inverse = gsl_matrix_alloc(rows, cols);
-  gsl_linalg_LU_invert(A, p, inverse);
+  QVector<double> inverse(rows * cols);
+  gsl_matrix_view inverse_view =
+      gsl_matrix_view_array(inverse.data(), cols, rows);
+  gsl_linalg_LU_invert(&A.matrix, p, &inverse_view.matrix);
 
-  gsl_matrix_free(A);
   gsl_permutation_free(p);
 
   this->blockSignals(true);
-  for (i = 0; i < rows; i++) {
-    for (int j = 0; j < cols; j++) setCell(i, j, gsl_matrix_get(inverse, i, j));
-  }
+  d_future_matrix->setCells(inverse);
   this->blockSignals(false);
 
-  gsl_matrix_free(inverse);
   QApplication::restoreOverrideCursor();
   emit modifiedWindow(this);
 }
@@ -320,52 +419,83 @@ void Matrix::forgetSavedCells() {
 }
 
 bool Matrix::recalculate() {
-  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-  Script *script =
-      scriptEnv->newScript(formula(), this, QString("<%1>").arg(name()));
-  connect(script, &Script::error, scriptEnv, &ScriptingEnv::error);
-  connect(script, &Script::error, scriptEnv, &ScriptingEnv::print);
-  if (!script->compile()) {
-    QApplication::restoreOverrideCursor();
-    return false;
-  }
-
-  this->blockSignals(true);
-
   int startRow = firstSelectedRow(false);
   int endRow = lastSelectedRow(false);
   int startCol = firstSelectedColumn(false);
   int endCol = lastSelectedColumn(false);
+  // nothing selected, nothing to change
+  if (startRow < 0 || startCol < 0) return true;
 
-  QVariant ret;
-  saveCellsToMemory();
-  double dx = fabs(xEnd() - xStart()) / (double)(numRows() - 1);
-  double dy = fabs(yEnd() - yStart()) / (double)(numCols() - 1);
-  for (int row = startRow; row <= endRow; row++)
-    for (int col = startCol; col <= endCol; col++) {
-      if (!isCellSelected(row, col)) continue;
-      script->setInt(row + 1, "i");
-      script->setInt(row + 1, "row");
-      script->setDouble(yStart() + row * dy, "y");
-      script->setInt(col + 1, "j");
-      script->setInt(col + 1, "col");
-      script->setDouble(xStart() + col * dx, "x");
-      ret = script->eval();
-      if (!ret.isValid()) {
-        forgetSavedCells();
-        blockSignals(false);
-        emit modifiedWindow(this);
-        QApplication::restoreOverrideCursor();
-        return false;
-      }
-      setCell(row, col, ret.toDouble());
+  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
+
+  // the formula reads the cells as they are now (cell() reads the matrix),
+  // while the results go to a copy, which then replaces the cells with a
+  // single undo step
+  QVector<double> cells = d_future_matrix->data();
+  MatrixFill fill;
+  fill.first_col = startCol;
+  for (int col = startCol; col <= endCol; col++)
+    fill.selection << selectedCells(col).intervals();
+  fill.x_start = xStart();
+  fill.dx = fabs(xEnd() - xStart()) / (double)(numRows() - 1);
+  fill.y_start = yStart();
+  fill.dy = fabs(yEnd() - yStart()) / (double)(numCols() - 1);
+  fill.cells = cells.data();
+  fill.rows = numRows();
+
+  // a script instance must only be used by one thread at a time, so every
+  // band of rows gets its own
+  const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+  const int selected_rows = qMax(1, endRow - startRow + 1);
+  const qint64 selected_cells =
+      static_cast<qint64>(selected_rows) * qMax(1, endCol - startCol + 1);
+  const int count = static_cast<int>(
+      qBound<qint64>(1, selected_cells / min_fill_band_cells, threads));
+  const int band_rows = (selected_rows + count - 1) / count;
+  QList<MatrixFillBand> bands;
+  QList<Script *> scripts;
+  bool ok = true;
+  for (int first = startRow; first <= endRow; first += band_rows) {
+    Script *script =
+        scriptEnv->newScript(formula(), this, QString("<%1>").arg(name()));
+    connect(script, &Script::error, scriptEnv, &ScriptingEnv::error);
+    connect(script, &Script::error, scriptEnv, &ScriptingEnv::print);
+    scripts << script;
+    if (!script->compile()) {
+      ok = false;
+      break;
     }
-  forgetSavedCells();
+    // the workers don't emit signals themselves
+    script->setEmitErrors(false);
+    MatrixFillBand band;
+    band.fill = &fill;
+    band.script = script;
+    band.first_row = first;
+    band.last_row = qMin(endRow, first + band_rows - 1);
+    bands << band;
+  }
 
-  blockSignals(false);
-  emit modifiedWindow(this);
+  if (ok) {
+    QtConcurrent::blockingMap(bands, fillMatrixBand);
+    // the first error only, not one per band
+    foreach (const MatrixFillBand &band, bands)
+      if (!band.ok) {
+        if (!band.error.isEmpty())
+          emit band.script->error(band.error, band.script->name(), 0);
+        ok = false;
+        break;
+      }
+  }
+  qDeleteAll(scripts);
+
+  if (ok) {
+    this->blockSignals(true);
+    d_future_matrix->setCells(cells);
+    this->blockSignals(false);
+    emit modifiedWindow(this);
+  }
   QApplication::restoreOverrideCursor();
-  return true;
+  return ok;
 }
 
 void Matrix::clearSelection() { d_future_matrix->clearSelectedCells(); }
@@ -548,20 +678,26 @@ void Matrix::print(const QString &fileName) {
 }
 
 void Matrix::range(double *min, double *max) {
-  double d_min = cell(0, 0);
-  double d_max = d_min;
-
-  for (int i = 0; i < numRows(); i++) {
-    for (int j = 0; j < numCols(); j++) {
-      double aux = cell(i, j);
-      if (aux <= d_min) d_min = aux;
-
-      if (aux >= d_max) d_max = aux;
+  int rows = numRows();
+  int cols = numCols();
+  *min = *max = 0.0;
+  if (rows == 0 || cols == 0) return;
+
+  // gsl_matrix_minmax() gives NaN as soon as one cell is NaN, which would
+  // spoil the color scale of the whole matrix; non-finite cells are skipped
+  const QVector<double> cells = d_future_matrix->data();
+  bool found = false;
+  for (const double value : cells) {
+    if (!qIsFinite(value)) continue;
+    if (!found) {
+      *min = *max = value;
+      found = true;
+    } else if (value < *min) {
+      *min = value;
+    } else if (value > *max) {
+      *max = value;
     }
   }
-
-  *min = d_min;
-  *max = d_max;
 }
 
 double **Matrix::allocateMatrixData(int rows, int columns) {
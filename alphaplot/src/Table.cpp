@@ -46,9 +46,15 @@
 #include <QShortcut>
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "core/IconLoader.h"
+#include "core/Project.h"
 #include "core/column/Column.h"
 #include "core/datatypes/DateTime2StringFilter.h"
 #include "core/datatypes/Double2StringFilter.h"
@@ -58,6 +64,72 @@
 #include "table/AsciiTableImportFilter.h"
 #include "table/TableModel.h"
 
+namespace {
+//! Minimum number of rows evaluated by one thread in Table::recalculate()
+const int min_formula_chunk_rows = 4096;
+
+//! Rows of a numeric formula interval evaluated by one worker thread
+struct FormulaChunk {
+  Column *column;
+  Script *script;
+  int first_row;
+  QVector<qreal> results;
+  //! Whether the script's references are resolved, so it may run on a worker
+  bool threaded = false;
+  bool ok = false;
+  //! Message of the error the chunk stopped at
+  QString error;
+};
+
+//! Evaluate a chunk of rows, in bulk if the script supports it
+/**
+ * Errors aren't emitted by the script, but kept in the chunk to be reported
+ * once all chunks are done.
+ */
+void evalFormulaChunk(FormulaChunk &chunk) {
+  if (chunk.script->evalBulk(chunk.first_row, chunk.results)) {
+    chunk.ok = true;
+    return;
+  }
+  for (int i = 0; i < chunk.results.size(); i++) {
+    chunk.script->setInt(chunk.first_row + i + 1, "i");
+    QVariant ret = chunk.script->eval();
+    if (!ret.isValid()) {
+      chunk.error = chunk.script->lastError();
+      return;
+    }
+    if (ret.canConvert(QVariant::Double))
+      chunk.results[i] = ret.toDouble();
+    else
+      chunk.results[i] = std::numeric_limits<double>::quiet_NaN();
+  }
+  chunk.ok = true;
+}
+
+//! Whether 'formula' may read one of 'columns'
+/**
+ * Conservative: columns referenced by index or by a computed name count as
+ * read, since they can't be resolved without evaluating the formula.
+ */
+bool formulaReadsColumns(const QString &formula,
+                         const QList<Column *> &columns) {
+  QRegExp indirect(
+      "\\b(column__|tablecol)\\s*\\(|"
+      "\\b(col|column_|cell|cell_)\\s*\\(\\s*[^\"\\s]");
+  if (indirect.indexIn(formula) != -1) return true;
+  foreach (Column *column, columns)
+    if (formula.contains(column->name())) return true;
+  return false;
+}
+
+//! Marks every row of a column as changed
+const Interval<int> all_rows(0, std::numeric_limits<int>::max() - 1);
+//! Tables a change may pass through before it's taken for a circular reference
+const int max_dependent_hops = 64;
+//! Tables the changes written by the running recalculateDependents() passed
+int dependent_hops = 0;
+}  // namespace
+
 Table::Table(ScriptingEnv *env, const QString &fname, const QString &sep,
              int ignoredLines, bool renameCols, bool stripSpaces,
              bool simplifySpaces, bool convertToNumeric, QLocale numericLocale,
@@ -75,6 +147,7 @@ Table::Table(ScriptingEnv *env, const QString &fname, const QString &sep,
   QFile file(fname);
   if (file.open(QIODevice::ReadOnly)) {
     d_future_table = qobject_cast<future::Table *>(filter.importAspect(file));
+    d_import_throughput = filter.mapped_throughput();
     if (!d_future_table)
       d_future_table = new future::Table(0, 0, 0, label);
     else
@@ -145,9 +218,9 @@ void Table::init() {
   connect(d_future_table, SIGNAL(columnsRemoved(int, int)), this,
           SLOT(handleColumnsRemoved(int, int)));
   connect(d_future_table, SIGNAL(rowsInserted(int, int)), this,
-          SLOT(handleRowChange()));
+          SLOT(handleRowsInserted(int, int)));
   connect(d_future_table, SIGNAL(rowsRemoved(int, int)), this,
-          SLOT(handleRowChange()));
+          SLOT(handleRowsRemoved(int, int)));
   connect(d_future_table, SIGNAL(dataChanged(int, int, int, int)), this,
           SLOT(handleColumnChange(int, int, int, int)));
   connect(d_future_table, SIGNAL(columnsReplaced(int, int)), this,
@@ -184,6 +257,17 @@ void Table::init() {
           &Table::rowcountchange);
   connect(d_future_table, &future::Table::rowsRemoved, this,
           &Table::rowcountchange);
+
+  connect(d_future_table, &future::Table::autoRecalculateChanged, this,
+          &Table::updateFormulaDependencies);
+  connect(d_future_table, &future::Table::columnsInserted, this,
+          &Table::updateFormulaDependencies);
+  connect(d_future_table, &future::Table::columnsReplaced, this,
+          &Table::updateFormulaDependencies);
+  connect(d_future_table, &future::Table::columnsRemoved, this,
+          &Table::updateFormulaDependencies);
+  // tables read by the formulas may still be loading
+  QTimer::singleShot(0, this, &Table::updateFormulaDependencies);
 }
 
 void Table::handleChange() { emit modifiedWindow(this); }
@@ -194,9 +278,12 @@ void Table::handleColumnChange(int first, int count) {
 }
 
 void Table::handleColumnChange(int top, int left, int bottom, int right) {
-  Q_UNUSED(top);
-  Q_UNUSED(bottom);
-  handleColumnChange(left, right - left + 1);
+  if (top == 0 && bottom >= numRows() - 1) {
+    handleColumnChange(left, right - left + 1);
+    return;
+  }
+  for (int i = left; i <= right; i++)
+    emit modifiedRows(this, colName(i), top, bottom);
 }
 
 void Table::handleColumnsAboutToBeRemoved(int first, int count) {
@@ -208,8 +295,17 @@ void Table::handleColumnsRemoved(int first, int count) {
   for (int i = first; i < first + count; i++) emit removedCol(colName(i));
 }
 
-void Table::handleRowChange() {
-  for (int i = 0; i < numCols(); i++) emit modifiedData(this, colName(i));
+void Table::handleRowsInserted(int first, int count) {
+  Q_UNUSED(count);
+  // all rows from first on have moved
+  for (int i = 0; i < numCols(); i++)
+    emit modifiedRows(this, colName(i), first, numRows() - 1);
+}
+
+void Table::handleRowsRemoved(int first, int count) {
+  // all rows from first on have moved, including the former last rows
+  for (int i = 0; i < numCols(); i++)
+    emit modifiedRows(this, colName(i), first, numRows() + count - 1);
 }
 
 void Table::setTableBackgroundColor(const QColor &col) {
@@ -384,10 +480,12 @@ void Table::setColumnTypes(const QStringList &ctl) {
 void Table::setCommands(const QStringList &com) {
   for (int i = 0; i < static_cast<int>(com.size()) && i < numCols(); i++)
     column(i)->setFormula(Interval<int>(0, numRows() - 1), com.at(i).trimmed());
+  updateFormulaDependencies();
 }
 
 void Table::setCommand(int col, const QString &com) {
   column(col)->setFormula(Interval<int>(0, numRows() - 1), com.trimmed());
+  updateFormulaDependencies();
 }
 
 void Table::setCommands(const QString &com) {
@@ -397,89 +495,400 @@ void Table::setCommands(const QString &com) {
 }
 
 bool Table::recalculate() {
+  QList<int> cols;
   for (int col = firstSelectedColumn(); col <= lastSelectedColumn(); col++)
-    if (!recalculate(col, true)) return false;
-  return true;
+    cols << col;
+  return recalculate(cols, true);
 }
 
 bool Table::recalculate(int col, bool only_selected_rows) {
+  return recalculate(QList<int>() << col, only_selected_rows);
+}
+
+bool Table::recalculate(const QList<int> &cols, bool only_selected_rows) {
+  QList<QList<Interval<int> > > rows;
+  foreach (int col, cols) {
+    Column *col_ptr = column(col);
+    if (!col_ptr) return false;
+    rows << (only_selected_rows ? selectedRows().intervals()
+                                : col_ptr->formulaIntervals());
+  }
+  return recalculateRows(cols, rows);
+}
+
+bool Table::recalculateRows(const QList<int> &cols,
+                            const QList<QList<Interval<int> > > &rows) {
   QApplication::setOverrideCursor(Qt::WaitCursor);
-  Column *col_ptr = column(col);
-  if (!col_ptr) return false;
-
-  QList<Interval<int> > formula_intervals = col_ptr->formulaIntervals();
-  if (only_selected_rows) {
-    // remove non-selected rows from list of intervals
-    QList<Interval<int> > deselected =
-        Interval<int>(0, col_ptr->rowCount() - 1) - selectedRows().intervals();
-    foreach (Interval<int> i, deselected)
-      Interval<int>::subtractIntervalFromList(&formula_intervals, i);
+  bool ok = true;
+  // numeric columns evaluated together; a column reading one of them has to
+  // wait until their results are written
+  QList<int> batch;
+  QList<QList<Interval<int> > > batch_rows;
+  QList<Column *> batch_columns;
+  for (int k = 0; k < cols.size(); k++) {
+    int col = cols.at(k);
+    Column *col_ptr = column(col);
+    if (!col_ptr) {
+      ok = false;
+      break;
+    }
+    bool numeric = (col_ptr->columnMode() == AlphaPlot::Numeric);
+    bool dependent = false;
+    if (!batch.isEmpty())
+      foreach (Interval<int> interval, col_ptr->formulaIntervals())
+        if (formulaReadsColumns(col_ptr->formula(interval.start()),
+                                batch_columns))
+          dependent = true;
+    if (!numeric || dependent) {
+      ok = recalculateNumeric(batch, batch_rows);
+      batch.clear();
+      batch_rows.clear();
+      batch_columns.clear();
+      if (!ok) break;
+    }
+    if (numeric) {
+      batch << col;
+      batch_rows << rows.at(k);
+      batch_columns << col_ptr;
+    } else if (!(ok = recalculateText(col, rows.at(k)))) {
+      break;
+    }
   }
-  foreach (Interval<int> interval, formula_intervals) {
-    QString formula = col_ptr->formula(interval.start());
-    if (formula.isEmpty()) continue;
+  if (ok && !batch.isEmpty()) ok = recalculateNumeric(batch, batch_rows);
+  QApplication::restoreOverrideCursor();
+  return ok;
+}
 
-    Script *colscript =
-        scriptEnv->newScript(formula, this, QString("<%1>").arg(colName(col)));
-    connect(colscript, &Script::error, scriptEnv, &ScriptingEnv::error);
-    connect(colscript, &Script::print, scriptEnv, &ScriptingEnv::print);
+QList<Interval<int> > Table::formulaRows(Column *col_ptr,
+                                         const QList<Interval<int> > &rows) {
+  QList<Interval<int> > formula_rows;
+  foreach (Interval<int> formula_interval, col_ptr->formulaIntervals())
+    foreach (Interval<int> row_interval, rows) {
+      Interval<int> interval =
+          Interval<int>::intersection(formula_interval, row_interval);
+      if (interval.isValid()) formula_rows << interval;
+    }
+  std::sort(formula_rows.begin(), formula_rows.end(),
+            [](const Interval<int> &a, const Interval<int> &b) {
+              return a.start() < b.start();
+            });
+  return formula_rows;
+}
 
-    if (!colscript->compile()) {
-      delete colscript;
-      QApplication::restoreOverrideCursor();
-      return false;
+Script *Table::newFormulaScript(int col, const QString &formula) {
+  Script *colscript =
+      scriptEnv->newScript(formula, this, QString("<%1>").arg(colName(col)));
+  connect(colscript, &Script::error, scriptEnv, &ScriptingEnv::error);
+  connect(colscript, &Script::print, scriptEnv, &ScriptingEnv::print);
+
+  if (!colscript->compile()) {
+    delete colscript;
+    return nullptr;
+  }
+  colscript->setInt(col + 1, "j");
+  return colscript;
+}
+
+bool Table::recalculateNumeric(const QList<int> &cols,
+                               const QList<QList<Interval<int> > > &rows) {
+  // a script instance must only be used by one thread at a time, so every
+  // chunk of rows gets its own
+  const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+  QList<FormulaChunk> chunks;
+  QList<Script *> scripts;
+  bool ok = true;
+  for (int k = 0; k < cols.size(); k++) {
+    int col = cols.at(k);
+    Column *col_ptr = column(col);
+    foreach (Interval<int> interval, formulaRows(col_ptr, rows.at(k))) {
+      QString formula = col_ptr->formula(interval.start());
+      if (formula.isEmpty()) continue;
+      int count = qBound(1, interval.size() / min_formula_chunk_rows, threads);
+      int chunk_rows = (interval.size() + count - 1) / count;
+      for (int first = interval.start(); ok && first <= interval.end();
+           first += chunk_rows) {
+        Script *colscript = newFormulaScript(col, formula);
+        if (!colscript) {
+          ok = false;
+          break;
+        }
+        scripts << colscript;
+        // workers neither look up columns nor emit signals themselves
+        colscript->setEmitErrors(false);
+        FormulaChunk chunk;
+        chunk.column = col_ptr;
+        chunk.script = colscript;
+        chunk.threaded = colscript->resolveReferences();
+        chunk.first_row = first;
+        chunk.results.resize(qMin(chunk_rows, interval.end() - first + 1));
+        chunks << chunk;
+      }
+    }
+  }
+
+  if (ok) {
+    QtConcurrent::blockingMap(chunks, [](FormulaChunk &chunk) {
+      if (chunk.threaded) evalFormulaChunk(chunk);
+    });
+    for (int c = 0; c < chunks.size(); c++)
+      if (!chunks.at(c).threaded) evalFormulaChunk(chunks[c]);
+    // the first error only, not one per chunk
+    foreach (const FormulaChunk &chunk, chunks)
+      if (!chunk.ok) {
+        if (!chunk.error.isEmpty())
+          emit scriptEnv->error(chunk.error, chunk.script->name(), 0);
+        ok = false;
+        break;
+      }
+  }
+
+  // write the chunks of each column with a single replaceValues() call,
+  // which also sets their validity; rows between the formula intervals keep
+  // their value and validity
+  for (int c = 0; ok && c < chunks.size();) {
+    Column *col_ptr = chunks.at(c).column;
+    int end = c;
+    while (end < chunks.size() && chunks.at(end).column == col_ptr) end++;
+    int first = chunks.at(c).first_row;
+    int last = chunks.at(end - 1).first_row +
+               chunks.at(end - 1).results.size() - 1;
+    QVector<qreal> results(last - first + 1);
+    IntervalAttribute<bool> invalid_gaps;
+    int next = first;
+    for (int k = c; k < end; k++) {
+      const FormulaChunk &chunk = chunks.at(k);
+      for (int row = next; row < chunk.first_row; row++) {
+        results[row - first] = col_ptr->valueAt(row);
+        if (col_ptr->isInvalid(row)) invalid_gaps.setValue(row, true);
+      }
+      std::copy(chunk.results.constBegin(), chunk.results.constEnd(),
+                results.begin() + (chunk.first_row - first));
+      next = chunk.first_row + chunk.results.size();
     }
+    col_ptr->replaceValues(first, results, invalid_gaps);
+    c = end;
+  }
+
+  qDeleteAll(scripts);
+  return ok;
+}
+
+bool Table::recalculateText(int col, const QList<Interval<int> > &rows) {
+  Column *col_ptr = column(col);
+  foreach (Interval<int> interval, formulaRows(col_ptr, rows)) {
+    QString formula = col_ptr->formula(interval.start());
+    if (formula.isEmpty()) continue;
+
+    Script *colscript = newFormulaScript(col, formula);
+    if (!colscript) return false;
 
-    colscript->setInt(col + 1, "j");
     QVariant ret;
     int start_row = interval.start();
     int end_row = interval.end();
-    switch (col_ptr->columnMode()) {
-      case AlphaPlot::Numeric: {
-        QVector<qreal> results(end_row - start_row + 1);
-        for (int i = start_row; i <= end_row; i++) {
-          colscript->setInt(i + 1, "i");
-          ret = colscript->eval();
-          if (!ret.isValid()) {
-            delete colscript;
-            QApplication::restoreOverrideCursor();
-            return false;
-          }
-          if (ret.canConvert(QVariant::Double))
-            results[i - start_row] = ret.toDouble();
-          else
-            results[i - start_row] = std::numeric_limits<double>::quiet_NaN();
-        }
-        col_ptr->replaceValues(start_row, results);
-        break;
-      }
-      default: {
-        QStringList results;
-        for (int i = start_row; i <= end_row; i++) {
-          colscript->setInt(i + 1, "i");
-          ret = colscript->eval();
-          if (!ret.isValid()) {
-            delete colscript;
-            QApplication::restoreOverrideCursor();
-            return false;
-          }
-          if (ret.type() == QVariant::Double)
-            results << QLocale().toString(ret.toDouble(), 'g', 14);
-          else if (ret.canConvert(QVariant::String))
-            results << ret.toString();
-          else
-            results << QString();
-        }
-        col_ptr->asStringColumn()->replaceTexts(start_row, results);
-        break;
+    QStringList results;
+    for (int i = start_row; i <= end_row; i++) {
+      colscript->setInt(i + 1, "i");
+      ret = colscript->eval();
+      if (!ret.isValid()) {
+        delete colscript;
+        return false;
       }
+      if (ret.type() == QVariant::Double)
+        results << QLocale().toString(ret.toDouble(), 'g', 14);
+      else if (ret.canConvert(QVariant::String))
+        results << ret.toString();
+      else
+        results << QString();
     }
+    col_ptr->asStringColumn()->replaceTexts(start_row, results);
     delete colscript;
   }
-  QApplication::restoreOverrideCursor();
   return true;
 }
 
+void Table::updateFormulaDependencies() {
+  d_formula_readers.clear();
+  delete d_formula_source_receiver;
+  d_formula_source_receiver = nullptr;
+  d_changed_source = nullptr;
+  d_formula_dependencies_dirty = false;
+  if (!d_future_table->autoRecalculate()) return;
+
+  for (int col = 0; col < numCols(); col++) {
+    Column *col_ptr = column(col);
+    QStringList formulas;
+    foreach (Interval<int> interval, col_ptr->formulaIntervals()) {
+      QString formula = col_ptr->formula(interval.start());
+      if (!formula.isEmpty() && !formulas.contains(formula))
+        formulas << formula;
+    }
+    foreach (const QString &formula, formulas) {
+      Script *colscript = scriptEnv->newScript(
+          formula, this, QString("<%1>").arg(colName(col)));
+      colscript->setEmitErrors(false);
+      QList<Column *> row_aligned, any_row;
+      if (colscript->compile() &&
+          !colscript->columnReferences(&row_aligned, &any_row))
+        // columns addressed by index may be any column of this table
+        for (int i = 0; i < numCols(); i++) any_row << column(i);
+      delete colscript;
+      foreach (Column *source, row_aligned)
+        d_formula_readers.insert(source, FormulaReader{col_ptr, true});
+      foreach (Column *source, any_row)
+        d_formula_readers.insert(source, FormulaReader{col_ptr, false});
+    }
+  }
+
+  // the graph only changes with the formulas and the names they refer to
+  d_formula_source_receiver = new QObject(this);
+  for (int col = 0; col < numCols(); col++)
+    connect(column(col), &Column::formulasChanged, d_formula_source_receiver,
+            [this]() { scheduleFormulaDependencies(); });
+  if (Project *project = d_future_table->project())
+    connect(project, &AbstractAspect::aspectDescriptionChanged,
+            d_formula_source_receiver,
+            [this]() { scheduleFormulaDependencies(); });
+  foreach (const AbstractColumn *source, d_formula_readers.uniqueKeys()) {
+    connect(source, &AbstractColumn::rowsChanged, d_formula_source_receiver,
+            [this](const AbstractColumn *source, int first, int count) {
+              d_changed_source = source;
+              d_changed_rows = Interval<int>(first, first + count - 1);
+            });
+    connect(source, &AbstractColumn::dataChanged, d_formula_source_receiver,
+            [this](const AbstractColumn *source) {
+              // dataChanged() without rowsChanged() may touch any row
+              Interval<int> rows =
+                  (source == d_changed_source) ? d_changed_rows : all_rows;
+              d_changed_source = nullptr;
+              // undo/redo restores the dependent rows along with their
+              // sources
+              const Project *project = d_future_table->project();
+              if (!d_recalculating_dependents &&
+                  !(project && project->isUndoingOrRedoing()))
+                addChangedSourceRows(source, rows);
+            });
+  }
+}
+
+void Table::scheduleFormulaDependencies() {
+  if (d_formula_dependencies_dirty) return;
+  d_formula_dependencies_dirty = true;
+  // once for a whole macro of formula changes, unless rebuilt before
+  QTimer::singleShot(0, this, [this]() {
+    if (d_formula_dependencies_dirty) updateFormulaDependencies();
+  });
+}
+
+void Table::addChangedSourceRows(const AbstractColumn *source,
+                                 Interval<int> rows) {
+  if (!rows.isValid()) return;
+  if (d_pending_source_rows.isEmpty()) {
+    // followed once the change (e.g. a paste macro) is complete
+    QTimer::singleShot(0, this, &Table::recalculateDependents);
+    d_pending_hops = dependent_hops;
+  } else {
+    d_pending_hops = qMax(d_pending_hops, dependent_hops);
+  }
+  d_pending_source_rows[source].setValue(rows, true);
+}
+
+void Table::reportFormulaWarning(const QString &message) {
+  if (message == d_formula_warning) return;
+  d_formula_warning = message;
+  emit formulaWarning("<b>[" +
+                      QDateTime::currentDateTime().toString(Qt::LocalDate) +
+                      "&emsp;" + tr("Table") + ": ''" + name() +
+                      "'']</b><hr>" + message.toHtmlEscaped() + "<br>");
+}
+
+void Table::recalculateDependents() {
+  QHash<const AbstractColumn *, IntervalAttribute<bool> > changed =
+      d_pending_source_rows;
+  d_pending_source_rows.clear();
+  if (changed.isEmpty() || !d_future_table->autoRecalculate()) return;
+  if (d_pending_hops >= max_dependent_hops) {
+    reportFormulaWarning(
+        tr("Formula columns depending on changes in %1 were not recalculated, "
+           "the tables probably reference each other circularly.")
+            .arg(name()));
+    return;
+  }
+  // formulas may have changed since, e.g. by undo
+  if (d_formula_dependencies_dirty) updateFormulaDependencies();
+
+  // rows of the formula columns that depend on the changed rows, directly or
+  // through other formula columns
+  QHash<Column *, IntervalAttribute<bool> > dirty;
+  QList<QPair<const AbstractColumn *, QList<Interval<int> > > > queue;
+  for (auto it = changed.constBegin(); it != changed.constEnd(); ++it)
+    queue << qMakePair(it.key(), it.value().intervals());
+  while (!queue.isEmpty()) {
+    QPair<const AbstractColumn *, QList<Interval<int> > > item =
+        queue.takeFirst();
+    foreach (const FormulaReader &reader,
+             d_formula_readers.values(item.first)) {
+      QList<Interval<int> > rows = item.second;
+      if (!reader.row_aligned) rows = QList<Interval<int> >() << all_rows;
+      IntervalAttribute<bool> &reader_rows = dirty[reader.column];
+      QList<Interval<int> > added;
+      foreach (Interval<int> interval, formulaRows(reader.column, rows))
+        foreach (Interval<int> part, interval - reader_rows.intervals()) {
+          reader_rows.setValue(part, true);
+          added << part;
+        }
+      if (!added.isEmpty())
+        queue << qMakePair(static_cast<const AbstractColumn *>(reader.column),
+                           added);
+    }
+  }
+
+  // topological order: a column is recalculated after all dirty columns it
+  // reads, columns of this table first to keep the order deterministic
+  QList<Column *> pending;
+  for (int col = 0; col < numCols(); col++)
+    if (!dirty.value(column(col)).intervals().isEmpty()) pending << column(col);
+  QHash<Column *, int> unresolved;
+  foreach (Column *col_ptr, pending) unresolved[col_ptr] = 0;
+  foreach (Column *source, pending)
+    foreach (const FormulaReader &reader, d_formula_readers.values(source))
+      if (unresolved.contains(reader.column)) unresolved[reader.column]++;
+  QList<Column *> ready;
+  foreach (Column *col_ptr, pending)
+    if (unresolved.value(col_ptr) == 0) ready << col_ptr;
+  QList<int> cols;
+  QList<QList<Interval<int> > > rows;
+  while (!ready.isEmpty()) {
+    Column *col_ptr = ready.takeFirst();
+    cols << d_future_table->columnIndex(col_ptr);
+    rows << dirty.value(col_ptr).intervals();
+    foreach (const FormulaReader &reader, d_formula_readers.values(col_ptr))
+      if (unresolved.contains(reader.column) &&
+          --unresolved[reader.column] == 0)
+        ready << reader.column;
+  }
+  if (cols.size() < pending.size()) {
+    QStringList circular;
+    foreach (Column *col_ptr, pending)
+      if (unresolved.value(col_ptr) > 0) circular << col_ptr->name();
+    reportFormulaWarning(tr("Columns %1 of %2 depend on circular formula "
+                            "references and were not recalculated.")
+                             .arg(circular.join(", "), name()));
+  } else {
+    d_formula_warning.clear();
+  }
+  if (cols.isEmpty()) return;
+
+  int outer_hops = dependent_hops;
+  dependent_hops = d_pending_hops + 1;
+  d_recalculating_dependents = true;
+  d_future_table->beginMacro(
+      tr("%1: recalculate dependent formulas").arg(name()));
+  recalculateRows(cols, rows);
+  d_future_table->endMacro();
+  d_recalculating_dependents = false;
+  dependent_hops = outer_hops;
+}
+
 int Table::firstXCol() {
   for (int j = 0; j < numCols(); j++) {
     if (column(j)->plotDesignation() == AlphaPlot::X) return j;
@@ -953,12 +1362,15 @@ void Table::applyFormula() {
   d_future_table->beginMacro(tr("%1: apply formula to column").arg(name()));
 
   QString formula = ui.formula_box->toPlainText();
+  QList<int> cols;
   for (int col = firstSelectedColumn(); col <= lastSelectedColumn(); col++) {
     Column *col_ptr = column(col);
     col_ptr->insertRows(col_ptr->rowCount(), numRows() - col_ptr->rowCount());
     col_ptr->setFormula(Interval<int>(0, numRows() - 1), formula);
-    if (!recalculate(col, false)) break;
+    cols << col;
   }
+  updateFormulaDependencies();
+  recalculate(cols, false);
 
   d_future_table->endMacro();
   QApplication::restoreOverrideCursor();
@@ -1008,6 +1420,7 @@ void Table::handleAspectDescriptionChange(const AbstractAspect *aspect) {
         }
       }
     }
+    updateFormulaDependencies();
   }
 }
 
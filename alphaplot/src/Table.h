@@ -40,6 +40,7 @@
 #include "MyWidget.h"
 
 // Scripting
+#include "future/lib/IntervalAttribute.h"
 #include "future/table/TableView.h"
 #include "future/table/future_Table.h"
 #include "globals.h"
@@ -84,6 +85,9 @@ class Table : public TableView,
         Qt::WindowFlags f = Qt::SubWindow);
   ~Table();
 
+  //! MB/s the file was parsed at by the parallel reader, 0 if not used
+  double importThroughput() const { return d_import_throughput; }
+
   virtual QString getItemName() override;
   virtual QIcon getItemIcon() override;
   virtual QString getItemTooltip() override;
@@ -136,7 +140,8 @@ class Table : public TableView,
   void setNumRows(int rows);
   void setNumCols(int cols);
   void handleChange();
-  void handleRowChange();
+  void handleRowsInserted(int first, int count);
+  void handleRowsRemoved(int first, int count);
   void handleColumnChange(int, int);
   void handleColumnChange(int, int, int, int);
   void handleColumnsAboutToBeRemoved(int, int);
@@ -211,6 +216,12 @@ class Table : public TableView,
   bool recalculate(int col, bool only_selected_rows = true);
   //! Recalculate selected cells
   bool recalculate();
+  //! Compute cells of several columns from their cell formulas
+  /**
+   * Numeric columns whose formulas don't read each other are evaluated
+   * together; their row ranges are split across the global thread pool.
+   */
+  bool recalculate(const QList<int>& cols, bool only_selected_rows);
 
   //! \name Row Operations
   //@{
@@ -278,6 +289,10 @@ class Table : public TableView,
   void aboutToRemoveCol(Table*, const QString&);
   void removedCol(const QString&);
   void modifiedData(Table*, const QString&);
+  //! Only the rows first to last of a column were modified
+  void modifiedRows(Table*, const QString&, int first, int last);
+  //! Formula columns could not be recalculated, e.g. circular references
+  void formulaWarning(const QString& message);
   void resizedTable(QWidget*);
   void showContextMenu(bool selection);
   void rowcountchange();
@@ -291,9 +306,63 @@ class Table : public TableView,
   void handleAspectDescriptionChange(const AbstractAspect* aspect);
   void handleAspectDescriptionAboutToChange(const AbstractAspect* aspect);
 
+ private slots:
+  //! Rebuild the formula dependency graph and connect to the columns read
+  void updateFormulaDependencies();
+  //! Recalculate the formula rows affected by the pending source changes
+  /**
+   * Only rows that can depend on the changed rows are recomputed, the
+   * affected columns in dependency order. Columns taking part in a circular
+   * reference are skipped and reported through formulaWarning().
+   */
+  void recalculateDependents();
+
  private:
+  //! Return the formula rows of 'col_ptr' within 'rows', sorted by start row
+  QList<Interval<int> > formulaRows(Column* col_ptr,
+                                    const QList<Interval<int> >& rows);
+  //! Create and compile a script evaluating 'formula' for column 'col'
+  Script* newFormulaScript(int col, const QString& formula);
+  //! Compute the cells 'rows[k]' of each column 'cols[k]'
+  bool recalculateRows(const QList<int>& cols,
+                       const QList<QList<Interval<int> > >& rows);
+  bool recalculateNumeric(const QList<int>& cols,
+                          const QList<QList<Interval<int> > >& rows);
+  bool recalculateText(int col, const QList<Interval<int> >& rows);
+  //! Queue rows of a formula source for recalculateDependents()
+  void addChangedSourceRows(const AbstractColumn* source, Interval<int> rows);
+  //! Rebuild the formula dependency graph once control returns to the loop
+  void scheduleFormulaDependencies();
+  //! Emit formulaWarning() unless 'message' was the last one reported
+  void reportFormulaWarning(const QString& message);
+
   QHash<const AbstractAspect*, QString> d_stored_column_labels;
 
+  //! A formula column of this table reading another column
+  struct FormulaReader {
+    Column* column;
+    //! Row i of 'column' only reads row i of the source
+    bool row_aligned;
+  };
+  //! Formula columns of this table by the columns they read
+  QMultiHash<const AbstractColumn*, FormulaReader> d_formula_readers;
+  //! Receiver of the source connections; deleting it drops all of them
+  QObject* d_formula_source_receiver = nullptr;
+  //! Rows announced by the last rowsChanged() of a formula source
+  const AbstractColumn* d_changed_source = nullptr;
+  Interval<int> d_changed_rows;
+  //! Changed source rows not yet handled by recalculateDependents()
+  QHash<const AbstractColumn*, IntervalAttribute<bool> > d_pending_source_rows;
+  //! Number of tables the pending changes have been passed through
+  int d_pending_hops = 0;
+  //! Set while recalculateDependents() writes its results
+  bool d_recalculating_dependents = false;
+  //! Set when formulas or names changed since the graph was last built
+  bool d_formula_dependencies_dirty = false;
+  //! Last formulaWarning() emitted, to not repeat it on every change
+  QString d_formula_warning;
+  double d_import_throughput = 0.0;
+
   // Scripting Functions
  public slots:
   int rowCount();
@@ -29,20 +29,30 @@
  ***************************************************************************/
 #include "TableStatistics.h"
 
-#include <gsl/gsl_statistics.h>
-#include <gsl/gsl_vector.h>
-
 #include <QContextMenuEvent>
 #include <QList>
 #include <QMenu>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
 
 #include "core/column/Column.h"
+#include "core/column/ColumnStatistics.h"
 #include "core/datatypes/Double2StringFilter.h"
 #include "table/TableDoubleHeaderView.h"
 #include "table/TableModel.h"
 #include "table/TableView.h"
 #include "table/future_Table.h"
 
+namespace {
+// doubles gathered per tile of row statistics; small enough to stay in
+// the cache while the accumulation loops run over them
+const int tile_values = 1 << 15;
+}  // namespace
+
 TableStatistics::TableStatistics(ScriptingEnv *env, QWidget *parent,
                                  Table *base, Type t, QList<int> targets)
     : Table(env, 1, 1, "", parent, ""),
@@ -160,54 +170,7 @@ void TableStatistics::update(Table *t, const QString &colName) {
   if (t != d_base) return;
 
   if (d_type == TableStatistics::StatRow) {
-    int columns = d_base->numCols();
-    if (columns > 0) {
-      for (int destRow = 0; destRow < d_targets.size(); destRow++) {
-        int srcRow = d_targets[destRow];
-
-        QList<int> validCells;
-        for (int col = 0; col < columns; col++) {
-          if (d_base->column(col)->rowCount() > srcRow &&
-              d_base->column(col)->columnMode() == AlphaPlot::Numeric &&
-              !d_base->column(col)->isInvalid(srcRow))
-            validCells.append(col);
-        }
-
-        column(0)->setValueAt(destRow, srcRow + 1);
-        column(1)->setValueAt(destRow, columns);
-        if (validCells.count() > 0) {
-          double *data = new double[validCells.count()];
-          gsl_vector *y = gsl_vector_alloc(validCells.count());
-
-          int index = 0;
-          foreach (int col, validCells) {
-            double val = d_base->column(col)->valueAt(srcRow);
-            gsl_vector_set(y, index, val);
-            data[index++] = val;
-          }
-          double mean = gsl_stats_mean(data, 1, validCells.count());
-          double sd = gsl_stats_sd(data, 1, validCells.count());
-          double min, max;
-          gsl_vector_minmax(y, &min, &max);
-
-          column(2)->setValueAt(destRow, mean);
-          column(3)->setValueAt(destRow, sd);
-          column(4)->setValueAt(destRow, sd / sqrt(validCells.count()));
-          column(5)->setValueAt(
-              destRow, gsl_stats_variance(data, 1, validCells.count()));
-          column(6)->setValueAt(destRow, mean * validCells.count());
-          column(7)->setValueAt(destRow, max);
-          column(8)->setValueAt(destRow, min);
-          column(9)->setValueAt(destRow, validCells.count());
-
-          gsl_vector_free(y);
-          delete[] data;
-        } else {
-          for (int i = 2; i < 9; i++) column(i)->setInvalid(destRow, true);
-          column(9)->setValueAt(destRow, 0);
-        }
-      }
-    }
+    if (d_base->numCols() > 0) updateRows();
   } else if (d_type == TableStatistics::StatColumn) {
     for (int destRow = 0; destRow < d_targets.size(); destRow++) {
       if (colName == QString(d_base->name()) + "_" +
@@ -220,57 +183,24 @@ void TableStatistics::update(Table *t, const QString &colName) {
         int rows = col->rowCount();
         if (rows == 0) return;
 
-        QList<int> validCells;
-        for (int row = 0; row < rows; ++row) {
-          if (!col->isInvalid(row)) validCells.append(row);
-        }
-        if (validCells.count() == 0) return;
-
-        double *data = new double[validCells.count()];
-        gsl_vector *y = gsl_vector_alloc(validCells.count());
-
-        int minIndex = validCells.at(0);
-        int maxIndex = validCells.at(0);
-        double val = col->valueAt(validCells.at(0));
-        gsl_vector_set(y, 0, val);
-        data[0] = val;
-        double min = val, max = val;
-        int index = 0;
-        foreach (int row, validCells) {
-          if (index > 0) {
-            val = col->valueAt(row);
-            gsl_vector_set(y, index, val);
-            data[index] = val;
-            if (val < min) {
-              min = val;
-              minIndex = row;
-            }
-            if (val > max) {
-              max = val;
-              maxIndex = row;
-            }
-          }
-          index++;
-        }
-        double mean = gsl_stats_mean(data, 1, validCells.count());
-        double sd = gsl_stats_sd(data, 1, validCells.count());
+        // the column keeps its statistics up to date; only the blocks
+        // changed since the last update are recomputed
+        const ColumnStatistics::Summary stats = col->statistics()->summary();
+        if (stats.count == 0) return;
+        const double sd = std::sqrt(stats.variance);
 
         column(0)->setTextAt(destRow, d_base->colLabel(colIndex));
         column(1)->setTextAt(destRow, "[1:" + QString::number(rows) + "]");
-        column(2)->setValueAt(destRow, mean);
+        column(2)->setValueAt(destRow, stats.mean);
         column(3)->setValueAt(destRow, sd);
-        column(4)->setValueAt(destRow, sd / sqrt(validCells.count()));
-        column(5)->setValueAt(destRow,
-                              gsl_stats_variance(data, 1, validCells.count()));
-        column(6)->setValueAt(destRow, mean * validCells.count());
-        column(7)->setValueAt(destRow, maxIndex + 1);
-        column(8)->setValueAt(destRow, max);
-        column(9)->setValueAt(destRow, minIndex + 1);
-        column(10)->setValueAt(destRow, min);
-        column(11)->setValueAt(destRow, validCells.count());
-
-        gsl_vector_free(y);
-        delete[] data;
+        column(4)->setValueAt(destRow, sd / sqrt(stats.count));
+        column(5)->setValueAt(destRow, stats.variance);
+        column(6)->setValueAt(destRow, stats.sum);
+        column(7)->setValueAt(destRow, stats.max_row + 1);
+        column(8)->setValueAt(destRow, stats.max);
+        column(9)->setValueAt(destRow, stats.min_row + 1);
+        column(10)->setValueAt(destRow, stats.min);
+        column(11)->setValueAt(destRow, stats.count);
       }
     }
   }
@@ -279,6 +209,109 @@ void TableStatistics::update(Table *t, const QString &colName) {
     emit modifiedData(this, Table::colName(i));
 }
 
+void TableStatistics::updateRows() {
+  const int columns = d_base->numCols();
+  QVector<const Column *> sources;
+  for (int col = 0; col < columns; col++)
+    if (d_base->column(col)->columnMode() == AlphaPlot::Numeric)
+      sources << d_base->column(col);
+
+  const int rows = d_targets.size();
+  if (rows == 0) return;
+  const int count = sources.size();
+  // enough target rows per tile to make the gathered values of all columns
+  // fill about tile_values doubles
+  const int tile_rows = qBound(16, tile_values / qMax(1, count), 4096);
+  const int tiles = (rows + tile_rows - 1) / tile_rows;
+
+  QVector<qreal> row_numbers(rows), mean(rows), sd(rows), se(rows),
+      variance(rows), sum(rows), max(rows), min(rows), n(rows);
+  auto tile = [&](const int &index) {
+    const int first = index * tile_rows;
+    const int size = qMin(tile_rows, rows - first);
+    // the values of every column for the tile's rows, with weight 1 for
+    // valid cells and 0 otherwise, so the loops below have no branches
+    std::vector<double> values(static_cast<size_t>(size) * count);
+    std::vector<double> weights(values.size());
+    for (int c = 0; c < count; c++) {
+      const Column *source = sources.at(c);
+      const int source_rows = source->rowCount();
+      double *value = values.data() + static_cast<size_t>(c) * size;
+      double *weight = weights.data() + static_cast<size_t>(c) * size;
+      for (int r = 0; r < size; r++) {
+        const int row = d_targets.at(first + r);
+        const bool valid = row < source_rows && !source->isInvalid(row);
+        value[r] = valid ? source->valueAt(row) : 0.0;
+        weight[r] = valid ? 1.0 : 0.0;
+      }
+    }
+
+    // two passes over the tile: the means, then the squared deviations
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> total(size, 0.0), cells(size, 0.0), m2(size, 0.0),
+        lowest(size, inf), highest(size, -inf);
+    for (int c = 0; c < count; c++) {
+      const double *value = values.data() + static_cast<size_t>(c) * size;
+      const double *weight = weights.data() + static_cast<size_t>(c) * size;
+      for (int r = 0; r < size; r++) {
+        total[r] += weight[r] * value[r];
+        cells[r] += weight[r];
+      }
+    }
+    std::vector<double> average(size);
+    for (int r = 0; r < size; r++)
+      average[r] = cells[r] > 0 ? total[r] / cells[r] : 0.0;
+    for (int c = 0; c < count; c++) {
+      const double *value = values.data() + static_cast<size_t>(c) * size;
+      const double *weight = weights.data() + static_cast<size_t>(c) * size;
+      for (int r = 0; r < size; r++) {
+        // an infinite mean would make 0 * inf a NaN for the invalid cells
+        const double deviation = value[r] - average[r];
+        m2[r] += weight[r] > 0 ? deviation * deviation : 0.0;
+        lowest[r] = std::min(lowest[r], weight[r] > 0 ? value[r] : inf);
+        highest[r] = std::max(highest[r], weight[r] > 0 ? value[r] : -inf);
+      }
+    }
+
+    for (int r = 0; r < size; r++) {
+      const int row = first + r;
+      row_numbers[row] = d_targets.at(row) + 1;
+      n[row] = cells[r];
+      mean[row] = average[r];
+      variance[row] = m2[r] / (cells[r] - 1);
+      sd[row] = std::sqrt(variance[row]);
+      se[row] = sd[row] / std::sqrt(cells[r]);
+      sum[row] = average[r] * cells[r];
+      max[row] = highest[r];
+      min[row] = lowest[r];
+    }
+  };
+  QVector<int> indices(tiles);
+  std::iota(indices.begin(), indices.end(), 0);
+  QtConcurrent::blockingMap(indices, tile);
+
+  column(0)->replaceValues(0, row_numbers);
+  column(1)->replaceValues(0, QVector<qreal>(rows, columns));
+  column(2)->replaceValues(0, mean);
+  column(3)->replaceValues(0, sd);
+  column(4)->replaceValues(0, se);
+  column(5)->replaceValues(0, variance);
+  column(6)->replaceValues(0, sum);
+  column(7)->replaceValues(0, max);
+  column(8)->replaceValues(0, min);
+  column(9)->replaceValues(0, n);
+
+  // rows without any valid cell only have a count
+  for (int row = 0; row < rows; row++) {
+    if (n.at(row) > 0) continue;
+    int end = row;
+    while (end + 1 < rows && n.at(end + 1) == 0) end++;
+    for (int i = 2; i < 9; i++)
+      column(i)->setInvalid(Interval<int>(row, end), true);
+    row = end;
+  }
+}
+
 void TableStatistics::renameCol(const QString &from, const QString &to) {
   if (d_type == TableStatistics::StatRow) return;
   for (int c = 0; c < d_targets.size(); c++)
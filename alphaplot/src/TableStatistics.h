@@ -64,6 +64,15 @@ class TableStatistics : public Table {
   bool eventFilter(QObject *watched, QEvent *event);
 
  private:
+  //! Recompute all row statistics
+  /**
+   * Target rows are processed in tiles on the thread pool. Each tile
+   * gathers the values of all numeric columns first and accumulates the
+   * moments of its rows column by column, so the inner loops run over
+   * contiguous arrays and vectorize.
+   */
+  void updateRows();
+
   Table *d_base;
   Type d_type;
   QList<int> d_targets;
@@ -28,11 +28,11 @@
  ***************************************************************************/
 #include "Convolution.h"
 
-#include <gsl/gsl_fft_halfcomplex.h>
-
 #include <QLocale>
 #include <QMessageBox>
+#include <QtConcurrent>
 
+#include "FFTPlan.h"
 #include "core/column/Column.h"
 
 Convolution::Convolution(ApplicationWindow *parent, Table *t,
@@ -82,11 +82,14 @@ void Convolution::setDataFromTable(Table *t, const QString &signalColName,
     delete[] d_y;
   }
 
+  const NumericColumnView signal = d_table->column(signal_col)->numericView();
+  const NumericColumnView response =
+      d_table->column(response_col)->numericView();
   d_n_response = 0;
   int rows = d_table->numRows();
-  for (int i = 0; i < rows; i++) {
-    if (!d_table->text(i, response_col).isEmpty()) d_n_response++;
-  }
+  for (const Interval<int> &run : response.validIntervals(
+           Interval<int>(0, qMin(rows, response.size()) - 1)))
+    d_n_response += run.size();
   if (d_n_response >= rows / 2) {
     QMessageBox::warning(qobject_cast<ApplicationWindow *>(parent()),
                          tr("AlphaPlot") + " - " + tr("Error"),
@@ -107,17 +110,18 @@ void Convolution::setDataFromTable(Table *t, const QString &signalColName,
 
   d_n = rows;
 
-  d_n_signal = 16;  // tmp number of points
-  while (d_n_signal < d_n + d_n_response / 2) d_n_signal *= 2;
+  // mixed-radix transforms take any length; only pad to the next length
+  // with small prime factors
+  d_n_signal = static_cast<int>(
+      FFTPlan::fastLength(static_cast<size_t>(d_n + d_n_response / 2)));
 
   d_x = new double[d_n_signal];    // signal
   d_y = new double[d_n_response];  // response
 
   if (d_y && d_x) {
     memset(d_x, 0, d_n_signal * sizeof(double));  // zero-pad signal data array
-    for (int i = 0; i < d_n; i++) d_x[i] = d_table->cell(i, signal_col);
-    for (int i = 0; i < d_n_response; i++)
-      d_y[i] = d_table->cell(i, response_col);
+    signal.copyTo(0, d_n, d_x);
+    response.copyTo(0, d_n_response, d_y);
   } else {
     QMessageBox::critical(qobject_cast<ApplicationWindow *>(parent()),
                           tr("AlphaPlot") + " - " + tr("Error"),
@@ -141,14 +145,10 @@ void Convolution::addResultCurve() {
 
   d_table->addCol();
   d_table->addCol();
-  // double x_temp[d_n];
-  for (int i = 0; i < d_n; i++) {
-    double x = i + 1;
-    // x_temp[i] = x;
-
-    d_table->column(cols)->setValueAt(i, x);
-    d_table->column(cols2)->setValueAt(i, d_x[i]);
-  }
+  QVector<qreal> x_temp(d_n);
+  for (int i = 0; i < d_n; i++) x_temp[i] = i + 1;
+  d_table->column(cols)->replaceValues(0, x_temp);
+  d_table->column(cols2)->replaceValues(0, QVector<qreal>(d_x, d_x + d_n));
 
   QStringList l = d_table->colNames().filter(tr("Index"));
   QString id = QString::number(l.size() + 1);
@@ -173,37 +173,49 @@ void Convolution::convlv(double *sig, int n, double *dres, int m, int sign) {
 
   if (m2 % 2 == 1) res[m2] = dres[m - 1];
 
-  // calculate ffts
-  gsl_fft_real_radix2_transform(res, 1, static_cast<size_t>(n));
-  gsl_fft_real_radix2_transform(sig, 1, static_cast<size_t>(n));
+  QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(n));
+  if (!plan) {
+    delete[] res;
+    return;
+  }
 
+  // calculate ffts; they are independent, so transform the response on the
+  // thread pool
+  QFuture<bool> res_transform =
+      QtConcurrent::run([&]() { return plan->realForward(res); });
+  plan->realForward(sig);
+  res_transform.waitForFinished();
+
+  // multiply/divide both ffts; in half-complex order the k-th term is
+  // (sig[2k - 1], sig[2k]), the first and (for an even length) the last
+  // terms are real
   double re, im, size;
-  for (i = 0; i < n / 2; i++) {  // multiply/divide both ffts
-    if (i == 0 || i == n / 2 - 1) {
-      if (sign == 1)
-        sig[i] = res[i] * sig[i];
-      else
-        sig[i] = sig[i] / res[i];
+  if (sign == 1)
+    sig[0] *= res[0];
+  else
+    sig[0] /= res[0];
+  for (i = 1; 2 * i < n; i++) {
+    const double res_re = res[2 * i - 1], res_im = res[2 * i];
+    const double sig_re = sig[2 * i - 1], sig_im = sig[2 * i];
+    if (sign == 1) {
+      re = res_re * sig_re - res_im * sig_im;
+      im = res_re * sig_im + res_im * sig_re;
     } else {
-      int ni = n - i;
-      if (sign == 1) {
-        re = res[i] * sig[i] - res[ni] * sig[ni];
-        im = res[i] * sig[ni] + res[ni] * sig[i];
-      } else {
-        size = res[i] * res[i] + res[ni] * res[ni];
-        re = res[i] * sig[i] + res[ni] * sig[ni];
-        im = res[i] * sig[ni] - res[ni] * sig[i];
-        re /= size;
-        im /= size;
-      }
-
-      sig[i] = re;
-      sig[ni] = im;
+      size = res_re * res_re + res_im * res_im;
+      re = (res_re * sig_re + res_im * sig_im) / size;
+      im = (res_re * sig_im - res_im * sig_re) / size;
     }
+    sig[2 * i - 1] = re;
+    sig[2 * i] = im;
+  }
+  if (n % 2 == 0) {
+    if (sign == 1)
+      sig[n - 1] *= res[n - 1];
+    else
+      sig[n - 1] /= res[n - 1];
   }
   delete[] res;
-  gsl_fft_halfcomplex_radix2_inverse(sig, 1,
-                                     static_cast<size_t>(n));  // inverse fft
+  plan->halfComplexInverse(sig);  // inverse fft
 }
 /**************************************************************************
  *             Class Deconvolution                                         *
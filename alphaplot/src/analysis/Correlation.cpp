@@ -28,12 +28,11 @@
  ***************************************************************************/
 #include "Correlation.h"
 
-#include <gsl/gsl_fft_halfcomplex.h>
-
 #include <QLocale>
 #include <QMessageBox>
-#include <vector>
+#include <QtConcurrent>
 
+#include "FFTPlan.h"
 #include "core/column/Column.h"
 
 Correlation::Correlation(ApplicationWindow *parent, Table *t,
@@ -87,8 +86,12 @@ void Correlation::setDataFromTable(Table *t, const QString &colName1,
   }
 
   int rows = d_table->numRows();
-  d_n = 16;  // tmp number of points
-  while (d_n < rows) d_n *= 2;
+  // zero-pad to at least 2 * rows - 1 points, so that the transform gives
+  // the linear correlation instead of a circular one; mixed-radix transforms
+  // take any length, so only pad on to the next length with small prime
+  // factors
+  d_n = static_cast<int>(
+      FFTPlan::fastLength(static_cast<size_t>(qMax(2 * rows - 1, 1))));
 
   d_x = new double[d_n];
   d_y = new double[d_n];
@@ -96,10 +99,8 @@ void Correlation::setDataFromTable(Table *t, const QString &colName1,
   if (d_y && d_x) {
     memset(d_x, 0, d_n * sizeof(double));  // zero-pad the two arrays...
     memset(d_y, 0, d_n * sizeof(double));
-    for (int i = 0; i < rows; i++) {
-      d_x[i] = d_table->cell(i, col1);
-      d_y[i] = d_table->cell(i, col2);
-    }
+    d_table->column(col1)->numericView().copyTo(0, rows, d_x);
+    d_table->column(col2)->numericView().copyTo(0, rows, d_y);
   } else {
     QMessageBox::critical(qobject_cast<ApplicationWindow *>(parent()),
                           tr("AlphaPlot") + " - " + tr("Error"),
@@ -110,29 +111,34 @@ void Correlation::setDataFromTable(Table *t, const QString &colName1,
 }
 
 void Correlation::output() {
-  // calculate the FFTs of the two functions
-  if (gsl_fft_real_radix2_transform(d_x, 1, d_n) == 0 &&
-      gsl_fft_real_radix2_transform(d_y, 1, d_n) == 0) {
-    // multiply the FFT by its complex conjugate
-    for (int i = 0; i < d_n / 2; i++) {
-      if (i == 0 || i == (d_n / 2) - 1)
-        d_x[i] *= d_x[i];
-      else {
-        int ni = d_n - i;
-        double dReal = d_x[i] * d_y[i] + d_x[ni] * d_y[ni];
-        double dImag = d_x[i] * d_y[ni] - d_x[ni] * d_y[i];
-        d_x[i] = dReal;
-        d_x[ni] = dImag;
-      }
-    }
-  } else {
+  QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(d_n));
+  if (!plan) return;
+
+  // calculate the FFTs of the two functions; they are independent, so
+  // transform one of them on the thread pool
+  QFuture<bool> x_transform =
+      QtConcurrent::run([&]() { return plan->realForward(d_x); });
+  const bool y_transformed = plan->realForward(d_y);
+  if (!x_transform.result() || !y_transformed) {
     QMessageBox::warning(qobject_cast<ApplicationWindow *>(parent()),
                          tr("AlphaPlot") + " - " + tr("Error"),
                          tr("Error in GSL forward FFT operation!"));
     return;
   }
 
-  gsl_fft_halfcomplex_radix2_inverse(d_x, 1, d_n);  // inverse FFT
+  // multiply the FFT by its complex conjugate; in half-complex order the
+  // k-th term is (d_x[2k - 1], d_x[2k]), the first and (for an even
+  // length) the last terms are real
+  d_x[0] *= d_y[0];
+  for (int k = 1; 2 * k < d_n; k++) {
+    const double x_re = d_x[2 * k - 1], x_im = d_x[2 * k];
+    const double y_re = d_y[2 * k - 1], y_im = d_y[2 * k];
+    d_x[2 * k - 1] = x_re * y_re + x_im * y_im;
+    d_x[2 * k] = x_re * y_im - x_im * y_re;
+  }
+  if (d_n % 2 == 0) d_x[d_n - 1] *= d_y[d_n - 1];
+
+  plan->halfComplexInverse(d_x);  // inverse FFT
 
   addResultCurve();
 }
@@ -148,7 +154,7 @@ void Correlation::addResultCurve() {
   d_table->addCol();
   int n = rows / 2;
 
-  std::vector<double> x_temp(rows), y_temp(rows);
+  QVector<qreal> x_temp(rows), y_temp(rows);
   for (int i = 0; i < rows; i++) {
     x_temp[i] = i - n;
 
@@ -156,10 +162,9 @@ void Correlation::addResultCurve() {
       y_temp[i] = d_x[d_n - n + i];
     else
       y_temp[i] = d_x[i - n];
-
-    d_table->column(cols)->setValueAt(i, x_temp[i]);
-    d_table->column(cols2)->setValueAt(i, y_temp[i]);
   }
+  d_table->column(cols)->replaceValues(0, x_temp);
+  d_table->column(cols2)->replaceValues(0, y_temp);
 
   QStringList l = d_table->colNames().filter(tr("Lag"));
   QString id = QString::number((int)l.size() + 1);
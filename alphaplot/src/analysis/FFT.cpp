@@ -33,11 +33,34 @@
 
 #include <QLocale>
 #include <QMessageBox>
+#include <algorithm>
 
 #include "2Dplot/Layout2D.h"
 #include "ColorBox.h"
+#include "FFTPlan.h"
 #include "core/column/Column.h"
 
+namespace {
+// fill the five result columns of an FFT with one bulk replace each;
+// amplitudes are divided by scale
+void fillColumns(const QList<Column *> &columns, const double *x,
+                 const double *complex, const double *amp, int n,
+                 double scale) {
+  QVector<qreal> values(n);
+  std::copy(x, x + n, values.begin());
+  columns.at(0)->replaceValues(0, values);
+  for (int i = 0; i < n; i++) values[i] = complex[2 * i];
+  columns.at(1)->replaceValues(0, values);
+  for (int i = 0; i < n; i++) values[i] = complex[2 * i + 1];
+  columns.at(2)->replaceValues(0, values);
+  for (int i = 0; i < n; i++) values[i] = amp[i] / scale;
+  columns.at(3)->replaceValues(0, values);
+  for (int i = 0; i < n; i++)
+    values[i] = atan(complex[2 * i + 1] / complex[2 * i]);
+  columns.at(4)->replaceValues(0, values);
+}
+}  // namespace
+
 FFT::FFT(ApplicationWindow *parent, Table *table, const QString &realColName,
          const QString &imagColName)
     : Filter(parent, table) {
@@ -87,12 +110,12 @@ QList<Column *> FFT::fftCurve() {
         tr("Forward") + " " + tr("FFT") + " " + tr("of") + " " + label;
     columns << new Column(tr("Frequency"), AlphaPlot::Numeric);
 
-    gsl_fft_real_workspace *work =
-        gsl_fft_real_workspace_alloc(static_cast<size_t>(d_n));
-    gsl_fft_real_wavetable *real =
-        gsl_fft_real_wavetable_alloc(static_cast<size_t>(d_n));
-
-    if (!work || !real) {
+    // no zero-padding to FFTPlan::fastLength(): the result is the spectrum of
+    // exactly the d_n samples, with one row per sample at multiples of df, and
+    // the inverse transform has to give back the original samples. Lengths
+    // with large prime factors are slower, but still transformed exactly.
+    QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(d_n));
+    if (!plan || !plan->realForward(d_y)) {
       QMessageBox::critical(
           app_, tr("AlphaPlot") + " - " + tr("Error"),
           tr("Could not allocate memory, operation aborted!"));
@@ -101,12 +124,7 @@ QList<Column *> FFT::fftCurve() {
       d_init_err = true;
       return QList<Column *>();
     }
-
-    gsl_fft_real_transform(d_y, 1, static_cast<size_t>(d_n), real, work);
     gsl_fft_halfcomplex_unpack(d_y, result, 1, static_cast<size_t>(d_n));
-
-    gsl_fft_real_wavetable_free(real);
-    gsl_fft_real_workspace_free(work);
   } else {
     QString label = associateddata_->table->name() + "_" +
                     associateddata_->xcol->name() + "_" +
@@ -116,12 +134,8 @@ QList<Column *> FFT::fftCurve() {
     columns << new Column(tr("Time"), AlphaPlot::Numeric);
 
     gsl_fft_real_unpack(d_y, result, 1, static_cast<size_t>(d_n));
-    gsl_fft_complex_wavetable *wavetable =
-        gsl_fft_complex_wavetable_alloc(static_cast<size_t>(d_n));
-    gsl_fft_complex_workspace *workspace =
-        gsl_fft_complex_workspace_alloc(static_cast<size_t>(d_n));
-
-    if (!workspace || !wavetable) {
+    QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(d_n));
+    if (!plan || !plan->complexInverse(result)) {
       QMessageBox::critical(
           app_, tr("AlphaPlot") + " - " + tr("Error"),
           tr("Could not allocate memory, operation aborted!"));
@@ -130,11 +144,6 @@ QList<Column *> FFT::fftCurve() {
       d_init_err = true;
       return QList<Column *>();
     }
-
-    gsl_fft_complex_inverse(result, 1, static_cast<size_t>(d_n), wavetable,
-                            workspace);
-    gsl_fft_complex_wavetable_free(wavetable);
-    gsl_fft_complex_workspace_free(workspace);
   }
 
   if (d_shift_order) {
@@ -162,17 +171,7 @@ QList<Column *> FFT::fftCurve() {
   columns << new Column(tr("Imaginary"), AlphaPlot::Numeric);
   columns << new Column(tr("Amplitude"), AlphaPlot::Numeric);
   columns << new Column(tr("Angle"), AlphaPlot::Numeric);
-  for (i = 0; i < d_n; i++) {
-    i2 = 2 * i;
-    columns.at(0)->setValueAt(i, d_x[i]);
-    columns.at(1)->setValueAt(i, result[i2]);
-    columns.at(2)->setValueAt(i, result[i2 + 1]);
-    if (d_normalize)
-      columns.at(3)->setValueAt(i, amp[i] / aMax);
-    else
-      columns.at(3)->setValueAt(i, amp[i]);
-    columns.at(4)->setValueAt(i, atan(result[i2 + 1] / result[i2]));
-  }
+  fillColumns(columns, d_x, result, amp, d_n, d_normalize ? aMax : 1.0);
   delete[] amp;
   delete[] result;
   columns.at(0)->setPlotDesignation(AlphaPlot::X);
@@ -188,12 +187,10 @@ QList<Column *> FFT::fftTable() {
   int rows = d_table->numRows();
   double *amp = new double[rows];
 
-  gsl_fft_complex_wavetable *wavetable =
-      gsl_fft_complex_wavetable_alloc(static_cast<size_t>(rows));
-  gsl_fft_complex_workspace *workspace =
-      gsl_fft_complex_workspace_alloc(static_cast<size_t>(rows));
+  // unpadded for the same reasons as in fftCurve()
+  QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(rows));
 
-  if (!amp || !wavetable || !workspace) {
+  if (!amp || !plan) {
     QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
                           tr("Could not allocate memory, operation aborted!"));
     delete[] amp;
@@ -205,18 +202,23 @@ QList<Column *> FFT::fftTable() {
       1.0 / static_cast<double>(rows * d_sampling);  // frequency sampling
   double aMax = 0.0;                                 // max amplitude
   QList<Column *> columns;
+  bool transformed;
   if (!d_inverse) {
     columns << new Column(tr("Frequency"), AlphaPlot::Numeric);
-    gsl_fft_complex_forward(d_y, 1, static_cast<size_t>(rows), wavetable,
-                            workspace);
+    transformed = plan->complexForward(d_y);
   } else {
     columns << new Column(tr("Time"), AlphaPlot::Numeric);
-    gsl_fft_complex_inverse(d_y, 1, static_cast<size_t>(rows), wavetable,
-                            workspace);
+    transformed = plan->complexInverse(d_y);
   }
 
-  gsl_fft_complex_wavetable_free(wavetable);
-  gsl_fft_complex_workspace_free(workspace);
+  if (!transformed) {
+    QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
+                          tr("Could not allocate memory, operation aborted!"));
+    qDeleteAll(columns);
+    delete[] amp;
+    d_init_err = true;
+    return QList<Column *>();
+  }
 
   if (d_shift_order) {
     int n2 = rows / 2;
@@ -242,17 +244,7 @@ QList<Column *> FFT::fftTable() {
   columns << new Column(tr("Imaginary"), AlphaPlot::Numeric);
   columns << new Column(tr("Amplitude"), AlphaPlot::Numeric);
   columns << new Column(tr("Angle"), AlphaPlot::Numeric);
-  for (i = 0; i < rows; i++) {
-    int i2 = 2 * i;
-    columns.at(0)->setValueAt(i, d_x[i]);
-    columns.at(1)->setValueAt(i, d_y[i2]);
-    columns.at(2)->setValueAt(i, d_y[i2 + 1]);
-    if (d_normalize)
-      columns.at(3)->setValueAt(i, amp[i] / aMax);
-    else
-      columns.at(3)->setValueAt(i, amp[i]);
-    columns.at(4)->setValueAt(i, atan(d_y[i2 + 1] / d_y[i2]));
-  }
+  fillColumns(columns, d_x, d_y, amp, rows, d_normalize ? aMax : 1.0);
   delete[] amp;
   columns.at(0)->setPlotDesignation(AlphaPlot::X);
   columns.at(1)->setPlotDesignation(AlphaPlot::Y);
@@ -336,11 +328,10 @@ void FFT::setDataFromTable(Table *t, const QString &realColName,
 
   if (d_y && d_x) {  // zero-pad data array
     memset(d_y, 0, static_cast<size_t>(n2) * sizeof(double));
-    for (int i = 0; i < d_n; i++) {
-      int i2 = 2 * i;
-      d_y[i2] = d_table->cell(i, d_real_col);
-      if (d_imag_col >= 0) d_y[i2 + 1] = d_table->cell(i, d_imag_col);
-    }
+    // interleave the real and imaginary parts
+    d_table->column(d_real_col)->numericView().copyTo(0, d_n, d_y, 2);
+    if (d_imag_col >= 0)
+      d_table->column(d_imag_col)->numericView().copyTo(0, d_n, d_y + 1, 2);
   } else {
     QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
                           tr("Could not allocate memory, operation aborted!"));
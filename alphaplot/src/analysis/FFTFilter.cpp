@@ -30,8 +30,7 @@
 #include <QLocale>
 #include <QMessageBox>
 #include "2Dplot/Plotcolumns.h"
-
-#include <gsl/gsl_fft_halfcomplex.h>
+#include "FFTPlan.h"
 
 FFTFilter::FFTFilter(ApplicationWindow *parent, AxisRect2D *axisrect,
                      const QString &curveTitle, int m)
@@ -99,7 +98,7 @@ void FFTFilter::setBand(double lowFreq, double highFreq) {
   }
 }
 
-void FFTFilter::calculateOutputData(double *x, double *y) {
+bool FFTFilter::calculateOutputData(double *x, double *y) {
   // interpolate y to even spacing
   double delta = (d_x[d_n - 1] - d_x[0]) / d_n;
   double xi = d_x[0];
@@ -118,13 +117,12 @@ void FFTFilter::calculateOutputData(double *x, double *y) {
 
   double df = 1.0 / (x[d_n - 1] - x[0]);
 
-  gsl_fft_real_workspace *work =
-      gsl_fft_real_workspace_alloc(static_cast<size_t>(d_n));
-  gsl_fft_real_wavetable *real =
-      gsl_fft_real_wavetable_alloc(static_cast<size_t>(d_n));
-
-  gsl_fft_real_transform(y, 1, static_cast<size_t>(d_n), real, work);
-  gsl_fft_real_wavetable_free(real);
+  QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(d_n));
+  if (!plan || !plan->realForward(y)) {
+    QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
+                          tr("Could not allocate memory, operation aborted!"));
+    return false;
+  }
 
   d_explanation = QLocale().toString(d_low_freq) + " ";
   if (d_filter_type > 2)
@@ -163,9 +161,10 @@ void FFTFilter::calculateOutputData(double *x, double *y) {
       break;
   }
 
-  gsl_fft_halfcomplex_wavetable *hc =
-      gsl_fft_halfcomplex_wavetable_alloc(static_cast<size_t>(d_n));
-  gsl_fft_halfcomplex_inverse(y, 1, static_cast<size_t>(d_n), hc, work);
-  gsl_fft_halfcomplex_wavetable_free(hc);
-  gsl_fft_real_workspace_free(work);
+  if (!plan->halfComplexInverse(y)) {
+    QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
+                          tr("Could not allocate memory, operation aborted!"));
+    return false;
+  }
+  return true;
 }
@@ -59,7 +59,7 @@ class FFTFilter : public Filter {
 
  private:
   void init(int m);
-  void calculateOutputData(double *x, double *y);
+  bool calculateOutputData(double *x, double *y);
 
   //! The filter type.
   FilterType d_filter_type;
@@ -0,0 +1,144 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Cached mixed-radix FFT plans shared by the analysis tools */
+
+#include "FFTPlan.h"
+
+#include <gsl/gsl_errno.h>
+
+#include <QList>
+#include <QMutexLocker>
+#include <initializer_list>
+
+namespace {
+// number of lengths whose plans are kept alive after their last use
+const int cached_plans = 8;
+
+QMutex cache_mutex;
+// most recently used first
+QList<QSharedPointer<FFTPlan>> cache;
+}  // namespace
+
+FFTPlan::FFTPlan(size_t n)
+    : d_n(n), d_real(nullptr), d_halfcomplex(nullptr), d_complex(nullptr) {}
+
+FFTPlan::~FFTPlan() {
+  if (d_real) gsl_fft_real_wavetable_free(d_real);
+  if (d_halfcomplex) gsl_fft_halfcomplex_wavetable_free(d_halfcomplex);
+  if (d_complex) gsl_fft_complex_wavetable_free(d_complex);
+  for (gsl_fft_real_workspace *workspace : d_real_workspaces)
+    gsl_fft_real_workspace_free(workspace);
+  for (gsl_fft_complex_workspace *workspace : d_complex_workspaces)
+    gsl_fft_complex_workspace_free(workspace);
+}
+
+QSharedPointer<FFTPlan> FFTPlan::plan(size_t n) {
+  if (n == 0) return QSharedPointer<FFTPlan>();
+  QMutexLocker locker(&cache_mutex);
+  for (int i = 0; i < cache.size(); i++) {
+    if (cache.at(i)->size() == n) {
+      if (i > 0) cache.move(i, 0);
+      return cache.first();
+    }
+  }
+  QSharedPointer<FFTPlan> result(new FFTPlan(n));
+  cache.prepend(result);
+  while (cache.size() > cached_plans) cache.removeLast();
+  return result;
+}
+
+size_t FFTPlan::fastLength(size_t n) {
+  if (n <= 1) return 1;
+  for (size_t length = n;; length++) {
+    size_t rest = length;
+    for (size_t factor : {2, 3, 5, 7})
+      while (rest % factor == 0) rest /= factor;
+    if (rest == 1) return length;
+  }
+}
+
+bool FFTPlan::realForward(double *data) {
+  gsl_fft_real_workspace *workspace = takeRealWorkspace();
+  if (!workspace) return false;
+  const int status = gsl_fft_real_transform(data, 1, d_n, d_real, workspace);
+  giveBack(workspace);
+  return status == GSL_SUCCESS;
+}
+
+bool FFTPlan::halfComplexInverse(double *data) {
+  gsl_fft_real_workspace *workspace = takeRealWorkspace();
+  if (!workspace) return false;
+  gsl_fft_halfcomplex_wavetable *wavetable;
+  {
+    QMutexLocker locker(&d_mutex);
+    if (!d_halfcomplex)
+      d_halfcomplex = gsl_fft_halfcomplex_wavetable_alloc(d_n);
+    wavetable = d_halfcomplex;
+  }
+  int status = GSL_ENOMEM;
+  if (wavetable)
+    status = gsl_fft_halfcomplex_inverse(data, 1, d_n, wavetable, workspace);
+  giveBack(workspace);
+  return status == GSL_SUCCESS;
+}
+
+bool FFTPlan::complexForward(double *data) {
+  gsl_fft_complex_workspace *workspace = takeComplexWorkspace();
+  if (!workspace) return false;
+  const int status =
+      gsl_fft_complex_forward(data, 1, d_n, d_complex, workspace);
+  giveBack(workspace);
+  return status == GSL_SUCCESS;
+}
+
+bool FFTPlan::complexInverse(double *data) {
+  gsl_fft_complex_workspace *workspace = takeComplexWorkspace();
+  if (!workspace) return false;
+  const int status =
+      gsl_fft_complex_inverse(data, 1, d_n, d_complex, workspace);
+  giveBack(workspace);
+  return status == GSL_SUCCESS;
+}
+
+gsl_fft_real_workspace *FFTPlan::takeRealWorkspace() {
+  QMutexLocker locker(&d_mutex);
+  if (!d_real) d_real = gsl_fft_real_wavetable_alloc(d_n);
+  if (!d_real) return nullptr;
+  if (d_real_workspaces.empty()) return gsl_fft_real_workspace_alloc(d_n);
+  gsl_fft_real_workspace *workspace = d_real_workspaces.back();
+  d_real_workspaces.pop_back();
+  return workspace;
+}
+
+gsl_fft_complex_workspace *FFTPlan::takeComplexWorkspace() {
+  QMutexLocker locker(&d_mutex);
+  if (!d_complex) d_complex = gsl_fft_complex_wavetable_alloc(d_n);
+  if (!d_complex) return nullptr;
+  if (d_complex_workspaces.empty())
+    return gsl_fft_complex_workspace_alloc(d_n);
+  gsl_fft_complex_workspace *workspace = d_complex_workspaces.back();
+  d_complex_workspaces.pop_back();
+  return workspace;
+}
+
+void FFTPlan::giveBack(gsl_fft_real_workspace *workspace) {
+  QMutexLocker locker(&d_mutex);
+  d_real_workspaces.push_back(workspace);
+}
+
+void FFTPlan::giveBack(gsl_fft_complex_workspace *workspace) {
+  QMutexLocker locker(&d_mutex);
+  d_complex_workspaces.push_back(workspace);
+}
@@ -0,0 +1,81 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Cached mixed-radix FFT plans shared by the analysis tools */
+
+#ifndef FFTPLAN_H
+#define FFTPLAN_H
+
+#include <gsl/gsl_fft_complex.h>
+#include <gsl/gsl_fft_halfcomplex.h>
+#include <gsl/gsl_fft_real.h>
+
+#include <QMutex>
+#include <QSharedPointer>
+#include <vector>
+
+//! Wavetables and workspaces for the FFTs of one length
+/**
+ * Setting up the GSL wavetables of a length factorizes it and computes all
+ * twiddle factors, which costs about as much as a transform. Plans are
+ * therefore created once per length through plan() and kept in a small
+ * cache, so repeated filters, smoothings and correlations of the same data
+ * size only pay for the transforms themselves.
+ *
+ * The transforms are mixed-radix and accept any length; fastLength() gives
+ * the next length that only has small prime factors, for callers that pad
+ * their data anyway. A plan may be used by several threads at once: the
+ * wavetables are read-only and every transform borrows its own workspace.
+ */
+class FFTPlan {
+ public:
+  ~FFTPlan();
+
+  //! The (cached) plan for transforms of length n, or null if n is 0
+  static QSharedPointer<FFTPlan> plan(size_t n);
+  //! Smallest length >= n without prime factors larger than 7
+  static size_t fastLength(size_t n);
+
+  size_t size() const { return d_n; }
+
+  //! Real forward transform in place, result in GSL half-complex order
+  bool realForward(double *data);
+  //! Normalized inverse of realForward() in place
+  bool halfComplexInverse(double *data);
+  //! Forward transform of n interleaved complex values in place
+  bool complexForward(double *data);
+  //! Normalized inverse of complexForward() in place
+  bool complexInverse(double *data);
+
+ private:
+  explicit FFTPlan(size_t n);
+  FFTPlan(const FFTPlan &) = delete;
+  FFTPlan &operator=(const FFTPlan &) = delete;
+
+  gsl_fft_real_workspace *takeRealWorkspace();
+  gsl_fft_complex_workspace *takeComplexWorkspace();
+  void giveBack(gsl_fft_real_workspace *workspace);
+  void giveBack(gsl_fft_complex_workspace *workspace);
+
+  size_t d_n;
+  //! wavetables are created on first use, workspaces are pooled for reuse
+  QMutex d_mutex;
+  gsl_fft_real_wavetable *d_real;
+  gsl_fft_halfcomplex_wavetable *d_halfcomplex;
+  gsl_fft_complex_wavetable *d_complex;
+  std::vector<gsl_fft_real_workspace *> d_real_workspaces;
+  std::vector<gsl_fft_complex_workspace *> d_complex_workspaces;
+};
+
+#endif  // FFTPLAN_H
@@ -34,6 +34,7 @@
 #include <QLocale>
 #include <QMessageBox>
 #include <algorithm>
+#include <vector>
 
 #include "2Dplot/AxisRect2D.h"
 #include "2Dplot/Curve2D.h"
@@ -45,6 +46,19 @@
 #include "core/column/Column.h"
 using namespace std;
 
+namespace {
+// the values of a column, shared with it if it stores doubles; other
+// columns read as 0.0 in their valid rows, like Column::valueAt() returns
+// them
+NumericColumnView numericValues(const Column *column) {
+  NumericColumnView view = column->numericView();
+  if (!view.isNull()) return view;
+  return NumericColumnView(
+      QVector<double>(column->rowCount(), 0.0),
+      IntervalAttribute<bool>(column->invalidIntervals()));
+}
+}  // namespace
+
 Filter::Filter(ApplicationWindow *parent, AxisRect2D *axisrect, QString name)
     : QObject(parent), app_(parent), axisrect_(axisrect) {
   QObject::setObjectName(name);
@@ -60,8 +74,6 @@ Filter::Filter(ApplicationWindow *parent, Table *table, QString name)
 
 void Filter::init() {
   d_n = 0;
-  data_ = std::unique_ptr<std::vector<std::pair<double, double>>>(
-      new std::vector<std::pair<double, double>>);
   d_curveColorIndex = 1;
   d_tolerance = 1e-4;
   d_points = app_->fitPoints;
@@ -208,51 +220,59 @@ void Filter::output() {
   double *Y = new double[d_points];
 
   // do the data analysis
-  calculateOutputData(X, Y);
+  if (!calculateOutputData(X, Y)) {
+    delete[] X;
+    delete[] Y;
+    return;
+  }
   addResultCurve(X, Y);
 }
 
 int Filter::sortedCurveData(double start, double end, double **x, double **y) {
   if (!associateddata_) return 0;
-  // start/end finding only works on nondecreasing data, so sort first
-  int datasize = (associateddata_->to - associateddata_->from) + 1;
-  std::unique_ptr<std::vector<std::pair<double, double>>> temp =
-      std::unique_ptr<std::vector<std::pair<double, double>>>(
-          new std::vector<std::pair<double, double>>);
-  temp->reserve(datasize);
-  for (int i = 0; i < datasize; i++) {
-    if (!associateddata_->xcol->isInvalid(i) &&
-        !associateddata_->ycol->isInvalid(i)) {
-      temp->push_back(
-          std::pair<double, double>(associateddata_->xcol->valueAt(i),
-                                    associateddata_->ycol->valueAt(i)));
-    }
-  }
-  std::stable_sort(temp->begin(), temp->end());
-
-  auto inside_range = [&](const std::pair<double, double> &x) {
-    if (std::fabs(std::fabs(x.first) - std::fabs(start)) <
+  const NumericColumnView xview = numericValues(associateddata_->xcol);
+  const NumericColumnView yview = numericValues(associateddata_->ycol);
+  const int from = qMax(0, associateddata_->from);
+  const int to =
+      qMin(associateddata_->to, qMin(xview.size(), yview.size()) - 1);
+
+  auto outside_range = [&](double value) {
+    if (std::fabs(std::fabs(value) - std::fabs(start)) <
             std::numeric_limits<double>::epsilon() ||
-        std::fabs(std::fabs(x.first) - std::fabs(end)) <
+        std::fabs(std::fabs(value) - std::fabs(end)) <
             std::numeric_limits<double>::epsilon()) {
       return false;
     } else
-      return (x.first < start || x.first > end);
+      return (value < start || value > end);
   };
 
-  temp->erase(std::remove_if(temp->begin(), temp->end(), inside_range),
-              temp->end());
-
-  datasize = temp->size();
-  data_->clear();
-  data_->reserve(datasize);
-  data_ = std::move(temp);
+  // rows valid in both columns and inside the range, read straight from the
+  // column storage
+  const double *xdata = xview.data();
+  const double *ydata = yview.data();
+  std::vector<int> rows;
+  rows.reserve(static_cast<size_t>(qMax(0, to - from + 1)));
+  const Interval<int> range(from, to);
+  for (const Interval<int> &xrun : xview.validIntervals(range))
+    for (const Interval<int> &run : yview.validIntervals(xrun))
+      for (int row = run.start(); row <= run.end(); row++)
+        if (!outside_range(xdata[row])) rows.push_back(row);
+
+  // start/end finding only works on nondecreasing data, so sort unless the
+  // data is sorted already; order like the (x, y) pairs the points are
+  auto less = [&](int lhs, int rhs) {
+    return xdata[lhs] < xdata[rhs] ||
+           (!(xdata[rhs] < xdata[lhs]) && ydata[lhs] < ydata[rhs]);
+  };
+  if (!std::is_sorted(rows.begin(), rows.end(), less))
+    std::stable_sort(rows.begin(), rows.end(), less);
 
+  const int datasize = static_cast<int>(rows.size());
   (*x) = new double[datasize];
   (*y) = new double[datasize];
   for (int i = 0; i < datasize; i++) {
-    (*x)[i] = data_->at(i).first;
-    (*y)[i] = data_->at(i).second;
+    (*x)[i] = xdata[rows[i]];
+    (*y)[i] = ydata[rows[i]];
   }
 
   return datasize;
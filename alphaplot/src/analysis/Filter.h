@@ -119,9 +119,10 @@ class Filter : public QObject {
   virtual void output();
 
   //! Calculates the data for the output curve and store it in the X an Y
-  //! vectors
-  virtual void calculateOutputData(double *X,
-                                   double *Y){Q_UNUSED(X) Q_UNUSED(Y)}
+  //! vectors; returns false if the analysis failed and no curve is to be added
+  virtual bool calculateOutputData(double *X, double *Y) {
+    Q_UNUSED(X) Q_UNUSED(Y) return true;
+  }
 
   ApplicationWindow *app_;
 
@@ -134,7 +135,6 @@ class Filter : public QObject {
   //! Size of the data arrays
   int d_n;
 
-  std::unique_ptr<std::vector<std::pair<double, double>>> data_;
   //! x data set to be analysed
   double *d_x;
 
@@ -37,6 +37,10 @@
 #include <QDateTime>
 #include <QLocale>
 #include <QMessageBox>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
 
 #include "2Dplot/AxisRect2D.h"
 #include "2Dplot/Curve2D.h"
@@ -72,23 +76,100 @@ Fit::Fit(ApplicationWindow *parent, AxisRect2D *axisrect, QString name)
   d_sort_data = true;
 }
 
-std::vector<double> Fit::fitGslMultifit(int &iterations, int &status) {
-  std::vector<double> result(d_p);
+//! GSL solver state reused by consecutive fits of one thread
+/**
+ * The solvers are allocated for a fixed number of points and parameters;
+ * they are only reallocated when a fit needs another size or algorithm.
+ */
+class FitWorkspace {
+ public:
+  FitWorkspace() = default;
+  FitWorkspace(const FitWorkspace &) = delete;
+  FitWorkspace &operator=(const FitWorkspace &) = delete;
+  ~FitWorkspace() {
+    if (d_multifit) gsl_multifit_fdfsolver_free(d_multifit);
+    if (d_multimin) gsl_multimin_fminimizer_free(d_multimin);
+    if (d_jacobian) gsl_matrix_free(d_jacobian);
+    if (d_steps) gsl_vector_free(d_steps);
+  }
+
+  gsl_multifit_fdfsolver *multifit(const gsl_multifit_fdfsolver_type *type,
+                                   size_t n, size_t p) {
+    if (d_multifit && (d_multifit->type != type || d_multifit->f->size != n ||
+                       d_multifit->x->size != p)) {
+      gsl_multifit_fdfsolver_free(d_multifit);
+      d_multifit = nullptr;
+    }
+    if (!d_multifit) d_multifit = gsl_multifit_fdfsolver_alloc(type, n, p);
+    return d_multifit;
+  }
+
+  gsl_multimin_fminimizer *multimin(size_t p) {
+    if (d_multimin && d_multimin->x->size != p) {
+      gsl_multimin_fminimizer_free(d_multimin);
+      d_multimin = nullptr;
+    }
+    if (!d_multimin)
+      d_multimin =
+          gsl_multimin_fminimizer_alloc(gsl_multimin_fminimizer_nmsimplex, p);
+    return d_multimin;
+  }
+
+  gsl_matrix *jacobian(size_t n, size_t p) {
+    if (d_jacobian && (d_jacobian->size1 != n || d_jacobian->size2 != p)) {
+      gsl_matrix_free(d_jacobian);
+      d_jacobian = nullptr;
+    }
+    if (!d_jacobian) d_jacobian = gsl_matrix_alloc(n, p);
+    return d_jacobian;
+  }
+
+  gsl_vector *steps(size_t p) {
+    if (d_steps && d_steps->size != p) {
+      gsl_vector_free(d_steps);
+      d_steps = nullptr;
+    }
+    if (!d_steps) d_steps = gsl_vector_alloc(p);
+    return d_steps;
+  }
+
+ private:
+  gsl_multifit_fdfsolver *d_multifit = nullptr;
+  gsl_multimin_fminimizer *d_multimin = nullptr;
+  gsl_matrix *d_jacobian = nullptr;
+  gsl_vector *d_steps = nullptr;
+};
 
+std::vector<double> Fit::fitGslMultifit(int &iterations, int &status) {
   // declare input data
+  std::vector<FitModel *> models;
+  for (auto &model : d_models) models.push_back(model.get());
   struct FitData data = {static_cast<size_t>(d_n),
                          static_cast<size_t>(d_p),
                          d_x,
                          d_y,
                          &d_y_errors[0],
-                         this};
+                         this,
+                         d_blocks.get(),
+                         models.data()};
+  FitWorkspace workspace;
+  return solveMultifit(&data, workspace, d_y_error_source == UnknownErrors,
+                       covar, chi_2, iterations, status);
+}
+
+std::vector<double> Fit::solveMultifit(FitData *data, FitWorkspace &workspace,
+                                       bool unit_errors,
+                                       gsl_matrix *covariance, double &chi2,
+                                       int &iterations, int &status) const {
+  std::vector<double> result(d_p);
+
   gsl_multifit_function_fdf f;
   f.f = d_f;
   f.df = d_df;
   f.fdf = d_fdf;
-  f.n = static_cast<size_t>(d_n);
-  f.p = static_cast<size_t>(d_p);
-  f.params = &data;
+  f.n = data->n;
+  f.p = data->p;
+  f.params = data;
 
   // initialize solver
   const gsl_multifit_fdfsolver_type *T;
@@ -103,8 +184,7 @@ std::vector<double> Fit::fitGslMultifit(int &iterations, int &status) {
       T = gsl_multifit_fdfsolver_lmsder;
       break;
   }
-  gsl_multifit_fdfsolver *s = gsl_multifit_fdfsolver_alloc(
-      T, static_cast<size_t>(d_n), static_cast<size_t>(d_p));
+  gsl_multifit_fdfsolver *s = workspace.multifit(T, data->n, data->p);
   gsl_multifit_fdfsolver_set(s, &f, d_param_init);
 
   // iterate solver algorithm
@@ -119,53 +199,66 @@ std::vector<double> Fit::fitGslMultifit(int &iterations, int &status) {
   // grab results
   for (int i = 0; i < d_p; i++)
     result[i] = gsl_vector_get(s->x, static_cast<size_t>(i));
-  gsl_blas_ddot(s->f, s->f, &chi_2);
+  // the same blocks and order of additions as the chi^2 callbacks
+  chi2 = data->blocks->sum([&](int, size_t begin, size_t end) {
+    double sum = 0.0;
+    for (size_t j = begin; j < end; j++) sum += pow(gsl_vector_get(s->f, j), 2);
+    return sum;
+  });
 #if GSL_MAJOR_VERSION < 2
-  gsl_multifit_covar(s->J, 0.0, covar);
+  gsl_multifit_covar(s->J, 0.0, covariance);
 #else
   {
-    gsl_matrix *J = gsl_matrix_alloc(d_n, d_p);
+    gsl_matrix *J = workspace.jacobian(data->n, data->p);
     gsl_multifit_fdfsolver_jac(s, J);
-    gsl_multifit_covar(J, 0.0, covar);
-    gsl_matrix_free(J);
+    gsl_multifit_covar(J, 0.0, covariance);
   }
 #endif
-  if (d_y_error_source == UnknownErrors) {
+  if (unit_errors) {
     // multiply covar by variance of residuals, which is used as an estimate for
     // the statistical errors (this relies on the Y errors being set to 1.0, so
     // that s->f is properly normalized)
-    gsl_matrix_scale(covar, chi_2 / (d_n - d_p));
+    gsl_matrix_scale(covariance, chi2 / (data->n - data->p));
   }
 
-  // free memory allocated for fitting
-  gsl_multifit_fdfsolver_free(s);
-
   return result;
 }
 
 std::vector<double> Fit::fitGslMultimin(int &iterations, int &status) {
-  std::vector<double> result(d_p);
-
   // declare input data
+  std::vector<FitModel *> models;
+  for (auto &model : d_models) models.push_back(model.get());
   struct FitData data = {static_cast<size_t>(d_n),
                          static_cast<size_t>(d_p),
                          d_x,
                          d_y,
                          &d_y_errors[0],
-                         this};
+                         this,
+                         d_blocks.get(),
+                         models.data()};
+  FitWorkspace workspace;
+  return solveMultimin(&data, workspace, d_y_error_source == UnknownErrors,
+                       covar, chi_2, iterations, status);
+}
+
+std::vector<double> Fit::solveMultimin(FitData *data, FitWorkspace &workspace,
+                                       bool unit_errors,
+                                       gsl_matrix *covariance, double &chi2,
+                                       int &iterations, int &status) const {
+  std::vector<double> result(d_p);
+
   gsl_multimin_function f;
   f.f = d_fsimplex;
-  f.n = static_cast<size_t>(d_p);
-  f.params = &data;
+  f.n = data->p;
+  f.params = data;
 
   // step size (size of the simplex)
   // can be increased for faster convergence
-  gsl_vector *ss = gsl_vector_alloc(f.n);
+  gsl_vector *ss = workspace.steps(f.n);
   gsl_vector_set_all(ss, 10.0);
 
   // initialize minimizer
-  const gsl_multimin_fminimizer_type *T = gsl_multimin_fminimizer_nmsimplex;
-  gsl_multimin_fminimizer *s_min = gsl_multimin_fminimizer_alloc(T, f.n);
+  gsl_multimin_fminimizer *s_min = workspace.multimin(f.n);
   gsl_multimin_fminimizer_set(s_min, &f, d_param_init, ss);
 
   // iterate minimization algorithm
@@ -181,22 +274,16 @@ std::vector<double> Fit::fitGslMultimin(int &iterations, int &status) {
   // grab results
   for (int i = 0; i < d_p; i++)
     result[i] = gsl_vector_get(s_min->x, static_cast<size_t>(i));
-  chi_2 = s_min->fval;
-  gsl_matrix *J =
-      gsl_matrix_alloc(static_cast<size_t>(d_n), static_cast<size_t>(d_p));
+  chi2 = s_min->fval;
+  gsl_matrix *J = workspace.jacobian(data->n, data->p);
   d_df(s_min->x, static_cast<void *>(f.params), J);
-  gsl_multifit_covar(J, 0.0, covar);
-  if (d_y_error_source == UnknownErrors) {
+  gsl_multifit_covar(J, 0.0, covariance);
+  if (unit_errors) {
     // multiply covar by variance of residuals, which is used as an estimate for
     // the statistical errors (this relies on the Y errors being set to 1.0)
-    gsl_matrix_scale(covar, chi_2 / (d_n - d_p));
+    gsl_matrix_scale(covariance, chi2 / (data->n - data->p));
   }
 
-  // free previously allocated memory
-  gsl_matrix_free(J);
-  gsl_multimin_fminimizer_free(s_min);
-  gsl_vector_free(ss);
-
   return result;
 }
 
@@ -261,7 +348,7 @@ QString Fit::logFitInfo(const std::vector<double> &par, int iterations,
   QString table;
   if (is_non_linear) {
     table =
-        Utilities::makeHtmlTable(10 + d_param_names.count(), 2, false, profile);
+        Utilities::makeHtmlTable(11 + d_param_names.count(), 2, false, profile);
   } else {
     table =
         Utilities::makeHtmlTable(6 + d_param_names.count(), 2, false, profile);
@@ -303,29 +390,49 @@ QString Fit::logFitInfo(const std::vector<double> &par, int iterations,
   if (is_non_linear) {
     table = table.arg(tr("Iterations"), QString::number(iterations),
                       tr("Status"), gsl_strerror(status));
+    // speedup of the first evaluation on each thread count over one thread
+    const int threads =
+        (d_blocks && d_blocks->used()) ? d_blocks->workers() : 1;
+    QString threadtext = QString::number(threads);
+    if (threads > 1) {
+      QStringList speedups;
+      foreach (int count, d_blocks->measuredThreads())
+        if (count > 1)
+          speedups << tr("%1x on %2")
+                          .arg(QLocale().toString(d_blocks->speedup(count),
+                                                  'f', 1))
+                          .arg(count);
+      threadtext += " (" + tr("speedup") + " " + speedups.join(", ") + ")";
+    }
+    table = table.arg(tr("Threads"), threadtext);
   }
   info += table + "<br>";
   return info;
 }
 
 double Fit::rSquare() {
+  return rSquare(d_y, d_y_errors.data(), d_n, chi_2,
+                 d_y_error_source != UnknownErrors);
+}
+
+double Fit::rSquare(const double *y, const double *sigma, int n, double chi2,
+                    bool weighted) {
   double mean = 0.0, tss = 0.0, weights_sum = 0.0;
 
-  if (d_y_error_source == UnknownErrors) {
-    for (int i = 0; i < d_n; i++) mean += d_y[i];
-    mean /= d_n;
-    for (int i = 0; i < d_n; i++) tss += (d_y[i] - mean) * (d_y[i] - mean);
+  if (!weighted) {
+    for (int i = 0; i < n; i++) mean += y[i];
+    mean /= n;
+    for (int i = 0; i < n; i++) tss += (y[i] - mean) * (y[i] - mean);
   } else {
-    for (int i = 0; i < d_n; i++) {
-      mean += d_y[i] / (d_y_errors[i] * d_y_errors[i]);
-      weights_sum += 1.0 / (d_y_errors[i] * d_y_errors[i]);
+    for (int i = 0; i < n; i++) {
+      mean += y[i] / (sigma[i] * sigma[i]);
+      weights_sum += 1.0 / (sigma[i] * sigma[i]);
     }
     mean /= weights_sum;
-    for (int i = 0; i < d_n; i++)
-      tss +=
-          (d_y[i] - mean) * (d_y[i] - mean) / (d_y_errors[i] * d_y_errors[i]);
+    for (int i = 0; i < n; i++)
+      tss += (y[i] - mean) * (y[i] - mean) / (sigma[i] * sigma[i]);
   }
-  return 1 - chi_2 / tss;
+  return 1 - chi2 / tss;
 }
 
 QString Fit::legendInfo() {
@@ -420,7 +527,11 @@ bool Fit::setYErrorSource(ErrorSource err, const QString &colName,
         d_y_error_dataset = colName;
 
         int col = t->colIndex(colName);
-        for (int i = 0; i < d_n; i++) d_y_errors[i] = t->cell(i, col);
+        const NumericColumnView errors = t->column(col)->numericView();
+        if (!errors.isNull())
+          errors.copyTo(0, d_n, d_y_errors);
+        else
+          for (int i = 0; i < d_n; i++) d_y_errors[i] = t->cell(i, col);
       } break;
   }
   return true;
@@ -464,6 +575,184 @@ Matrix *Fit::covarianceMatrix(const QString &matrixName) {
   return m;
 }
 
+namespace {
+// data and results of one y column of Fit::batchFit()
+struct BatchJob {
+  QString name;
+  std::vector<double> x, y, sigma;
+  std::vector<double> results, errors;
+  double chi2 = 0.0;
+  double r2 = 0.0;
+  int iterations = 0;
+  int status = GSL_SUCCESS;
+  bool fitted = false;
+};
+}  // namespace
+
+Table *Fit::batchFit(Column *xcol, const QList<Column *> &ycols,
+                     const QString &tableName) {
+  if (!xcol || ycols.isEmpty() || d_init_err) return nullptr;
+  if (!is_non_linear) {
+    QMessageBox::critical(app_, tr("Fit Error"),
+                          tr("Only non-linear fits can be applied to several "
+                             "columns at once. Operation aborted!"));
+    return nullptr;
+  }
+  if (!d_p) {
+    QMessageBox::critical(app_, tr("Fit Error"),
+                          tr("There are no parameters specified for this fit "
+                             "operation. Operation aborted!"));
+    return nullptr;
+  }
+  if (d_formula.isEmpty()) {
+    QMessageBox::critical(
+        app_, tr("Fit Error"),
+        tr("You must specify a valid fit function first. Operation aborted!"));
+    return nullptr;
+  }
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+
+  // copy the valid points of every column, sorted by x like the data of a
+  // single fit
+  const bool poisson = d_y_error_source == PoissonErrors;
+  std::vector<BatchJob> jobs(static_cast<size_t>(ycols.size()));
+  for (int c = 0; c < ycols.size(); c++) {
+    Column *ycol = ycols.at(c);
+    BatchJob &job = jobs[static_cast<size_t>(c)];
+    job.name = ycol->name();
+    std::vector<std::pair<double, double>> points;
+    const int rows = std::min(xcol->rowCount(), ycol->rowCount());
+    points.reserve(static_cast<size_t>(rows));
+    for (int i = 0; i < rows; i++)
+      if (!xcol->isInvalid(i) && !ycol->isInvalid(i))
+        points.push_back(std::make_pair(xcol->valueAt(i), ycol->valueAt(i)));
+    std::stable_sort(points.begin(), points.end());
+    for (const std::pair<double, double> &point : points) {
+      job.x.push_back(point.first);
+      job.y.push_back(point.second);
+      job.sigma.push_back(poisson ? sqrt(point.second) : 1.0);
+    }
+  }
+
+  d_script.reset(
+      scriptEnv->newScript(d_formula, this, metaObject()->className()));
+  connect(d_script.get(), &Script::error, this, &Fit::scriptError);
+  const bool user_function = d_f == user_f;
+  // user functions FitModel can't compile are evaluated by d_script, which
+  // must stay on this thread
+  int workers = std::min(QThreadPool::globalInstance()->maxThreadCount(),
+                         ycols.size());
+  if (workers < 1 ||
+      (user_function && !FitModel(d_formula, d_param_names).isValid()))
+    workers = 1;
+
+  std::atomic<size_t> next(0);
+  auto worker = [&](int &) {
+    FitWorkspace workspace;
+    std::unique_ptr<FitModel> model(
+        user_function ? new FitModel(d_formula, d_param_names) : nullptr);
+    FitModel *models[] = {model.get()};
+    const size_t p = static_cast<size_t>(d_p);
+    gsl_matrix *covariance = gsl_matrix_alloc(p, p);
+    for (size_t j = next++; j < jobs.size(); j = next++) {
+      BatchJob &job = jobs[j];
+      const size_t n = job.x.size();
+      if (n <= p) continue;
+      // the columns are spread over the threads, not their points
+      FitBlocks blocks(n, 1);
+      struct FitData data = {n,
+                             p,
+                             job.x.data(),
+                             job.y.data(),
+                             job.sigma.data(),
+                             this,
+                             &blocks,
+                             models};
+      if (d_solver == NelderMeadSimplex)
+        job.results = solveMultimin(&data, workspace, !poisson, covariance,
+                                    job.chi2, job.iterations, job.status);
+      else
+        job.results = solveMultifit(&data, workspace, !poisson, covariance,
+                                    job.chi2, job.iterations, job.status);
+      const double chi_2_dof = job.chi2 / (n - p);
+      for (size_t i = 0; i < p; i++) {
+        const double variance = gsl_matrix_get(covariance, i, i);
+        job.errors.push_back(
+            sqrt(d_scale_errors ? chi_2_dof * variance : variance));
+      }
+      job.r2 = rSquare(job.y.data(), job.sigma.data(), static_cast<int>(n),
+                       job.chi2, poisson);
+      job.fitted = true;
+    }
+    gsl_matrix_free(covariance);
+  };
+  QVector<int> threads(workers);
+  if (workers == 1)
+    worker(threads[0]);
+  else
+    QtConcurrent::blockingMap(threads, worker);
+
+  // let derived fits convert their parameters, e.g. decay rates to times
+  const std::vector<double> results = d_results;
+  for (BatchJob &job : jobs) {
+    if (!job.fitted) continue;
+    storeCustomFitResults(job.results);
+    job.results = d_results;
+  }
+  d_results = results;
+
+  // one column per parameter and error, then chi^2, R^2 and the status
+  const int rows = static_cast<int>(jobs.size());
+  const int columns = 2 * d_p + 4;
+  QStringList names, statuses;
+  std::vector<QVector<double>> values(static_cast<size_t>(columns - 2),
+                                      QVector<double>(rows, 0.0));
+  for (int r = 0; r < rows; r++) {
+    const BatchJob &job = jobs[static_cast<size_t>(r)];
+    names << job.name;
+    if (!job.fitted) {
+      statuses << tr("You need at least %1 data points for this fit "
+                     "operation.")
+                      .arg(d_p + 1);
+      continue;
+    }
+    statuses << gsl_strerror(job.status);
+    for (int i = 0; i < d_p; i++) {
+      values[static_cast<size_t>(2 * i)][r] = job.results[i];
+      values[static_cast<size_t>(2 * i + 1)][r] = job.errors[i];
+    }
+    values[static_cast<size_t>(2 * d_p)][r] = job.chi2;
+    values[static_cast<size_t>(2 * d_p + 1)][r] = job.r2;
+  }
+
+  Table *t = app_->newTable(tableName, rows, columns);
+  QStringList header;
+  header << tr("Column");
+  for (int i = 0; i < d_p; i++)
+    header << d_param_names[i] << d_param_names[i] + "_" + tr("Error");
+  header << tr("Chi^2") << tr("R^2") << tr("Status");
+  t->setHeader(header);
+  t->column(0)->setColumnMode(AlphaPlot::Text);
+  t->column(0)->setPlotDesignation(AlphaPlot::X);
+  t->column(0)->replaceTexts(0, names);
+  for (int c = 1; c < columns - 1; c++) {
+    Column *column = t->column(c);
+    column->setColumnMode(AlphaPlot::Numeric);
+    column->replaceValues(0, values[static_cast<size_t>(c - 1)]);
+    if (c <= 2 * d_p && c % 2 == 0)
+      column->setPlotDesignation(AlphaPlot::yErr);
+    for (int r = 0; r < rows; r++)
+      if (!jobs[static_cast<size_t>(r)].fitted) column->setInvalid(r);
+  }
+  t->column(columns - 1)->setColumnMode(AlphaPlot::Text);
+  t->column(columns - 1)->replaceTexts(0, statuses);
+  t->showNormal();
+
+  QApplication::restoreOverrideCursor();
+  return t;
+}
+
 const std::vector<double> &Fit::errors() {
   if (d_result_errors.empty()) {
     d_result_errors.resize(d_p);
@@ -519,6 +808,12 @@ void Fit::fit() {
   d_script.reset(
       scriptEnv->newScript(d_formula, this, metaObject()->className()));
   connect(d_script.get(), &Script::error, this, &Fit::scriptError);
+  d_blocks.reset(new FitBlocks(static_cast<size_t>(d_n), d_threads));
+  d_models.clear();
+  d_models.emplace_back(new FitModel(d_formula, d_param_names));
+  if (d_models.front()->isValid())
+    while (d_models.size() < static_cast<size_t>(d_blocks->workers()))
+      d_models.emplace_back(new FitModel(d_formula, d_param_names));
 
   if (d_solver == NelderMeadSimplex)
     par = fitGslMultimin(iterations, status);
@@ -544,34 +839,90 @@ void Fit::scriptError(const QString &message, const QString &script_name,
       QString("%1:%2\n").arg(script_name).arg(line_number) + message);
 }
 
-int Fit::evaluate_f(const gsl_vector *x, gsl_vector *f) {
+namespace {
+std::vector<double> parameterValues(const gsl_vector *x) {
+  std::vector<double> values(x->size);
+  for (size_t i = 0; i < x->size; i++) values[i] = gsl_vector_get(x, i);
+  return values;
+}
+
+// whether the user function of 'data' can be evaluated by its FitModels
+bool compiledModel(const FitData *data) {
+  return data->models && data->models[0] && data->models[0]->isValid();
+}
+}  // namespace
+
+int Fit::evaluate_f(const gsl_vector *x, gsl_vector *f, const FitData *data) {
+  const double *X = data->X;
+  const double *Y = data->Y;
+  const double *sigma = data->sigma;
+  if (compiledModel(data)) {
+    const std::vector<double> par = parameterValues(x);
+    std::vector<double> y(data->n);
+    std::atomic<bool> success(true);
+    data->blocks->run([&](int worker, size_t begin, size_t end) {
+      if (!data->models[worker]->evaluate(par.data(), X + begin,
+                                          static_cast<int>(end - begin),
+                                          &y[begin])) {
+        success = false;
+        return;
+      }
+      for (size_t j = begin; j < end; j++)
+        gsl_vector_set(f, j, (y[j] - Y[j]) / sigma[j]);
+    });
+    return success ? GSL_SUCCESS : GSL_EINVAL;
+  }
+
   for (int i = 0; i < d_p; i++)
     d_script->setDouble(gsl_vector_get(x, static_cast<size_t>(i)),
                         d_param_names[i].toUtf8());
-  for (int j = 0; j < d_n; j++) {
-    d_script->setDouble(d_x[j], "x");
+  for (size_t j = 0; j < data->n; j++) {
+    d_script->setDouble(X[j], "x");
     bool success;
-    gsl_vector_set(
-        f, static_cast<size_t>(j),
-        (d_script->eval().toDouble(&success) - d_y[j]) / d_y_errors[j]);
+    gsl_vector_set(f, j,
+                   (d_script->eval().toDouble(&success) - Y[j]) / sigma[j]);
     if (!success) return GSL_EINVAL;
   }
   return GSL_SUCCESS;
 }
 
-double Fit::evaluate_d(const gsl_vector *x) {
+double Fit::evaluate_d(const gsl_vector *x, const FitData *data) {
+  const double *X = data->X;
+  const double *Y = data->Y;
+  const double *sigma = data->sigma;
   double result = 0.0;
+  if (compiledModel(data)) {
+    const std::vector<double> par = parameterValues(x);
+    std::vector<double> y(data->n);
+    std::atomic<bool> success(true);
+    result = data->blocks->sum([&](int worker, size_t begin, size_t end) {
+      double sum = 0.0;
+      if (!data->models[worker]->evaluate(par.data(), X + begin,
+                                          static_cast<int>(end - begin),
+                                          &y[begin])) {
+        success = false;
+        return sum;
+      }
+      for (size_t j = begin; j < end; j++)
+        sum += pow((y[j] - Y[j]) / sigma[j], 2);
+      return sum;
+    });
+    return success ? result : GSL_EINVAL;
+  }
+
   for (int i = 0; i < d_p; i++)
     d_script->setDouble(gsl_vector_get(x, static_cast<size_t>(i)),
                         d_param_names[i].toUtf8());
-  for (int j = 0; j < d_n; j++) {
-    d_script->setDouble(d_x[j], "x");
-    bool success;
-    result +=
-        pow((d_script->eval().toDouble(&success) - d_y[j]) / d_y_errors[j], 2);
-    if (!success) return GSL_EINVAL;
-  }
-  return result;
+  bool success = true;
+  result = FitBlocks::serialSum(data->n, [&](size_t begin, size_t end) {
+    double sum = 0.0;
+    for (size_t j = begin; j < end && success; j++) {
+      d_script->setDouble(X[j], "x");
+      sum += pow((d_script->eval().toDouble(&success) - Y[j]) / sigma[j], 2);
+    }
+    return sum;
+  });
+  return success ? result : GSL_EINVAL;
 }
 
 typedef struct {
@@ -593,26 +944,42 @@ double Fit::evaluate_df_helper(double x, void *params) {
   return result;
 }
 
-int Fit::evaluate_df(const gsl_vector *x, gsl_matrix *J) {
+int Fit::evaluate_df(const gsl_vector *x, gsl_matrix *J, const FitData *data) {
+  const double *X = data->X;
+  const double *sigma = data->sigma;
+  if (compiledModel(data)) {
+    const std::vector<double> par = parameterValues(x);
+    std::atomic<bool> success(true);
+    data->blocks->run([&](int worker, size_t begin, size_t end) {
+      gsl_matrix_view rows =
+          gsl_matrix_submatrix(J, begin, 0, end - begin, data->p);
+      if (!data->models[worker]->jacobian(par.data(), X + begin,
+                                          sigma + begin,
+                                          static_cast<int>(end - begin),
+                                          &rows.matrix))
+        success = false;
+    });
+    return success ? GSL_SUCCESS : GSL_EINVAL;
+  }
+
   double result, abserr;
   gsl_function F;
   F.function = &evaluate_df_helper;
-  DiffData data;
-  F.params = &data;
-  data.script = d_script.get();
-  data.success = true;
+  DiffData diff;
+  F.params = &diff;
+  diff.script = d_script.get();
+  diff.success = true;
   for (int i = 0; i < d_p; i++)
     d_script->setDouble(gsl_vector_get(x, static_cast<size_t>(i)),
                         d_param_names[i].toUtf8());
-  for (int i = 0; i < d_n; i++) {
-    d_script->setDouble(d_x[i], "x");
+  for (size_t i = 0; i < data->n; i++) {
+    d_script->setDouble(X[i], "x");
     for (int j = 0; j < d_p; j++) {
-      data.param = d_param_names[j];
+      diff.param = d_param_names[j];
       gsl_deriv_central(&F, gsl_vector_get(x, static_cast<size_t>(j)), 1e-8,
                         &result, &abserr);
-      if (!data.success) return GSL_EINVAL;
-      gsl_matrix_set(J, static_cast<size_t>(i), static_cast<size_t>(j),
-                     result / d_y_errors[j]);
+      if (!diff.success) return GSL_EINVAL;
+      gsl_matrix_set(J, i, static_cast<size_t>(j), result / sigma[i]);
     }
   }
   return GSL_SUCCESS;
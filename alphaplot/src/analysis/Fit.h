@@ -36,12 +36,17 @@
 #include <vector>
 
 #include "Filter.h"
+#include "FitBlocks.h"
+#include "FitModel.h"
 #include "scripting/Script.h"
 
 class Table;
 class Matrix;
 class ApplicationWindow;
 class Script;
+class Column;
+class FitWorkspace;
+struct FitData;
 
 //! Fit base class
 class Fit : public Filter, public scripted {
@@ -92,6 +97,12 @@ class Fit : public Filter, public scripted {
 
   void setAlgorithm(Algorithm s) { d_solver = s; }
 
+  //! Maximum number of threads evaluating the fit function
+  /**
+   * 0 (the default) uses all threads of the global thread pool.
+   */
+  void setThreadCount(int threads) { d_threads = threads; }
+
   //! Specifies weather the result of the fit is a function curve
   void generateFunction(bool yes, int points = 100);
 
@@ -116,9 +127,24 @@ class Fit : public Filter, public scripted {
   Table *parametersTable(const QString &tableName);
   Matrix *covarianceMatrix(const QString &matrixName);
 
-  int evaluate_f(const gsl_vector *x, gsl_vector *f);
-  double evaluate_d(const gsl_vector *x);
-  int evaluate_df(const gsl_vector *x, gsl_matrix *J);
+  //! Fits the model to each of 'ycols' against 'xcol'
+  /**
+   * Uses the function, initial guesses, algorithm and output settings of
+   * this fit, but all valid points of the columns instead of the data range
+   * of the fitted curve. The fits are independent of each other and run
+   * concurrently, one per thread; every thread reuses its solver workspace
+   * and compiled function for the columns it fits. Y errors are estimated
+   * from the residuals unless the error source is PoissonErrors.
+   *
+   * Writes one row per y column to a new table: the parameters with their
+   * errors, chi^2, R^2 and the solver status.
+   */
+  Table *batchFit(Column *xcol, const QList<Column *> &ycols,
+                  const QString &tableName);
+
+  int evaluate_f(const gsl_vector *x, gsl_vector *f, const FitData *data);
+  double evaluate_d(const gsl_vector *x, const FitData *data);
+  int evaluate_df(const gsl_vector *x, gsl_matrix *J, const FitData *data);
   static double evaluate_df_helper(double x, void *param);
 
  protected slots:
@@ -134,6 +160,28 @@ class Fit : public Filter, public scripted {
   //! (Levenberg-Marquardt).
   std::vector<double> fitGslMultifit(int &iterations, int &status);
 
+  //! Run the simplex minimizer on 'data', storing the covariance matrix in
+  //! 'covariance'
+  /**
+   * Only reads the settings of the fit, so batchFit() runs it on several
+   * threads at once, each with its own data and workspace. 'unit_errors'
+   * tells that all Y errors are 1.0 and have to be estimated from the
+   * residuals.
+   */
+  std::vector<double> solveMultimin(FitData *data, FitWorkspace &workspace,
+                                    bool unit_errors, gsl_matrix *covariance,
+                                    double &chi2, int &iterations,
+                                    int &status) const;
+  //! Same as solveMultimin(), using the Levenberg-Marquardt solvers
+  std::vector<double> solveMultifit(FitData *data, FitWorkspace &workspace,
+                                    bool unit_errors, gsl_matrix *covariance,
+                                    double &chi2, int &iterations,
+                                    int &status) const;
+
+  //! Coefficient of determination of a fit with sum of squares 'chi2'
+  static double rSquare(const double *y, const double *sigma, int n,
+                        double chi2, bool weighted);
+
   //! Customs and stores the fit results according to the derived class
   //! specifications. Used by exponential fits.
   virtual void storeCustomFitResults(const std::vector<double> &par);
@@ -219,6 +267,21 @@ class Fit : public Filter, public scripted {
 
   //! Script used to evaluate user-defined functions.
   std::unique_ptr<Script> d_script;
+
+  //! Compiled form of d_formula, one per worker of d_blocks; evaluate_*()
+  //! fall back to d_script if it isn't valid
+  std::vector<std::unique_ptr<FitModel>> d_models;
+
+  //! Splits the evaluation of the fit function over threads
+  std::unique_ptr<FitBlocks> d_blocks;
+
+  //! Maximum number of threads used by d_blocks, 0 for all
+  int d_threads = 0;
+
+  //! Whether d_models can be used instead of d_script
+  bool hasCompiledModel() const {
+    return !d_models.empty() && d_models.front()->isValid();
+  }
 };
 
 #endif  // FIT_H
@@ -0,0 +1,104 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Parallel evaluation of fit functions over the data points */
+
+#include "FitBlocks.h"
+
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+// points per block; large enough that a block outweighs handing it to a
+// thread, small enough to spread typical spectra over several threads
+const size_t block_size = 1024;
+}  // namespace
+
+FitBlocks::FitBlocks(size_t n, int threads)
+    : d_n(n), d_blocks((n + block_size - 1) / block_size) {
+  if (threads <= 0) threads = QThreadPool::globalInstance()->maxThreadCount();
+  d_workers = static_cast<int>(
+      std::max<size_t>(1, std::min(static_cast<size_t>(threads), d_blocks)));
+}
+
+void FitBlocks::run(const std::function<void(int, size_t, size_t)> &function) {
+  evaluate([&](int worker, size_t block) {
+    const size_t begin = block * block_size;
+    function(worker, begin, std::min(d_n, begin + block_size));
+  });
+}
+
+double FitBlocks::sum(
+    const std::function<double(int, size_t, size_t)> &function) {
+  std::vector<double> partial(d_blocks);
+  evaluate([&](int worker, size_t block) {
+    const size_t begin = block * block_size;
+    partial[block] = function(worker, begin, std::min(d_n, begin + block_size));
+  });
+  double result = 0.0;
+  for (double value : partial) result += value;
+  return result;
+}
+
+double FitBlocks::serialSum(
+    size_t n, const std::function<double(size_t, size_t)> &function) {
+  // the same blocks and order of additions as sum()
+  double result = 0.0;
+  for (size_t begin = 0; begin < n; begin += block_size)
+    result += function(begin, std::min(n, begin + block_size));
+  return result;
+}
+
+double FitBlocks::speedup(int threads) const {
+  const qint64 time = d_wall_times.value(threads);
+  if (time <= 0 || !d_wall_times.contains(1)) return 1.0;
+  return static_cast<double>(d_wall_times.value(1)) /
+         static_cast<double>(time);
+}
+
+void FitBlocks::evaluate(const std::function<void(int, size_t)> &block) {
+  if (!d_wall_times.isEmpty() || d_workers == 1) {
+    if (d_wall_times.isEmpty()) d_wall_times.insert(1, 0);
+    evaluate(block, d_workers);
+    return;
+  }
+  // time the first evaluation on 1, 2, 4, ... and all workers
+  for (int workers = 1;; workers = std::min(2 * workers, d_workers)) {
+    QElapsedTimer timer;
+    timer.start();
+    evaluate(block, workers);
+    d_wall_times.insert(workers, std::max<qint64>(1, timer.nsecsElapsed()));
+    if (workers == d_workers) break;
+  }
+}
+
+void FitBlocks::evaluate(const std::function<void(int, size_t)> &block,
+                         int workers) {
+  auto worker = [&](int &index) {
+    for (size_t b = static_cast<size_t>(index); b < d_blocks;
+         b += static_cast<size_t>(workers))
+      block(index, b);
+  };
+  QVector<int> indices(workers);
+  std::iota(indices.begin(), indices.end(), 0);
+  if (workers == 1)
+    worker(indices[0]);
+  else
+    QtConcurrent::blockingMap(indices, worker);
+}
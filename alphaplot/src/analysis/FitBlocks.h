@@ -0,0 +1,83 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Parallel evaluation of fit functions over the data points */
+
+#ifndef FITBLOCKS_H
+#define FITBLOCKS_H
+
+#include <QMap>
+#include <QVector>
+#include <QtGlobal>
+#include <cstddef>
+#include <functional>
+
+//! Evaluates a fit function over blocks of data points on several threads
+/**
+ * The points 0 ... n-1 are split into blocks of a fixed size. Each worker
+ * runs on a thread of the global thread pool and handles every
+ * workers()-th block, so per-thread resources (e.g. a FitModel) can be
+ * indexed by the worker number passed to the callbacks.
+ *
+ * Since the blocks don't depend on the number of workers and sum() adds the
+ * partial sums of the blocks in block order, chi^2 and other reductions are
+ * the same bit for bit whether a fit runs on one thread or on many. Sums
+ * computed outside of the workers (e.g. by the Script fallback of user
+ * functions) use serialSum() to add up the same blocks in the same order.
+ *
+ * The first run() or sum() is evaluated once on one worker and once on
+ * every doubled number of workers up to workers(), to measure the speedup
+ * of each thread count. The callbacks only write their own rows or return
+ * their partial sum, so evaluating a block again gives the same result.
+ */
+class FitBlocks {
+ public:
+  //! Split 'n' points over at most 'threads' workers
+  /**
+   * threads <= 0 uses the maximum thread count of the global thread pool.
+   */
+  FitBlocks(size_t n, int threads);
+
+  //! Number of threads the blocks are evaluated on
+  int workers() const { return d_workers; }
+
+  //! Call function(worker, begin, end) for every block [begin, end)
+  void run(const std::function<void(int, size_t, size_t)> &function);
+  //! Return the sum of function(worker, begin, end) over all blocks
+  double sum(const std::function<double(int, size_t, size_t)> &function);
+  //! Return the sum of function(begin, end) over all blocks, on this thread
+  static double serialSum(
+      size_t n, const std::function<double(size_t, size_t)> &function);
+
+  //! Whether run() or sum() were called
+  bool used() const { return !d_wall_times.isEmpty(); }
+  //! Thread counts the first evaluation was timed with
+  QVector<int> measuredThreads() const {
+    return d_wall_times.keys().toVector();
+  }
+  //! Speedup of the first evaluation on 'threads' over one thread
+  double speedup(int threads) const;
+
+ private:
+  void evaluate(const std::function<void(int, size_t)> &block);
+  void evaluate(const std::function<void(int, size_t)> &block, int workers);
+
+  size_t d_n;
+  size_t d_blocks;
+  int d_workers;
+  //! nanoseconds the first evaluation took per number of workers
+  QMap<int, qint64> d_wall_times;
+};
+
+#endif  // FITBLOCKS_H
@@ -392,6 +392,13 @@ void FitDialog::initAdvancedPage() {
   gl2->addWidget(new QLabel(tr("Name: ")), 2, 1);
   covMatrixName = new QLineEdit(tr("CovMatrix"));
   gl2->addWidget(covMatrixName, 2, 2);
+  btnBatchFit = new QPushButton(tr("Fit All &Columns"));
+  btnBatchFit->setToolTip(
+      tr("Fit the function to every Y column of the fitted curve's table"));
+  gl2->addWidget(btnBatchFit, 3, 0);
+  gl2->addWidget(new QLabel(tr("Name: ")), 3, 1);
+  batchTableName = new QLineEdit(tr("BatchFit"));
+  gl2->addWidget(batchTableName, 3, 2);
 
   scaleErrorsBox = new QCheckBox(tr("Scale Errors with sqrt(Chi^2/doF)"));
   scaleErrorsBox->setChecked(app_->fit_scale_errors);
@@ -442,6 +449,7 @@ void FitDialog::initAdvancedPage() {
 
   connect(btnParamTable, SIGNAL(clicked()), this, SLOT(showParametersTable()));
   connect(btnCovMatrix, SIGNAL(clicked()), this, SLOT(showCovarianceMatrix()));
+  connect(btnBatchFit, SIGNAL(clicked()), this, SLOT(showBatchFit()));
   connect(samePointsBtn, SIGNAL(toggled(bool)), this,
           SLOT(showPointsBox(bool)));
   connect(generatePointsBtn, SIGNAL(toggled(bool)), this,
@@ -478,6 +486,40 @@ void FitDialog::showParametersTable() {
   d_fitter->parametersTable(tableName);
 }
 
+void FitDialog::showBatchFit() {
+  QString tableName = batchTableName->text();
+  if (tableName.isEmpty()) {
+    QMessageBox::critical(
+        this, tr("Error"),
+        tr("Please enter a valid name for the batch fit table."));
+    return;
+  }
+
+  if (!d_fitter) {
+    QMessageBox::critical(this, tr("Error"),
+                          tr("Please perform a fit first and try again."));
+    return;
+  }
+
+  PlotData::AssociatedData *associateddata =
+      PlotColumns::getassociateddatafromstring(axisrect_,
+                                               boxCurve->currentText());
+  if (!associateddata) return;
+
+  QList<Column *> ycols;
+  Table *table = associateddata->table;
+  for (int i = 0; i < table->numCols(); i++) {
+    Column *col = table->column(i);
+    if (col != associateddata->xcol &&
+        col->plotDesignation() == AlphaPlot::Y &&
+        col->columnMode() == AlphaPlot::Numeric)
+      ycols << col;
+  }
+
+  tableName = app_->generateUniqueName(tableName, false);
+  d_fitter->batchFit(associateddata->xcol, ycols, tableName);
+}
+
 void FitDialog::showCovarianceMatrix() {
   QString matrixName = covMatrixName->text();
   if (matrixName.isEmpty()) {
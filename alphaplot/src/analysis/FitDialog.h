@@ -136,6 +136,8 @@ class FitDialog : public QDialog {
   void showParametersTable();
   //! Display the covariance matrix
   void showCovarianceMatrix();
+  //! Fit the Y columns of the fitted curve's table and display the results
+  void showBatchFit();
 
   //! Applies the user changes to the numerical format of the output results
   void applyChanges();
@@ -188,8 +190,8 @@ class FitDialog : public QDialog {
   ColorBox* boxColor;
   QComboBox *boxYErrorSource, *tableNamesBox, *colNamesBox;
   QRadioButton *generatePointsBtn, *samePointsBtn;
-  QPushButton *btnParamTable, *btnCovMatrix;
-  QLineEdit *covMatrixName, *paramTableName;
+  QPushButton *btnParamTable, *btnCovMatrix, *btnBatchFit;
+  QLineEdit *covMatrixName, *paramTableName, *batchTableName;
   QCheckBox *plotLabelBox, *logBox, *scaleErrorsBox;
   ApplicationWindow *app_;
   double xmin_;
@@ -0,0 +1,104 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Compiled evaluation of user-defined fit functions */
+
+#include "FitModel.h"
+
+#include <gsl/gsl_math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <QRegExp>
+
+#include "scripting/MuParserScript.h"
+
+namespace {
+// points handed to muParser per bulk evaluation; keeps the bound arrays small
+// enough to stay in cache
+const int chunk_size = 2048;
+}  // namespace
+
+FitModel::FitModel(const QString &formula, const QStringList &parameters)
+    : d_x(chunk_size),
+      d_params(static_cast<size_t>(parameters.size()),
+               std::vector<double>(chunk_size)),
+      d_valid(false) {
+  const QString expression = formula.trimmed();
+  // comments and statement separators need MuParserScript's pre-processing
+  if (expression.isEmpty() || expression.contains(QRegExp("[#;\\n]"))) return;
+
+  MuParserScript::initParser(d_parser);
+  try {
+    d_parser.DefineVar("x", d_x.data());
+    for (int j = 0; j < parameters.size(); j++)
+      d_parser.DefineVar(parameters.at(j).toStdString(),
+                         d_params[static_cast<size_t>(j)].data());
+    d_parser.SetExpr(expression.toStdString());
+    // compile right away; syntax errors and unknown variables throw here
+    d_parser.Eval();
+    d_valid = true;
+  } catch (mu::ParserError &) {
+  }
+}
+
+bool FitModel::evaluate(const double *params, const double *x, int n,
+                        double *y) {
+  if (!d_valid) return false;
+  const int count = std::min(n, chunk_size);
+  for (size_t j = 0; j < d_params.size(); j++)
+    std::fill(d_params[j].begin(), d_params[j].begin() + count, params[j]);
+  try {
+    for (int start = 0; start < n; start += chunk_size) {
+      const int length = std::min(chunk_size, n - start);
+      std::memcpy(d_x.data(), x + start,
+                  static_cast<size_t>(length) * sizeof(double));
+      d_parser.Eval(y + start, length);
+    }
+  } catch (mu::ParserError &) {
+    return false;
+  }
+  return true;
+}
+
+bool FitModel::jacobian(const double *params, const double *x,
+                        const double *sigma, int n, gsl_matrix *J) {
+  if (!d_valid) return false;
+  d_upper.resize(static_cast<size_t>(n));
+  d_lower.resize(static_cast<size_t>(n));
+  std::vector<double> shifted(params, params + d_params.size());
+  for (size_t j = 0; j < d_params.size(); j++) {
+    // step balancing truncation and rounding error of central differences;
+    // divide by the distance of the rounded points, not by 2 * step
+    const double p = params[j];
+    const double step = GSL_ROOT3_DBL_EPSILON * std::max(std::fabs(p), 1.0);
+    const double upper = p + step;
+    const double lower = p - step;
+    shifted[j] = upper;
+    if (!evaluate(shifted.data(), x, n, d_upper.data())) return false;
+    shifted[j] = lower;
+    if (!evaluate(shifted.data(), x, n, d_lower.data())) return false;
+    shifted[j] = p;
+
+    const double width = upper - lower;
+    for (int i = 0; i < n; i++)
+      gsl_matrix_set(J, static_cast<size_t>(i), j,
+                     (d_upper[static_cast<size_t>(i)] -
+                      d_lower[static_cast<size_t>(i)]) /
+                         width / sigma[i]);
+  }
+  return true;
+}
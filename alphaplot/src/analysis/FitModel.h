@@ -0,0 +1,71 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Compiled evaluation of user-defined fit functions */
+
+#ifndef FITMODEL_H
+#define FITMODEL_H
+
+#include <gsl/gsl_matrix.h>
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+#include <../3rdparty/muparser/muParser.h>
+
+//! Evaluates a user-defined fit function for many data points at once
+/**
+ * The formula is compiled once by muParser, with "x" and every fit parameter
+ * bound to plain double arrays. An evaluation then copies the parameters
+ * and a chunk of x values into those arrays and runs the bulk mode of
+ * mu::ParserBase::Eval() over the chunk, instead of setting variables and
+ * converting a QVariant for every point like Script::eval().
+ *
+ * Formulas muParser can't evaluate that way (multiple statements, unknown
+ * variables, ...) leave the model invalid; the caller then falls back to
+ * evaluating its Script point by point, which also reports the error.
+ *
+ * A model must not be used by more than one thread at a time.
+ */
+class FitModel {
+ public:
+  FitModel(const QString &formula, const QStringList &parameters);
+
+  //! Whether evaluate() and jacobian() can be used
+  bool isValid() const { return d_valid; }
+
+  //! Compute y[i] = f(x[i]; params) for i = 0 ... n-1
+  bool evaluate(const double *params, const double *x, int n, double *y);
+
+  //! Compute the Jacobian J(i, j) = df(x[i]; params)/dparams[j] / sigma[i]
+  /**
+   * The derivatives are central differences; every row of J is computed by
+   * two bulk evaluations per parameter.
+   */
+  bool jacobian(const double *params, const double *x, const double *sigma,
+                int n, gsl_matrix *J);
+
+ private:
+  mu::Parser d_parser;
+  //! chunk of x values bound to the variable "x"
+  std::vector<double> d_x;
+  //! parameter values bound to the parameter variables, one array each
+  std::vector<std::vector<double>> d_params;
+  //! buffers for the perturbed evaluations of jacobian()
+  std::vector<double> d_upper, d_lower;
+  bool d_valid;
+};
+
+#endif  // FITMODEL_H
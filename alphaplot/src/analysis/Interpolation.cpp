@@ -113,7 +113,7 @@ void Interpolation::setMethod(const InterpolationMethod &method) {
   d_min_points = min_points;
 }
 
-void Interpolation::calculateOutputData(double *x, double *y) {
+bool Interpolation::calculateOutputData(double *x, double *y) {
   gsl_interp_accel *acc = gsl_interp_accel_alloc();
   const gsl_interp_type *method = nullptr;
   switch (d_method) {
@@ -151,6 +151,7 @@ void Interpolation::calculateOutputData(double *x, double *y) {
 
   gsl_spline_free(interp);
   gsl_interp_accel_free(acc);
+  return true;
 }
 
 bool Interpolation::isDataAcceptable() {
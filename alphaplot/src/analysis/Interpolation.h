@@ -51,7 +51,7 @@ class Interpolation : public Filter {
 
  private:
   void init(const InterpolationMethod &method);
-  void calculateOutputData(double *x, double *y);
+  bool calculateOutputData(double *x, double *y);
 
   //! the interpolation method
   InterpolationMethod d_method;
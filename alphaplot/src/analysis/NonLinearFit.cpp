@@ -97,6 +97,17 @@ void NonLinearFit::setParametersList(const QStringList &lst) {
 
 void NonLinearFit::calculateFitCurveData(const std::vector<double> &par,
                                          double *X, double *Y) {
+  if (hasCompiledModel()) {
+    if (d_gen_function) {
+      double X0 = d_x[0];
+      double step = (d_x[d_n - 1] - X0) / (d_points - 1);
+      for (int i = 0; i < d_points; i++) X[i] = X0 + i * step;
+    } else {
+      for (int i = 0; i < d_points; i++) X[i] = d_x[i];
+    }
+    if (d_models.front()->evaluate(par.data(), X, d_points, Y)) return;
+  }
+
   for (int i = 0; i < d_p; i++)
     d_script->setDouble(par[i], d_param_names[i].toUtf8());
 
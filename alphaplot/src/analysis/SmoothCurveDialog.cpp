@@ -33,6 +33,7 @@
 #include "SmoothFilter.h"
 #include "scripting/MyParser.h"
 
+#include <QCheckBox>
 #include <QComboBox>
 #include <QGroupBox>
 #include <QLabel>
@@ -82,7 +83,9 @@ SmoothCurveDialog::SmoothCurveDialog(int method, QWidget *parent,
 
     gl1->addWidget(new QLabel(tr("Color")), 4, 0);
     gl1->addWidget(boxColor, 4, 1);
-    gl1->setRowStretch(5, 1);
+    boxAllColumns = new QCheckBox(tr("Smooth all &Y columns of the table"));
+    gl1->addWidget(boxAllColumns, 5, 0, 1, 2);
+    gl1->setRowStretch(6, 1);
   } else {
     gl1->addWidget(new QLabel(tr("Points")), 1, 0);
     boxPointsLeft = new QSpinBox();
@@ -93,7 +96,9 @@ SmoothCurveDialog::SmoothCurveDialog(int method, QWidget *parent,
 
     gl1->addWidget(new QLabel(tr("Color")), 2, 0);
     gl1->addWidget(boxColor, 2, 1);
-    gl1->setRowStretch(3, 1);
+    boxAllColumns = new QCheckBox(tr("Smooth all &Y columns of the table"));
+    gl1->addWidget(boxAllColumns, 3, 0, 1, 2);
+    gl1->setRowStretch(4, 1);
   }
   gl1->setColumnStretch(2, 1);
 
@@ -129,6 +134,7 @@ void SmoothCurveDialog::smooth() {
     sf->setSmoothPoints(boxPointsLeft->value());
 
   sf->setColor(boxColor->currentIndex());
+  sf->setSmoothAllColumns(boxAllColumns->isChecked());
   sf->run();
   delete sf;
 }
@@ -32,6 +32,7 @@
 #include <QDialog>
 
 class QPushButton;
+class QCheckBox;
 class QComboBox;
 class QSpinBox;
 class AxisRect2D;
@@ -52,6 +53,7 @@ class SmoothCurveDialog : public QDialog {
   QComboBox* boxName;
   QSpinBox *boxPointsLeft, *boxPointsRight, *boxOrder;
   ColorBox* boxColor;
+  QCheckBox* boxAllColumns;
 
  public slots:
   void setAxisRect(AxisRect2D* axisrect);
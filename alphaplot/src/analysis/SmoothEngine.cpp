@@ -0,0 +1,124 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Moving average and Savitzky-Golay smoothing kernels */
+
+#include "SmoothEngine.h"
+
+#include <QVector>
+#include <QtConcurrent>
+#include <QtNumeric>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace {
+// points per chunk; enough work to be worth a thread, and keeps the running
+// sums of the moving average short
+const int chunk_size = 1 << 16;
+}  // namespace
+
+void SmoothEngine::movingAverage(const double *y, double *result, int n,
+                                 int points) {
+  const int half = points / 2;
+  forEachChunk(n, [&](int begin, int end) {
+    const int first = std::max(0, begin - half);
+    const int last = std::min(n, end + half);
+    // running sums of the deviations from the first finite point of the
+    // chunk; the offset keeps the differences of the sums accurate for data
+    // with a large baseline. Infinite and NaN points are only counted, so
+    // they can't spoil the sums of the windows after them; the windows
+    // holding one are summed up one by one
+    double base = 0.0;
+    for (int i = first; i < last; i++)
+      if (qIsFinite(y[i])) {
+        base = y[i];
+        break;
+      }
+    std::vector<double> sums(static_cast<size_t>(last - first + 1));
+    std::vector<int> non_finite(static_cast<size_t>(last - first + 1));
+    sums[0] = 0.0;
+    non_finite[0] = 0;
+    for (int i = first; i < last; i++) {
+      const bool finite = qIsFinite(y[i]);
+      sums[i - first + 1] = sums[i - first] + (finite ? y[i] - base : 0.0);
+      non_finite[i - first + 1] = non_finite[i - first] + (finite ? 0 : 1);
+    }
+
+    for (int i = begin; i < end; i++) {
+      const int width = std::min(half, std::min(i, n - 1 - i));
+      const int from = i - width - first, to = i + width + 1 - first;
+      if (non_finite[to] != non_finite[from]) {
+        double sum = 0.0;
+        for (int j = i - width; j <= i + width; j++) sum += y[j];
+        result[i] = sum / static_cast<double>(2 * width + 1);
+        continue;
+      }
+      result[i] = base + (sums[to] - sums[from]) /
+                             static_cast<double>(2 * width + 1);
+    }
+  });
+}
+
+void SmoothEngine::savitzkyGolay(const double *y, double *result, int n,
+                                 const double *coefficients, int left,
+                                 int right) {
+  const int points = left + right + 1;
+  auto edge = [&](int i) {
+    double convolution = 0.0;
+    for (int k = 0; k < points; k++) {
+      const int j = i - left + k;
+      if (j >= 0 && j < n) convolution += coefficients[k] * y[j];
+    }
+    result[i] = convolution;
+  };
+
+  forEachChunk(n, [&](int begin, int end) {
+    // points whose whole window lies inside the data
+    const int inner_begin = std::min(end, std::max(begin, left));
+    const int inner_end = std::max(inner_begin, std::min(end, n - right));
+
+    for (int i = begin; i < inner_begin; i++) edge(i);
+
+    // apply the coefficients tap by tap to the whole run; this adds the
+    // products in the same order as edge() does
+    double *out = result + inner_begin;
+    const int length = inner_end - inner_begin;
+    std::fill(out, out + length, 0.0);
+    for (int k = 0; k < points; k++) {
+      const double c = coefficients[k];
+      const double *in = y + inner_begin - left + k;
+      for (int i = 0; i < length; i++) out[i] += c * in[i];
+    }
+
+    for (int i = inner_end; i < end; i++) edge(i);
+  });
+}
+
+void SmoothEngine::forEachChunk(
+    int n, const std::function<void(int, int)> &function) {
+  if (n <= 0) return;
+  const int chunks = (n - 1) / chunk_size + 1;
+  auto chunk = [&](const int &index) {
+    const int begin = index * chunk_size;
+    function(begin, std::min(n, begin + chunk_size));
+  };
+  if (chunks == 1) {
+    chunk(0);
+    return;
+  }
+  QVector<int> indices(chunks);
+  std::iota(indices.begin(), indices.end(), 0);
+  QtConcurrent::blockingMap(indices, chunk);
+}
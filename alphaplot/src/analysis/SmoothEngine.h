@@ -0,0 +1,57 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Moving average and Savitzky-Golay smoothing kernels */
+
+#ifndef SMOOTHENGINE_H
+#define SMOOTHENGINE_H
+
+#include <functional>
+
+//! Window smoothing of uniformly sampled data
+/**
+ * The data is split into chunks which are smoothed on the threads of the
+ * global thread pool. Every chunk reads the points of its neighbours that
+ * fall into the windows of its first and last points (the halo), but only
+ * writes its own results, so the output is the same as a serial run.
+ *
+ * Input and result must not overlap.
+ */
+class SmoothEngine {
+ public:
+  //! Moving average over 'points' / 2 neighbours on each side
+  /**
+   * Near the edges the window shrinks symmetrically, so the first and last
+   * points are kept as they are. Each chunk keeps running sums of its points
+   * and halo, which makes the cost independent of the window width.
+   */
+  static void movingAverage(const double *y, double *result, int n,
+                            int points);
+
+  //! Convolve with the 'left' + 'right' + 1 Savitzky-Golay coefficients
+  /**
+   * Points outside the data are taken as zero. Away from the edges the
+   * coefficients are applied one after the other to whole runs of points,
+   * which the compiler turns into vectorized multiply-adds.
+   */
+  static void savitzkyGolay(const double *y, double *result, int n,
+                            const double *coefficients, int left, int right);
+
+ private:
+  //! Call function(begin, end) for the chunks of 0 ... n-1 on the thread pool
+  static void forEachChunk(int n,
+                           const std::function<void(int, int)> &function);
+};
+
+#endif  // SMOOTHENGINE_H
@@ -34,10 +34,17 @@
 #include <QMessageBox>
 
 #include <gsl/gsl_blas.h>
-#include <gsl/gsl_fft_halfcomplex.h>
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_poly.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "FFTPlan.h"
+#include "SmoothEngine.h"
+#include "Table.h"
+#include "core/column/Column.h"
+
 SmoothFilter::SmoothFilter(ApplicationWindow *parent, AxisRect2D *axisrect,
                            PlotData::AssociatedData *associateddata, int m)
     : Filter(parent, axisrect) {
@@ -60,6 +67,7 @@ void SmoothFilter::init(int m) {
   d_right_points = 2;
   d_left_points = 2;
   d_polynom_order = 2;
+  d_all_columns = false;
 }
 
 void SmoothFilter::setMethod(int m) {
@@ -74,87 +82,135 @@ void SmoothFilter::setMethod(int m) {
   d_method = static_cast<SmoothMethod>(m);
 }
 
-void SmoothFilter::calculateOutputData(double *x, double *y) {
+bool SmoothFilter::calculateOutputData(double *x, double *y) {
   for (int i = 0; i < d_points; i++) {
     x[i] = d_x[i];
     y[i] = d_y[i];  // filtering frequencies
   }
 
+  return smooth(x, y, d_n);
+}
+
+bool SmoothFilter::smooth(double *x, double *y, int n) {
   switch (static_cast<int>(d_method)) {
     case 1:
       d_explanation = QString::number(d_right_points) + " " + tr("points") +
                       " " + tr("Savitzky-Golay smoothing");
-      smoothSavGol(x, y);
-      break;
+      return smoothSavGol(x, y, n);
     case 2:
       d_explanation = QString::number(d_right_points) + " " + tr("points") +
                       " " + tr("FFT smoothing");
-      smoothFFT(x, y);
-      break;
+      return smoothFFT(x, y, n);
     case 3:
       d_explanation = QString::number(d_right_points) + " " + tr("points") +
                       " " + tr("average smoothing");
-      smoothAverage(x, y);
+      smoothAverage(x, y, n);
       break;
   }
+  return true;
 }
 
-void SmoothFilter::smoothFFT(double *x, double *y) {
-  gsl_fft_real_workspace *work =
-      gsl_fft_real_workspace_alloc(static_cast<size_t>(d_n));
-  gsl_fft_real_wavetable *real =
-      gsl_fft_real_wavetable_alloc(static_cast<size_t>(d_n));
-  // FFT forward
-  gsl_fft_real_transform(y, 1, static_cast<size_t>(d_n), real, work);
-  gsl_fft_real_wavetable_free(real);
+void SmoothFilter::output() {
+  if (d_all_columns && associateddata_)
+    smoothColumns();
+  else
+    Filter::output();
+}
 
-  double df = 1.0 / static_cast<double>(x[1] - x[0]);
-  double lf = df / static_cast<double>(d_right_points);  // frequency cutoff
-  df = 0.5 * df / static_cast<double>(d_n);
+void SmoothFilter::smoothColumns() {
+  Table *table = associateddata_->table;
+  Column *xcol = associateddata_->xcol;
+
+  // the rows of the curve's range with a valid x value, sorted by x
+  QVector<int> rows;
+  for (int i = associateddata_->from; i <= associateddata_->to; i++)
+    if (!xcol->isInvalid(i)) rows << i;
+  std::stable_sort(rows.begin(), rows.end(), [xcol](int a, int b) {
+    return xcol->valueAt(a) < xcol->valueAt(b);
+  });
+  const int n = rows.size();
+  if (n < 2) return;
+
+  QVector<qreal> x(n), y(n), valid_x, valid_y;
+  for (int i = 0; i < n; i++) x[i] = xcol->valueAt(rows.at(i));
+  Column *x_result = new Column(xcol->name(), AlphaPlot::Numeric);
+  x_result->setPlotDesignation(AlphaPlot::X);
+  x_result->replaceValues(0, x);
+
+  // first set the values, then add the columns to the table, otherwise, we
+  // generate too many undo commands
+  QList<Column *> columns;
+  columns << x_result;
+  for (int c = 0; c < table->numCols(); c++) {
+    Column *ycol = table->column(c);
+    if (ycol == xcol || ycol->plotDesignation() != AlphaPlot::Y ||
+        ycol->columnMode() != AlphaPlot::Numeric)
+      continue;
+
+    // invalid y values are left out of the smoothing, not averaged in as
+    // zeros; their rows stay invalid in the result
+    valid_x.clear();
+    valid_y.clear();
+    for (int i = 0; i < n; i++)
+      if (!ycol->isInvalid(rows.at(i))) {
+        valid_x << x.at(i);
+        valid_y << ycol->valueAt(rows.at(i));
+      }
+    if (valid_y.size() < 2) continue;
+    if (!smooth(valid_x.data(), valid_y.data(), valid_y.size())) {
+      qDeleteAll(columns);
+      return;
+    }
 
-  for (int i = 0; i < d_n; i++) {
-    x[i] = d_x[i];
-    y[i] = i * df > lf ? 0 : y[i];  // filtering frequencies
+    for (int i = 0, j = 0; i < n; i++)
+      y[i] = ycol->isInvalid(rows.at(i)) ? 0.0 : valid_y.at(j++);
+    Column *y_result = new Column(ycol->name(), AlphaPlot::Numeric);
+    y_result->setPlotDesignation(AlphaPlot::Y);
+    y_result->replaceValues(0, y);
+    for (int i = 0; i < n; i++)
+      if (ycol->isInvalid(rows.at(i))) y_result->setInvalid(i);
+    columns << y_result;
   }
 
-  gsl_fft_halfcomplex_wavetable *hc =
-      gsl_fft_halfcomplex_wavetable_alloc(static_cast<size_t>(d_n));
-  // FFT inverse
-  gsl_fft_halfcomplex_inverse(y, 1, static_cast<size_t>(d_n), hc, work);
-  gsl_fft_halfcomplex_wavetable_free(hc);
-  gsl_fft_real_workspace_free(work);
-}
-
-void SmoothFilter::smoothAverage(double *, double *y) {
-  int p2 = d_right_points / 2;
-  double m = double(2 * p2 + 1);
-  double aux = 0.0;
-  double *s = new double[static_cast<size_t>(d_n)];
+  if (columns.size() < 2) {
+    delete x_result;
+    return;
+  }
 
-  s[0] = y[0];
-  for (int i = 1; i < p2; i++) {
-    aux = 0.0;
-    for (int j = -i; j <= i; j++) aux += y[i + j];
+  app_->newTable(app_->generateUniqueName(objectName()),
+                 d_explanation + " " + tr("of") + " " + table->name(),
+                 columns);
+}
 
-    s[i] = aux / static_cast<double>(2 * i + 1);
+bool SmoothFilter::smoothFFT(double *x, double *y, int n) {
+  QSharedPointer<FFTPlan> plan = FFTPlan::plan(static_cast<size_t>(n));
+  // FFT forward
+  if (!plan || !plan->realForward(y)) {
+    QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
+                          tr("Could not allocate memory, operation aborted!"));
+    return false;
   }
-  for (int i = p2; i < d_n - p2; i++) {
-    aux = 0.0;
-    for (int j = -p2; j <= p2; j++) aux += y[i + j];
 
-    s[i] = aux / m;
-  }
-  for (int i = d_n - p2; i < d_n - 1; i++) {
-    aux = 0.0;
-    for (int j = d_n - i - 1; j >= i - d_n + 1; j--) aux += y[i + j];
+  double df = 1.0 / static_cast<double>(x[1] - x[0]);
+  double lf = df / static_cast<double>(d_right_points);  // frequency cutoff
+  df = 0.5 * df / static_cast<double>(n);
 
-    s[i] = aux / static_cast<double>(2 * (d_n - i - 1) + 1);
-  }
-  s[d_n - 1] = y[d_n - 1];
+  for (int i = 0; i < n; i++)
+    y[i] = i * df > lf ? 0 : y[i];  // filtering frequencies
 
-  for (int i = 0; i < d_n; i++) y[i] = s[i];
+  // FFT inverse
+  if (!plan->halfComplexInverse(y)) {
+    QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
+                          tr("Could not allocate memory, operation aborted!"));
+    return false;
+  }
+  return true;
+}
 
-  delete[] s;
+void SmoothFilter::smoothAverage(double *, double *y, int n) {
+  std::vector<double> s(static_cast<size_t>(n));
+  SmoothEngine::movingAverage(y, s.data(), n, d_right_points);
+  std::copy(s.begin(), s.end(), y);
 }
 
 /**
@@ -258,7 +314,7 @@ int SmoothFilter::savitzkyGolayCoefficients(int points, int polynom_order,
  * would it help
  * to add an "edge behaviour" option to the UI?)
  */
-void SmoothFilter::smoothSavGol(double *, double *y_inout) {
+bool SmoothFilter::smoothSavGol(double *, double *y_inout, int n) {
   // total number of points in smoothing window
   int points = d_left_points + d_right_points + 1;
 
@@ -267,16 +323,16 @@ void SmoothFilter::smoothSavGol(double *, double *y_inout) {
         app_, tr("AlphaPlot") + " - " + tr("Error"),
         tr("The polynomial order must be lower than the number of left points "
            "plus the number of right points!"));
-    return;
+    return false;
   }
 
-  if (d_n < points) {
+  if (n < points) {
     QMessageBox::critical(app_, tr("AlphaPlot") + " - " + tr("Error"),
                           tr("Tried to smooth over more points "
                              "(left+right+1=%1) than given as input (%2).")
                               .arg(points)
-                              .arg(d_n));
-    return;
+                              .arg(n));
+    return false;
   }
 
   // Savitzky-Golay coefficient matrix, y' = H y
@@ -287,65 +343,28 @@ void SmoothFilter::smoothSavGol(double *, double *y_inout) {
                           tr("Internal error in Savitzky-Golay algorithm.\n") +
                               gsl_strerror(error));
     gsl_matrix_free(h);
-    return;
+    return false;
   }
 
-  // allocate memory for the result (temporary; don't overwrite y_inout while we
-  // still read from it)
-  QVector<double> result(d_n);
-
-  // near left edge: use interpolation of (points) left-most input values
-  // i.e. we deviate from the specified left/right points to use
-  /*
-  for (int i=0; i<d_left_points; i++) {
-          double convolution = 0.0;
-          for (int k=0; k<points; k++)
-                  convolution += gsl_matrix_get(h, i, k) * y_inout[k];
-          result[i] =  convolution;
-  }
-  */
-  // legacy behaviour: handle left edge by zero padding
-  for (int i = 0; i < d_left_points; i++) {
-    double convolution = 0.0;
-    for (int k = d_left_points - i; k < points; k++)
-      convolution +=
-          gsl_matrix_get(h, d_left_points, k) * y_inout[i - d_left_points + k];
-    result[i] = convolution;
-  }
-  // central part: convolve with fixed row of h (as given by number of left
-  // points to use)
-  for (int i = d_left_points; i < d_n - d_right_points; i++) {
-    double convolution = 0.0;
-    for (int k = 0; k < points; k++)
-      convolution +=
-          gsl_matrix_get(h, d_left_points, k) * y_inout[i - d_left_points + k];
-    result[i] = convolution;
-  }
-  // near right edge: use interpolation of (points) right-most input values
-  // i.e. we deviate from the specified left/right points to use
-  /*
-  for (int i=d_n-d_right_points; i<d_n; i++) {
-          double convolution = 0.0;
-          for (int k=0; k<points; k++)
-                  convolution += gsl_matrix_get(h, points-d_n+i, k) *
-  y_inout[d_n-points+k];
-          result[i] = convolution;
-  }
-  */
-  // legacy behaviour: handle right edge by zero padding
-  for (int i = d_n - d_right_points; i < d_n; i++) {
-    double convolution = 0.0;
-    for (int k = 0; i - d_left_points + k < d_n; k++)
-      convolution +=
-          gsl_matrix_get(h, d_left_points, k) * y_inout[i - d_left_points + k];
-    result[i] = convolution;
-  }
-
-  // deallocate memory
+  // convolve with fixed row of h (as given by number of left points to use);
+  // legacy behaviour: handle the edges by zero padding. Using the
+  // interpolation of the (points) left-/rightmost input values instead
+  // would mean convolving with the other rows of h near the edges.
+  QVector<double> coefficients(points);
+  for (int k = 0; k < points; k++)
+    coefficients[k] = gsl_matrix_get(h, static_cast<size_t>(d_left_points),
+                                     static_cast<size_t>(k));
   gsl_matrix_free(h);
 
+  // the result is temporary; don't overwrite y_inout while we still read
+  // from it
+  QVector<double> result(n);
+  SmoothEngine::savitzkyGolay(y_inout, result.data(), n, coefficients.data(),
+                              d_left_points, d_right_points);
+
   // write result into *y_inout
-  qCopy(result.begin(), result.end(), y_inout);
+  std::copy(result.begin(), result.end(), y_inout);
+  return true;
 }
 
 /**
@@ -53,13 +53,23 @@ class SmoothFilter : public Filter {
   void setSmoothPoints(int points, int left_points = 0);
   //! Sets the polynomial order in the Savitky-Golay algorithm.
   void setPolynomOrder(int order);
+  //! Smooth all Y columns of the curve's table instead of just the curve.
+  /**
+   * The results are written to a new table, with the curve's X column
+   * sorted and one smoothed column per numeric Y column.
+   */
+  void setSmoothAllColumns(bool all) { d_all_columns = all; }
 
  private:
   void init(int m);
-  void calculateOutputData(double *x, double *y);
-  void smoothFFT(double *x, double *y);
-  void smoothAverage(double *x, double *y);
-  void smoothSavGol(double *x, double *y);
+  bool calculateOutputData(double *x, double *y);
+  void output();
+  //! Smooth the n points of y with the current method; false on errors
+  bool smooth(double *x, double *y, int n);
+  void smoothColumns();
+  bool smoothFFT(double *x, double *y, int n);
+  void smoothAverage(double *x, double *y, int n);
+  bool smoothSavGol(double *x, double *y, int n);
   void smoothModifiedSavGol(double *x, double *y);
   static int savitzkyGolayCoefficients(int points, int polynom_order,
                                        gsl_matrix *h);
@@ -75,6 +85,9 @@ class SmoothFilter : public Filter {
 
   //! Polynomial order in the Savitzky-Golay algorithm.
   int d_polynom_order;
+
+  //! Whether all Y columns of the curve's table are smoothed.
+  bool d_all_columns;
 };
 
 #endif  // SMOOTHFILTER_H
@@ -41,11 +41,16 @@
 
 #include <gsl/gsl_blas.h>
 #include <gsl/gsl_math.h>
+#include "FitBlocks.h"
 #include "fit_gsl.h"
 #include "Fit.h"
 
+/* The point loops of the callbacks below run on the blocks of           */
+/* FitData::blocks, several threads evaluating distinct points at once.  */
+/* Sums go through FitBlocks::sum(), which adds them in a fixed order.   */
+
 int expd3_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -58,18 +63,19 @@ int expd3_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double t3 = gsl_vector_get(x, 5);
   double y0 = gsl_vector_get(x, 6);
 
-  size_t i;
-  for (i = 0; i < n; i++) {
-    double Yi =
-        A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) + A3 * exp(-X[i] * t3) + y0;
-    gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double Yi = A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) +
+                  A3 * exp(-X[i] * t3) + y0;
+      gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
+    }
+  });
 
   return GSL_SUCCESS;
 }
 
 double expd3_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -82,21 +88,21 @@ double expd3_d(const gsl_vector *x, void *params) {
   double t3 = gsl_vector_get(x, 5);
   double y0 = gsl_vector_get(x, 6);
 
-  size_t i;
-  double val = 0;
-  for (i = 0; i < n; i++) {
-    double dYi = ((A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) +
-                   A3 * exp(-X[i] * t3) + y0) -
-                  Y[i]) /
-                 sigma[i];
-    val += dYi * dYi;
-  }
-
-  return val;
+  return blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double dYi = ((A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) +
+                     A3 * exp(-X[i] * t3) + y0) -
+                    Y[i]) /
+                   sigma[i];
+      val += dYi * dYi;
+    }
+    return val;
+  });
 }
 
 int expd3_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
 
@@ -107,26 +113,27 @@ int expd3_df(const gsl_vector *x, void *params, gsl_matrix *J) {
   double A3 = gsl_vector_get(x, 4);
   double l3 = gsl_vector_get(x, 5);
 
-  size_t i;
-  for (i = 0; i < n; i++) {
-    /* Jacobian matrix J(i,j) = dfi / dxj, */
-    /* where fi = (Yi - yi)/sigma[i],      */
-    /* Yi = A1 * exp(-xi*l1) + A2 * exp(-xi*l2) +y0  */
-    /* and the xj are the parameters (A1,l1,A2,l2,y0) */
-    double t = X[i];
-    double s = sigma[i];
-    double e1 = exp(-t * l1) / s;
-    double e2 = exp(-t * l2) / s;
-    double e3 = exp(-t * l3) / s;
-
-    gsl_matrix_set(J, i, 0, e1);
-    gsl_matrix_set(J, i, 1, -t * A1 * e1);
-    gsl_matrix_set(J, i, 2, e2);
-    gsl_matrix_set(J, i, 3, -t * A2 * e2);
-    gsl_matrix_set(J, i, 4, e3);
-    gsl_matrix_set(J, i, 5, -t * A3 * e3);
-    gsl_matrix_set(J, i, 6, 1 / s);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      /* Jacobian matrix J(i,j) = dfi / dxj, */
+      /* where fi = (Yi - yi)/sigma[i],      */
+      /* Yi = A1 * exp(-xi*l1) + A2 * exp(-xi*l2) +y0  */
+      /* and the xj are the parameters (A1,l1,A2,l2,y0) */
+      double t = X[i];
+      double s = sigma[i];
+      double e1 = exp(-t * l1) / s;
+      double e2 = exp(-t * l2) / s;
+      double e3 = exp(-t * l3) / s;
+
+      gsl_matrix_set(J, i, 0, e1);
+      gsl_matrix_set(J, i, 1, -t * A1 * e1);
+      gsl_matrix_set(J, i, 2, e2);
+      gsl_matrix_set(J, i, 3, -t * A2 * e2);
+      gsl_matrix_set(J, i, 4, e3);
+      gsl_matrix_set(J, i, 5, -t * A3 * e3);
+      gsl_matrix_set(J, i, 6, 1 / s);
+    }
+  });
   return GSL_SUCCESS;
 }
 
@@ -138,7 +145,7 @@ int expd3_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J) {
 }
 
 int expd2_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -149,17 +156,18 @@ int expd2_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double t2 = gsl_vector_get(x, 3);
   double y0 = gsl_vector_get(x, 4);
 
-  size_t i;
-  for (i = 0; i < n; i++) {
-    double Yi = A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) + y0;
-    gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double Yi = A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) + y0;
+      gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
+    }
+  });
 
   return GSL_SUCCESS;
 }
 
 double expd2_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -170,19 +178,19 @@ double expd2_d(const gsl_vector *x, void *params) {
   double t2 = gsl_vector_get(x, 3);
   double y0 = gsl_vector_get(x, 4);
 
-  size_t i;
-  double val = 0;
-  for (i = 0; i < n; i++) {
-    double dYi =
-        ((A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) + y0) - Y[i]) / sigma[i];
-    val += dYi * dYi;
-  }
-
-  return val;
+  return blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double dYi = ((A1 * exp(-X[i] * t1) + A2 * exp(-X[i] * t2) + y0) - Y[i]) /
+                   sigma[i];
+      val += dYi * dYi;
+    }
+    return val;
+  });
 }
 
 int expd2_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
 
@@ -191,24 +199,24 @@ int expd2_df(const gsl_vector *x, void *params, gsl_matrix *J) {
   double A2 = gsl_vector_get(x, 2);
   double l2 = gsl_vector_get(x, 3);
 
-  size_t i;
-
-  for (i = 0; i < n; i++) {
-    /* Jacobian matrix J(i,j) = dfi / dxj, */
-    /* where fi = (Yi - yi)/sigma[i],      */
-    /* Yi = A1 * exp(-xi*l1) + A2 * exp(-xi*l2) +y0  */
-    /* and the xj are the parameters (A1,l1,A2,l2,y0) */
-    double s = sigma[i];
-    double t = X[i];
-    double e1 = exp(-t * l1) / s;
-    double e2 = exp(-t * l2) / s;
-
-    gsl_matrix_set(J, i, 0, e1);
-    gsl_matrix_set(J, i, 1, -t * A1 * e1);
-    gsl_matrix_set(J, i, 2, e2);
-    gsl_matrix_set(J, i, 3, -t * A2 * e2);
-    gsl_matrix_set(J, i, 4, 1 / s);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      /* Jacobian matrix J(i,j) = dfi / dxj, */
+      /* where fi = (Yi - yi)/sigma[i],      */
+      /* Yi = A1 * exp(-xi*l1) + A2 * exp(-xi*l2) +y0  */
+      /* and the xj are the parameters (A1,l1,A2,l2,y0) */
+      double s = sigma[i];
+      double t = X[i];
+      double e1 = exp(-t * l1) / s;
+      double e2 = exp(-t * l2) / s;
+
+      gsl_matrix_set(J, i, 0, e1);
+      gsl_matrix_set(J, i, 1, -t * A1 * e1);
+      gsl_matrix_set(J, i, 2, e2);
+      gsl_matrix_set(J, i, 3, -t * A2 * e2);
+      gsl_matrix_set(J, i, 4, 1 / s);
+    }
+  });
   return GSL_SUCCESS;
 }
 
@@ -219,7 +227,7 @@ int expd2_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J) {
 }
 
 int exp_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -227,16 +235,17 @@ int exp_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double A = gsl_vector_get(x, 0);
   double lambda = gsl_vector_get(x, 1);
   double b = gsl_vector_get(x, 2);
-  size_t i;
-  for (i = 0; i < n; i++) {
-    double Yi = A * exp(-lambda * X[i]) + b;
-    gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double Yi = A * exp(-lambda * X[i]) + b;
+      gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
+    }
+  });
   return GSL_SUCCESS;
 }
 
 double exp_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -244,36 +253,38 @@ double exp_d(const gsl_vector *x, void *params) {
   double A = gsl_vector_get(x, 0);
   double lambda = gsl_vector_get(x, 1);
   double b = gsl_vector_get(x, 2);
-  size_t i;
-  double val = 0;
-  for (i = 0; i < n; i++) {
-    double dYi = ((A * exp(-lambda * X[i]) + b) - Y[i]) / sigma[i];
-    val += dYi * dYi;
-  }
-  return val;
+  return blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double dYi = ((A * exp(-lambda * X[i]) + b) - Y[i]) / sigma[i];
+      val += dYi * dYi;
+    }
+    return val;
+  });
 }
 
 int exp_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
 
   double A = gsl_vector_get(x, 0);
   double lambda = gsl_vector_get(x, 1);
-  size_t i;
-  for (i = 0; i < n; i++) {
-    /* Jacobian matrix J(i,j) = dfi / dxj, */
-    /* where fi = (Yi - yi)/sigma[i],      */
-    /* Yi = A * exp(-lambda * i) + b  */
-    /* and the xj are the parameters (A,lambda,b) */
-
-    double t = X[i];
-    double s = sigma[i];
-    double e = exp(-lambda * t);
-    gsl_matrix_set(J, i, 0, e / s);
-    gsl_matrix_set(J, i, 1, -t * A * e / s);
-    gsl_matrix_set(J, i, 2, 1 / s);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      /* Jacobian matrix J(i,j) = dfi / dxj, */
+      /* where fi = (Yi - yi)/sigma[i],      */
+      /* Yi = A * exp(-lambda * i) + b  */
+      /* and the xj are the parameters (A,lambda,b) */
+
+      double t = X[i];
+      double s = sigma[i];
+      double e = exp(-lambda * t);
+      gsl_matrix_set(J, i, 0, e / s);
+      gsl_matrix_set(J, i, 1, -t * A * e / s);
+      gsl_matrix_set(J, i, 2, 1 / s);
+    }
+  });
   return GSL_SUCCESS;
 }
 
@@ -284,7 +295,7 @@ int exp_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J) {
 }
 
 int gauss_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -294,18 +305,18 @@ int gauss_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double C = gsl_vector_get(x, 2);
   double w = gsl_vector_get(x, 3);
 
-  size_t i;
-
-  for (i = 0; i < n; i++) {
-    double diff = X[i] - C;
-    double Yi = A * exp(-0.5 * diff * diff / (w * w)) + Y0;
-    gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double diff = X[i] - C;
+      double Yi = A * exp(-0.5 * diff * diff / (w * w)) + Y0;
+      gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
+    }
+  });
   return GSL_SUCCESS;
 }
 
 double gauss_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -315,20 +326,20 @@ double gauss_d(const gsl_vector *x, void *params) {
   double C = gsl_vector_get(x, 2);
   double w = gsl_vector_get(x, 3);
 
-  size_t i;
-  double val = 0;
-
-  for (i = 0; i < n; i++) {
-    double diff = X[i] - C;
-    double dYi =
-        ((A * exp(-0.5 * diff * diff / (w * w)) + Y0) - Y[i]) / sigma[i];
-    val += dYi * dYi;
-  }
-  return val;
+  return blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double diff = X[i] - C;
+      double dYi =
+          ((A * exp(-0.5 * diff * diff / (w * w)) + Y0) - Y[i]) / sigma[i];
+      val += dYi * dYi;
+    }
+    return val;
+  });
 }
 
 int gauss_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
 
@@ -336,22 +347,23 @@ int gauss_df(const gsl_vector *x, void *params, gsl_matrix *J) {
   double C = gsl_vector_get(x, 2);
   double w = gsl_vector_get(x, 3);
 
-  size_t i;
-  for (i = 0; i < n; i++) {
-    /* Jacobian matrix J(i,j) = dfi / dxj,     */
-    /* where fi = Yi - yi,                     */
-    /* Yi = y=A*exp[-(Xi-xc)^2/(2*w*w)]+B      */
-    /* and the xj are the parameters (B,A,C,w) */
-
-    double s = sigma[i];
-    double diff = X[i] - C;
-    double e = exp(-0.5 * diff * diff / (w * w)) / s;
-
-    gsl_matrix_set(J, i, 0, 1 / s);
-    gsl_matrix_set(J, i, 1, e);
-    gsl_matrix_set(J, i, 2, diff * A * e / (w * w));
-    gsl_matrix_set(J, i, 3, diff * diff * A * e / (w * w * w));
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      /* Jacobian matrix J(i,j) = dfi / dxj,     */
+      /* where fi = Yi - yi,                     */
+      /* Yi = y=A*exp[-(Xi-xc)^2/(2*w*w)]+B      */
+      /* and the xj are the parameters (B,A,C,w) */
+
+      double s = sigma[i];
+      double diff = X[i] - C;
+      double e = exp(-0.5 * diff * diff / (w * w)) / s;
+
+      gsl_matrix_set(J, i, 0, 1 / s);
+      gsl_matrix_set(J, i, 1, e);
+      gsl_matrix_set(J, i, 2, diff * A * e / (w * w));
+      gsl_matrix_set(J, i, 3, diff * diff * A * e / (w * w * w));
+    }
+  });
   return GSL_SUCCESS;
 }
 
@@ -363,7 +375,7 @@ int gauss_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J) {
 }
 
 int gauss_multi_peak_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   size_t p = static_cast<struct FitData *>(params)->p;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
@@ -375,21 +387,22 @@ int gauss_multi_peak_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double *w2 = new double[peaks];
   double offset = gsl_vector_get(x, p - 1);
 
-  size_t i, j;
-  for (i = 0; i < peaks; i++) {
+  for (size_t i = 0; i < peaks; i++) {
     xc[i] = gsl_vector_get(x, 3 * i + 1);
     double wi = gsl_vector_get(x, 3 * i + 2);
     a[i] = sqrt(M_2_PI) * gsl_vector_get(x, 3 * i) / wi;
     w2[i] = wi * wi;
   }
-  for (i = 0; i < n; i++) {
-    double res = 0;
-    for (j = 0; j < peaks; j++) {
-      double diff = X[i] - xc[j];
-      res += a[j] * exp(-2 * diff * diff / w2[j]);
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double res = 0;
+      for (size_t j = 0; j < peaks; j++) {
+        double diff = X[i] - xc[j];
+        res += a[j] * exp(-2 * diff * diff / w2[j]);
+      }
+      gsl_vector_set(f, i, (res + offset - Y[i]) / sigma[i]);
     }
-    gsl_vector_set(f, i, (res + offset - Y[i]) / sigma[i]);
-  }
+  });
   delete[] a;
   delete[] xc;
   delete[] w2;
@@ -397,7 +410,7 @@ int gauss_multi_peak_f(const gsl_vector *x, void *params, gsl_vector *f) {
 }
 
 double gauss_multi_peak_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   size_t p = static_cast<struct FitData *>(params)->p;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
@@ -409,32 +422,33 @@ double gauss_multi_peak_d(const gsl_vector *x, void *params) {
   double *w2 = new double[peaks];
   double offset = gsl_vector_get(x, p - 1);
 
-  size_t i, j;
-  double val = 0;
-  for (i = 0; i < peaks; i++) {
+  for (size_t i = 0; i < peaks; i++) {
     xc[i] = gsl_vector_get(x, 3 * i + 1);
     double wi = gsl_vector_get(x, 3 * i + 2);
     a[i] = sqrt(M_2_PI) * gsl_vector_get(x, 3 * i) / wi;
     w2[i] = wi * wi;
   }
-  double t;
-  for (i = 0; i < n; i++) {
-    double res = 0;
-    for (j = 0; j < peaks; j++) {
-      double diff = X[i] - xc[j];
-      res += a[j] * exp(-2 * diff * diff / w2[j]);
+  double sum = blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double res = 0;
+      for (size_t j = 0; j < peaks; j++) {
+        double diff = X[i] - xc[j];
+        res += a[j] * exp(-2 * diff * diff / w2[j]);
+      }
+      double t = (res + offset - Y[i]) / sigma[i];
+      val += t * t;
     }
-    t = (res + offset - Y[i]) / sigma[i];
-    val += t * t;
-  }
+    return val;
+  });
   delete[] a;
   delete[] xc;
   delete[] w2;
-  return val;
+  return sum;
 }
 
 int gauss_multi_peak_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   size_t p = static_cast<struct FitData *>(params)->p;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -444,26 +458,27 @@ int gauss_multi_peak_df(const gsl_vector *x, void *params, gsl_matrix *J) {
   double *xc = new double[peaks];
   double *w = new double[peaks];
 
-  size_t i, j;
-  for (i = 0; i < peaks; i++) {
+  for (size_t i = 0; i < peaks; i++) {
     a[i] = gsl_vector_get(x, 3 * i);
     xc[i] = gsl_vector_get(x, 3 * i + 1);
     w[i] = gsl_vector_get(x, 3 * i + 2);
   }
-  for (i = 0; i < n; i++) {
-    double s = sigma[i];
-    for (j = 0; j < peaks; j++) {
-      double diff = X[i] - xc[j];
-      double w2 = w[j] * w[j];
-      double e = sqrt(M_2_PI) / s * exp(-2 * diff * diff / w2);
-
-      gsl_matrix_set(J, i, 3 * j, e / w[j]);
-      gsl_matrix_set(J, i, 3 * j + 1, 4 * diff * a[j] * e / (w2 * w[j]));
-      gsl_matrix_set(J, i, 3 * j + 2,
-                     a[j] / w2 * e * (4 * diff * diff / w2 - 1));
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double s = sigma[i];
+      for (size_t j = 0; j < peaks; j++) {
+        double diff = X[i] - xc[j];
+        double w2 = w[j] * w[j];
+        double e = sqrt(M_2_PI) / s * exp(-2 * diff * diff / w2);
+
+        gsl_matrix_set(J, i, 3 * j, e / w[j]);
+        gsl_matrix_set(J, i, 3 * j + 1, 4 * diff * a[j] * e / (w2 * w[j]));
+        gsl_matrix_set(J, i, 3 * j + 2,
+                       a[j] / w2 * e * (4 * diff * diff / w2 - 1));
+      }
+      gsl_matrix_set(J, i, p - 1, 1.0 / s);
     }
-    gsl_matrix_set(J, i, p - 1, 1.0 / s);
-  }
+  });
   delete[] a;
   delete[] xc;
   delete[] w;
@@ -478,7 +493,7 @@ int gauss_multi_peak_fdf(const gsl_vector *x, void *params, gsl_vector *f,
 }
 
 int lorentz_multi_peak_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   size_t p = static_cast<struct FitData *>(params)->p;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
@@ -490,20 +505,21 @@ int lorentz_multi_peak_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double *w = new double[peaks];
   double offset = gsl_vector_get(x, p - 1);
 
-  size_t i, j;
-  for (i = 0; i < peaks; i++) {
+  for (size_t i = 0; i < peaks; i++) {
     a[i] = gsl_vector_get(x, 3 * i);
     xc[i] = gsl_vector_get(x, 3 * i + 1);
     w[i] = gsl_vector_get(x, 3 * i + 2);
   }
-  for (i = 0; i < n; i++) {
-    double res = 0;
-    for (j = 0; j < peaks; j++) {
-      double diff = X[i] - xc[j];
-      res += a[j] * w[j] / (4 * diff * diff + w[j] * w[j]);
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double res = 0;
+      for (size_t j = 0; j < peaks; j++) {
+        double diff = X[i] - xc[j];
+        res += a[j] * w[j] / (4 * diff * diff + w[j] * w[j]);
+      }
+      gsl_vector_set(f, i, (res + offset - Y[i]) / sigma[i]);
     }
-    gsl_vector_set(f, i, (res + offset - Y[i]) / sigma[i]);
-  }
+  });
   delete[] a;
   delete[] xc;
   delete[] w;
@@ -511,7 +527,7 @@ int lorentz_multi_peak_f(const gsl_vector *x, void *params, gsl_vector *f) {
 }
 
 double lorentz_multi_peak_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   size_t p = static_cast<struct FitData *>(params)->p;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
@@ -523,30 +539,32 @@ double lorentz_multi_peak_d(const gsl_vector *x, void *params) {
   double *w = new double[peaks];
   double offset = gsl_vector_get(x, p - 1);
 
-  size_t i, j;
-  double val = 0, t;
-  for (i = 0; i < peaks; i++) {
+  for (size_t i = 0; i < peaks; i++) {
     a[i] = gsl_vector_get(x, 3 * i);
     xc[i] = gsl_vector_get(x, 3 * i + 1);
     w[i] = gsl_vector_get(x, 3 * i + 2);
   }
-  for (i = 0; i < n; i++) {
-    double res = 0;
-    for (j = 0; j < peaks; j++) {
-      double diff = X[i] - xc[j];
-      res += a[j] * w[j] / (4 * diff * diff + w[j] * w[j]);
+  double sum = blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double res = 0;
+      for (size_t j = 0; j < peaks; j++) {
+        double diff = X[i] - xc[j];
+        res += a[j] * w[j] / (4 * diff * diff + w[j] * w[j]);
+      }
+      double t = (res + offset - Y[i]) / sigma[i];
+      val += t * t;
     }
-    t = (res + offset - Y[i]) / sigma[i];
-    val += t * t;
-  }
+    return val;
+  });
   delete[] a;
   delete[] xc;
   delete[] w;
-  return GSL_SUCCESS;
+  return sum;
 }
 
 int lorentz_multi_peak_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   size_t p = static_cast<struct FitData *>(params)->p;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -556,27 +574,28 @@ int lorentz_multi_peak_df(const gsl_vector *x, void *params, gsl_matrix *J) {
   double *xc = new double[peaks];
   double *w = new double[peaks];
 
-  size_t i, j;
-  for (i = 0; i < peaks; i++) {
+  for (size_t i = 0; i < peaks; i++) {
     a[i] = gsl_vector_get(x, 3 * i);
     xc[i] = gsl_vector_get(x, 3 * i + 1);
     w[i] = gsl_vector_get(x, 3 * i + 2);
   }
-  for (i = 0; i < n; i++) {
-    double s = sigma[i];
-    for (j = 0; j < peaks; j++) {
-      double diff = X[i] - xc[j];
-      double w2 = w[j] * w[j];
-      double num = 1.0 / (4 * diff * diff + w2);
-      double den = 4 * diff * diff - w2;
-
-      gsl_matrix_set(J, i, 3 * j, w[j] * num / s);
-      gsl_matrix_set(J, i, 3 * j + 1,
-                     8 * diff * a[j] * w[j] * num * sqrt(num) / s);
-      gsl_matrix_set(J, i, 3 * j + 2, den * a[j] * num * num / s);
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double s = sigma[i];
+      for (size_t j = 0; j < peaks; j++) {
+        double diff = X[i] - xc[j];
+        double w2 = w[j] * w[j];
+        double num = 1.0 / (4 * diff * diff + w2);
+        double den = 4 * diff * diff - w2;
+
+        gsl_matrix_set(J, i, 3 * j, w[j] * num / s);
+        gsl_matrix_set(J, i, 3 * j + 1,
+                       8 * diff * a[j] * w[j] * num * sqrt(num) / s);
+        gsl_matrix_set(J, i, 3 * j + 2, den * a[j] * num * num / s);
+      }
+      gsl_matrix_set(J, i, p - 1, 1.0 / s);
     }
-    gsl_matrix_set(J, i, p - 1, 1.0 / s);
-  }
+  });
   delete[] a;
   delete[] xc;
   delete[] w;
@@ -591,15 +610,18 @@ int lorentz_multi_peak_fdf(const gsl_vector *x, void *params, gsl_vector *f,
 }
 
 int user_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  return static_cast<struct FitData *>(params)->fit->evaluate_f(x, f);
+  struct FitData *data = static_cast<struct FitData *>(params);
+  return data->fit->evaluate_f(x, f, data);
 }
 
 double user_d(const gsl_vector *x, void *params) {
-  return static_cast<struct FitData *>(params)->fit->evaluate_d(x);
+  struct FitData *data = static_cast<struct FitData *>(params);
+  return data->fit->evaluate_d(x, data);
 }
 
 int user_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  return static_cast<struct FitData *>(params)->fit->evaluate_df(x, J);
+  struct FitData *data = static_cast<struct FitData *>(params);
+  return data->fit->evaluate_df(x, J, data);
 }
 
 int user_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J) {
@@ -609,7 +631,7 @@ int user_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J) {
 }
 
 int boltzmann_f(const gsl_vector *x, void *params, gsl_vector *f) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -618,17 +640,18 @@ int boltzmann_f(const gsl_vector *x, void *params, gsl_vector *f) {
   double A2 = gsl_vector_get(x, 1);
   double x0 = gsl_vector_get(x, 2);
   double dx = gsl_vector_get(x, 3);
-  size_t i;
-  for (i = 0; i < n; i++) {
-    double Yi = (A1 - A2) / (1 + exp((X[i] - x0) / dx)) + A2;
-    gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      double Yi = (A1 - A2) / (1 + exp((X[i] - x0) / dx)) + A2;
+      gsl_vector_set(f, i, (Yi - Y[i]) / sigma[i]);
+    }
+  });
 
   return GSL_SUCCESS;
 }
 
 double boltzmann_d(const gsl_vector *x, void *params) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *Y = static_cast<struct FitData *>(params)->Y;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
@@ -637,18 +660,19 @@ double boltzmann_d(const gsl_vector *x, void *params) {
   double A2 = gsl_vector_get(x, 1);
   double x0 = gsl_vector_get(x, 2);
   double dx = gsl_vector_get(x, 3);
-  size_t i;
-  double val = 0;
-  for (i = 0; i < n; i++) {
-    double dYi =
-        ((A1 - A2) / (1 + exp((X[i] - x0) / dx)) + A2 - Y[i]) / sigma[i];
-    val += dYi * dYi;
-  }
-  return val;
+  return blocks->sum([&](int, size_t begin, size_t end) {
+    double val = 0;
+    for (size_t i = begin; i < end; i++) {
+      double dYi =
+          ((A1 - A2) / (1 + exp((X[i] - x0) / dx)) + A2 - Y[i]) / sigma[i];
+      val += dYi * dYi;
+    }
+    return val;
+  });
 }
 
 int boltzmann_df(const gsl_vector *x, void *params, gsl_matrix *J) {
-  size_t n = static_cast<struct FitData *>(params)->n;
+  FitBlocks *blocks = static_cast<struct FitData *>(params)->blocks;
   double *X = static_cast<struct FitData *>(params)->X;
   double *sigma = static_cast<struct FitData *>(params)->sigma;
 
@@ -656,22 +680,23 @@ int boltzmann_df(const gsl_vector *x, void *params, gsl_matrix *J) {
   double A2 = gsl_vector_get(x, 1);
   double x0 = gsl_vector_get(x, 2);
   double dx = gsl_vector_get(x, 3);
-  size_t i;
-  for (i = 0; i < n; i++) {
-    /* Jacobian matrix J(i,j) = dfi / dxj,         */
-    /* where fi = Yi - yi,                         */
-    /* Yi = (A1-A2)/(1+exp((X[i]-x0)/dx)) + A2     */
-    /* and the xj are the parameters (A1,A2,x0,dx) */
-    double s = sigma[i];
-    double diff = X[i] - x0;
-    double e = exp(diff / dx);
-    double r = 1 / (1 + e);
-    double aux = (A1 - A2) * e * r * r / (dx * s);
-    gsl_matrix_set(J, i, 0, r / s);
-    gsl_matrix_set(J, i, 1, (1 - r) / s);
-    gsl_matrix_set(J, i, 2, aux);
-    gsl_matrix_set(J, i, 3, aux * diff / dx);
-  }
+  blocks->run([&](int, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      /* Jacobian matrix J(i,j) = dfi / dxj,         */
+      /* where fi = Yi - yi,                         */
+      /* Yi = (A1-A2)/(1+exp((X[i]-x0)/dx)) + A2     */
+      /* and the xj are the parameters (A1,A2,x0,dx) */
+      double s = sigma[i];
+      double diff = X[i] - x0;
+      double e = exp(diff / dx);
+      double r = 1 / (1 + e);
+      double aux = (A1 - A2) * e * r * r / (dx * s);
+      gsl_matrix_set(J, i, 0, r / s);
+      gsl_matrix_set(J, i, 1, (1 - r) / s);
+      gsl_matrix_set(J, i, 2, aux);
+      gsl_matrix_set(J, i, 3, aux * diff / dx);
+    }
+  });
   return GSL_SUCCESS;
 }
 
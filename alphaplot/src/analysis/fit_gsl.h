@@ -39,6 +39,8 @@
 #include <gsl/gsl_matrix.h>
 
 class Fit;
+class FitBlocks;
+class FitModel;
 
 //! Structure for fitting data
 struct FitData {
@@ -48,6 +50,8 @@ struct FitData {
   double *Y;
   double *sigma;  // standard deviation of Y (for weighting)
   Fit *fit;
+  FitBlocks *blocks;  // splits the point loops over threads
+  FitModel **models;  // compiled user function, one per worker of blocks
 };
 
 int expd3_fdf(const gsl_vector *x, void *params, gsl_vector *f, gsl_matrix *J);
@@ -1,8 +1,10 @@
 #include "AprojHandler.h"
 
+#include <QBuffer>
 #include <QFile>
 #include <QMdiSubWindow>
 #include <QMessageBox>
+#include <QThread>
 
 #include "2Dplot/Layout2D.h"
 #include "3Dplot/Layout3D.h"
@@ -11,11 +13,28 @@
 #include "Matrix.h"
 #include "Note.h"
 #include "Table.h"
+#include "core/GzipDevice.h"
+#include "future/core/Project.h"
 #include "future/lib/XmlStreamReader.h"
 #include "future/lib/XmlStreamWriter.h"
 
 const QString AprojHandler::xmlschemafile_ = ":xmlschema/aproj.xsd";
 
+namespace {
+// size from which on project files are opened lazily
+const qint64 lazy_loading_bytes = qint64(16) << 20;
+
+// Whether to leave the table and matrix data of a project file on disk until
+// it is needed. Controlled by the global setting "lazy_loading" (default:
+// true); only uncompressed files of some size qualify, compressed ones can
+// not be read from at random.
+bool lazyLoading(const QString &filename) {
+  QVariant value = Project::global("lazy_loading");
+  if (value.isValid() && !value.toBool()) return false;
+  return QFileInfo(filename).size() >= lazy_loading_bytes;
+}
+}  // namespace
+
 AprojHandler::AprojHandler(ApplicationWindow *app)
     : QObject(app), app_(app), recursivecount_(0) {
   Q_ASSERT(app_);
@@ -24,19 +43,8 @@ AprojHandler::AprojHandler(ApplicationWindow *app)
 AprojHandler::~AprojHandler() {}
 
 ApplicationWindow *AprojHandler::openproject(const QString &filename) {
-  QFile *file = nullptr;
-  if (filename.endsWith(".gz", Qt::CaseInsensitive) ||
-      filename.endsWith(".gz~", Qt::CaseInsensitive)) {
-    file = openCompressedFile(filename);
-    if (!file) return nullptr;
-  } else {
-    file = new QFile(filename);
-    if (!file->open(QIODevice::ReadOnly | QFile::Text)) {
-      qDebug() << "unable to open " << filename;
-      delete file;
-      return nullptr;
-    }
-  }
+  QList<XmlPagedData> paged;
+  QIODevice *file = openProjectFile(filename, &paged);
 
   // check xml schema
   /*if (!checkXmlSchema(filename)) {
@@ -83,7 +91,7 @@ ApplicationWindow *AprojHandler::openproject(const QString &filename) {
   // rename project folder item
   FolderTreeWidgetItem *item = app->getProjectRootItem();
 
-  Folder *cfolder = readxmlstream(app, file, filename, item);
+  Folder *cfolder = readxmlstream(app, file, filename, item, paged);
   file->close();
   delete file;
 
@@ -153,15 +161,9 @@ void AprojHandler::appendproject(const QString &filename) {
     return;
   }
 
-  QFile *file = nullptr;
-  if (filename.endsWith(".gz", Qt::CaseInsensitive) ||
-      filename.endsWith(".gz~", Qt::CaseInsensitive)) {
-    file = openCompressedFile(filename);
-    if (!file) return;
-  } else {
-    file = new QFile(filename);
-    file->open(QIODevice::ReadOnly);
-  }
+  QList<XmlPagedData> paged;
+  QIODevice *file = openProjectFile(filename, &paged);
+  if (!file) return;
 
   app_->recentProjects.removeAll(filename);
   app_->recentProjects.push_front(filename);
@@ -175,7 +177,7 @@ void AprojHandler::appendproject(const QString &filename) {
       static_cast<FolderTreeWidgetItem *>(cfolder->folderTreeWidgetItem());
   app_->blockFolderviewsignals(true);
   app_->blockSignals(true);
-  readxmlstream(app_, file, filename, item);
+  readxmlstream(app_, file, filename, item, paged);
 
   file->close();
   delete file;
@@ -189,7 +191,7 @@ void AprojHandler::appendproject(const QString &filename) {
 
 QStringList AprojHandler::checkbeforeappendproject(const QString &filename) {
   QStringList conflictlist, windowlist;
-  QFile *file = nullptr;
+  QIODevice *file = nullptr;
   if (filename.endsWith(".gz", Qt::CaseInsensitive) ||
       filename.endsWith(".gz~", Qt::CaseInsensitive)) {
     file = openCompressedFile(filename);
@@ -313,13 +315,15 @@ MyWidget *AprojHandler::opentemplate(const QString &filename) {
   return mywidget;
 }
 
-Folder *AprojHandler::readxmlstream(ApplicationWindow *app, QFile *file,
+Folder *AprojHandler::readxmlstream(ApplicationWindow *app, QIODevice *file,
                                     const QString &filename,
-                                    FolderTreeWidgetItem *rootitem) {
+                                    FolderTreeWidgetItem *rootitem,
+                                    const QList<XmlPagedData> &paged) {
   Folder *cfolder = nullptr;
   QFileInfo fileinfo(filename);
   std::unique_ptr<XmlStreamReader> xmlreader =
       std::unique_ptr<XmlStreamReader>(new XmlStreamReader(file));
+  xmlreader->setPagedData(paged);
   QXmlStreamReader::TokenType token;
   while (!xmlreader->atEnd()) {
     token = xmlreader->readNext();
@@ -439,48 +443,113 @@ Folder *AprojHandler::readxmlstream(ApplicationWindow *app, QFile *file,
   return cfolder;
 }
 
-QFile *AprojHandler::openCompressedFile(const QString &filename) {
-  QTemporaryFile *tempfile = new QTemporaryFile;
-  std::unique_ptr<QFile> file = std::unique_ptr<QFile>(new QFile(filename));
-  if (!file->open(QIODevice::ReadOnly) || !tempfile->open()) {
+QIODevice *AprojHandler::openProjectFile(const QString &filename,
+                                         QList<XmlPagedData> *paged) {
+  if (filename.endsWith(".gz", Qt::CaseInsensitive) ||
+      filename.endsWith(".gz~", Qt::CaseInsensitive))
+    return openCompressedFile(filename);
+
+  if (lazyLoading(filename)) {
+    // only the rest of the document is parsed now, the column and matrix
+    // data is read back when it is first accessed
+    QByteArray document;
+    if (XmlPagedData::strip(filename, &document, paged)) {
+      QBuffer *buffer = new QBuffer();
+      buffer->setData(document);
+      buffer->open(QIODevice::ReadOnly);
+      return buffer;
+    }
+  }
+
+  QFile *file = new QFile(filename);
+  if (!file->open(QIODevice::ReadOnly | QFile::Text)) {
     qDebug() << "unable to open " << filename;
-    delete tempfile;
+    delete file;
     return nullptr;
   }
-  std::unique_ptr<QByteArray> bytearray =
-      std::unique_ptr<QByteArray>(new QByteArray);
-
-  *bytearray.get() = file->readAll();
-  tempfile->write(qUncompress(*bytearray.get()));
-  bytearray->clear();
-  tempfile->reset();
-  return tempfile;
+  return file;
+}
+
+QIODevice *AprojHandler::openCompressedFile(const QString &filename) {
+  // inflate while the xml is read instead of unpacking the whole file first
+  QFile *file = new QFile(filename);
+  GzipDevice *device = new GzipDevice(file);
+  file->setParent(device);
+  if (!device->open(QIODevice::ReadOnly)) {
+    qDebug() << "unable to open " << filename << device->errorString();
+    delete device;
+    return nullptr;
+  }
+  return device;
 }
 
 bool AprojHandler::saveproject(const QString &filename, Folder *folder) {
+  errorstring_.clear();
+  // data not read yet has to be copied from somewhere else than the file
+  // being overwritten
+  if (!XmlPagedData::detach(filename)) {
+    errorstring_ = tr("The data not read yet from %1 could not be copied "
+                      "aside, so the file was left as it is.")
+                       .arg(filename);
+    return false;
+  }
   bool compress = false;
   if (filename.endsWith(".gz")) compress = true;
 
   std::unique_ptr<XmlStreamWriter> xmlwriter;
   std::unique_ptr<QFile> file = std::unique_ptr<QFile>(new QFile(filename));
-  if (!file->open(QIODevice::WriteOnly | QIODevice::Text)) {
-    qDebug() << "failed to open xml file for writing";
+  std::unique_ptr<GzipDevice> gzip;
+  if (!file->open(compress ? QIODevice::WriteOnly
+                           : QIODevice::WriteOnly | QIODevice::Text)) {
+    errorstring_ = tr("Could not open %1 for writing: %2")
+                       .arg(filename, file->errorString());
     return false;
   }
-  std::unique_ptr<QByteArray> bytearray =
-      std::unique_ptr<QByteArray>(new QByteArray);
 
   if (!compress) {
     // Uncompressed file save
     xmlwriter =
         std::unique_ptr<XmlStreamWriter>(new XmlStreamWriter(file.get()));
   } else {
-    // Compressed file save
-    bytearray = std::unique_ptr<QByteArray>(new QByteArray);
+    // Compressed file save, compressed on the fly as the xml is written
+    gzip = std::unique_ptr<GzipDevice>(new GzipDevice(file.get()));
+    gzip->setThreads(QThread::idealThreadCount());
+    if (!gzip->open(QIODevice::WriteOnly)) {
+      errorstring_ = tr("Could not write %1: %2")
+                         .arg(filename, gzip->errorString());
+      return false;
+    }
     xmlwriter =
-        std::unique_ptr<XmlStreamWriter>(new XmlStreamWriter(bytearray.get()));
+        std::unique_ptr<XmlStreamWriter>(new XmlStreamWriter(gzip.get()));
   }
 
+  writeproject(xmlwriter.get(), folder);
+  if (xmlwriter->hasDeferredError()) {
+    errorstring_ = tr("The data of some columns or matrices could not be "
+                      "written to %1.")
+                       .arg(filename);
+    return false;
+  }
+  // Compressed file
+  if (compress) {
+    gzip->close();
+    if (!gzip->flushed()) {
+      errorstring_ = tr("Could not write %1: %2")
+                         .arg(filename, gzip->errorString());
+      return false;
+    }
+  }
+  if (xmlwriter->hasError() || !file->flush()) {
+    errorstring_ = tr("Could not write %1: %2")
+                       .arg(filename, file->errorString());
+    return false;
+  }
+  return true;
+}
+
+QString AprojHandler::errorString() const { return errorstring_; }
+
+void AprojHandler::writeproject(XmlStreamWriter *xmlwriter, Folder *folder) {
   xmlwriter->setCodec("UTF-8");
 
   xmlwriter->setAutoFormatting(false);
@@ -494,18 +563,12 @@ bool AprojHandler::saveproject(const QString &filename, Folder *folder) {
                             QString::number(root->windowCount(true)));
 
   recursivecount_ = 0;
-  saveTreeRecursive(root, xmlwriter.get());
+  saveTreeRecursive(root, xmlwriter);
   xmlwriter->writeStartElement("log");
   xmlwriter->writeAttribute("value", app_->getLogInfoText());
   xmlwriter->writeEndElement();
   xmlwriter->writeEndElement();
   xmlwriter->writeEndDocument();
-  // Compressed file
-  if (compress) {
-    file->write(qCompress(*bytearray.get()));
-  }
-  file->commitTransaction();
-  return true;
 }
 
 void AprojHandler::saveTreeRecursive(Folder *folder,
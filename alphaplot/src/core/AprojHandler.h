@@ -3,15 +3,17 @@
 
 //#include <QAbstractMessageHandler>
 #include <QObject>
+#include <QString>
 
 class ApplicationWindow;
-class QFile;
+class QIODevice;
 class Folder;
 class FolderTreeWidgetItem;
 class XmlStreamWriter;
 class Table;
 class Matrix;
 class MyWidget;
+class XmlPagedData;
 
 class AprojHandler : public QObject {
   Q_OBJECT
@@ -22,23 +24,30 @@ class AprojHandler : public QObject {
   void appendproject(const QString &filename);
   QStringList checkbeforeappendproject(const QString &filename);
   MyWidget *opentemplate(const QString &filename);
-  Folder *readxmlstream(ApplicationWindow *app, QFile *file,
+  Folder *readxmlstream(ApplicationWindow *app, QIODevice *file,
                         const QString &filename,
-                        FolderTreeWidgetItem *rootitem);
+                        FolderTreeWidgetItem *rootitem,
+                        const QList<XmlPagedData> &paged);
 
   bool saveproject(const QString &filename, Folder *folder);
+  //! Why the last saveproject() failed
+  QString errorString() const;
+  void writeproject(XmlStreamWriter *xmlwriter, Folder *folder);
   void saveTreeRecursive(Folder *folder, XmlStreamWriter *xmlwriter);
   bool saveTemplate(const QString &filename, MyWidget *mywidget);
   QList<Table *> tables(ApplicationWindow *app);
   QList<Matrix *> matrixs(ApplicationWindow *app);
 
  private:
-  QFile *openCompressedFile(const QString &filename);
+  QIODevice *openProjectFile(const QString &filename,
+                             QList<XmlPagedData> *paged);
+  QIODevice *openCompressedFile(const QString &filename);
   bool checkXmlSchema(const QString &filename);
 
  private:
   ApplicationWindow *app_;
   int recursivecount_;
+  QString errorstring_;
   static const QString xmlschemafile_;
 };
 
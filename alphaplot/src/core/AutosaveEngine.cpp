@@ -0,0 +1,194 @@
+/* This file is part of AlphaPlot.
+
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Saves projects in the background
+*/
+
+#include "AutosaveEngine.h"
+
+#include <QDebug>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent>
+#include <memory>
+
+#include "core/AprojHandler.h"
+#include "core/GzipDevice.h"
+#include "future/lib/XmlPagedData.h"
+
+namespace {
+// bytes of xml kept for unchanged snapshots between two saves
+const qint64 cache_bytes = qint64(64) << 20;
+}  // namespace
+
+AutosaveEngine::AutosaveEngine(QObject *parent)
+    : QObject(parent), d_cache_hint(0) {
+  connect(&d_watcher, &QFutureWatcher<bool>::finished, this,
+          &AutosaveEngine::saveFinished);
+}
+
+AutosaveEngine::~AutosaveEngine() { d_future.waitForFinished(); }
+
+bool AutosaveEngine::start(AprojHandler *handler, Folder *folder,
+                           const QString &filename) {
+  if (isRunning()) return false;
+
+  QByteArray skeleton;
+  QList<Deferred> deferred;
+  {
+    XmlStreamWriter xmlwriter(&skeleton);
+    xmlwriter.setDeferring(true);
+    handler->writeproject(&xmlwriter, folder);
+    deferred = xmlwriter.takeDeferred();
+  }
+
+  d_filename = filename;
+  d_future = QtConcurrent::run(this, &AutosaveEngine::save, filename,
+                               skeleton, deferred);
+  d_watcher.setFuture(d_future);
+  return true;
+}
+
+void AutosaveEngine::saveFinished() {
+  emit finished(d_future.result(), d_filename);
+}
+
+bool AutosaveEngine::save(const QString &filename, const QByteArray &skeleton,
+                          const QList<Deferred> &deferred) {
+  // written to a temporary file, which replaces the project file on commit()
+  const bool compress = filename.endsWith(".gz");
+  QSaveFile file(filename);
+  if (!file.open(compress ? QIODevice::WriteOnly
+                          : QIODevice::WriteOnly | QIODevice::Text)) {
+    qDebug() << "failed to open" << filename << "for autosave"
+             << file.errorString();
+    return false;
+  }
+  QIODevice *device = &file;
+  std::unique_ptr<GzipDevice> gzip;
+  if (compress) {
+    gzip = std::unique_ptr<GzipDevice>(new GzipDevice(&file));
+    gzip->setThreads(QThread::idealThreadCount());
+    if (!gzip->open(QIODevice::WriteOnly)) {
+      qDebug() << "failed to compress autosave" << gzip->errorString();
+      file.cancelWriting();
+      return false;
+    }
+    device = gzip.get();
+  }
+
+  qint64 total = skeleton.size(), done = 0;
+  foreach (const Deferred &data, deferred) total += data->sizeHint();
+  int percent = 0;
+  emit progress(percent);
+  auto advance = [&](qint64 bytes) {
+    done += bytes;
+    const int now = static_cast<int>(100 * qMin(done, total) / total);
+    if (now != percent) emit progress(percent = now);
+  };
+
+  QList<Fragment> cache;
+  qint64 cached = 0;
+  int position = 0;
+  for (int i = 0; i < deferred.size(); i++) {
+    const QByteArray marker =
+        "<!--" + XmlStreamWriter::placeholder(i) + "-->";
+    const int at = skeleton.indexOf(marker, position);
+    if (at < 0) {
+      qDebug() << "autosave: placeholder" << i << "missing";
+      file.cancelWriting();
+      return false;
+    }
+    if (!writeAll(device, skeleton.constData() + position, at - position) ||
+        !writeDeferred(device, deferred.at(i), &cache, &cached)) {
+      file.cancelWriting();
+      return false;
+    }
+    advance(at - position + deferred.at(i)->sizeHint());
+    position = at + marker.size();
+  }
+  if (!writeAll(device, skeleton.constData() + position,
+                skeleton.size() - position)) {
+    file.cancelWriting();
+    return false;
+  }
+  if (gzip) {
+    gzip->close();
+    if (!gzip->flushed()) {
+      qDebug() << "failed to write compressed file" << gzip->errorString();
+      file.cancelWriting();
+      return false;
+    }
+  }
+  d_cache = cache;
+  advance(total);
+#ifdef Q_OS_WIN
+  // column and matrix data not read yet keeps the project file open, which
+  // can't be replaced on Windows then; elsewhere the open file still reads
+  // the old data after the rename
+  if (!XmlPagedData::detach(filename)) {
+    file.cancelWriting();
+    return false;
+  }
+#endif
+  if (!file.commit()) {
+    qDebug() << "failed to replace" << filename << file.errorString();
+    return false;
+  }
+  return true;
+}
+
+bool AutosaveEngine::writeDeferred(QIODevice *device, const Deferred &data,
+                                   QList<Fragment> *cache, qint64 *cached) {
+  // snapshots mostly come in the same order as last time, so the search
+  // starts after the previous hit
+  for (int i = 0; i < d_cache.size(); i++) {
+    const int index = (d_cache_hint + i) % d_cache.size();
+    const Fragment &fragment = d_cache.at(index);
+    if (!fragment.data->sameAs(*data)) continue;
+    d_cache_hint = index + 1;
+    *cached += fragment.xml.size();
+    *cache << Fragment{data, fragment.xml};
+    return writeAll(device, fragment.xml.constData(), fragment.xml.size());
+  }
+
+  if (*cached + data->sizeHint() > cache_bytes) {
+    // too large to keep, straight to the file
+    QXmlStreamWriter xmlwriter(device);
+    return data->write(&xmlwriter);
+  }
+  QByteArray xml;
+  {
+    QXmlStreamWriter xmlwriter(&xml);
+    if (!data->write(&xmlwriter)) return false;
+  }
+  *cached += xml.size();
+  *cache << Fragment{data, xml};
+  return writeAll(device, xml.constData(), xml.size());
+}
+
+bool AutosaveEngine::writeAll(QIODevice *device, const char *data,
+                              qint64 size) {
+  while (size > 0) {
+    const qint64 written = device->write(data, size);
+    if (written <= 0) {
+      qDebug() << "autosave: write failed" << device->errorString();
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
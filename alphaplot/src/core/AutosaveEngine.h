@@ -0,0 +1,93 @@
+/* This file is part of AlphaPlot.
+
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Saves projects in the background
+*/
+
+#ifndef AUTOSAVEENGINE_H
+#define AUTOSAVEENGINE_H
+
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+
+#include "future/lib/XmlStreamWriter.h"
+
+class AprojHandler;
+class Folder;
+class QIODevice;
+
+//! Writes project files on a worker thread
+/**
+ * start() serializes the project on the calling thread, but without the
+ * table and matrix data: columns and matrices only hand over a snapshot
+ * sharing their data (see XmlStreamWriter::writeDeferred()), which takes no
+ * time. The snapshots are turned into xml and the file is written on the
+ * global thread pool, into a temporary file which replaces the project file
+ * only once it is complete.
+ *
+ * The xml of snapshots whose data did not change since the previous save is
+ * reused instead of being generated again, up to a memory budget.
+ */
+class AutosaveEngine : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit AutosaveEngine(QObject *parent = nullptr);
+  ~AutosaveEngine();
+
+  //! Start saving folder and its subfolders to filename
+  /**
+   * Returns false without saving if the previous save is still running.
+   */
+  bool start(AprojHandler *handler, Folder *folder, const QString &filename);
+  bool isRunning() const { return d_future.isRunning(); }
+  //! Block until the running save, if any, is done
+  void waitForFinished() { d_future.waitForFinished(); }
+
+ signals:
+  //! Percentage of the project written so far
+  void progress(int percent);
+  void finished(bool ok, const QString &filename);
+
+ private slots:
+  void saveFinished();
+
+ private:
+  typedef QSharedPointer<const XmlStreamWriter::DeferredData> Deferred;
+  //! Xml of a snapshot written before
+  struct Fragment {
+    Deferred data;
+    QByteArray xml;
+  };
+
+  //! Write the document, run on the thread pool
+  bool save(const QString &filename, const QByteArray &skeleton,
+            const QList<Deferred> &deferred);
+  //! Write the xml of data, from the cache if possible
+  bool writeDeferred(QIODevice *device, const Deferred &data,
+                     QList<Fragment> *cache, qint64 *cached);
+  static bool writeAll(QIODevice *device, const char *data, qint64 size);
+
+  QString d_filename;
+  QFuture<bool> d_future;
+  QFutureWatcher<bool> d_watcher;
+  //! Only touched by save() while it runs
+  QList<Fragment> d_cache;
+  int d_cache_hint;
+};
+
+#endif  // AUTOSAVEENGINE_H
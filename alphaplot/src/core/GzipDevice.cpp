@@ -0,0 +1,293 @@
+/* This file is part of AlphaPlot.
+
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Streaming gzip compression for project files
+*/
+
+#include "GzipDevice.h"
+
+#include <zlib.h>
+
+#include <QtConcurrent>
+#include <climits>
+#include <cstring>
+
+namespace {
+// uncompressed bytes compressed at once
+const int chunk_size = 1 << 20;
+// compressed bytes read from the underlying device at once
+const int input_size = 1 << 18;
+
+//! Whether a stream starting with \c header was written by qCompress()
+/**
+ * qCompress() puts the uncompressed size in front of a zlib stream, so
+ * a zlib header follows at offset 4. A size prefix may begin like a gzip
+ * header, which is only taken for gzip if no zlib header follows.
+ */
+bool isQCompressed(const QByteArray &header) {
+  if (header.size() >= 6) {
+    const uint cmf = uchar(header.at(4));
+    const uint flg = uchar(header.at(5));
+    if (cmf == 0x78 && (cmf * 256 + flg) % 31 == 0) return true;
+  }
+  return !header.startsWith(QByteArray("\x1f\x8b\x08", 3));
+}
+}  // namespace
+
+GzipDevice::GzipDevice(QIODevice *device, QObject *parent)
+    : QIODevice(parent),
+      d_device(device),
+      d_format(QCompress),
+      d_threads(1),
+      d_level(Z_DEFAULT_COMPRESSION),
+      d_error(false),
+      d_wrote(false),
+      d_size_pos(-1),
+      d_size(0),
+      d_adler(0),
+      d_stream(nullptr),
+      d_stream_end(false) {}
+
+GzipDevice::~GzipDevice() {
+  if (isOpen()) close();
+}
+
+void GzipDevice::setFormat(Format format) { d_format = format; }
+
+void GzipDevice::setThreads(int threads) { d_threads = qMax(1, threads); }
+
+void GzipDevice::setCompressionLevel(int level) {
+  d_level = qBound(0, level, 9);
+}
+
+bool GzipDevice::open(OpenMode mode) {
+  mode &= ~QIODevice::Text;
+  if ((mode & QIODevice::ReadWrite) == QIODevice::ReadWrite ||
+      !(mode & QIODevice::ReadWrite)) {
+    setErrorString(tr("Compressed files open either for reading or writing"));
+    return false;
+  }
+  if (!d_device->isOpen() && !d_device->open(mode)) {
+    setErrorString(d_device->errorString());
+    return false;
+  }
+
+  d_error = false;
+  d_wrote = false;
+  if (mode & QIODevice::ReadOnly) {
+    d_stream = new z_stream;
+    std::memset(d_stream, 0, sizeof(z_stream));
+    // skip the uncompressed size qCompress() puts in front of the stream
+    if (isQCompressed(d_device->peek(6))) d_device->read(4);
+    // detect a zlib or gzip header
+    if (inflateInit2(d_stream, 15 + 32) != Z_OK) {
+      delete d_stream;
+      d_stream = nullptr;
+      setErrorString(tr("Could not initialize decompression"));
+      return false;
+    }
+    d_stream_end = false;
+    d_input.clear();
+  } else {
+    d_chunk.reserve(chunk_size);
+    if (d_format == QCompress) {
+      d_size_pos = d_device->isSequential() ? -1 : d_device->pos();
+      d_size = 0;
+      d_adler = adler32(0L, Z_NULL, 0);
+      // size, filled in by close(), and a zlib header for the default level
+      if (d_device->write(QByteArray("\0\0\0\0\x78\x9c", 6)) != 6) {
+        setErrorString(d_device->errorString());
+        return false;
+      }
+    }
+  }
+  return QIODevice::open(mode);
+}
+
+void GzipDevice::close() {
+  if (!isOpen()) return;
+  if (openMode() & QIODevice::WriteOnly) {
+    // an empty file still needs one (empty) member to be valid gzip
+    if (!d_chunk.isEmpty() ||
+        (d_format == Gzip && !d_wrote && d_members.isEmpty()))
+      submitChunk();
+    writeMembers(0);
+    d_chunk = QByteArray();
+    if (d_format == QCompress) writeTrailer();
+  } else {
+    inflateEnd(d_stream);
+    delete d_stream;
+    d_stream = nullptr;
+    d_input.clear();
+  }
+  QIODevice::close();
+}
+
+bool GzipDevice::atEnd() const {
+  if (!isOpen()) return true;
+  if (openMode() & QIODevice::WriteOnly) return false;
+  return d_error || (d_stream_end && d_stream->avail_in == 0 &&
+                     d_device->atEnd() && QIODevice::bytesAvailable() == 0);
+}
+
+qint64 GzipDevice::readData(char *data, qint64 maxlen) {
+  if (d_error || !d_stream) return -1;
+  const uInt wanted = static_cast<uInt>(qMin<qint64>(maxlen, INT_MAX));
+  d_stream->next_out = reinterpret_cast<Bytef *>(data);
+  d_stream->avail_out = wanted;
+  while (d_stream->avail_out > 0) {
+    if (d_stream->avail_in == 0 && !fillInput()) {
+      if (!d_stream_end) fail(tr("Unexpected end of compressed data"));
+      break;
+    }
+    if (d_stream_end) {
+      // another gzip member follows
+      inflateReset(d_stream);
+      d_stream_end = false;
+    }
+    const int status = inflate(d_stream, Z_NO_FLUSH);
+    if (status == Z_STREAM_END) {
+      d_stream_end = true;
+    } else if (status != Z_OK) {
+      fail(tr("Corrupt compressed data: %1")
+               .arg(QString::fromLatin1(d_stream->msg ? d_stream->msg : "")));
+      break;
+    }
+  }
+  const qint64 produced = wanted - d_stream->avail_out;
+  return (produced == 0 && d_error) ? -1 : produced;
+}
+
+qint64 GzipDevice::writeData(const char *data, qint64 len) {
+  if (d_error) return -1;
+  qint64 written = 0;
+  while (written < len) {
+    const int count = static_cast<int>(
+        qMin<qint64>(len - written, chunk_size - d_chunk.size()));
+    d_chunk.append(data + written, count);
+    written += count;
+    if (d_chunk.size() >= chunk_size) submitChunk();
+    if (d_error) return -1;
+  }
+  return len;
+}
+
+void GzipDevice::submitChunk() {
+  const QByteArray chunk = d_chunk;
+  d_chunk.clear();
+  d_chunk.reserve(chunk_size);
+  if (d_format == QCompress) {
+    // the chunks are submitted in stream order, so the checksum of the
+    // whole stream is simply carried on
+    d_adler = adler32(d_adler, reinterpret_cast<const Bytef *>(chunk.constData()),
+                      static_cast<uInt>(chunk.size()));
+    d_size += chunk.size();
+  }
+  if (d_threads == 1) {
+    writeMember(compressMember(chunk, d_level, d_format));
+    return;
+  }
+  d_members << QtConcurrent::run(&GzipDevice::compressMember, chunk, d_level,
+                                 d_format);
+  // keep every thread busy, but no more chunks than that in memory
+  writeMembers(d_threads);
+}
+
+void GzipDevice::writeMembers(int pending) {
+  while (d_members.size() > pending)
+    writeMember(d_members.takeFirst().result());
+}
+
+void GzipDevice::writeMember(const QByteArray &member) {
+  if (d_error) return;
+  if (member.isEmpty()) {
+    fail(tr("Compression failed"));
+    return;
+  }
+  if (d_device->write(member) != member.size()) {
+    fail(d_device->errorString());
+    return;
+  }
+  d_wrote = true;
+}
+
+QByteArray GzipDevice::compressMember(const QByteArray &chunk, int level,
+                                      Format format) {
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  // window bits + 16 writes a gzip header and trailer, negative window bits
+  // raw deflate data, the header and trailer of the zlib stream are written
+  // by open() and close()
+  if (deflateInit2(&stream, level, Z_DEFLATED,
+                   format == Gzip ? 15 + 16 : -15, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    return QByteArray();
+  // a sync flush ends with an empty stored block, which deflateBound()
+  // leaves out
+  QByteArray member(static_cast<int>(deflateBound(&stream, chunk.size())) + 16,
+                    Qt::Uninitialized);
+  stream.next_in =
+      reinterpret_cast<Bytef *>(const_cast<char *>(chunk.constData()));
+  stream.avail_in = static_cast<uInt>(chunk.size());
+  stream.next_out = reinterpret_cast<Bytef *>(member.data());
+  stream.avail_out = static_cast<uInt>(member.size());
+  // a sync flush ends the data on a byte boundary without ending the
+  // stream, so the deflated chunks can be joined
+  const int status = deflate(&stream, format == Gzip ? Z_FINISH : Z_SYNC_FLUSH);
+  const bool ok = format == Gzip
+                      ? status == Z_STREAM_END
+                      : status == Z_OK && stream.avail_in == 0 &&
+                            stream.avail_out > 0;
+  member.resize(static_cast<int>(stream.total_out));
+  deflateEnd(&stream);
+  return ok ? member : QByteArray();
+}
+
+void GzipDevice::writeTrailer() {
+  if (d_error) return;
+  // an empty final block ends the deflate data, the Adler-32 checksum of
+  // the uncompressed data the zlib stream
+  QByteArray trailer("\x03\x00", 2);
+  for (int shift = 24; shift >= 0; shift -= 8)
+    trailer.append(static_cast<char>((d_adler >> shift) & 0xff));
+  if (d_device->write(trailer) != trailer.size()) {
+    fail(d_device->errorString());
+    return;
+  }
+  if (d_size_pos < 0) return;
+  // big endian, like qCompress(); larger data can't be read by
+  // qUncompress() anyway
+  const quint32 size = static_cast<quint32>(d_size);
+  QByteArray header;
+  for (int shift = 24; shift >= 0; shift -= 8)
+    header.append(static_cast<char>((size >> shift) & 0xff));
+  const qint64 end = d_device->pos();
+  if (!d_device->seek(d_size_pos) || d_device->write(header) != 4 ||
+      !d_device->seek(end))
+    fail(d_device->errorString());
+}
+
+bool GzipDevice::fillInput() {
+  d_input = d_device->read(input_size);
+  if (d_input.isEmpty()) return false;
+  d_stream->next_in = reinterpret_cast<Bytef *>(d_input.data());
+  d_stream->avail_in = static_cast<uInt>(d_input.size());
+  return true;
+}
+
+void GzipDevice::fail(const QString &message) {
+  d_error = true;
+  setErrorString(message);
+}
@@ -0,0 +1,119 @@
+/* This file is part of AlphaPlot.
+
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Streaming gzip compression for project files
+*/
+
+#ifndef GZIPDEVICE_H
+#define GZIPDEVICE_H
+
+#include <QFuture>
+#include <QIODevice>
+#include <QList>
+
+struct z_stream_s;
+
+//! Sequential device compressing to or decompressing from another device
+/**
+ * Data written is cut into chunks which are compressed independently, on
+ * the global thread pool if more than one thread is allowed, and written in
+ * order. At most a few chunks are held at any time, so the memory needed
+ * does not grow with the amount of data.
+ *
+ * By default the output has the qCompress() layout projects have always
+ * been saved in, so every AlphaPlot version can open them: the chunks are
+ * deflated with a sync flush, which lets them be joined into one zlib
+ * stream, behind the 4 byte uncompressed size. The size is filled in on
+ * close() if the underlying device can seek; qUncompress() only takes it as
+ * a hint. With setFormat(Gzip), every chunk becomes a gzip member of a
+ * regular multi-member .gz file instead.
+ *
+ * Reading inflates the underlying device piece by piece and takes either
+ * format.
+ *
+ * The device can be opened either ReadOnly or WriteOnly. The underlying
+ * device is opened with the same mode if it is not open yet; close() does
+ * not close it. Errors make read() and write() fail; after writing, check
+ * flushed() once the device is closed.
+ */
+class GzipDevice : public QIODevice {
+  Q_OBJECT
+
+ public:
+  enum Format {
+    //! One zlib stream behind its size, as written by qCompress()
+    QCompress,
+    //! One gzip member per chunk
+    Gzip
+  };
+
+  GzipDevice(QIODevice *device, QObject *parent = nullptr);
+  ~GzipDevice();
+
+  //! Format written, QCompress unless set before open()
+  void setFormat(Format format);
+  //! Number of threads compressing chunks, 1 compresses in the caller
+  void setThreads(int threads);
+  //! zlib compression level, 0 (none) ... 9 (best)
+  void setCompressionLevel(int level);
+
+  bool open(OpenMode mode) override;
+  void close() override;
+  bool isSequential() const override { return true; }
+  bool atEnd() const override;
+  //! Whether everything written so far reached the underlying device
+  bool flushed() const { return !d_error; }
+
+ protected:
+  qint64 readData(char *data, qint64 maxlen) override;
+  qint64 writeData(const char *data, qint64 len) override;
+
+ private:
+  //! Hand the buffered chunk to the compressor
+  void submitChunk();
+  //! Write finished members until at most 'pending' are left
+  void writeMembers(int pending);
+  void writeMember(const QByteArray &member);
+  static QByteArray compressMember(const QByteArray &chunk, int level,
+                                   Format format);
+  //! Finish the qCompress() stream and fill in its size
+  void writeTrailer();
+  //! Read more compressed input, return false at the end of the device
+  bool fillInput();
+  void fail(const QString &message);
+
+  QIODevice *d_device;
+  Format d_format;
+  int d_threads;
+  int d_level;
+  bool d_error;
+  bool d_wrote;
+
+  // writing
+  QByteArray d_chunk;
+  QList<QFuture<QByteArray>> d_members;
+  //! Where the qCompress() size goes, -1 if the device can't seek
+  qint64 d_size_pos;
+  qint64 d_size;
+  //! Adler-32 checksum of the data written so far, for the zlib trailer
+  unsigned long d_adler;
+
+  // reading
+  z_stream_s *d_stream;
+  QByteArray d_input;
+  bool d_stream_end;
+};
+
+#endif  // GZIPDEVICE_H
@@ -359,6 +359,51 @@ QDateTime Utilities::stripDateTimeToFormat(const QDateTime& datetime,
   return QDateTime::fromString(datetime.toString(format), format);
 }
 
+bool Utilities::isLosslessDateTimeFormat(const QString& format) {
+  bool year = false, month = false, day = false, hour = false, minute = false,
+       second = false, msec = false;
+  bool quoted = false;
+  for (int i = 0; i < format.size();) {
+    const QChar c = format.at(i);
+    int run = 1;
+    while (i + run < format.size() && format.at(i + run) == c) run++;
+    if (c == QLatin1Char('\'')) {
+      // two consecutive quotes are a literal quote
+      if (run % 2) quoted = !quoted;
+    } else if (!quoted) {
+      switch (c.toLatin1()) {
+        case 'y':
+          year = true;
+          break;
+        case 'M':
+          month = true;
+          break;
+        case 'd':
+          // "ddd" and "dddd" are day names, not the day of the month
+          if (run <= 2) day = true;
+          break;
+        case 'h':
+        case 'H':
+          hour = true;
+          break;
+        case 'm':
+          minute = true;
+          break;
+        case 's':
+          second = true;
+          break;
+        case 'z':
+          msec = true;
+          break;
+        default:
+          break;
+      }
+    }
+    i += run;
+  }
+  return year && month && day && hour && minute && second && msec;
+}
+
 QImage Utilities::convertToGrayScale(const QImage& srcImage) {
   // Convert to 32bit pixel format
   QImage dstImage = srcImage.convertToFormat(srcImage.hasAlphaChannel()
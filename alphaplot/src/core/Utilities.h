@@ -45,6 +45,8 @@ class Utilities {
 
   static QDateTime stripDateTimeToFormat(const QDateTime &datetime,
                                          const QString &format);
+  // true if stripDateTimeToFormat() with this format keeps every field
+  static bool isLosslessDateTimeFormat(const QString &format);
 
   static QImage convertToGrayScale(const QImage &srcImage);
   static QImage convertToGrayScaleFast(const QImage &srcImage);
@@ -38,6 +38,7 @@
 
 #include "core/AbstractAspect.h"
 #include "globals.h"
+#include "lib/DateTimeVector.h"
 #include "lib/Interval.h"
 
 class Column;
@@ -308,6 +309,15 @@ class AbstractColumn : public AbstractAspect {
     Q_UNUSED(row);
     return QDateTime();
   }
+  //! Return the QDateTime in row 'row' as milliseconds since epoch
+  /**
+   * Use this only when dataType() is QDateTime. Invalid date-times
+   * are returned as DateTimeVector::invalidMSecs(). Columns storing
+   * the raw values reimplement this to avoid creating a QDateTime.
+   */
+  virtual qint64 dateTimeMSecsAt(int row) const {
+    return DateTimeVector::toMSecs(dateTimeAt(row));
+  }
   //! Set the content of row 'row'
   /**
    * Use this only when dataType() is QDateTime
@@ -392,6 +402,16 @@ class AbstractColumn : public AbstractAspect {
    * one handler for lots of columns.
    */
   void dataChanged(const AbstractColumn* source);
+  //! Only the data of some rows has changed
+  /**
+   * Emitted right before dataChanged() by operations which
+   * only touch the rows first to first+count-1 (this includes
+   * rows appended to fill the gap up to 'first'). Receivers
+   * may use it to update only these rows.
+   * 'source' is always the this pointer of the column that
+   * emitted this signal.
+   */
+  void rowsChanged(const AbstractColumn* source, int first, int count);
   //! The column will be replaced
   /**
    * This is used then a column is replaced by another
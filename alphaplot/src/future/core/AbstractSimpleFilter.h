@@ -341,6 +341,9 @@ class SimpleFilterColumn : public AbstractColumn {
   virtual QDateTime dateTimeAt(int row) const {
     return d_owner->dateTimeAt(row);
   }
+  virtual qint64 dateTimeMSecsAt(int row) const {
+    return d_owner->dateTimeMSecsAt(row);
+  }
   virtual double valueAt(int row) const { return d_owner->valueAt(row); }
 
  private:
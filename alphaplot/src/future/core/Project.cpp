@@ -55,7 +55,8 @@ class Project::Private {
       : mdi_window_visibility(static_cast<MdiWindowVisibility>(
             Project::global("default_mdi_window_visibility").toInt())),
         primary_view(0),
-        scripting_engine(0) {}
+        scripting_engine(0),
+        undoing_or_redoing(false) {}
   ~Private() {
 #ifndef LEGACY_CODE_0_2_x
     delete primary_view;
@@ -70,6 +71,7 @@ class Project::Private {
 #endif
   AbstractScriptingEngine *scripting_engine;
   QString file_name;
+  bool undoing_or_redoing;
 };
 
 Project::Project() : future::Folder(tr("Unnamed")), d(new Private()) {
@@ -127,6 +129,12 @@ AbstractScriptingEngine *Project::scriptingEngine() const {
   return d->scripting_engine;
 }
 
+void Project::setUndoingOrRedoing(bool running) {
+  d->undoing_or_redoing = running;
+}
+
+bool Project::isUndoingOrRedoing() const { return d->undoing_or_redoing; }
+
 /* ================== static methods ======================= */
 ConfigPageWidget *Project::makeConfigPage() { return new ProjectConfigPage(); }
 
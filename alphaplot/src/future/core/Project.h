@@ -76,6 +76,14 @@ class Project : public future::Folder {
   MdiWindowVisibility mdiWindowVisibility() const;
   void setFileName(const QString &file_name);
   QString fileName() const;
+  //! Mark the following changes as made by undo or redo
+  /**
+   * Set around moving through the undo stack, so that receivers of the
+   * changes can tell them from new edits.
+   */
+  void setUndoingOrRedoing(bool running);
+  //! Whether the changes currently made come from undo or redo
+  bool isUndoingOrRedoing() const;
 
   static ConfigPageWidget *makeConfigPage();
   static QString configPageLabel();
@@ -31,11 +31,211 @@
 
 #include <QXmlStreamWriter>
 #include <QtDebug>
+#include <QtEndian>
+#include <climits>
+#include <cstring>
 
 #include "core/IconLoader.h"
 #include "core/column/ColumnPrivate.h"
+#include "core/column/ColumnStatistics.h"
 #include "core/column/columncommands.h"
 #include "lib/XmlStreamReader.h"
+#include "lib/XmlStreamWriter.h"
+
+namespace {
+//! Version of the binary <data> element written by Column::save()
+const int binary_data_version = 1;
+
+//! Whether numeric and date-time columns are saved as one binary blob
+/**
+ * Controlled by the global setting "binary_data", set on the general
+ * application settings page (default: false, since AlphaPlot versions
+ * without the <data> element can't open such projects).
+ * With it disabled every cell is written as its own <row> element.
+ */
+bool binaryDataEnabled() {
+  QVariant value = Column::global("binary_data");
+  return value.isValid() && value.toBool();
+}
+
+//! Bytes of binary data encoded per writeCharacters() call; a multiple of 3,
+//! so the base64 text of the pieces simply adds up
+const int base64_chunk_bytes = 3 << 18;
+
+//! Snapshot of the rows of a column for saving
+/**
+ * Holds implicitly shared copies of the column's data and validity, which
+ * the column detaches from on its next change.
+ */
+class ColumnRows : public XmlStreamWriter::DeferredData {
+ public:
+  ColumnRows(AlphaPlot::ColumnDataType type, void* data,
+             const IntervalAttribute<bool>& validity, bool binary)
+      : d_type(type),
+        d_type_name(AlphaPlot::enumValueToString(type, "ColumnDataType")),
+        d_validity(validity),
+        d_binary(binary) {
+    switch (type) {
+      case AlphaPlot::TypeDouble:
+        d_values = *static_cast<QVector<double>*>(data);
+        break;
+      case AlphaPlot::TypeString:
+        d_texts = *static_cast<QStringList*>(data);
+        break;
+      default:
+        d_msecs = *static_cast<DateTimeVector*>(data);
+        break;
+    }
+  }
+
+  int rowCount() const {
+    switch (d_type) {
+      case AlphaPlot::TypeDouble:
+        return d_values.size();
+      case AlphaPlot::TypeString:
+        return d_texts.size();
+      default:
+        return d_msecs.size();
+    }
+  }
+
+  bool write(QXmlStreamWriter* writer) const override {
+    if (d_binary && d_type != AlphaPlot::TypeString) {
+      writeData(writer);
+      return !writer->hasError();
+    }
+    const int rows = rowCount();
+    for (int i = 0; i < rows; i++) {
+      writer->writeStartElement("row");
+      writer->writeAttribute("type", d_type_name);
+      writer->writeAttribute("index", QString::number(i));
+      writer->writeAttribute("invalid", d_validity.isSet(i) ? "yes" : "no");
+      switch (d_type) {
+        case AlphaPlot::TypeDouble:
+          writer->writeCharacters(QString::number(d_values.at(i), 'e', 16));
+          break;
+        case AlphaPlot::TypeString:
+          writer->writeCharacters(d_texts.at(i));
+          break;
+        default: {
+          // invalid entries are written as empty strings, which read back
+          // as invalid QDateTime
+          if (d_msecs.msecsAt(i) != DateTimeVector::invalidMSecs())
+            writer->writeCharacters(
+                d_msecs.at(i).toString("yyyy-dd-MM hh:mm:ss:zzz"));
+        } break;
+      }
+      writer->writeEndElement();
+    }
+    return !writer->hasError();
+  }
+
+  bool sameAs(const XmlStreamWriter::DeferredData& other) const override {
+    const ColumnRows* rows = dynamic_cast<const ColumnRows*>(&other);
+    if (!rows || rows->d_type != d_type || rows->d_binary != d_binary ||
+        rows->rowCount() != rowCount() ||
+        rows->d_validity.intervals() != d_validity.intervals())
+      return false;
+    switch (d_type) {
+      case AlphaPlot::TypeDouble:
+        return rows->d_values.isSharedWith(d_values);
+      case AlphaPlot::TypeString:
+        return rows->d_texts.isSharedWith(d_texts);
+      default:
+        return rows->d_msecs.constData() == d_msecs.constData() &&
+               rows->d_msecs.cellSpecs().constData() ==
+                   d_msecs.cellSpecs().constData() &&
+               rows->d_msecs.timeSpec() == d_msecs.timeSpec() &&
+               rows->d_msecs.offsetFromUtc() == d_msecs.offsetFromUtc();
+    }
+  }
+
+  qint64 sizeHint() const override {
+    const qint64 rows = rowCount();
+    if (d_binary && d_type != AlphaPlot::TypeString) return rows * 11;
+    qint64 size = rows * 50;
+    if (d_type == AlphaPlot::TypeString)
+      for (const QString& text : d_texts) size += text.size();
+    else
+      size += rows * 23;
+    return size;
+  }
+
+ private:
+  //! Write all rows and their validity as one binary XML data element
+  void writeData(QXmlStreamWriter* writer) const {
+    // layout: rowCount() little-endian 64 bit values (IEEE 754 doubles or
+    // milliseconds since the epoch) followed by a validity bitmap with one
+    // bit per row (set = valid), least significant bit first. Date-times
+    // with time specs other than the column's add one little-endian 32 bit
+    // DateTimeVector spec code per row
+    const int rows = rowCount();
+    const bool cell_specs =
+        d_type != AlphaPlot::TypeDouble && !d_msecs.cellSpecs().isEmpty();
+    QByteArray bitmap(static_cast<int>((static_cast<qint64>(rows) + 7) / 8),
+                      0);
+    foreach (Interval<int> interval,
+             d_validity.unsetIntervals(Interval<int>(0, rows - 1)))
+      for (int i = interval.start(); i <= interval.end(); i++)
+        bitmap[i / 8] = bitmap.at(i / 8) | char(1 << (i % 8));
+
+    writer->writeStartElement("data");
+    writer->writeAttribute("version", QString::number(binary_data_version));
+    writer->writeAttribute("encoding", "base64");
+    writer->writeAttribute("rows", QString::number(rows));
+    if (d_type != AlphaPlot::TypeDouble) {
+      writer->writeAttribute("time_spec", QString::number(d_msecs.timeSpec()));
+      writer->writeAttribute("offset_from_utc",
+                             QString::number(d_msecs.offsetFromUtc()));
+      if (cell_specs) writer->writeAttribute("cell_specs", "yes");
+    }
+    // the blob is encoded piece by piece, so neither it nor its text has to
+    // fit in memory (or in an int) at once
+    QByteArray chunk;
+    chunk.reserve(base64_chunk_bytes + 8);
+    auto flush = [&](bool all) {
+      const int bytes = all ? chunk.size() : chunk.size() - chunk.size() % 3;
+      writer->writeCharacters(
+          QString::fromLatin1(QByteArray::fromRawData(chunk.constData(), bytes)
+                                  .toBase64()));
+      chunk.remove(0, bytes);
+    };
+    uchar value[8];
+    for (int i = 0; i < rows; i++) {
+      if (d_type == AlphaPlot::TypeDouble) {
+        quint64 bits;
+        std::memcpy(&bits, &d_values.constData()[i], sizeof(bits));
+        qToLittleEndian<quint64>(bits, value);
+      } else {
+        qToLittleEndian<qint64>(d_msecs.constData()[i], value);
+      }
+      chunk.append(reinterpret_cast<const char*>(value), 8);
+      if (chunk.size() >= base64_chunk_bytes) flush(false);
+    }
+    for (int i = 0; i < bitmap.size(); i += base64_chunk_bytes) {
+      chunk.append(bitmap.mid(i, base64_chunk_bytes));
+      if (chunk.size() >= base64_chunk_bytes) flush(false);
+    }
+    if (cell_specs) {
+      for (int i = 0; i < rows; i++) {
+        qToLittleEndian<qint32>(d_msecs.specAt(i), value);
+        chunk.append(reinterpret_cast<const char*>(value), 4);
+        if (chunk.size() >= base64_chunk_bytes) flush(false);
+      }
+    }
+    flush(true);
+    writer->writeEndElement();
+  }
+
+  AlphaPlot::ColumnDataType d_type;
+  QString d_type_name;
+  QVector<double> d_values;
+  QStringList d_texts;
+  DateTimeVector d_msecs;
+  IntervalAttribute<bool> d_validity;
+  bool d_binary;
+};
+}  // namespace
 
 Column::Column(const QString& name, AlphaPlot::ColumnMode mode)
     : AbstractColumn(name) {
@@ -62,12 +262,18 @@ void Column::initPrivate(std::unique_ptr<QStringList> d,
 }
 
 template <>
-void Column::initPrivate(std::unique_ptr<QList<QDateTime> > d,
+void Column::initPrivate(std::unique_ptr<DateTimeVector> d,
                          IntervalAttribute<bool> v) {
   d_column_private = new Private(this, AlphaPlot::TypeDateTime,
                                  AlphaPlot::DateTime, d.release(), v);
 }
 
+template <>
+void Column::initPrivate(std::unique_ptr<QList<QDateTime> > d,
+                         IntervalAttribute<bool> v) {
+  initPrivate(std::unique_ptr<DateTimeVector>(new DateTimeVector(*d)), v);
+}
+
 void Column::init() {
   d_string_io = new ColumnStringIO(this);
   d_column_private->inputFilter()->input(0, d_string_io);
@@ -77,10 +283,23 @@ void Column::init() {
 }
 
 Column::~Column() {
+  d_statistics.reset();
   delete d_string_io;
   delete d_column_private;
 }
 
+ColumnStatistics* Column::statistics() const {
+  if (!d_statistics) d_statistics.reset(new ColumnStatistics(this));
+  return d_statistics.get();
+}
+
+NumericColumnView Column::numericView() const {
+  if (dataType() != AlphaPlot::TypeDouble) return NumericColumnView();
+  return NumericColumnView(
+      *static_cast<QVector<double>*>(d_column_private->dataPointer()),
+      d_column_private->validityAttribute());
+}
+
 void Column::setColumnMode(const AlphaPlot::ColumnMode mode,
                            AbstractFilter* conversion_filter) {
   if (mode != columnMode())  // mode changed
@@ -141,6 +360,11 @@ void Column::removeRows(int first, int count) {
   if (count > 0) exec(new ColumnRemoveRowsCmd(d_column_private, first, count));
 }
 
+void Column::permuteRows(const QVector<int>& permutation) {
+  if (!permutation.isEmpty())
+    exec(new ColumnPermuteRowsCmd(d_column_private, permutation));
+}
+
 void Column::setPlotDesignation(AlphaPlot::PlotDesignation pd) {
   if (pd != plotDesignation())
     exec(new ColumnSetPlotDesignationCmd(d_column_private, pd));
@@ -225,6 +449,13 @@ void Column::replaceValues(int first, const QVector<qreal>& new_values) {
     exec(new ColumnReplaceValuesCmd(d_column_private, first, new_values));
 }
 
+void Column::replaceValues(int first, const QVector<qreal>& new_values,
+                           const IntervalAttribute<bool>& invalid_rows) {
+  if (!new_values.isEmpty())
+    exec(new ColumnReplaceValuesCmd(d_column_private, first, new_values,
+                                    invalid_rows));
+}
+
 QString Column::textAt(int row) const { return d_column_private->textAt(row); }
 
 QDate Column::dateAt(int row) const { return d_column_private->dateAt(row); }
@@ -235,6 +466,10 @@ QDateTime Column::dateTimeAt(int row) const {
   return d_column_private->dateTimeAt(row);
 }
 
+qint64 Column::dateTimeMSecsAt(int row) const {
+  return d_column_private->dateTimeMSecsAt(row);
+}
+
 double Column::valueAt(int row) const { return d_column_private->valueAt(row); }
 
 QIcon Column::icon() const {
@@ -300,53 +535,29 @@ void Column::save(QXmlStreamWriter* writer, const bool saveastemplate) const {
     writer->writeCharacters(formula(interval.start()));
     writer->writeEndElement();
   }
-  int i;
   if (!saveastemplate) {
-    switch (dataType()) {
-      case AlphaPlot::TypeDouble:
-        for (i = 0; i < rowCount(); i++) {
-          writer->writeStartElement("row");
-          writer->writeAttribute("type", AlphaPlot::enumValueToString(
-                                             dataType(), "ColumnDataType"));
-          writer->writeAttribute("index", QString::number(i));
-          writer->writeAttribute("invalid", isInvalid(i) ? "yes" : "no");
-          writer->writeCharacters(QString::number(valueAt(i), 'e', 16));
-          writer->writeEndElement();
-        }
-        break;
-      case AlphaPlot::TypeString:
-        for (i = 0; i < rowCount(); i++) {
-          writer->writeStartElement("row");
-          writer->writeAttribute("type", AlphaPlot::enumValueToString(
-                                             dataType(), "ColumnDataType"));
-          writer->writeAttribute("index", QString::number(i));
-          writer->writeAttribute("invalid", isInvalid(i) ? "yes" : "no");
-          writer->writeCharacters(textAt(i));
-          writer->writeEndElement();
-        }
-        break;
-      case AlphaPlot::TypeDateTime:
-      case AlphaPlot::TypeDay:
-      case AlphaPlot::TypeMonth: {
-        {  // this conversion is needed to store base class;
-          NumericDateTimeBaseFilter numericFilter(
-              *(d_column_private->getNumericDateTimeFilter()));
-          writer->writeStartElement("numericDateTimeFilter");
-          numericFilter.save(writer);
-          writer->writeEndElement();
-        }
-        for (i = 0; i < rowCount(); i++) {
-          writer->writeStartElement("row");
-          writer->writeAttribute("type", AlphaPlot::enumValueToString(
-                                             dataType(), "ColumnDataType"));
-          writer->writeAttribute("index", QString::number(i));
-          writer->writeAttribute("invalid", isInvalid(i) ? "yes" : "no");
-          writer->writeCharacters(
-              dateTimeAt(i).toString("yyyy-dd-MM hh:mm:ss:zzz"));
-          writer->writeEndElement();
-        }
-      } break;
+    if (dataType() != AlphaPlot::TypeDouble &&
+        dataType() != AlphaPlot::TypeString) {
+      // this conversion is needed to store base class;
+      NumericDateTimeBaseFilter numericFilter(
+          *(d_column_private->getNumericDateTimeFilter()));
+      writer->writeStartElement("numericDateTimeFilter");
+      numericFilter.save(writer);
+      writer->writeEndElement();
     }
+    // the rows are written from a snapshot, which an autosave may do later
+    // on another thread; rows still in the project file are copied as they
+    // are
+    if (d_column_private->isPaged())
+      XmlStreamWriter::writeDeferred(
+          writer, QSharedPointer<const XmlStreamWriter::DeferredData>(
+                      new XmlPagedData(d_column_private->paged())));
+    else
+      XmlStreamWriter::writeDeferred(
+          writer,
+          QSharedPointer<const XmlStreamWriter::DeferredData>(new ColumnRows(
+              dataType(), d_column_private->dataPointer(),
+              d_column_private->validityAttribute(), binaryDataEnabled())));
   }
   writer->writeEndElement();  // "column"
 }
@@ -402,6 +613,8 @@ bool Column::load(XmlStreamReader* reader) {
     clearValidity();
     clearMasks();
     clearFormulas();
+    XmlRowBuffer buffer;
+    XmlPagedData paged;
     // read child elements
     while (!reader->atEnd()) {
       reader->readNext();
@@ -423,7 +636,11 @@ bool Column::load(XmlStreamReader* reader) {
         else if (reader->name() == "formula")
           ret_val = XmlReadFormula(reader);
         else if (reader->name() == "row")
-          ret_val = XmlReadRow(reader);
+          ret_val = XmlReadRow(reader, &buffer);
+        else if (reader->name() == "data")
+          ret_val = XmlReadData(reader, &buffer);
+        else if (reader->name() == "paged")
+          paged = reader->readPagedElement();
         else  // unknown element
         {
           reader->raiseWarning(
@@ -433,6 +650,8 @@ bool Column::load(XmlStreamReader* reader) {
         if (!ret_val) return false;
       }
     }
+    if (buffer.row_count > 0) installXmlRows(buffer);
+    if (!paged.isNull()) d_column_private->setPaged(paged);
   } else  // no column element
     reader->raiseError(tr("no column element found"));
 
@@ -500,7 +719,43 @@ bool Column::XmlReadFormula(XmlStreamReader* reader) {
   return true;
 }
 
-bool Column::XmlReadRow(XmlStreamReader* reader) {
+//! Rows of a column collected while reading it from XML
+/**
+ * Column::load() fills this buffer from all <row> or <data> elements and
+ * installs it with a single replaceModeData() call afterwards, so loading
+ * neither creates one QUndoCommand per cell nor copies the validity
+ * attribute for every row.
+ */
+struct Column::XmlRowBuffer {
+  QVector<qreal> values;
+  QStringList texts;
+  DateTimeVector date_times;
+  IntervalAttribute<bool> validity;
+  int row_count = 0;
+
+  //! Make room for 'row'; rows skipped over are invalid like in setValueAt()
+  void growTo(int row, AlphaPlot::ColumnDataType type) {
+    if (row < row_count) return;
+    if (row > row_count)
+      validity.setValue(Interval<int>(row_count, row - 1), true);
+    row_count = row + 1;
+    switch (type) {
+      case AlphaPlot::TypeDouble:
+        values.resize(row_count);
+        break;
+      case AlphaPlot::TypeString:
+        while (texts.size() < row_count) texts.append(QString());
+        break;
+      case AlphaPlot::TypeDateTime:
+      case AlphaPlot::TypeDay:
+      case AlphaPlot::TypeMonth:
+        date_times.resize(row_count);
+        break;
+    }
+  }
+};
+
+bool Column::XmlReadRow(XmlStreamReader* reader, XmlRowBuffer* buffer) {
   Q_ASSERT(reader->isStartElement() && reader->name() == "row");
 
   QString str;
@@ -517,12 +772,16 @@ bool Column::XmlReadRow(XmlStreamReader* reader) {
 
   bool ok;
   int index = reader->readAttributeInt("index", &ok);
-  if (!ok) {
+  if (!ok || index < 0) {
     reader->raiseError(tr("invalid or missing row index"));
     return false;
   }
 
+  bool invalid =
+      attribs.value(reader->namespaceUri().toString(), "invalid") ==
+      QLatin1String("yes");
   str = reader->readElementText();
+  buffer->growTo(index, dataType());
   switch (dataType()) {
     case AlphaPlot::TypeDouble: {
       double value = str.toDouble(&ok);
@@ -530,11 +789,11 @@ bool Column::XmlReadRow(XmlStreamReader* reader) {
         reader->raiseError(tr("invalid row value"));
         return false;
       }
-      setValueAt(index, value);
+      buffer->values[index] = value;
       break;
     }
     case AlphaPlot::TypeString:
-      setTextAt(index, str);
+      buffer->texts[index] = str;
       break;
 
     case AlphaPlot::TypeDateTime:
@@ -542,15 +801,230 @@ bool Column::XmlReadRow(XmlStreamReader* reader) {
     case AlphaPlot::TypeMonth:
       QDateTime date_time =
           QDateTime::fromString(str, "yyyy-dd-MM hh:mm:ss:zzz");
-      setDateTimeAt(index, date_time);
+      buffer->date_times.replace(index, date_time);
+      if (!date_time.isValid()) invalid = true;
       break;
   }
+  buffer->validity.setValue(index, invalid);
 
-  str = attribs.value(reader->namespaceUri().toString(), "invalid").toString();
-  if (str == "yes") setInvalid(index);
+  return true;
+}
+
+bool Column::XmlReadData(XmlStreamReader* reader, XmlRowBuffer* buffer) {
+  Q_ASSERT(reader->isStartElement() && reader->name() == "data");
+
+  bool ok;
+  int version = reader->readAttributeInt("version", &ok);
+  if (!ok || version < 1 || version > binary_data_version) {
+    reader->raiseError(tr("invalid or unsupported data version"));
+    return false;
+  }
+  QXmlStreamAttributes attribs = reader->attributes();
+  if (attribs.value(reader->namespaceUri().toString(), "encoding") !=
+      QLatin1String("base64")) {
+    reader->raiseError(tr("invalid or missing data encoding"));
+    return false;
+  }
+  int rows = reader->readAttributeInt("rows", &ok);
+  if (!ok || rows < 0) {
+    reader->raiseError(tr("invalid or missing data row count"));
+    return false;
+  }
+  const bool is_double = (dataType() == AlphaPlot::TypeDouble);
+  if (dataType() == AlphaPlot::TypeString) {
+    reader->raiseError(tr("binary data is not supported for text columns"));
+    return false;
+  }
+  int time_spec = Qt::LocalTime;
+  int offset_from_utc = 0;
+  bool cell_specs = false;
+  if (!is_double) {
+    time_spec = reader->readAttributeInt("time_spec", &ok);
+    if (ok) offset_from_utc = reader->readAttributeInt("offset_from_utc", &ok);
+    if (!ok) {
+      reader->raiseError(tr("invalid or missing data time spec"));
+      return false;
+    }
+    cell_specs =
+        attribs.value(reader->namespaceUri().toString(), "cell_specs") ==
+        QLatin1String("yes");
+  }
+
+  const qint64 value_bytes = static_cast<qint64>(rows) * 8;
+  const qint64 bitmap_bytes = (static_cast<qint64>(rows) + 7) / 8;
+  const qint64 spec_bytes = cell_specs ? static_cast<qint64>(rows) * 4 : 0;
+  const qint64 blob_bytes = value_bytes + bitmap_bytes + spec_bytes;
+  if (blob_bytes > INT_MAX) {
+    reader->raiseError(tr("data size does not match row count"));
+    return false;
+  }
+  // decode the text piece by piece as the reader delivers it, rather than
+  // reading all of it into one string first
+  QByteArray blob;
+  blob.reserve(static_cast<int>(blob_bytes));
+  QByteArray pending;
+  while (!reader->atEnd()) {
+    reader->readNext();
+    if (reader->isEndElement()) break;
+    if (reader->isComment() || reader->isWhitespace()) continue;
+    if (!reader->isCharacters()) {
+      reader->raiseError(tr("unexpected element in binary data"));
+      return false;
+    }
+    pending.append(reader->text().toLatin1());
+    // only whole groups of four characters decode on their own
+    const int usable = pending.size() - pending.size() % 4;
+    blob.append(QByteArray::fromBase64(
+        QByteArray::fromRawData(pending.constData(), usable)));
+    pending.remove(0, usable);
+  }
+  if (reader->hasError()) return false;
+  blob.append(QByteArray::fromBase64(pending));
+  if (blob.size() != blob_bytes) {
+    reader->raiseError(tr("data size does not match row count"));
+    return false;
+  }
+  const uchar* src = reinterpret_cast<const uchar*>(blob.constData());
+  const uchar* bitmap = src + value_bytes;
+
+  // the data element always holds the complete column
+  *buffer = XmlRowBuffer();
+  buffer->row_count = rows;
+  if (is_double) {
+    buffer->values.resize(rows);
+    qreal* dest = buffer->values.data();
+    for (int i = 0; i < rows; i++) {
+      quint64 bits = qFromLittleEndian<quint64>(src + i * 8);
+      std::memcpy(&dest[i], &bits, sizeof(bits));
+    }
+  } else {
+    buffer->date_times.setTimeSpec(static_cast<Qt::TimeSpec>(time_spec),
+                                   offset_from_utc);
+    buffer->date_times.resize(rows);
+    qint64* dest = buffer->date_times.data();
+    for (int i = 0; i < rows; i++)
+      dest[i] = qFromLittleEndian<qint64>(src + i * 8);
+    if (cell_specs) {
+      const uchar* specs = bitmap + bitmap_bytes;
+      QVector<qint32> codes(rows);
+      for (int i = 0; i < rows; i++) {
+        codes[i] = qFromLittleEndian<qint32>(specs + i * 4);
+        // offsets from UTC are below a day, the other codes are the spec
+        // codes of the column, local time and UTC
+        if (qAbs(qint64(codes[i])) >= 86400 &&
+            codes[i] > DateTimeVector::specCode(Qt::UTC)) {
+          reader->raiseError(tr("invalid data time spec"));
+          return false;
+        }
+      }
+      buffer->date_times.setCellSpecs(codes);
+    }
+  }
+
+  // turn the runs of invalid rows in the bitmap into intervals
+  int run_start = -1;
+  for (int i = 0; i <= rows; i++) {
+    bool valid = (i == rows) || (bitmap[i / 8] & (1 << (i % 8)));
+    if (!valid && run_start < 0) {
+      run_start = i;
+    } else if (valid && run_start >= 0) {
+      buffer->validity.setValue(Interval<int>(run_start, i - 1), true);
+      run_start = -1;
+    }
+  }
 
   return true;
 }
+
+bool Column::readPagedRows(const XmlPagedData& paged) {
+  QByteArray elements;
+  const bool read = paged.read(&elements);
+  XmlStreamReader reader(elements);
+  XmlRowBuffer buffer;
+  if (read && reader.readNextStartElement()) {
+    while (reader.readNextStartElement()) {
+      bool ret_val = true;
+      if (reader.name() == "row")
+        ret_val = XmlReadRow(&reader, &buffer);
+      else if (reader.name() == "data")
+        ret_val = XmlReadData(&reader, &buffer);
+      else
+        reader.skipCurrentElement();
+      if (!ret_val) break;
+    }
+  }
+  const bool ok = read && !reader.hasError();
+  if (!ok) {
+    XmlPagedDataErrors::report(
+        tr("The data of column %1 could not be read from %2, which was "
+           "changed or truncated since the project was opened. The column "
+           "is shown empty; its data stays in the file as it is unless the "
+           "column is changed.")
+            .arg(name(), paged.fileName()));
+    // rows read before the error are not trusted either
+    buffer = XmlRowBuffer();
+  }
+  // rowCount() promised this many rows already
+  if (buffer.row_count < paged.rows())
+    buffer.growTo(paged.rows() - 1, dataType());
+  if (!ok && paged.rows() > 0)
+    buffer.validity.setValue(Interval<int>(0, paged.rows() - 1), true);
+
+  void* data = nullptr;
+  switch (dataType()) {
+    case AlphaPlot::TypeDouble:
+      data = new QVector<qreal>(buffer.values);
+      break;
+    case AlphaPlot::TypeString:
+      data = new QStringList(buffer.texts);
+      break;
+    case AlphaPlot::TypeDateTime:
+    case AlphaPlot::TypeDay:
+    case AlphaPlot::TypeMonth:
+      data = new DateTimeVector(buffer.date_times);
+      break;
+  }
+  d_column_private->installPaged(data, buffer.validity);
+  return ok;
+}
+
+void Column::installXmlRows(const XmlRowBuffer& buffer) {
+  const AlphaPlot::ColumnDataType type = dataType();
+  void* old_data = d_column_private->dataPointer();
+  void* new_data = nullptr;
+  switch (type) {
+    case AlphaPlot::TypeDouble:
+      new_data = new QVector<qreal>(buffer.values);
+      break;
+    case AlphaPlot::TypeString:
+      new_data = new QStringList(buffer.texts);
+      break;
+    case AlphaPlot::TypeDateTime:
+    case AlphaPlot::TypeDay:
+    case AlphaPlot::TypeMonth:
+      new_data = new DateTimeVector(buffer.date_times);
+      break;
+  }
+  d_column_private->replaceModeData(columnMode(), type, new_data,
+                                    d_column_private->inputFilter(),
+                                    outputFilter(), buffer.validity);
+  // replaceModeData() does nothing while the mode is locked
+  if (d_column_private->dataPointer() != new_data) old_data = new_data;
+  switch (type) {
+    case AlphaPlot::TypeDouble:
+      delete static_cast<QVector<qreal>*>(old_data);
+      break;
+    case AlphaPlot::TypeString:
+      delete static_cast<QStringList*>(old_data);
+      break;
+    case AlphaPlot::TypeDateTime:
+    case AlphaPlot::TypeDay:
+    case AlphaPlot::TypeMonth:
+      delete static_cast<DateTimeVector*>(old_data);
+      break;
+  }
+}
+
 AlphaPlot::ColumnDataType Column::dataType() const {
   return d_column_private->dataType();
 }
@@ -592,6 +1066,10 @@ QList<Interval<int> > Column::invalidIntervals() const {
   return d_column_private->invalidIntervals();
 }
 
+QList<Interval<int> > Column::validIntervals(Interval<int> range) const {
+  return d_column_private->validIntervals(range);
+}
+
 bool Column::isMasked(int row) const { return d_column_private->isMasked(row); }
 
 bool Column::isMasked(Interval<int> i) const {
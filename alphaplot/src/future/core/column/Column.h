@@ -34,6 +34,7 @@
 
 #include "core/AbstractAspect.h"
 #include "core/AbstractSimpleFilter.h"
+#include "core/column/NumericColumnView.h"
 #include "core/datatypes/NumericDateTimeBaseFilter.h"
 #include "lib/IntervalAttribute.h"
 #include "lib/XmlStreamReader.h"
@@ -41,6 +42,7 @@
 class QString;
 
 class ColumnStringIO;
+class ColumnStatistics;
 
 //! Aspect that manages a column
 /**
@@ -151,6 +153,12 @@ class Column : public AbstractColumn {
   void insertRows(int before, int count);
   //! Remove 'count' rows starting from row 'first'
   void removeRows(int first, int count);
+  //! Reorder the rows: row k receives the former row permutation[k]
+  /**
+   * Data, validity and masking are moved in one undo step; formulas stay
+   * with their rows. 'permutation' must be a permutation of 0 ... n-1.
+   */
+  void permuteRows(const QVector<int>& permutation);
   //! Return the column plot designation
   AlphaPlot::PlotDesignation plotDesignation() const;
   //! Return the column plot designation color
@@ -172,6 +180,18 @@ class Column : public AbstractColumn {
   AbstractSimpleFilter* inputFilter() const;
   //! Return a wrapper column object used for String I/O.
   ColumnStringIO* asStringColumn() const { return d_string_io; }
+  //! Return the cached statistics of the valid rows
+  /**
+   * Created on first use; it keeps itself up to date with the column.
+   */
+  ColumnStatistics* statistics() const;
+  //! Return a read-only view of the values, sharing the column's storage
+  /**
+   * Analysis code should read numeric columns through this instead of
+   * copying valueAt() row by row. The view is null unless the column stores
+   * doubles.
+   */
+  NumericColumnView numericView() const;
 
   //! \name IntervalAttribute related functions
   //@{
@@ -181,6 +201,8 @@ class Column : public AbstractColumn {
   bool isInvalid(Interval<int> i) const;
   //! Return all intervals of invalid rows
   QList<Interval<int> > invalidIntervals() const;
+  //! Return the runs of valid rows within 'range'
+  QList<Interval<int> > validIntervals(Interval<int> range) const;
   //! Return whether a certain row is masked
   bool isMasked(int row) const;
   //! Return whether a certain interval of rows rows is fully masked
@@ -277,6 +299,11 @@ class Column : public AbstractColumn {
    * Use this only when dataType() is QDateTime
    */
   QDateTime dateTimeAt(int row) const;
+  //! Return the raw milliseconds since epoch in row 'row'
+  /**
+   * Use this only when dataType() is QDateTime
+   */
+  qint64 dateTimeMSecsAt(int row) const;
   //! Set the content of row 'row'
   /**
    * Use this only when dataType() is QDateTime
@@ -299,6 +326,13 @@ class Column : public AbstractColumn {
    * Use this only when dataType() is double
    */
   virtual void replaceValues(int first, const QVector<qreal>& new_values);
+  //! Replace a range of values, marking the rows of 'invalid_rows' invalid
+  /**
+   * Use this only when dataType() is double. A single undo command sets
+   * both the values and the validity of the rows.
+   */
+  void replaceValues(int first, const QVector<qreal>& new_values,
+                     const IntervalAttribute<bool>& invalid_rows);
   //@}
 
   //! \name XML related functions
@@ -319,8 +353,19 @@ class Column : public AbstractColumn {
   bool XmlReadMask(XmlStreamReader* reader);
   //! Read XML formula element
   bool XmlReadFormula(XmlStreamReader* reader);
-  //! Read XML row element
-  bool XmlReadRow(XmlStreamReader* reader);
+  struct XmlRowBuffer;
+  //! Read XML row element into 'buffer'
+  bool XmlReadRow(XmlStreamReader* reader, XmlRowBuffer* buffer);
+  //! Read XML binary data element (all rows and their validity at once)
+  bool XmlReadData(XmlStreamReader* reader, XmlRowBuffer* buffer);
+  //! Install the rows read by load() without any undo command
+  void installXmlRows(const XmlRowBuffer& buffer);
+  //! Read the rows load() left in the project file
+  /**
+   * \return false if they could not be read; invalid rows are installed
+   * instead
+   */
+  bool readPagedRows(const XmlPagedData& paged);
   //@}
 
  private slots:
@@ -330,12 +375,21 @@ class Column : public AbstractColumn {
   //! Pointer to the private data object
   Private* d_column_private;
   ColumnStringIO* d_string_io;
+  mutable std::unique_ptr<ColumnStatistics> d_statistics;
 
   void init();
   template <class D>
   void initPrivate(std::unique_ptr<D>, IntervalAttribute<bool>);
 
   friend class ColumnStringIO;
+
+ signals:
+  //! The formulas of the column have changed
+  /**
+   * 'source' is always the this pointer of the column that
+   * emitted this signal.
+   */
+  void formulasChanged(const AbstractColumn* source);
 };
 
 //! String-IO interface of Column.
@@ -52,8 +52,35 @@
 #include "core/datatypes/String2DoubleFilter.h"
 #include "core/datatypes/String2MonthFilter.h"
 
+namespace {
+//! Return 'attribute' with row permutation[k] moved to row k
+IntervalAttribute<bool> permutedAttribute(
+    const IntervalAttribute<bool>& attribute, const QVector<int>& permutation) {
+  QList<Interval<int> > source = attribute.intervals();
+  if (source.isEmpty()) return attribute;
+  const int rows = permutation.size();
+  // rows beyond the permutation stay where they are
+  QList<Interval<int> > result;
+  foreach (Interval<int> interval, source)
+    if (interval.end() >= rows)
+      result << Interval<int>(qMax(interval.start(), rows), interval.end());
+  int run_start = -1;
+  for (int k = 0; k < rows; k++) {
+    bool set = attribute.isSet(permutation.at(k));
+    if (set && run_start < 0) {
+      run_start = k;
+    } else if (!set && run_start >= 0) {
+      result << Interval<int>(run_start, k - 1);
+      run_start = -1;
+    }
+  }
+  if (run_start >= 0) result << Interval<int>(run_start, rows - 1);
+  return IntervalAttribute<bool>(result);
+}
+}  // namespace
+
 Column::Private::Private(Column* owner, AlphaPlot::ColumnMode mode)
-    : d_owner(owner) {
+    : d_owner(owner), d_paged_rows(0) {
   Q_ASSERT(owner != 0);  // a Column::Private without owner is not allowed
   // because the owner must become the parent aspect of the input and output
   // filters
@@ -96,7 +123,7 @@ Column::Private::Private(Column* owner, AlphaPlot::ColumnMode mode)
               &DateTime2StringFilter::formatChanged, d_owner,
               &Column::notifyDisplayChange);
       d_data_type = AlphaPlot::TypeDateTime;
-      d_data = new QList<QDateTime>();
+      d_data = new DateTimeVector();
       break;
     case AlphaPlot::Month:
       d_input_filter = new String2MonthFilter();
@@ -106,7 +133,7 @@ Column::Private::Private(Column* owner, AlphaPlot::ColumnMode mode)
               &DateTime2StringFilter::formatChanged, d_owner,
               &Column::notifyDisplayChange);
       d_data_type = AlphaPlot::TypeDateTime;
-      d_data = new QList<QDateTime>();
+      d_data = new DateTimeVector();
       break;
     case AlphaPlot::Day:
       d_input_filter = new String2DayOfWeekFilter();
@@ -116,7 +143,7 @@ Column::Private::Private(Column* owner, AlphaPlot::ColumnMode mode)
               &DateTime2StringFilter::formatChanged, d_owner,
               &Column::notifyDisplayChange);
       d_data_type = AlphaPlot::TypeDateTime;
-      d_data = new QList<QDateTime>();
+      d_data = new DateTimeVector();
       break;
   }  // switch(mode)
 
@@ -129,7 +156,7 @@ Column::Private::Private(Column* owner, AlphaPlot::ColumnMode mode)
 Column::Private::Private(Column* owner, AlphaPlot::ColumnDataType type,
                          AlphaPlot::ColumnMode mode, void* data,
                          IntervalAttribute<bool> validity)
-    : d_owner(owner) {
+    : d_owner(owner), d_paged_rows(0) {
   d_data_type = type;
   d_column_mode = mode;
   d_column_mode_lock = 0;
@@ -215,13 +242,14 @@ Column::Private::~Private() {
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
     case AlphaPlot::TypeMonth:
-      delete static_cast<QList<QDateTime>*>(d_data);
+      delete static_cast<DateTimeVector*>(d_data);
       break;
   }  // switch(d_data_type)
 }
 
 void Column::Private::setColumnMode(const AlphaPlot::ColumnMode new_mode,
                                     AbstractFilter* converter) {
+  pageIn();
   const auto& old_mode = d_column_mode;
   if (new_mode == old_mode) return;
   void* old_data = d_data;
@@ -300,7 +328,7 @@ void Column::Private::setColumnMode(const AlphaPlot::ColumnMode new_mode,
       if ((AlphaPlot::ColumnMode::DateTime != old_mode) &&
           (AlphaPlot::ColumnMode::Month != old_mode) &&
           (AlphaPlot::ColumnMode::Day != old_mode)) {
-        d_data = new QList<QDateTime>();
+        d_data = new DateTimeVector();
         d_data_type = AlphaPlot::TypeDateTime;
       }
       connect(static_cast<DateTime2StringFilter*>(new_out_filter),
@@ -341,7 +369,7 @@ void Column::Private::setColumnMode(const AlphaPlot::ColumnMode new_mode,
       if ((AlphaPlot::ColumnMode::DateTime != old_mode) &&
           (AlphaPlot::ColumnMode::Month != old_mode) &&
           (AlphaPlot::ColumnMode::Day != old_mode)) {
-        d_data = new QList<QDateTime>();
+        d_data = new DateTimeVector();
         d_data_type = AlphaPlot::TypeDateTime;
       }
       static_cast<DateTime2StringFilter*>(new_out_filter)->setFormat("MMMM");
@@ -372,7 +400,7 @@ void Column::Private::setColumnMode(const AlphaPlot::ColumnMode new_mode,
       if ((AlphaPlot::ColumnMode::DateTime != old_mode) &&
           (AlphaPlot::ColumnMode::Month != old_mode) &&
           (AlphaPlot::ColumnMode::Day != old_mode)) {
-        d_data = new QList<QDateTime>();
+        d_data = new DateTimeVector();
         d_data_type = AlphaPlot::TypeDateTime;
       }
       static_cast<DateTime2StringFilter*>(new_out_filter)->setFormat("dddd");
@@ -427,7 +455,7 @@ void Column::Private::setColumnMode(const AlphaPlot::ColumnMode new_mode,
           (AlphaPlot::ColumnMode::Month != new_mode) &&
           (AlphaPlot::ColumnMode::Day != new_mode))
         temp_col.reset(new Column("temp_col",
-                                  *(static_cast<QList<QDateTime>*>(old_data)),
+                                  *(static_cast<DateTimeVector*>(old_data)),
                                   d_validity));
       break;
     }
@@ -464,6 +492,7 @@ void Column::Private::replaceModeData(AlphaPlot::ColumnMode mode,
                                       AbstractSimpleFilter* in_filter,
                                       AbstractSimpleFilter* out_filter,
                                       IntervalAttribute<bool> validity) {
+  pageIn();
   if (d_column_mode_lock == true) return;
 
   emit d_owner->modeAboutToChange(d_owner);
@@ -520,6 +549,7 @@ void Column::Private::replaceModeData(AlphaPlot::ColumnMode mode,
 
 void Column::Private::replaceData(void* data,
                                   IntervalAttribute<bool> validity) {
+  pageIn();
   emit d_owner->dataAboutToChange(d_owner);
   d_data = data;
   d_validity = validity;
@@ -527,6 +557,7 @@ void Column::Private::replaceData(void* data,
 }
 
 bool Column::Private::copy(const AbstractColumn* other) {
+  pageIn();
   if (other->dataType() != dataType()) return false;
   int num_rows = other->rowCount();
 
@@ -548,9 +579,7 @@ bool Column::Private::copy(const AbstractColumn* other) {
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
     case AlphaPlot::TypeMonth: {
-      for (int i = 0; i < num_rows; i++)
-        static_cast<QList<QDateTime>*>(d_data)->replace(i,
-                                                        other->dateTimeAt(i));
+      copyDateTimes(other, 0, 0, num_rows);
       break;
     }
   }
@@ -564,6 +593,8 @@ bool Column::Private::copy(const AbstractColumn* other) {
 
 bool Column::Private::copy(const AbstractColumn* source, int source_start,
                            int dest_start, int num_rows) {
+  pageIn();
+  source->pageIn();
   if (source->dataType() != dataType()) return false;
   if (num_rows == 0) return true;
 
@@ -587,11 +618,10 @@ bool Column::Private::copy(const AbstractColumn* source, int source_start,
       break;
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
-    case AlphaPlot::TypeMonth:
-      for (int i = 0; i < num_rows; i++)
-        static_cast<QList<QDateTime>*>(d_data)->replace(
-            dest_start + i, source->dateTimeAt(source_start + i));
+    case AlphaPlot::TypeMonth: {
+      copyDateTimes(source, source_start, dest_start, num_rows);
       break;
+    }
   }
   // copy the validity information
   for (int i = 0; i < num_rows; i++)
@@ -602,12 +632,33 @@ bool Column::Private::copy(const AbstractColumn* source, int source_start,
   return true;
 }
 
+void Column::Private::copyDateTimes(const AbstractColumn* source,
+                                    int source_start, int dest_start,
+                                    int num_rows) {
+  DateTimeVector* vector = static_cast<DateTimeVector*>(d_data);
+  const Column* column = qobject_cast<const Column*>(source);
+  if (column) {
+    vector->copy(*static_cast<DateTimeVector*>(
+                     column->d_column_private->dataPointer()),
+                 source_start, dest_start, num_rows);
+    return;
+  }
+  // e.g. the output of an input filter
+  for (int i = 0; i < num_rows; i++)
+    vector->replace(dest_start + i, source->dateTimeAt(source_start + i));
+}
+
 bool Column::Private::copy(const Private* other) {
+  pageIn();
+  other->pageIn();
   if (other->dataType() != dataType()) return false;
   int num_rows = other->rowCount();
 
   emit d_owner->dataAboutToChange(d_owner);
   resizeTo(num_rows);
+  if (d_data_type == AlphaPlot::TypeDateTime)
+    static_cast<DateTimeVector*>(d_data)->copyTimeSpec(
+        *static_cast<DateTimeVector*>(other->dataPointer()));
 
   // copy the data
   switch (d_data_type) {
@@ -624,9 +675,8 @@ bool Column::Private::copy(const Private* other) {
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
     case AlphaPlot::TypeMonth: {
-      for (int i = 0; i < num_rows; i++)
-        static_cast<QList<QDateTime>*>(d_data)->replace(i,
-                                                        other->dateTimeAt(i));
+      static_cast<DateTimeVector*>(d_data)->copy(
+          *static_cast<DateTimeVector*>(other->dataPointer()), 0, 0, num_rows);
       break;
     }
   }
@@ -640,6 +690,8 @@ bool Column::Private::copy(const Private* other) {
 
 bool Column::Private::copy(const Private* source, int source_start,
                            int dest_start, int num_rows) {
+  pageIn();
+  source->pageIn();
   if (source->dataType() != dataType()) return false;
   if (num_rows == 0) return true;
 
@@ -663,11 +715,12 @@ bool Column::Private::copy(const Private* source, int source_start,
       break;
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
-    case AlphaPlot::TypeMonth:
-      for (int i = 0; i < num_rows; i++)
-        static_cast<QList<QDateTime>*>(d_data)->replace(
-            dest_start + i, source->dateTimeAt(source_start + i));
+    case AlphaPlot::TypeMonth: {
+      static_cast<DateTimeVector*>(d_data)->copy(
+          *static_cast<DateTimeVector*>(source->dataPointer()), source_start,
+          dest_start, num_rows);
       break;
+    }
   }
   // copy the validity information
   for (int i = 0; i < num_rows; i++)
@@ -679,13 +732,14 @@ bool Column::Private::copy(const Private* source, int source_start,
 }
 
 int Column::Private::rowCount() const {
+  if (d_page_state.loadAcquire() != 0) return d_paged_rows;
   switch (d_data_type) {
     case AlphaPlot::TypeDouble:
       return static_cast<QVector<double>*>(d_data)->size();
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
     case AlphaPlot::TypeMonth:
-      return static_cast<QList<QDateTime>*>(d_data)->size();
+      return static_cast<DateTimeVector*>(d_data)->size();
     case AlphaPlot::TypeString:
       return static_cast<QStringList*>(d_data)->size();
   }
@@ -694,6 +748,7 @@ int Column::Private::rowCount() const {
 }
 
 void Column::Private::resizeTo(int new_size) {
+  pageIn();
   int old_size = rowCount();
   if (new_size == old_size) return;
 
@@ -703,17 +758,9 @@ void Column::Private::resizeTo(int new_size) {
       break;
     case AlphaPlot::TypeDateTime:
     case AlphaPlot::TypeDay:
-    case AlphaPlot::TypeMonth: {
-      int new_rows = new_size - old_size;
-      if (new_rows > 0) {
-        for (int i = 0; i < new_rows; i++)
-          static_cast<QList<QDateTime>*>(d_data)->append(QDateTime());
-      } else {
-        for (int i = 0; i < -new_rows; i++)
-          static_cast<QList<QDateTime>*>(d_data)->removeLast();
-      }
+    case AlphaPlot::TypeMonth:
+      static_cast<DateTimeVector*>(d_data)->resize(new_size);
       break;
-    }
     case AlphaPlot::TypeString: {
       int new_rows = new_size - old_size;
       if (new_rows > 0) {
@@ -728,7 +775,48 @@ void Column::Private::resizeTo(int new_size) {
   }
 }
 
+void Column::Private::permuteRows(const QVector<int>& permutation) {
+  pageIn();
+  const int rows = permutation.size();
+  emit d_owner->dataAboutToChange(d_owner);
+  emit d_owner->maskingAboutToChange(d_owner);
+  if (rows > rowCount()) {
+    d_validity.setValue(Interval<int>(rowCount(), rows - 1), true);
+    resizeTo(rows);
+  }
+
+  switch (d_data_type) {
+    case AlphaPlot::TypeDouble: {
+      QVector<double>* data = static_cast<QVector<double>*>(d_data);
+      const QVector<double> old_data = *data;
+      double* ptr = data->data();
+      for (int k = 0; k < rows; k++) ptr[k] = old_data.at(permutation.at(k));
+      break;
+    }
+    case AlphaPlot::TypeString: {
+      QStringList* data = static_cast<QStringList*>(d_data);
+      const QStringList old_data = *data;
+      for (int k = 0; k < rows; k++)
+        (*data)[k] = old_data.at(permutation.at(k));
+      break;
+    }
+    case AlphaPlot::TypeDateTime:
+    case AlphaPlot::TypeDay:
+    case AlphaPlot::TypeMonth: {
+      static_cast<DateTimeVector*>(d_data)->permute(permutation);
+      break;
+    }
+  }
+  d_validity = permutedAttribute(d_validity, permutation);
+  d_masking = permutedAttribute(d_masking, permutation);
+
+  if (rows > 0) emit d_owner->rowsChanged(d_owner, 0, rows);
+  emit d_owner->dataChanged(d_owner);
+  emit d_owner->maskingChanged(d_owner);
+}
+
 void Column::Private::insertRows(int before, int count) {
+  pageIn();
   if (count == 0) return;
 
   emit d_owner->rowsAboutToBeInserted(d_owner, before, count);
@@ -745,8 +833,7 @@ void Column::Private::insertRows(int before, int count) {
       case AlphaPlot::TypeDateTime:
       case AlphaPlot::TypeDay:
       case AlphaPlot::TypeMonth:
-        for (int i = 0; i < count; i++)
-          static_cast<QList<QDateTime>*>(d_data)->insert(before, QDateTime());
+        static_cast<DateTimeVector*>(d_data)->insert(before, count);
         break;
       case AlphaPlot::TypeString:
         for (int i = 0; i < count; i++)
@@ -758,6 +845,7 @@ void Column::Private::insertRows(int before, int count) {
 }
 
 void Column::Private::removeRows(int first, int count) {
+  pageIn();
   if (count == 0) return;
 
   emit d_owner->rowsAboutToBeRemoved(d_owner, first, count);
@@ -776,8 +864,7 @@ void Column::Private::removeRows(int first, int count) {
       case AlphaPlot::TypeDateTime:
       case AlphaPlot::TypeDay:
       case AlphaPlot::TypeMonth:
-        for (int i = 0; i < corrected_count; i++)
-          static_cast<QList<QDateTime>*>(d_data)->removeAt(first);
+        static_cast<DateTimeVector*>(d_data)->remove(first, corrected_count);
         break;
       case AlphaPlot::TypeString:
         for (int i = 0; i < corrected_count; i++)
@@ -821,6 +908,7 @@ void Column::Private::setPlotDesignationColor(AlphaPlot::PlotDesignation pd) {
 void Column::Private::clear() { removeRows(0, rowCount()); }
 
 void Column::Private::clearValidity() {
+  pageIn();
   emit d_owner->dataAboutToChange(d_owner);
   d_validity.clear();
   emit d_owner->dataChanged(d_owner);
@@ -833,12 +921,15 @@ void Column::Private::clearMasks() {
 }
 
 void Column::Private::setInvalid(Interval<int> i, bool invalid) {
+  pageIn();
   emit d_owner->dataAboutToChange(d_owner);
   d_validity.setValue(i, invalid);
+  if (i.isValid()) emit d_owner->rowsChanged(d_owner, i.start(), i.size());
   emit d_owner->dataChanged(d_owner);
 }
 
 void Column::Private::setInvalid(int row, bool invalid) {
+  pageIn();
   setInvalid(Interval<int>(row, row), invalid);
 }
 
@@ -854,15 +945,20 @@ void Column::Private::setMasked(int row, bool mask) {
 
 void Column::Private::setFormula(Interval<int> i, QString formula) {
   d_formulas.setValue(i, formula);
+  emit d_owner->formulasChanged(d_owner);
 }
 
 void Column::Private::setFormula(int row, QString formula) {
   setFormula(Interval<int>(row, row), formula);
 }
 
-void Column::Private::clearFormulas() { d_formulas.clear(); }
+void Column::Private::clearFormulas() {
+  d_formulas.clear();
+  emit d_owner->formulasChanged(d_owner);
+}
 
 QString Column::Private::textAt(int row) const {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeString) return QString();
   return static_cast<QStringList*>(d_data)->value(row);
 }
@@ -872,19 +968,30 @@ QDate Column::Private::dateAt(int row) const { return dateTimeAt(row).date(); }
 QTime Column::Private::timeAt(int row) const { return dateTimeAt(row).time(); }
 
 QDateTime Column::Private::dateTimeAt(int row) const {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeDateTime) return QDateTime();
-  return static_cast<QList<QDateTime>*>(d_data)->value(row);
+  return static_cast<DateTimeVector*>(d_data)->at(row);
+}
+
+qint64 Column::Private::dateTimeMSecsAt(int row) const {
+  pageIn();
+  if (d_data_type != AlphaPlot::TypeDateTime)
+    return DateTimeVector::invalidMSecs();
+  return static_cast<DateTimeVector*>(d_data)->msecsAt(row);
 }
 
 double Column::Private::valueAt(int row) const {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeDouble) return 0.0;
   return static_cast<QVector<double>*>(d_data)->value(row);
 }
 
 void Column::Private::setTextAt(int row, const QString& new_value) {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeString) return;
 
   emit d_owner->dataAboutToChange(d_owner);
+  int changed_first = qMin(row, rowCount());
   if (row >= rowCount()) {
     if (row + 1 - rowCount() >
         1)  // we are adding more than one row in resizeTo()
@@ -894,13 +1001,16 @@ void Column::Private::setTextAt(int row, const QString& new_value) {
 
   static_cast<QStringList*>(d_data)->replace(row, new_value);
   d_validity.setValue(Interval<int>(row, row), false);
+  emit d_owner->rowsChanged(d_owner, changed_first, row - changed_first + 1);
   emit d_owner->dataChanged(d_owner);
 }
 
 void Column::Private::replaceTexts(int first, const QStringList& new_values) {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeString) return;
 
   emit d_owner->dataAboutToChange(d_owner);
+  int changed_first = qMin(first, rowCount());
   int num_rows = new_values.size();
   if (first + 1 - rowCount() > 1)
     d_validity.setValue(Interval<int>(rowCount(), first - 1), true);
@@ -909,6 +1019,8 @@ void Column::Private::replaceTexts(int first, const QStringList& new_values) {
   for (int i = 0; i < num_rows; i++)
     static_cast<QStringList*>(d_data)->replace(first + i, new_values.at(i));
   d_validity.setValue(Interval<int>(first, first + num_rows - 1), false);
+  emit d_owner->rowsChanged(d_owner, changed_first,
+                            first + num_rows - changed_first);
   emit d_owner->dataChanged(d_owner);
 }
 
@@ -925,9 +1037,11 @@ void Column::Private::setTimeAt(int row, const QTime& new_value) {
 }
 
 void Column::Private::setDateTimeAt(int row, const QDateTime& new_value) {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeDateTime) return;
 
   emit d_owner->dataAboutToChange(d_owner);
+  int changed_first = qMin(row, rowCount());
   if (row >= rowCount()) {
     if (row + 1 - rowCount() >
         1)  // we are adding more than one row in resizeTo()
@@ -935,33 +1049,40 @@ void Column::Private::setDateTimeAt(int row, const QDateTime& new_value) {
     resizeTo(row + 1);
   }
 
-  static_cast<QList<QDateTime>*>(d_data)->replace(row, new_value);
+  static_cast<DateTimeVector*>(d_data)->replace(row, new_value);
   d_validity.setValue(Interval<int>(row, row), !new_value.isValid());
+  emit d_owner->rowsChanged(d_owner, changed_first, row - changed_first + 1);
   emit d_owner->dataChanged(d_owner);
 }
 
 void Column::Private::replaceDateTimes(int first,
                                        const QList<QDateTime>& new_values) {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeDateTime) return;
 
   emit d_owner->dataAboutToChange(d_owner);
+  int changed_first = qMin(first, rowCount());
   int num_rows = new_values.size();
   if (first + 1 - rowCount() > 1)
     d_validity.setValue(Interval<int>(rowCount(), first - 1), true);
   if (first + num_rows > rowCount()) resizeTo(first + num_rows);
 
+  DateTimeVector* vector = static_cast<DateTimeVector*>(d_data);
   for (int i = 0; i < num_rows; i++) {
-    static_cast<QList<QDateTime>*>(d_data)->replace(first + i,
-                                                    new_values.at(i));
-    d_validity.setValue(i, !new_values.at(i).isValid());
+    vector->replace(first + i, new_values.at(i));
+    d_validity.setValue(first + i, !new_values.at(i).isValid());
   }
+  emit d_owner->rowsChanged(d_owner, changed_first,
+                            first + num_rows - changed_first);
   emit d_owner->dataChanged(d_owner);
 }
 
 void Column::Private::setValueAt(int row, double new_value) {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeDouble) return;
 
   emit d_owner->dataAboutToChange(d_owner);
+  int changed_first = qMin(row, rowCount());
   if (row >= rowCount()) {
     if (row + 1 - rowCount() >
         1)  // we are adding more than one row in resizeTo()
@@ -971,14 +1092,18 @@ void Column::Private::setValueAt(int row, double new_value) {
 
   static_cast<QVector<double>*>(d_data)->replace(row, new_value);
   d_validity.setValue(Interval<int>(row, row), false);
+  emit d_owner->rowsChanged(d_owner, changed_first, row - changed_first + 1);
   emit d_owner->dataChanged(d_owner);
 }
 
-void Column::Private::replaceValues(int first,
-                                    const QVector<qreal>& new_values) {
+void Column::Private::replaceValues(
+    int first, const QVector<qreal>& new_values,
+    const IntervalAttribute<bool>& invalid_rows) {
+  pageIn();
   if (d_data_type != AlphaPlot::TypeDouble) return;
 
   emit d_owner->dataAboutToChange(d_owner);
+  int changed_first = qMin(first, rowCount());
   int num_rows = new_values.size();
   if (first + 1 - rowCount() > 1)
     d_validity.setValue(Interval<int>(rowCount(), first - 1), true);
@@ -986,7 +1111,14 @@ void Column::Private::replaceValues(int first,
 
   double* ptr = static_cast<QVector<double>*>(d_data)->data();
   for (int i = 0; i < num_rows; i++) ptr[first + i] = new_values.at(i);
-  d_validity.setValue(Interval<int>(first, first + num_rows - 1), false);
+  const Interval<int> replaced(first, first + num_rows - 1);
+  d_validity.setValue(replaced, false);
+  foreach (Interval<int> interval, invalid_rows.intervals()) {
+    interval = Interval<int>::intersection(interval, replaced);
+    if (interval.isValid()) d_validity.setValue(interval, true);
+  }
+  emit d_owner->rowsChanged(d_owner, changed_first,
+                            first + num_rows - changed_first);
   emit d_owner->dataChanged(d_owner);
 }
 
@@ -1007,8 +1139,58 @@ void Column::Private::replaceMasking(IntervalAttribute<bool> masking) {
 
 void Column::Private::replaceFormulas(IntervalAttribute<QString> formulas) {
   d_formulas = formulas;
+  emit d_owner->formulasChanged(d_owner);
 }
 
 QString Column::Private::name() const { return d_owner->name(); }
 
 QString Column::Private::comment() const { return d_owner->comment(); }
+
+void Column::Private::installPaged(void* data,
+                                   const IntervalAttribute<bool>& validity) {
+  switch (d_data_type) {
+    case AlphaPlot::TypeDouble:
+      delete static_cast<QVector<double>*>(d_data);
+      break;
+    case AlphaPlot::TypeString:
+      delete static_cast<QStringList*>(d_data);
+      break;
+    case AlphaPlot::TypeDateTime:
+    case AlphaPlot::TypeDay:
+    case AlphaPlot::TypeMonth:
+      delete static_cast<DateTimeVector*>(d_data);
+      break;
+  }
+  d_data = data;
+  d_validity = validity;
+}
+
+void Column::Private::setPaged(const XmlPagedData& paged) {
+  d_paged = paged;
+  d_paged_rows = paged.rows();
+  d_page_state.storeRelease(paged.isNull() ? 0 : 1);
+}
+
+void Column::Private::readPaged() const {
+  // the first thread to get here reads the rows, any other one waits until
+  // they are installed; rowCount() doesn't look at d_paged, so it may be
+  // released here
+  QMutexLocker locker(&d_page_mutex);
+  if (d_page_state.loadAcquire() != 1) return;
+  // the rows were there all along as far as anybody else is concerned, so
+  // they are put in place quietly
+  if (!d_owner->readPagedRows(d_paged)) {
+    d_page_state.storeRelease(2);
+    return;
+  }
+  d_paged = XmlPagedData();
+  d_page_state.storeRelease(0);
+}
+
+void Column::Private::pageInForChange() {
+  readPaged();
+  QMutexLocker locker(&d_page_mutex);
+  if (d_page_state.loadAcquire() == 0) return;
+  d_paged = XmlPagedData();
+  d_page_state.storeRelease(0);
+}
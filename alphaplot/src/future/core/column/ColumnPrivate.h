@@ -30,12 +30,16 @@
 #ifndef COLUMNPRIVATE_H
 #define COLUMNPRIVATE_H
 
+#include <QAtomicInt>
+#include <QMutex>
 #include <QObject>
 #include <QScopedPointer>
 
 #include "core/column/Column.h"
 #include "future/core/datatypes/NumericDateTimeBaseFilter.h"
+#include "lib/DateTimeVector.h"
 #include "lib/IntervalAttribute.h"
+#include "lib/XmlPagedData.h"
 class AbstractSimpleFilter;
 class QString;
 
@@ -139,6 +143,12 @@ class Column::Private {
   void insertRows(int before, int count);
   //! Remove 'count' rows starting from row 'first'
   void removeRows(int first, int count);
+  //! Move the former row permutation[k] to row k
+  /**
+   * Data, validity and masking are moved, formulas stay with their rows.
+   * The column is extended by invalid rows if 'permutation' is longer.
+   */
+  void permuteRows(const QVector<int>& permutation);
   //! Return the column name/label
   QString name() const;
   //! Return the column comment
@@ -156,7 +166,10 @@ class Column::Private {
   //! Clear the whole column
   void clear();
   //! Return the data pointer
-  void* dataPointer() const { return d_data; }
+  void* dataPointer() const {
+    pageIn();
+    return d_data;
+  }
   //! Return the input filter (for string -> data type conversion)
   AbstractSimpleFilter* inputFilter() const { return d_input_filter; }
   //! Return the output filter (for data type -> string  conversion)
@@ -173,7 +186,10 @@ class Column::Private {
   //! Replace data pointer and validity
   void replaceData(void* data, IntervalAttribute<bool> validity);
   //! Return the validity interval attribute
-  IntervalAttribute<bool> validityAttribute() { return d_validity; }
+  IntervalAttribute<bool> validityAttribute() {
+    pageIn();
+    return d_validity;
+  }
   //! Return the masking interval attribute
   IntervalAttribute<bool> maskingAttribute() { return d_masking; }
   //! Replace the list of intervals of masked rows
@@ -186,13 +202,25 @@ class Column::Private {
   //! \name IntervalAttribute related functions
   //@{
   //! Return whether a certain row contains an invalid value
-  bool isInvalid(int row) const { return d_validity.isSet(row); }
+  bool isInvalid(int row) const {
+    pageIn();
+    return d_validity.isSet(row);
+  }
   //! Return whether a certain interval of rows contains only invalid values
-  bool isInvalid(Interval<int> i) const { return d_validity.isSet(i); }
+  bool isInvalid(Interval<int> i) const {
+    pageIn();
+    return d_validity.isSet(i);
+  }
   //! Return all intervals of invalid rows
   QList<Interval<int> > invalidIntervals() const {
+    pageIn();
     return d_validity.intervals();
   }
+  //! Return the runs of valid rows within 'range'
+  QList<Interval<int> > validIntervals(Interval<int> range) const {
+    pageIn();
+    return d_validity.unsetIntervals(range);
+  }
   //! Return whether a certain row is masked
   bool isMasked(int row) const { return d_masking.isSet(row); }
   //! Return whether a certain interval of rows rows is fully masked
@@ -293,6 +321,11 @@ class Column::Private {
    * Use this only when dataType() is QDateTime
    */
   QDateTime dateTimeAt(int row) const;
+  //! Return the raw milliseconds since epoch in row 'row'
+  /**
+   * Use this only when dataType() is QDateTime
+   */
+  qint64 dateTimeMSecsAt(int row) const;
   //! Set the content of row 'row'
   /**
    * Use this only when dataType() is QDateTime
@@ -314,7 +347,9 @@ class Column::Private {
   /**
    * Use this only when dataType() is double
    */
-  void replaceValues(int first, const QVector<qreal>& new_values);
+  void replaceValues(
+      int first, const QVector<qreal>& new_values,
+      const IntervalAttribute<bool>& invalid_rows = IntervalAttribute<bool>());
   //@}
   //! Get current conversion filter from DateTime to double
   NumericDateTimeBaseFilter* getNumericDateTimeFilter();
@@ -322,7 +357,52 @@ class Column::Private {
   //! ownership
   void setNumericDateTimeFilter(NumericDateTimeBaseFilter* const newFilter);
 
+  //! \name paging
+  //@{
+  //! Leave the rows in the project file until they are first accessed
+  /**
+   * rowCount() reports the paged rows meanwhile; every other access to the
+   * data reads them through pageIn(). Call it on the thread owning the
+   * column, before anything else may read it.
+   */
+  void setPaged(const XmlPagedData& paged);
+  //! Return whether the rows are still in the project file
+  /**
+   * Rows which could not be read stay there too, so saving the project
+   * copies them unchanged rather than the invalid rows shown instead.
+   */
+  bool isPaged() const { return d_page_state.loadAcquire() != 0; }
+  //! Return the rows left in the project file
+  const XmlPagedData& paged() const { return d_paged; }
+  //! Read the rows from the project file if they are still there
+  /**
+   * Safe to call from several threads at once, e.g. from the workers of a
+   * QtConcurrent map reading the column: one of them reads the rows, the
+   * others wait for it.
+   */
+  void pageIn() const {
+    if (d_page_state.loadAcquire() == 1) readPaged();
+  }
+  //! Read the rows from the project file before changing them
+  /**
+   * Rows which could not be read are given up on here: the invalid rows
+   * shown instead are what gets changed and saved from now on.
+   */
+  void pageIn() {
+    if (d_page_state.loadAcquire() != 0) pageInForChange();
+  }
+  //! Install the rows read from the project file, without any signals
+  void installPaged(void* data, const IntervalAttribute<bool>& validity);
+  //@}
+
  private:
+  //! Let the owner read the paged rows
+  void readPaged() const;
+  void pageInForChange();
+  //! Copy date-times from 'source' keeping the time spec of each row
+  void copyDateTimes(const AbstractColumn* source, int source_start,
+                     int dest_start, int num_rows);
+
   //! \name data members
   //@{
   //! Data type string
@@ -340,7 +420,7 @@ class Column::Private {
   //! Pointer to the data vector
   /**
    * This will point to a QVector<double>, QStringList or
-   * QList<QDateTime> depending on the stored data type.
+   * DateTimeVector depending on the stored data type.
    */
   void* d_data;
   //! The input filter (for string -> data type conversion)
@@ -357,6 +437,15 @@ class Column::Private {
   QColor d_plot_designation_color;
   //! The owner column
   Column* d_owner;
+  //! Rows not read from the project file yet
+  mutable XmlPagedData d_paged;
+  //! Number of rows in d_paged
+  int d_paged_rows;
+  //! 1 while the rows are paged, 2 if they could not be read; set after
+  //! d_data is installed
+  mutable QAtomicInt d_page_state;
+  //! Held while the rows are read
+  mutable QMutex d_page_mutex;
   //@}
 };
 
@@ -0,0 +1,267 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Cached, incrementally updated statistics of a column */
+
+#include "core/column/ColumnStatistics.h"
+
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "core/column/Column.h"
+
+namespace {
+// rows per block; a changed cell costs recomputing this many rows
+const int block_size = 4096;
+// order statistics kept per block for quantiles of large columns
+const int sketch_size = 128;
+// changed blocks from which on they are recomputed on the thread pool
+const int parallel_blocks = 16;
+
+const double nan = std::numeric_limits<double>::quiet_NaN();
+}  // namespace
+
+ColumnStatistics::ColumnStatistics(const Column *column)
+    : d_column(column),
+      d_rows_announced(false),
+      d_summary_valid(false),
+      d_quantiles_valid(false) {
+  connect(column, SIGNAL(rowsChanged(const AbstractColumn *, int, int)), this,
+          SLOT(columnRowsChanged(const AbstractColumn *, int, int)));
+  connect(column, SIGNAL(dataChanged(const AbstractColumn *)), this,
+          SLOT(columnDataChanged(const AbstractColumn *)));
+  connect(column, SIGNAL(rowsInserted(const AbstractColumn *, int, int)),
+          this, SLOT(columnRowsInserted(const AbstractColumn *, int, int)));
+  connect(column, SIGNAL(rowsRemoved(const AbstractColumn *, int, int)), this,
+          SLOT(columnRowsRemoved(const AbstractColumn *, int, int)));
+  connect(column, SIGNAL(modeChanged(const AbstractColumn *)), this,
+          SLOT(invalidate()));
+}
+
+ColumnStatistics::Summary ColumnStatistics::summary() {
+  refresh();
+  return d_summary;
+}
+
+double ColumnStatistics::quantile(double p) {
+  refresh();
+  if (d_summary.count == 0) return nan;
+
+  if (!d_quantiles_valid) {
+    d_sorted.clear();
+    d_sketch.clear();
+    if (d_summary.count <= exact_quantile_rows) {
+      d_sorted.reserve(static_cast<size_t>(d_summary.count));
+      const int rows = d_column->rowCount();
+      for (const Interval<int> &run :
+           d_column->validIntervals(Interval<int>(0, rows - 1)))
+        for (int row = run.start(); row <= run.end() && row < rows; row++)
+          d_sorted.push_back(d_column->valueAt(row));
+      std::sort(d_sorted.begin(), d_sorted.end());
+    } else {
+      for (const Block &block : d_blocks) {
+        if (block.count == 0) continue;
+        const double weight = static_cast<double>(block.count) /
+                              static_cast<double>(block.sketch.size());
+        for (double value : block.sketch) d_sketch.emplace_back(value, weight);
+      }
+      std::sort(d_sketch.begin(), d_sketch.end());
+    }
+    d_quantiles_valid = true;
+  }
+
+  p = std::min(1.0, std::max(0.0, p));
+  if (!d_sorted.empty()) {
+    const double index = p * static_cast<double>(d_sorted.size() - 1);
+    const size_t lhs = static_cast<size_t>(index);
+    const double delta = index - static_cast<double>(lhs);
+    if (lhs + 1 >= d_sorted.size()) return d_sorted.back();
+    return (1 - delta) * d_sorted[lhs] + delta * d_sorted[lhs + 1];
+  }
+
+  // every sketch value stands for 'weight' neighbouring ranks; interpolate
+  // between the centres of these rank ranges
+  const double rank = p * static_cast<double>(d_summary.count - 1);
+  double covered = 0.0;
+  double previous_center = 0.0, previous_value = d_sketch.front().first;
+  for (size_t i = 0; i < d_sketch.size(); i++) {
+    const double value = d_sketch[i].first;
+    const double center = covered + 0.5 * (d_sketch[i].second - 1);
+    if (center >= rank) {
+      if (i == 0 || center <= previous_center) return value;
+      const double t = (rank - previous_center) / (center - previous_center);
+      return previous_value + t * (value - previous_value);
+    }
+    covered += d_sketch[i].second;
+    previous_center = center;
+    previous_value = value;
+  }
+  return d_sketch.back().first;
+}
+
+void ColumnStatistics::columnRowsChanged(const AbstractColumn *, int first,
+                                         int count) {
+  d_rows_announced = true;
+  mark(first, first + count - 1);
+}
+
+void ColumnStatistics::columnDataChanged(const AbstractColumn *) {
+  if (d_rows_announced)
+    d_rows_announced = false;
+  else
+    invalidate();
+}
+
+void ColumnStatistics::columnRowsInserted(const AbstractColumn *, int before,
+                                          int) {
+  markFrom(before);
+}
+
+void ColumnStatistics::columnRowsRemoved(const AbstractColumn *, int first,
+                                         int) {
+  markFrom(first);
+}
+
+void ColumnStatistics::invalidate() { markFrom(0); }
+
+void ColumnStatistics::markFrom(int first) {
+  mark(first, std::numeric_limits<int>::max());
+}
+
+void ColumnStatistics::mark(int first, int last) {
+  d_summary_valid = false;
+  d_quantiles_valid = false;
+  if (first < 0) first = 0;
+  const int blocks = static_cast<int>(d_blocks.size());
+  for (int b = first / block_size; b <= last / block_size && b < blocks; b++)
+    d_blocks[static_cast<size_t>(b)].dirty = true;
+}
+
+void ColumnStatistics::refresh() {
+  // the number of rows may change without any other signal than
+  // dataChanged(); the old last block may have lost or gained rows
+  const size_t blocks = static_cast<size_t>(
+      (d_column->rowCount() + block_size - 1) / block_size);
+  if (blocks != d_blocks.size()) {
+    const size_t old = d_blocks.size();
+    Block empty = Block();
+    empty.dirty = true;
+    d_blocks.resize(blocks, empty);
+    if (old > 0 && old - 1 < blocks) d_blocks[old - 1].dirty = true;
+    d_summary_valid = false;
+    d_quantiles_valid = false;
+  }
+
+  std::vector<int> dirty;
+  for (size_t b = 0; b < d_blocks.size(); b++)
+    if (d_blocks[b].dirty) dirty.push_back(static_cast<int>(b));
+  if (!dirty.empty()) {
+    d_summary_valid = false;
+    d_quantiles_valid = false;
+  }
+  if (dirty.size() >= static_cast<size_t>(parallel_blocks))
+    QtConcurrent::blockingMap(dirty, [this](int &b) { computeBlock(b); });
+  else
+    for (int b : dirty) computeBlock(b);
+
+  if (d_summary_valid) return;
+
+  Summary s = {0, 0.0, 0.0, nan, nan, nan, -1, -1};
+  double m2 = 0.0;
+  double compensation = 0.0;
+  for (const Block &block : d_blocks) {
+    if (block.count == 0) continue;
+    // Neumaier summation of the block sums
+    const double sum = s.sum + block.sum;
+    if (std::fabs(s.sum) >= std::fabs(block.sum))
+      compensation += (s.sum - sum) + block.sum;
+    else
+      compensation += (block.sum - sum) + s.sum;
+    s.sum = sum;
+
+    // pairwise merge of mean and squared deviations (Chan et al.)
+    const double n_a = static_cast<double>(s.count);
+    const double n_b = static_cast<double>(block.count);
+    const double n = n_a + n_b;
+    const double delta = block.mean - s.mean;
+    s.mean += delta * n_b / n;
+    m2 += block.m2 + delta * delta * n_a * n_b / n;
+    s.count += block.count;
+
+    if (s.min_row < 0 || block.min < s.min) {
+      s.min = block.min;
+      s.min_row = block.min_row;
+    }
+    if (s.max_row < 0 || block.max > s.max) {
+      s.max = block.max;
+      s.max_row = block.max_row;
+    }
+  }
+  s.sum += compensation;
+  if (s.count > 1) s.variance = m2 / static_cast<double>(s.count - 1);
+  d_summary = s;
+  d_summary_valid = true;
+}
+
+void ColumnStatistics::computeBlock(int index) {
+  Block &block = d_blocks[static_cast<size_t>(index)];
+  const int begin = index * block_size;
+  const int end = std::min(d_column->rowCount(), begin + block_size);
+
+  std::vector<double> values;
+  values.reserve(static_cast<size_t>(std::max(0, end - begin)));
+  block.min_row = -1;
+  block.max_row = -1;
+  if (begin < end) {
+    for (const Interval<int> &run :
+         d_column->validIntervals(Interval<int>(begin, end - 1))) {
+      for (int row = run.start(); row <= run.end() && row < end; row++) {
+        const double value = d_column->valueAt(row);
+        if (block.min_row < 0 || value < block.min) {
+          block.min = value;
+          block.min_row = row;
+        }
+        if (block.max_row < 0 || value > block.max) {
+          block.max = value;
+          block.max_row = row;
+        }
+        values.push_back(value);
+      }
+    }
+  }
+
+  // two passes over the block: the mean, then the squared deviations
+  block.count = static_cast<int>(values.size());
+  double sum = 0.0;
+  for (double value : values) sum += value;
+  block.sum = sum;
+  block.mean = block.count > 0 ? sum / block.count : 0.0;
+  double m2 = 0.0;
+  for (double value : values) m2 += (value - block.mean) * (value - block.mean);
+  block.m2 = m2;
+
+  std::sort(values.begin(), values.end());
+  const int samples = std::min(block.count, sketch_size);
+  block.sketch.resize(static_cast<size_t>(samples));
+  for (int j = 0; j < samples; j++) {
+    const int rank =
+        samples == 1
+            ? 0
+            : (j * (block.count - 1) + (samples - 1) / 2) / (samples - 1);
+    block.sketch[static_cast<size_t>(j)] = values[static_cast<size_t>(rank)];
+  }
+  block.dirty = false;
+}
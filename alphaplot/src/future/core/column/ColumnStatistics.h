@@ -0,0 +1,122 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Cached, incrementally updated statistics of a column */
+
+#ifndef COLUMNSTATISTICS_H
+#define COLUMNSTATISTICS_H
+
+#include <QObject>
+#include <vector>
+
+class AbstractColumn;
+class Column;
+
+//! Statistics of the valid rows of a column, kept up to date between calls
+/**
+ * The rows are split into blocks of a fixed size, each with its own count,
+ * mean, sum of squared deviations, min/max and a small quantile sketch.
+ * Edits reported by the column's rowsChanged() signal only mark the blocks
+ * they touch; inserted or removed rows mark the blocks after them, and any
+ * other data change marks every block. summary() and quantile() recompute
+ * the marked blocks (on the thread pool if there are many) and merge the
+ * block summaries, so small edits of huge columns are cheap.
+ *
+ * Blocks are merged with the pairwise update of Chan et al., which is as
+ * stable as Welford's algorithm, and block sums are added with Neumaier
+ * compensation.
+ *
+ * Quantiles are exact up to exact_quantile_rows valid rows. Beyond that
+ * they come from the merged block sketches, which are accurate to a small
+ * fraction of a percent in rank.
+ *
+ * Get the statistics of a column through Column::statistics().
+ */
+class ColumnStatistics : public QObject {
+  Q_OBJECT
+
+ public:
+  //! Number of valid rows up to which quantile() is exact
+  static const int exact_quantile_rows = 1 << 21;
+
+  struct Summary {
+    //! number of valid rows
+    int count;
+    double sum;
+    double mean;
+    //! sample variance, NaN for less than two rows
+    double variance;
+    double min;
+    double max;
+    //! first row holding min and max, -1 if there are no valid rows
+    int min_row;
+    int max_row;
+  };
+
+  explicit ColumnStatistics(const Column *column);
+
+  //! Statistics of all valid rows of the column
+  Summary summary();
+  //! The p-quantile (0 <= p <= 1) of the valid rows
+  /**
+   * Interpolates between the neighbouring order statistics like
+   * gsl_stats_quantile_from_sorted_data(). NaN if there are no valid rows.
+   */
+  double quantile(double p);
+
+ private slots:
+  void columnRowsChanged(const AbstractColumn *source, int first, int count);
+  void columnDataChanged(const AbstractColumn *source);
+  void columnRowsInserted(const AbstractColumn *source, int before,
+                          int count);
+  void columnRowsRemoved(const AbstractColumn *source, int first, int count);
+  void invalidate();
+
+ private:
+  struct Block {
+    bool dirty;
+    int count;
+    double sum;
+    double mean;
+    //! sum of squared deviations from the mean
+    double m2;
+    double min;
+    double max;
+    int min_row;
+    int max_row;
+    //! evenly spaced order statistics of the block, smallest to largest
+    std::vector<double> sketch;
+  };
+
+  //! Mark the blocks holding row first and all rows after it as changed
+  void markFrom(int first);
+  //! Mark the blocks holding rows first ... last as changed
+  void mark(int first, int last);
+  //! Recompute the changed blocks and the merged summary
+  void refresh();
+  void computeBlock(int index);
+
+  const Column *d_column;
+  std::vector<Block> d_blocks;
+  //! whether rowsChanged() announced the next dataChanged()
+  bool d_rows_announced;
+  bool d_summary_valid;
+  Summary d_summary;
+  //! sorted valid values (exact) or merged sketch (value, weight) pairs
+  bool d_quantiles_valid;
+  std::vector<double> d_sorted;
+  std::vector<std::pair<double, double>> d_sketch;
+};
+
+#endif  // COLUMNSTATISTICS_H
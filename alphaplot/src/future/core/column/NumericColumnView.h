@@ -0,0 +1,85 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Read-only view of the values of a numeric column */
+
+#ifndef NUMERICCOLUMNVIEW_H
+#define NUMERICCOLUMNVIEW_H
+
+#include <QVector>
+#include <algorithm>
+#include <limits>
+
+#include "lib/IntervalAttribute.h"
+
+//! Read-only view of the values and validity of a numeric column
+/**
+ * The view shares the column's value vector and its intervals of invalid
+ * rows instead of copying them. Both are implicitly shared, so the column
+ * detaches its own copy on the next change and the view keeps showing the
+ * data as it was when the view was taken.
+ *
+ * Invalid rows hold arbitrary values in data(); check them with isInvalid()
+ * or iterate over validIntervals().
+ *
+ * Get a view through Column::numericView(). Columns which do not store
+ * doubles give a null view.
+ */
+class NumericColumnView {
+ public:
+  NumericColumnView() : d_null(true) {}
+  NumericColumnView(const QVector<double> &values,
+                    const IntervalAttribute<bool> &validity)
+      : d_null(false), d_values(values), d_validity(validity) {}
+
+  bool isNull() const { return d_null; }
+  int size() const { return d_values.size(); }
+  //! The values of all rows, valid or not
+  const double *data() const { return d_values.constData(); }
+  double valueAt(int row) const { return d_values.at(row); }
+  bool isInvalid(int row) const { return d_validity.isSet(row); }
+  //! Return the runs of valid rows within 'range'
+  QList<Interval<int> > validIntervals(Interval<int> range) const {
+    return d_validity.unsetIntervals(range);
+  }
+  //! Return the runs of valid rows among all rows
+  QList<Interval<int> > validIntervals() const {
+    return validIntervals(Interval<int>(0, size() - 1));
+  }
+
+  //! Copy rows first ... first + count - 1 to every stride-th target element
+  /**
+   * Invalid rows become NaN and rows beyond the end of the column 0, which
+   * is what Table::cell() returns for them.
+   */
+  void copyTo(int first, int count, double *target, int stride = 1) const {
+    if (count <= 0) return;
+    const int end = std::max(first, std::min(first + count, size()));
+    for (int i = 0; i < count; i++)
+      target[i * stride] = first + i < end
+                               ? std::numeric_limits<double>::quiet_NaN()
+                               : 0.0;
+    const Interval<int> range(first, end - 1);
+    for (const Interval<int> &run : validIntervals(range))
+      for (int row = run.start(); row <= run.end(); row++)
+        target[(row - first) * stride] = d_values.at(row);
+  }
+
+ private:
+  bool d_null;
+  QVector<double> d_values;
+  IntervalAttribute<bool> d_validity;
+};
+
+#endif  // NUMERICCOLUMNVIEW_H
@@ -55,7 +55,7 @@ ColumnSetModeCmd::~ColumnSetModeCmd() {
       else if (d_new_type == AlphaPlot::TypeString)
         delete static_cast<QStringList*>(d_new_data);
       else if (d_new_type == AlphaPlot::TypeDateTime)
-        delete static_cast<QList<QDateTime>*>(d_new_data);
+        delete static_cast<DateTimeVector*>(d_new_data);
     }
   } else {
     if (d_new_data != d_old_data) {
@@ -64,7 +64,7 @@ ColumnSetModeCmd::~ColumnSetModeCmd() {
       else if (d_old_type == AlphaPlot::TypeString)
         delete static_cast<QStringList*>(d_old_data);
       else if (d_old_type == AlphaPlot::TypeDateTime)
-        delete static_cast<QList<QDateTime>*>(d_old_data);
+        delete static_cast<DateTimeVector*>(d_old_data);
     }
   }
   if (d_conversion_filter) delete d_conversion_filter;
@@ -278,6 +278,48 @@ void ColumnRemoveRowsCmd::undo() {
 // end of class ColumnRemoveRowsCmd
 ///////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////
+// class ColumnPermuteRowsCmd
+///////////////////////////////////////////////////////////////////////////
+ColumnPermuteRowsCmd::ColumnPermuteRowsCmd(Column::Private* col,
+                                           const QVector<int>& permutation,
+                                           QUndoCommand* parent)
+    : QUndoCommand(parent),
+      d_col(col),
+      d_permutation(permutation),
+      d_row_count(-1) {
+  setText(QObject::tr("%1: reorder %2 row(s)")
+              .arg(col->name())
+              .arg(permutation.size()));
+}
+
+ColumnPermuteRowsCmd::~ColumnPermuteRowsCmd() {}
+
+void ColumnPermuteRowsCmd::redo() {
+  if (d_row_count < 0) {
+    d_row_count = d_col->rowCount();
+    if (d_permutation.size() > d_row_count)
+      d_validity = d_col->validityAttribute();
+  }
+  d_col->permuteRows(d_permutation);
+}
+
+void ColumnPermuteRowsCmd::undo() {
+  // only the inverse is needed, the rows themselves are still there
+  QVector<int> inverse(d_permutation.size());
+  for (int k = 0; k < d_permutation.size(); k++)
+    inverse[d_permutation.at(k)] = k;
+  d_col->permuteRows(inverse);
+  if (d_permutation.size() > d_row_count) {
+    d_col->resizeTo(d_row_count);
+    d_col->replaceData(d_col->dataPointer(), d_validity);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////
+// end of class ColumnPermuteRowsCmd
+///////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////
 // class ColumnSetPlotDesignationCmd
 ///////////////////////////////////////////////////////////////////////////
@@ -319,14 +361,14 @@ ColumnClearCmd::~ColumnClearCmd() {
     else if (d_type == AlphaPlot::TypeString)
       delete static_cast<QStringList*>(d_empty_data);
     else if (d_type == AlphaPlot::TypeDateTime)
-      delete static_cast<QList<QDateTime>*>(d_empty_data);
+      delete static_cast<DateTimeVector*>(d_empty_data);
   } else {
     if (d_type == AlphaPlot::TypeDouble)
       delete static_cast<QVector<double>*>(d_data);
     else if (d_type == AlphaPlot::TypeString)
       delete static_cast<QStringList*>(d_data);
     else if (d_type == AlphaPlot::TypeDateTime)
-      delete static_cast<QList<QDateTime>*>(d_data);
+      delete static_cast<DateTimeVector*>(d_data);
   }
 }
 
@@ -340,7 +382,7 @@ void ColumnClearCmd::redo() {
       case AlphaPlot::TypeDateTime:
       case AlphaPlot::TypeDay:
       case AlphaPlot::TypeMonth:
-        d_empty_data = new QList<QDateTime>();
+        d_empty_data = new DateTimeVector();
         break;
       case AlphaPlot::TypeString:
         d_empty_data = new QStringList();
@@ -667,13 +709,14 @@ void ColumnReplaceTextsCmd::undo() {
 ///////////////////////////////////////////////////////////////////////////
 // class ColumnReplaceValuesCmd
 ///////////////////////////////////////////////////////////////////////////
-ColumnReplaceValuesCmd::ColumnReplaceValuesCmd(Column::Private* col, int first,
-                                               const QVector<qreal>& new_values,
-                                               QUndoCommand* parent)
+ColumnReplaceValuesCmd::ColumnReplaceValuesCmd(
+    Column::Private* col, int first, const QVector<qreal>& new_values,
+    const IntervalAttribute<bool>& invalid_rows, QUndoCommand* parent)
     : QUndoCommand(parent),
       d_col(col),
       d_first(first),
-      d_new_values(new_values) {
+      d_new_values(new_values),
+      d_invalid_rows(invalid_rows) {
   setText(QObject::tr("%1: replace the values for rows %2 to %3")
               .arg(col->name())
               .arg(first)
@@ -691,7 +734,7 @@ void ColumnReplaceValuesCmd::redo() {
     d_validity = d_col->validityAttribute();
     d_copied = true;
   }
-  d_col->replaceValues(d_first, d_new_values);
+  d_col->replaceValues(d_first, d_new_values, d_invalid_rows);
 }
 
 void ColumnReplaceValuesCmd::undo() {
@@ -725,7 +768,7 @@ ColumnReplaceDateTimesCmd::~ColumnReplaceDateTimesCmd() {}
 
 void ColumnReplaceDateTimesCmd::redo() {
   if (!d_copied) {
-    d_old_values = static_cast<QList<QDateTime>*>(d_col->dataPointer())
+    d_old_values = static_cast<DateTimeVector*>(d_col->dataPointer())
                        ->mid(d_first, d_new_values.count());
     d_row_count = d_col->rowCount();
     d_validity = d_col->validityAttribute();
@@ -258,6 +258,37 @@ class ColumnRemoveRowsCmd : public QUndoCommand {
 // end of class ColumnRemoveRowsCmd
 ///////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////
+// class ColumnPermuteRowsCmd
+///////////////////////////////////////////////////////////////////////////
+//! Reorder the rows of a column, e.g. to sort it
+class ColumnPermuteRowsCmd : public QUndoCommand {
+ public:
+  //! Ctor
+  ColumnPermuteRowsCmd(Column::Private* col, const QVector<int>& permutation,
+                       QUndoCommand* parent = 0);
+  //! Dtor
+  ~ColumnPermuteRowsCmd();
+
+  //! Execute the command
+  virtual void redo();
+  //! Undo the command
+  virtual void undo();
+
+ private:
+  //! The private column data to modify
+  Column::Private* d_col;
+  //! Row k receives the former row d_permutation[k]
+  QVector<int> d_permutation;
+  //! The number of rows before the first redo()
+  int d_row_count;
+  //! The old validity, only saved if the column is extended
+  IntervalAttribute<bool> d_validity;
+};
+///////////////////////////////////////////////////////////////////////////
+// end of class ColumnPermuteRowsCmd
+///////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////
 // class ColumnSetPlotDesignationCmd
 ///////////////////////////////////////////////////////////////////////////
@@ -655,9 +686,14 @@ class ColumnReplaceTextsCmd : public QUndoCommand {
 class ColumnReplaceValuesCmd : public QUndoCommand {
  public:
   //! Ctor
-  ColumnReplaceValuesCmd(Column::Private* col, int first,
-                         const QVector<qreal>& new_values,
-                         QUndoCommand* parent = 0);
+  /**
+   * Rows of 'invalid_rows' (row numbers of the column) are marked invalid,
+   * the other replaced rows valid.
+   */
+  ColumnReplaceValuesCmd(
+      Column::Private* col, int first, const QVector<qreal>& new_values,
+      const IntervalAttribute<bool>& invalid_rows = IntervalAttribute<bool>(),
+      QUndoCommand* parent = 0);
   //! Dtor
   ~ColumnReplaceValuesCmd();
 
@@ -673,6 +709,8 @@ class ColumnReplaceValuesCmd : public QUndoCommand {
   int d_first;
   //! The new values
   QVector<qreal> d_new_values;
+  //! The replaced rows marked invalid
+  IntervalAttribute<bool> d_invalid_rows;
   //! The old values
   QVector<qreal> d_old_values;
   //! Status flag
@@ -47,6 +47,9 @@ class DateTime2DoubleFilter : public NumericDateTimeBaseFilter {
 
   virtual double valueAt(int row) const {
     if (!d_inputs.value(0)) return 0.0;
+    // fixed length units need no calendar arithmetic, use the raw msecs
+    if (hasFixedLengthUnit())
+      return msecsOffsetToDouble(d_inputs.value(0)->dateTimeMSecsAt(row));
     QDateTime input_value = d_inputs.value(0)->dateTimeAt(row);
     return offsetToDouble(input_value);
   }
@@ -30,6 +30,8 @@
 
 #include <math.h>
 
+#include "lib/DateTimeVector.h"
+
 const QDateTime NumericDateTimeBaseFilter::zeroOffsetDate =
     QDateTime::fromMSecsSinceEpoch(0);
 static const double milliSecondsInDay = 86400000.0;
@@ -94,6 +96,37 @@ void NumericDateTimeBaseFilter::setBaseDateTime(const QDateTime &date) {
     m_date_time_0 = date;
   else
     m_date_time_0 = zeroOffsetDate;
+  m_msecs_0 = m_date_time_0.toMSecsSinceEpoch();
+}
+
+bool NumericDateTimeBaseFilter::hasFixedLengthUnit() const {
+  switch (m_unit_interval) {
+    case UnitInterval::Hour:
+    case UnitInterval::Minute:
+    case UnitInterval::Second:
+    case UnitInterval::Millisecond:
+      return true;
+    default:
+      return false;
+  }
+}
+
+double NumericDateTimeBaseFilter::msecsOffsetToDouble(qint64 msecs) const {
+  // QDateTime::msecsTo() returns 0 for invalid date-times
+  if (msecs == DateTimeVector::invalidMSecs()) return 0.0;
+  const double offset = static_cast<double>(msecs - m_msecs_0);
+  switch (m_unit_interval) {
+    case UnitInterval::Hour:
+      return offset / 1000.0 / 3600.0;
+    case UnitInterval::Minute:
+      return offset / 1000.0 / 60.0;
+    case UnitInterval::Second:
+      return offset / 1000.0;
+    case UnitInterval::Millisecond:
+      return offset;
+    default:
+      return offsetToDouble(QDateTime::fromMSecsSinceEpoch(msecs));
+  }
 }
 
 double NumericDateTimeBaseFilter::offsetToDouble(
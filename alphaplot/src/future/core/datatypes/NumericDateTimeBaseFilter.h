@@ -64,12 +64,14 @@ class NumericDateTimeBaseFilter : public AbstractSimpleFilter {
         m_date_time_0(
             (date_time_0.isValid())
                 ? (date_time_0)
-                : (zeroOffsetDate)){};  // default to zeroOffsetDate if invalid
-                                        // datetime provided
+                : (zeroOffsetDate)),  // default to zeroOffsetDate if invalid
+                                      // datetime provided
+        m_msecs_0(m_date_time_0.toMSecsSinceEpoch()){};
 
   NumericDateTimeBaseFilter(const NumericDateTimeBaseFilter &other)
       : m_unit_interval(other.m_unit_interval),
-        m_date_time_0(other.m_date_time_0){};
+        m_date_time_0(other.m_date_time_0),
+        m_msecs_0(other.m_msecs_0){};
 
   //! Save to XML
   void writeExtraAttributes(QXmlStreamWriter *writer) const override;
@@ -82,12 +84,17 @@ class NumericDateTimeBaseFilter : public AbstractSimpleFilter {
  protected:
   // convert the given date to double wrt unit, offset and base date
   double offsetToDouble(const QDateTime &m_offset) const;
+  // true if the unit has a fixed length in milliseconds (hour and below)
+  bool hasFixedLengthUnit() const;
+  // same as offsetToDouble() for raw msecs, only valid for fixed length units
+  double msecsOffsetToDouble(qint64 msecs) const;
   // convert the given numerical offset to DateTime wrt unit and base date
   QDateTime makeDateTime(double input_value) const;
 
  private:
   UnitInterval m_unit_interval;
   QDateTime m_date_time_0;
+  qint64 m_msecs_0;
 
   void setUnitInterval(const UnitInterval unit);
   void setBaseDateTime(const QDateTime &date);
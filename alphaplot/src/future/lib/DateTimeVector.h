@@ -0,0 +1,229 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Contiguous storage for date-time column data */
+
+#ifndef DATETIMEVECTOR_H
+#define DATETIMEVECTOR_H
+
+#include <QDateTime>
+#include <QList>
+#include <QVector>
+#include <limits>
+
+//! Contiguous storage for DateTime, Month and Day columns
+/**
+ * Values are kept as milliseconds since the epoch (1970-01-01T00:00:00 UTC)
+ * in one QVector<qint64>. Invalid date-times are stored as invalidMSecs().
+ *
+ * The vector has a time spec (and offset for Qt::OffsetFromUTC) that at()
+ * uses for the cells. Cells given with another spec keep theirs in a second
+ * vector of spec codes, which is only allocated once such a cell is stored,
+ * so columns with a single spec cost no more than their milliseconds. Cells
+ * with a Qt::TimeZone spec are kept with the offset from UTC they had, as
+ * the time zone itself is not stored.
+ */
+class DateTimeVector {
+ public:
+  DateTimeVector(Qt::TimeSpec spec = Qt::LocalTime, int offset_from_utc = 0)
+      : d_spec(spec), d_offset_from_utc(offset_from_utc) {}
+  explicit DateTimeVector(const QList<QDateTime>& list)
+      : d_spec(Qt::LocalTime), d_offset_from_utc(0) {
+    foreach (const QDateTime& dt, list)
+      if (dt.isValid()) {
+        adoptTimeSpec(dt);
+        break;
+      }
+    d_msecs.reserve(list.size());
+    foreach (const QDateTime& dt, list)
+      append(dt);
+  }
+
+  //! Marker for an invalid date-time
+  static qint64 invalidMSecs() { return std::numeric_limits<qint64>::min(); }
+  //! Convert a QDateTime to the stored representation
+  static qint64 toMSecs(const QDateTime& dt) {
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : invalidMSecs();
+  }
+  //! Convert a stored value back to a QDateTime using the vector's time spec
+  QDateTime fromMSecs(qint64 msecs) const {
+    return fromMSecs(msecs, columnSpec());
+  }
+
+  //! Spec code of cells using the vector's time spec
+  static qint32 columnSpec() { return std::numeric_limits<qint32>::min(); }
+  //! Spec code of a time spec; other codes are offsets from UTC in seconds
+  static qint32 specCode(Qt::TimeSpec spec, int offset_from_utc = 0) {
+    switch (spec) {
+      case Qt::LocalTime:
+        return columnSpec() + 1;
+      case Qt::UTC:
+        return columnSpec() + 2;
+      default:
+        return offset_from_utc;
+    }
+  }
+
+  int size() const { return d_msecs.size(); }
+  bool isEmpty() const { return d_msecs.isEmpty(); }
+  void reserve(int size) { d_msecs.reserve(size); }
+  void resize(int new_size) {
+    int old_size = d_msecs.size();
+    d_msecs.resize(new_size);
+    for (int i = old_size; i < new_size; i++) d_msecs[i] = invalidMSecs();
+    if (!d_cell_specs.isEmpty()) {
+      d_cell_specs.resize(new_size);
+      for (int i = old_size; i < new_size; i++) d_cell_specs[i] = columnSpec();
+    }
+  }
+  void clear() {
+    d_msecs.clear();
+    d_cell_specs.clear();
+  }
+
+  //! Return the raw value in row 'row' or invalidMSecs() if out of range
+  qint64 msecsAt(int row) const {
+    return d_msecs.value(row, invalidMSecs());
+  }
+  //! Return the spec code of row 'row'
+  qint32 specAt(int row) const {
+    return d_cell_specs.value(row, columnSpec());
+  }
+  //! Return the QDateTime in row 'row' (invalid if out of range)
+  QDateTime at(int row) const { return fromMSecs(msecsAt(row), specAt(row)); }
+  //! Set the raw value in row 'row', to be shown in the vector's time spec
+  void setMSecs(int row, qint64 msecs) {
+    d_msecs[row] = msecs;
+    if (!d_cell_specs.isEmpty()) d_cell_specs[row] = columnSpec();
+  }
+  void replace(int row, const QDateTime& dt) {
+    d_msecs[row] = toMSecs(dt);
+    setSpecAt(row, cellSpec(dt));
+  }
+  void append(const QDateTime& dt) {
+    if (d_msecs.isEmpty()) adoptTimeSpec(dt);
+    d_msecs.append(toMSecs(dt));
+    if (!d_cell_specs.isEmpty()) d_cell_specs.append(columnSpec());
+    setSpecAt(d_msecs.size() - 1, cellSpec(dt));
+  }
+  void appendMSecs(qint64 msecs) {
+    d_msecs.append(msecs);
+    if (!d_cell_specs.isEmpty()) d_cell_specs.append(columnSpec());
+  }
+  void insert(int before, int count) {
+    d_msecs.insert(before, count, invalidMSecs());
+    if (!d_cell_specs.isEmpty())
+      d_cell_specs.insert(before, count, columnSpec());
+  }
+  void remove(int first, int count) {
+    d_msecs.remove(first, count);
+    if (!d_cell_specs.isEmpty()) d_cell_specs.remove(first, count);
+  }
+  //! Copy 'count' rows from 'source_start' in 'source' to 'dest_start'
+  /**
+   * The rows keep the time specs they have in 'source'.
+   */
+  void copy(const DateTimeVector& source, int source_start, int dest_start,
+            int count) {
+    for (int i = 0; i < count; i++) {
+      d_msecs[dest_start + i] = source.msecsAt(source_start + i);
+      qint32 spec = source.specAt(source_start + i);
+      if (spec == columnSpec())
+        spec = specCode(source.d_spec, source.d_offset_from_utc);
+      if (spec == specCode(d_spec, d_offset_from_utc)) spec = columnSpec();
+      setSpecAt(dest_start + i, spec);
+    }
+  }
+  //! Reorder the rows; row k becomes the old row permutation[k]
+  void permute(const QVector<int>& permutation) {
+    const QVector<qint64> old_msecs = d_msecs;
+    const QVector<qint32> old_specs = d_cell_specs;
+    for (int k = 0; k < permutation.size(); k++) {
+      const int row = permutation.at(k);
+      d_msecs[k] = old_msecs.at(row);
+      if (!old_specs.isEmpty()) d_cell_specs[k] = old_specs.at(row);
+    }
+  }
+  //! Return a range of rows as QDateTimes
+  QList<QDateTime> mid(int first, int count) const {
+    QList<QDateTime> list;
+    int last = qMin(first + count, d_msecs.size());
+    list.reserve(qMax(0, last - first));
+    for (int i = first; i < last; i++) list.append(at(i));
+    return list;
+  }
+
+  const qint64* constData() const { return d_msecs.constData(); }
+  qint64* data() { return d_msecs.data(); }
+  const QVector<qint64>& msecs() const { return d_msecs; }
+  //! Spec codes of all rows, empty if all rows use the vector's time spec
+  const QVector<qint32>& cellSpecs() const { return d_cell_specs; }
+  //! Set the spec codes of all rows; 'specs' is empty or has size() codes
+  void setCellSpecs(const QVector<qint32>& specs) { d_cell_specs = specs; }
+
+  Qt::TimeSpec timeSpec() const { return d_spec; }
+  int offsetFromUtc() const { return d_offset_from_utc; }
+  void setTimeSpec(Qt::TimeSpec spec, int offset_from_utc = 0) {
+    d_spec = spec;
+    d_offset_from_utc = offset_from_utc;
+  }
+  //! Copy the time spec of another vector
+  void copyTimeSpec(const DateTimeVector& other) {
+    d_spec = other.d_spec;
+    d_offset_from_utc = other.d_offset_from_utc;
+  }
+
+ private:
+  QDateTime fromMSecs(qint64 msecs, qint32 spec) const {
+    if (msecs == invalidMSecs()) return QDateTime();
+    if (spec == columnSpec())
+      return QDateTime::fromMSecsSinceEpoch(msecs, d_spec, d_offset_from_utc);
+    if (spec == specCode(Qt::LocalTime))
+      return QDateTime::fromMSecsSinceEpoch(msecs, Qt::LocalTime);
+    if (spec == specCode(Qt::UTC))
+      return QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+    return QDateTime::fromMSecsSinceEpoch(msecs, Qt::OffsetFromUTC, spec);
+  }
+  //! Spec code 'dt' is stored with
+  qint32 cellSpec(const QDateTime& dt) const {
+    if (!dt.isValid()) return columnSpec();
+    const Qt::TimeSpec spec =
+        (dt.timeSpec() == Qt::TimeZone) ? Qt::OffsetFromUTC : dt.timeSpec();
+    const int offset = (spec == Qt::OffsetFromUTC) ? dt.offsetFromUtc() : 0;
+    if (spec == d_spec && offset == d_offset_from_utc) return columnSpec();
+    return specCode(spec, offset);
+  }
+  void setSpecAt(int row, qint32 spec) {
+    if (d_cell_specs.isEmpty()) {
+      if (spec == columnSpec()) return;
+      d_cell_specs.fill(columnSpec(), d_msecs.size());
+    }
+    d_cell_specs[row] = spec;
+  }
+  void adoptTimeSpec(const QDateTime& dt) {
+    if (!dt.isValid()) return;
+    d_spec = (dt.timeSpec() == Qt::TimeZone) ? Qt::OffsetFromUTC
+                                             : dt.timeSpec();
+    d_offset_from_utc =
+        (d_spec == Qt::OffsetFromUTC) ? dt.offsetFromUtc() : 0;
+  }
+
+  QVector<qint64> d_msecs;
+  //! Spec code per row, or empty while all rows use d_spec
+  QVector<qint32> d_cell_specs;
+  Qt::TimeSpec d_spec;
+  int d_offset_from_utc;
+};
+
+#endif  // DATETIMEVECTOR_H
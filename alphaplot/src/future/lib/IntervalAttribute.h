@@ -30,113 +30,66 @@
 #ifndef INTERVALATTRIBUTE_H
 #define INTERVALATTRIBUTE_H
 
-#include "Interval.h"
 #include <QList>
+#include <algorithm>
+
+#include "Interval.h"
 
 //! A class representing an interval-based attribute
+/**
+ * The intervals are kept sorted by their start row and never overlap, so
+ * that value() only needs a binary search and setValue() only touches the
+ * intervals overlapping the new one.
+ */
 template <class T>
 class IntervalAttribute {
  public:
   void setValue(Interval<int> i, T value) {
+    if (!i.isValid()) return;
     // first: subtract the new interval from all others
-    QList<Interval<int> > temp_list;
-    for (int c = 0; c < d_intervals.size(); c++) {
-      temp_list = Interval<int>::subtract(d_intervals.at(c), i);
-      if (temp_list.isEmpty()) {
-        d_intervals.removeAt(c);
-        d_values.removeAt(c--);
-      } else {
-        d_intervals.replace(c, temp_list.at(0));
-        if (temp_list.size() > 1) {
-          d_intervals.insert(c, temp_list.at(1));
-          d_values.insert(c, d_values.at(c));
-        }
-      }
-    }
-
-    // second: try to merge the new interval with an old one
-    for (int c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).touches(i) && d_values.at(c) == value) {
-        d_intervals.replace(c, Interval<int>::merge(d_intervals.at(c), i));
-        return;
-      }
-    }
-    // if it could not be merged, just append it
-    d_intervals.append(i);
-    d_values.append(value);
+    int c = cutOut(i);
+    // second: insert the new interval and merge it with equal neighbours
+    d_intervals.insert(c, i);
+    d_values.insert(c, value);
+    mergeWithNext(c);
+    if (c > 0) mergeWithNext(c - 1);
   }
 
   // overloaded for convenience
   void setValue(int row, T value) { setValue(Interval<int>(row, row), value); }
 
   T value(int row) const {
-    for (int c = d_intervals.size() - 1; c >= 0; c--) {
-      if (d_intervals.at(c).contains(row)) return d_values.at(c);
-    }
+    int c = firstEndingAtOrAfter(row);
+    if (c < d_intervals.size() && d_intervals.at(c).start() <= row)
+      return d_values.at(c);
     return T();
   }
 
   void insertRows(int before, int count) {
-    QList<Interval<int> > temp_list;
-    // first: split all intervals that contain 'before'
-    for (int c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).contains(before)) {
-        temp_list = Interval<int>::split(d_intervals.at(c), before);
-        d_intervals.replace(c, temp_list.at(0));
-        if (temp_list.size() > 1) {
-          d_intervals.insert(c, temp_list.at(1));
-          d_values.insert(c, d_values.at(c));
-          c++;
-        }
-      }
+    int c = firstEndingAtOrAfter(before);
+    if (c >= d_intervals.size()) return;
+    // first: split the interval that contains 'before'
+    if (d_intervals.at(c).start() < before) {
+      QList<Interval<int> > temp_list =
+          Interval<int>::split(d_intervals.at(c), before);
+      d_intervals.replace(c, temp_list.at(0));
+      d_intervals.insert(c + 1, temp_list.at(1));
+      d_values.insert(c + 1, d_values.at(c));
+      c++;
     }
     // second: translate all intervals that start at 'before' or later
-    for (int c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).start() >= before) d_intervals[c].translate(count);
-    }
+    for (; c < d_intervals.size(); c++) d_intervals[c].translate(count);
   }
 
   void removeRows(int first, int count) {
-    QList<Interval<int> > temp_list;
-    Interval<int> i(first, first + count - 1);
+    if (count <= 0) return;
     // first: remove the relevant rows from all intervals
-    for (int c = 0; c < d_intervals.size(); c++) {
-      temp_list = Interval<int>::subtract(d_intervals.at(c), i);
-      if (temp_list.isEmpty()) {
-        d_intervals.removeAt(c);
-        d_values.removeAt(c--);
-      } else {
-        d_intervals.replace(c, temp_list.at(0));
-        if (temp_list.size() > 1) {
-          d_intervals.insert(c, temp_list.at(1));
-          d_values.insert(c, d_values.at(c));
-          c++;
-        }
-      }
-    }
+    int c = cutOut(Interval<int>(first, first + count - 1));
     // second: translate all intervals that start at 'first+count' or later
-    for (int c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).start() >= first + count)
-        d_intervals[c].translate(-count);
-    }
-    // third: merge as many intervals as possible
-    QList<T> values_copy = d_values;
-    QList<Interval<int> > intervals_copy = d_intervals;
-    d_values.clear();
-    d_intervals.clear();
-    for (int c = 0; c < intervals_copy.size(); c++) {
-      i = intervals_copy.at(c);
-      T value = values_copy.at(c);
-      for (int cc = 0; cc < d_intervals.size(); cc++) {
-        if (d_intervals.at(cc).touches(i) && d_values.at(cc) == value) {
-          d_intervals.replace(cc, Interval<int>::merge(d_intervals.at(cc), i));
-          return;
-        }
-      }
-      // if it could not be merged, just append it
-      d_intervals.append(i);
-      d_values.append(value);
-    }
+    for (int cc = c; cc < d_intervals.size(); cc++)
+      d_intervals[cc].translate(-count);
+    // third: merge the intervals at both sides of the removed rows
+    if (c > 0) mergeWithNext(c - 1);
   }
 
   void clear() {
@@ -147,42 +100,120 @@ class IntervalAttribute {
   QList<Interval<int> > intervals() const { return d_intervals; }
   QList<T> values() const { return d_values; }
   IntervalAttribute<T>& operator=(const IntervalAttribute<T>& other) {
-    d_intervals.clear();
-    d_values.clear();
-    foreach (Interval<int> iv, other.intervals())
-      d_intervals.append(iv);
-    foreach (T value, other.values())
-      d_values.append(value);
+    d_intervals = other.d_intervals;
+    d_values = other.d_values;
     return *this;
   }
 
  private:
+  //! Index of the first interval with end() >= row (binary search)
+  int firstEndingAtOrAfter(int row) const {
+    return std::lower_bound(d_intervals.constBegin(), d_intervals.constEnd(),
+                            row,
+                            [](const Interval<int>& iv, int r) {
+                              return iv.end() < r;
+                            }) -
+           d_intervals.constBegin();
+  }
+
+  //! Remove the rows of 'i' from all intervals, return the insert position
+  int cutOut(Interval<int> i) {
+    int first = firstEndingAtOrAfter(i.start());
+    int last = first;
+    QList<Interval<int> > pieces;
+    QList<T> piece_values;
+    while (last < d_intervals.size() &&
+           d_intervals.at(last).start() <= i.end()) {
+      const Interval<int>& iv = d_intervals.at(last);
+      if (iv.start() < i.start()) {
+        pieces.append(Interval<int>(iv.start(), i.start() - 1));
+        piece_values.append(d_values.at(last));
+      }
+      if (iv.end() > i.end()) {
+        pieces.append(Interval<int>(i.end() + 1, iv.end()));
+        piece_values.append(d_values.at(last));
+      }
+      last++;
+    }
+    d_intervals.erase(d_intervals.begin() + first,
+                      d_intervals.begin() + last);
+    d_values.erase(d_values.begin() + first, d_values.begin() + last);
+    int pos = first;
+    for (int p = 0; p < pieces.size(); p++) {
+      d_intervals.insert(first + p, pieces.at(p));
+      d_values.insert(first + p, piece_values.at(p));
+      // the left piece (if any) lies before the cut out interval
+      if (pieces.at(p).start() < i.start()) pos++;
+    }
+    return pos;
+  }
+
+  //! Merge interval c with interval c+1 if they touch and have equal values
+  void mergeWithNext(int c) {
+    if (c + 1 >= d_intervals.size()) return;
+    if (d_intervals.at(c).touches(d_intervals.at(c + 1)) &&
+        d_values.at(c) == d_values.at(c + 1)) {
+      d_intervals.replace(c, Interval<int>::merge(d_intervals.at(c),
+                                                  d_intervals.at(c + 1)));
+      d_intervals.removeAt(c + 1);
+      d_values.removeAt(c + 1);
+    }
+  }
+
   QList<T> d_values;
   QList<Interval<int> > d_intervals;
 };
 
 //! A class representing an interval-based attribute (bool version)
+/**
+ * Only the intervals where the attribute is set are stored. They are kept
+ * sorted by their start row and never overlap or touch, so isSet() is a
+ * binary search. unsetIntervals() returns the runs of unset rows at once,
+ * e.g. all valid rows of a validity attribute.
+ */
 template <>
 class IntervalAttribute<bool> {
  public:
   IntervalAttribute<bool>() {}
-  IntervalAttribute<bool>(QList<Interval<int> > intervals)
-      : d_intervals(intervals) {}
+  IntervalAttribute<bool>(QList<Interval<int> > intervals) {
+    std::sort(intervals.begin(), intervals.end(),
+              [](const Interval<int>& a, const Interval<int>& b) {
+                return a.start() < b.start();
+              });
+    foreach (Interval<int> iv, intervals) {
+      if (!iv.isValid()) continue;
+      // sorted by start, so iv can only overlap or touch the last interval
+      if (!d_intervals.isEmpty() && d_intervals.last().end() >= iv.start() - 1)
+        d_intervals.last().setEnd(qMax(d_intervals.last().end(), iv.end()));
+      else
+        d_intervals.append(iv);
+    }
+  }
   IntervalAttribute<bool>& operator=(const IntervalAttribute<bool>& other) {
-    d_intervals.clear();
-    foreach (Interval<int> iv, other.intervals())
-      d_intervals.append(iv);
+    d_intervals = other.d_intervals;
     return *this;
   }
 
   void setValue(Interval<int> i, bool value = true) {
+    if (!i.isValid()) return;
     if (value) {
-      foreach (Interval<int> iv, d_intervals)
-        if (iv.contains(i)) return;
-
-      Interval<int>::mergeIntervalIntoList(&d_intervals, i);
+      // merge all intervals intersecting or touching i into one
+      int first = firstEndingAtOrAfter(i.start() - 1);
+      int last = first;
+      int start = i.start();
+      int end = i.end();
+      while (last < d_intervals.size() &&
+             d_intervals.at(last).start() <= i.end() + 1) {
+        start = qMin(start, d_intervals.at(last).start());
+        end = qMax(end, d_intervals.at(last).end());
+        last++;
+      }
+      if (last - first == 1 && d_intervals.at(first).contains(i)) return;
+      d_intervals.erase(d_intervals.begin() + first,
+                        d_intervals.begin() + last);
+      d_intervals.insert(first, Interval<int>(start, end));
     } else {  // unset
-      Interval<int>::subtractIntervalFromList(&d_intervals, i);
+      cutOut(i);
     }
   }
 
@@ -191,51 +222,57 @@ class IntervalAttribute<bool> {
   }
 
   bool isSet(int row) const {
-    foreach (Interval<int> iv, d_intervals)
-      if (iv.contains(row)) return true;
-    return false;
+    int c = firstEndingAtOrAfter(row);
+    return c < d_intervals.size() && d_intervals.at(c).start() <= row;
   }
 
   bool isSet(Interval<int> i) const {
-    foreach (Interval<int> iv, d_intervals)
-      if (iv.contains(i)) return true;
-    return false;
+    int c = firstEndingAtOrAfter(i.start());
+    return c < d_intervals.size() && d_intervals.at(c).contains(i);
+  }
+
+  //! Return the maximal runs of unset rows within 'range'
+  QList<Interval<int> > unsetIntervals(Interval<int> range) const {
+    QList<Interval<int> > result;
+    if (!range.isValid()) return result;
+    int pos = range.start();
+    for (int c = firstEndingAtOrAfter(range.start());
+         c < d_intervals.size() && d_intervals.at(c).start() <= range.end();
+         c++) {
+      if (d_intervals.at(c).start() > pos)
+        result.append(Interval<int>(pos, d_intervals.at(c).start() - 1));
+      pos = qMax(pos, d_intervals.at(c).end() + 1);
+    }
+    if (pos <= range.end()) result.append(Interval<int>(pos, range.end()));
+    return result;
   }
 
   void insertRows(int before, int count) {
-    QList<Interval<int> > temp_list;
-    int c;
-    // first: split all intervals that contain 'before'
-    for (c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).contains(before)) {
-        temp_list = Interval<int>::split(d_intervals.at(c), before);
-        d_intervals.replace(c, temp_list.at(0));
-        if (temp_list.size() > 1) d_intervals.insert(c++, temp_list.at(1));
-      }
+    int c = firstEndingAtOrAfter(before);
+    if (c >= d_intervals.size()) return;
+    // first: split the interval that contains 'before'
+    if (d_intervals.at(c).start() < before) {
+      QList<Interval<int> > temp_list =
+          Interval<int>::split(d_intervals.at(c), before);
+      d_intervals.replace(c, temp_list.at(0));
+      d_intervals.insert(++c, temp_list.at(1));
     }
     // second: translate all intervals that start at 'before' or later
-    for (c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).start() >= before) d_intervals[c].translate(count);
-    }
+    for (; c < d_intervals.size(); c++) d_intervals[c].translate(count);
   }
 
   void removeRows(int first, int count) {
-    int c;
+    if (count <= 0) return;
     // first: remove the relevant rows from all intervals
-    Interval<int>::subtractIntervalFromList(
-        &d_intervals, Interval<int>(first, first + count - 1));
+    int c = cutOut(Interval<int>(first, first + count - 1));
     // second: translate all intervals that start at 'first+count' or later
-    for (c = 0; c < d_intervals.size(); c++) {
-      if (d_intervals.at(c).start() >= first + count)
-        d_intervals[c].translate(-count);
-    }
-    // third: merge as many intervals as possible
-    for (c = d_intervals.size() - 1; c >= 0; c--) {
-      Interval<int> iv = d_intervals.takeAt(c);
-      int size_before = d_intervals.size();
-      Interval<int>::mergeIntervalIntoList(&d_intervals, iv);
-      if (size_before == d_intervals.size())  // merge successful
-        c--;
+    for (int cc = c; cc < d_intervals.size(); cc++)
+      d_intervals[cc].translate(-count);
+    // third: merge the intervals at both sides of the removed rows
+    if (c > 0 && c < d_intervals.size() &&
+        d_intervals.at(c - 1).touches(d_intervals.at(c))) {
+      d_intervals[c - 1].setEnd(d_intervals.at(c).end());
+      d_intervals.removeAt(c);
     }
   }
 
@@ -244,6 +281,40 @@ class IntervalAttribute<bool> {
   void clear() { d_intervals.clear(); }
 
  private:
+  //! Index of the first interval with end() >= row (binary search)
+  int firstEndingAtOrAfter(int row) const {
+    return std::lower_bound(d_intervals.constBegin(), d_intervals.constEnd(),
+                            row,
+                            [](const Interval<int>& iv, int r) {
+                              return iv.end() < r;
+                            }) -
+           d_intervals.constBegin();
+  }
+
+  //! Remove the rows of 'i' from all intervals, return the insert position
+  int cutOut(Interval<int> i) {
+    int first = firstEndingAtOrAfter(i.start());
+    int last = first;
+    QList<Interval<int> > pieces;
+    while (last < d_intervals.size() &&
+           d_intervals.at(last).start() <= i.end()) {
+      const Interval<int>& iv = d_intervals.at(last);
+      if (iv.start() < i.start())
+        pieces.append(Interval<int>(iv.start(), i.start() - 1));
+      if (iv.end() > i.end())
+        pieces.append(Interval<int>(i.end() + 1, iv.end()));
+      last++;
+    }
+    d_intervals.erase(d_intervals.begin() + first,
+                      d_intervals.begin() + last);
+    int pos = first;
+    for (int p = 0; p < pieces.size(); p++) {
+      d_intervals.insert(first + p, pieces.at(p));
+      if (pieces.at(p).start() < i.start()) pos++;
+    }
+    return pos;
+  }
+
   QList<Interval<int> > d_intervals;
 };
 
@@ -0,0 +1,345 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Bulk data of a project file, read on demand */
+
+#include "lib/XmlPagedData.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QScopedPointer>
+#include <QTemporaryFile>
+#include <QVector>
+#include <QXmlStreamReader>
+#include <QtDebug>
+#include <cstring>
+
+//! Project file shared by the XmlPagedData read from it
+class XmlPagedFile {
+ public:
+  explicit XmlPagedFile(const QString &filename);
+  ~XmlPagedFile();
+
+  bool open();
+  //! Whether the file is still the one strip() indexed
+  bool unchanged();
+  QFile *file() { return &d_file; }
+  QString path() const { return d_path; }
+  bool read(qint64 offset, qint64 length, QByteArray *data);
+  //! Read from a temporary copy of the file from now on
+  bool detach();
+
+  //! The files data is paged from
+  static QMutex s_mutex;
+  static QList<XmlPagedFile *> s_files;
+
+ private:
+  QMutex d_mutex;
+  QString d_path;
+  QFile d_file;
+  QScopedPointer<QTemporaryFile> d_copy;
+  QIODevice *d_device;
+  //! Size when strip() indexed the file
+  qint64 d_size;
+};
+
+QMutex XmlPagedFile::s_mutex;
+QList<XmlPagedFile *> XmlPagedFile::s_files;
+
+XmlPagedFile::XmlPagedFile(const QString &filename)
+    : d_path(QFileInfo(filename).canonicalFilePath()),
+      d_file(filename),
+      d_device(&d_file),
+      d_size(-1) {
+  QMutexLocker locker(&s_mutex);
+  s_files << this;
+}
+
+XmlPagedFile::~XmlPagedFile() {
+  QMutexLocker locker(&s_mutex);
+  s_files.removeAll(this);
+}
+
+bool XmlPagedFile::open() {
+  if (!d_file.open(QIODevice::ReadOnly)) return false;
+  d_size = d_file.size();
+  return true;
+}
+
+bool XmlPagedFile::unchanged() {
+  // the size of the open handle, so a file replaced by renaming another one
+  // over it still counts as unchanged; changes which keep the size mostly
+  // break the xml, which the readers check
+  return d_file.size() == d_size;
+}
+
+bool XmlPagedFile::read(qint64 offset, qint64 length, QByteArray *data) {
+  QMutexLocker locker(&d_mutex);
+  data->clear();
+  // the copy is ours, the file may have been changed by anybody
+  if (!d_copy && !unchanged()) return false;
+  if (!d_device->seek(offset)) return false;
+  *data = d_device->read(length);
+  return data->size() == length;
+}
+
+bool XmlPagedFile::detach() {
+  QMutexLocker locker(&d_mutex);
+  if (d_copy) return true;
+  if (!unchanged()) {
+    qDebug() << d_path << "changed since it was opened, not copied";
+    return false;
+  }
+  QScopedPointer<QTemporaryFile> copy(new QTemporaryFile);
+  bool ok = copy->open() && d_file.seek(0);
+  while (ok && !d_file.atEnd()) {
+    const QByteArray chunk = d_file.read(1 << 20);
+    ok = !chunk.isEmpty() && copy->write(chunk) == chunk.size();
+  }
+  if (!ok || !copy->flush()) {
+    qDebug() << "failed to copy" << d_path << "aside" << copy->errorString();
+    return false;
+  }
+  d_copy.swap(copy);
+  d_device = d_copy.data();
+  d_file.close();
+  return true;
+}
+
+namespace {
+bool startsWith(const char *pos, const char *end, const char *text) {
+  const size_t length = std::strlen(text);
+  return static_cast<size_t>(end - pos) >= length &&
+         std::memcmp(pos, text, length) == 0;
+}
+
+// position after the next occurrence of text, nullptr if there is none
+const char *skipPast(const char *pos, const char *end, const char *text) {
+  const size_t length = std::strlen(text);
+  for (; static_cast<size_t>(end - pos) >= length; pos++) {
+    pos = static_cast<const char *>(std::memchr(pos, text[0], end - pos));
+    if (!pos) return nullptr;
+    if (static_cast<size_t>(end - pos) >= length &&
+        std::memcmp(pos, text, length) == 0)
+      return pos + length;
+  }
+  return nullptr;
+}
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// elements holding bulk data, by the name of their parent
+bool isBulk(const QByteArray &parent, const QByteArray &name) {
+  return (parent == "column" && (name == "row" || name == "data")) ||
+         (parent == "matrix" && name == "cell");
+}
+
+// rows held by the bulk element with the start tag begin ... end
+int bulkRows(const QByteArray &name, const char *begin, const char *end) {
+  if (name != "data") return 1;
+  const char *value = skipPast(begin, end, " rows=\"");
+  if (!value) return 0;
+  int rows = 0;
+  for (; value < end && *value >= '0' && *value <= '9'; value++)
+    rows = rows * 10 + (*value - '0');
+  return rows;
+}
+}  // namespace
+
+XmlPagedData::XmlPagedData() : d_offset(0), d_length(0), d_rows(0) {}
+
+QString XmlPagedData::fileName() const {
+  return isNull() ? QString() : d_file->path();
+}
+
+bool XmlPagedData::read(QByteArray *elements) const {
+  elements->clear();
+  if (isNull()) return false;
+  QByteArray data;
+  if (!d_file->read(d_offset, d_length, &data)) {
+    qDebug() << "failed to read paged data from" << d_file->path();
+    return false;
+  }
+  *elements = "<paged>" + data + "</paged>";
+  return true;
+}
+
+bool XmlPagedData::write(QXmlStreamWriter *writer) const {
+  QByteArray elements;
+  if (!read(&elements)) {
+    XmlPagedDataErrors::report(
+        QObject::tr("Data not looked at since the project was opened could "
+                    "not be copied from %1, which was changed or truncated "
+                    "meanwhile. The project was not saved.")
+            .arg(fileName()));
+    return false;
+  }
+  QXmlStreamReader reader(elements);
+  int depth = 0;
+  while (!reader.atEnd()) {
+    reader.readNext();
+    if (reader.isStartElement() && depth++ == 0) continue;
+    if (reader.isEndElement() && --depth == 0) break;
+    if (depth > 0) writer->writeCurrentToken(reader);
+  }
+  if (reader.hasError()) {
+    qDebug() << "failed to copy paged data" << reader.errorString();
+    return false;
+  }
+  return !writer->hasError();
+}
+
+bool XmlPagedData::sameAs(const XmlStreamWriter::DeferredData &other) const {
+  const XmlPagedData *paged = dynamic_cast<const XmlPagedData *>(&other);
+  return paged && paged->d_file == d_file && paged->d_offset == d_offset &&
+         paged->d_length == d_length;
+}
+
+bool XmlPagedData::strip(const QString &filename, QByteArray *document,
+                         QList<XmlPagedData> *paged) {
+  QSharedPointer<XmlPagedFile> file(new XmlPagedFile(filename));
+  const qint64 size = file->file()->size();
+  if (!file->open() || size <= 0) return false;
+  const uchar *map = file->file()->map(0, size);
+  if (!map) return false;
+
+  // a plain scan over the tags, which is enough for the files written by
+  // XmlStreamWriter: markup characters in text and attribute values are
+  // escaped, only comments, CDATA sections and the like are skipped over
+  const char *begin = reinterpret_cast<const char *>(map);
+  const char *end = begin + size;
+  document->clear();
+  paged->clear();
+  QVector<QByteArray> elements;
+  const char *copied = begin;
+  // the run of bulk elements being left out
+  const char *run = nullptr;
+  int run_depth = 0;
+  int run_rows = 0;
+  auto closeRun = [&](const char *at) {
+    document->append(copied, static_cast<int>(run - copied));
+    document->append("<paged index=\"" + QByteArray::number(paged->size()) +
+                     "\"/>");
+    XmlPagedData data;
+    data.d_file = file;
+    data.d_offset = run - begin;
+    data.d_length = at - run;
+    data.d_rows = run_rows;
+    *paged << data;
+    copied = at;
+    run = nullptr;
+  };
+
+  bool ok = true;
+  const char *pos = begin;
+  while (ok && (pos = static_cast<const char *>(
+                    std::memchr(pos, '<', end - pos)))) {
+    if (startsWith(pos, end, "<![CDATA[")) {
+      pos = skipPast(pos, end, "]]>");
+      ok = pos != nullptr;
+      continue;
+    }
+    if (startsWith(pos, end, "<!--")) {
+      pos = skipPast(pos, end, "-->");
+      ok = pos != nullptr;
+      continue;
+    }
+    if (startsWith(pos, end, "<?")) {
+      pos = skipPast(pos, end, "?>");
+      ok = pos != nullptr;
+      continue;
+    }
+    if (startsWith(pos, end, "<!")) {
+      pos = skipPast(pos, end, ">");
+      ok = pos != nullptr;
+      continue;
+    }
+
+    const bool closing = startsWith(pos, end, "</");
+    const char *name = pos + (closing ? 2 : 1);
+    const char *name_end = name;
+    while (name_end < end && !isSpace(*name_end) && *name_end != '>' &&
+           *name_end != '/')
+      name_end++;
+    const char *tag_end = name_end;
+    for (char quote = 0; tag_end < end; tag_end++) {
+      if (quote) {
+        if (*tag_end == quote) quote = 0;
+      } else if (*tag_end == '"' || *tag_end == '\'') {
+        quote = *tag_end;
+      } else if (*tag_end == '>') {
+        break;
+      }
+    }
+    if (tag_end == end) {
+      ok = false;
+      break;
+    }
+    const QByteArray tag = QByteArray::fromRawData(name, name_end - name);
+    const bool at_run_level = run && elements.size() == run_depth;
+
+    if (closing) {
+      if (at_run_level) closeRun(pos);
+      if (!elements.isEmpty()) elements.removeLast();
+    } else {
+      if (!elements.isEmpty() && isBulk(elements.last(), tag) &&
+          (!run || at_run_level)) {
+        if (!run) {
+          run = pos;
+          run_depth = elements.size();
+          run_rows = 0;
+        }
+        run_rows += bulkRows(tag, name_end, tag_end);
+      } else if (at_run_level) {
+        closeRun(pos);
+      }
+      if (tag_end[-1] != '/') elements << tag;
+    }
+    pos = tag_end + 1;
+  }
+  if (ok && !run) document->append(copied, static_cast<int>(end - copied));
+  // the QByteArrays in elements point into the mapped file
+  elements.clear();
+  file->file()->unmap(const_cast<uchar *>(map));
+  if (!ok || run) {
+    qDebug() << "unable to index" << filename;
+    document->clear();
+    paged->clear();
+    return false;
+  }
+  return true;
+}
+
+bool XmlPagedData::detach(const QString &filename) {
+  const QString path = QFileInfo(filename).canonicalFilePath();
+  if (path.isEmpty()) return true;
+  QMutexLocker locker(&XmlPagedFile::s_mutex);
+  bool ok = true;
+  foreach (XmlPagedFile *file, XmlPagedFile::s_files)
+    if (file->path() == path && !file->detach()) ok = false;
+  return ok;
+}
+
+XmlPagedDataErrors *XmlPagedDataErrors::instance() {
+  static XmlPagedDataErrors errors;
+  return &errors;
+}
+
+void XmlPagedDataErrors::report(const QString &message) {
+  qDebug() << message;
+  emit instance()->failed(message);
+}
@@ -0,0 +1,110 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Bulk data of a project file, read on demand */
+
+#ifndef XMLPAGEDDATA_H
+#define XMLPAGEDDATA_H
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QSharedPointer>
+#include <QString>
+
+#include "lib/XmlStreamWriter.h"
+
+class XmlPagedFile;
+
+//! Bulk data elements left in a project file when it was opened
+/**
+ * strip() indexes a project file and leaves out the rows of its columns
+ * (<row> and <data> elements) and the cells of its matrices; every run of
+ * them is replaced by a <paged index="..."/> element. Columns and matrices
+ * keep the XmlPagedData of that index and read() it back on first access,
+ * so data which is never looked at is never parsed nor held in memory.
+ *
+ * The file is kept open as long as some XmlPagedData refers to it. Call
+ * detach() before a file gets overwritten; the data is then read from a
+ * temporary copy.
+ *
+ * As deferred data, the elements are copied unchanged when the project is
+ * saved again without having been read.
+ *
+ * If the file changed its size meanwhile, read() fails rather than
+ * returning whatever is at the offsets now; other changes mostly leave
+ * broken xml, which fails the readers and write(). The data then stays
+ * paged, so it is not saved back as empty rows, and the failure is reported
+ * through XmlPagedDataErrors.
+ */
+class XmlPagedData : public XmlStreamWriter::DeferredData {
+ public:
+  XmlPagedData();
+
+  bool isNull() const { return d_file.isNull(); }
+  //! Number of rows the elements hold (<row> or <cell> elements or the rows
+  //! of <data> elements)
+  int rows() const { return d_rows; }
+  //! Name of the file the elements are in
+  QString fileName() const;
+  //! Read the elements, wrapped in a <paged> element
+  /**
+   * \return false if the file no longer holds them, e.g. because it was
+   * truncated by another program
+   */
+  bool read(QByteArray *elements) const;
+
+  bool write(QXmlStreamWriter *writer) const override;
+  bool sameAs(const XmlStreamWriter::DeferredData &other) const override;
+  qint64 sizeHint() const override { return d_length; }
+
+  //! Read filename without its bulk data
+  /**
+   * \param document the file with the bulk data replaced by <paged> elements
+   * \param paged the data left out, by index
+   * \return false if the file could not be read
+   */
+  static bool strip(const QString &filename, QByteArray *document,
+                    QList<XmlPagedData> *paged);
+  //! Read data paged from filename from a copy from now on
+  /**
+   * \return false if the copy could not be made; the file must not be
+   * overwritten then
+   */
+  static bool detach(const QString &filename);
+
+ private:
+  QSharedPointer<XmlPagedFile> d_file;
+  qint64 d_offset;
+  qint64 d_length;
+  int d_rows;
+};
+
+//! Reports paged data which could not be read back to the user
+class XmlPagedDataErrors : public QObject {
+  Q_OBJECT
+ public:
+  static XmlPagedDataErrors *instance();
+  //! Report message, from any thread
+  static void report(const QString &message);
+
+ signals:
+  //! May be emitted on any thread
+  void failed(const QString &message);
+
+ private:
+  XmlPagedDataErrors() {}
+};
+
+#endif  // XMLPAGEDDATA_H
@@ -302,3 +302,15 @@ bool XmlStreamReader::skipToEndElement() {
   }
   return true;
 }
+
+XmlPagedData XmlStreamReader::readPagedElement() {
+  Q_ASSERT(isStartElement() && name() == "paged");
+  bool ok;
+  const int index = readAttributeInt("index", &ok);
+  if (!ok || index < 0 || index >= d_paged.size()) {
+    raiseError(QObject::tr("invalid or missing paged data index"));
+    return XmlPagedData();
+  }
+  skipToEndElement();
+  return d_paged.at(index);
+}
@@ -33,6 +33,7 @@
 #include <QXmlStreamReader>
 #include <QString>
 #include <QStringList>
+#include "lib/XmlPagedData.h"
 #include "lib/macros.h"
 
 //! XML stream parser that supports errors as well as warnings
@@ -89,7 +90,13 @@ class XmlStreamReader : public QXmlStreamReader {
   QPen readPen(bool* ok);
   QBrush readBrush(bool* ok);
 
+  //! Set the data left out of the document, see XmlPagedData::strip()
+  void setPagedData(const QList<XmlPagedData>& paged) { d_paged = paged; }
+  //! Read a <paged> element and return the data it stands for
+  XmlPagedData readPagedElement();
+
  private:
+  QList<XmlPagedData> d_paged;
   QStringList d_warnings;
   QString d_error_prefix;
   QString d_error_postfix;
@@ -2,15 +2,42 @@
 
 #include <QColor>
 #include <QFont>
+#include <QHash>
+#include <QMutex>
 #include <QPen>
 
-XmlStreamWriter::XmlStreamWriter() : QXmlStreamWriter() {}
+namespace {
+// Column::save() and friends only get a QXmlStreamWriter, which has no
+// virtual functions to find out whether it is one of ours; our writers are
+// looked up here instead
+QMutex writers_mutex;
+QHash<const QXmlStreamWriter *, XmlStreamWriter *> writers;
+}  // namespace
+
+XmlStreamWriter::XmlStreamWriter()
+    : QXmlStreamWriter(), d_deferring(false), d_deferred_error(false) {
+  QMutexLocker locker(&writers_mutex);
+  writers.insert(this, this);
+}
 
 XmlStreamWriter::XmlStreamWriter(QIODevice *device)
-    : QXmlStreamWriter(device) {}
+    : QXmlStreamWriter(device), d_deferring(false), d_deferred_error(false) {
+  QMutexLocker locker(&writers_mutex);
+  writers.insert(this, this);
+}
 
 XmlStreamWriter::XmlStreamWriter(QByteArray *bytearray)
-    : QXmlStreamWriter(bytearray) {}
+    : QXmlStreamWriter(bytearray),
+      d_deferring(false),
+      d_deferred_error(false) {
+  QMutexLocker locker(&writers_mutex);
+  writers.insert(this, this);
+}
+
+XmlStreamWriter::~XmlStreamWriter() {
+  QMutexLocker locker(&writers_mutex);
+  writers.remove(this);
+}
 
 void XmlStreamWriter::writeFont(const QFont &font, const QColor &color) {
   writeStartElement("font");
@@ -45,3 +72,36 @@ void XmlStreamWriter::writeBrush(const QBrush &brush) {
   writeAttribute("style", QString::number(brush.style()));
   writeEndElement();
 }
+
+void XmlStreamWriter::setDeferring(bool deferring) {
+  QMutexLocker locker(&writers_mutex);
+  d_deferring = deferring;
+}
+
+QList<QSharedPointer<const XmlStreamWriter::DeferredData> >
+XmlStreamWriter::takeDeferred() {
+  QList<QSharedPointer<const DeferredData> > deferred;
+  deferred.swap(d_deferred);
+  return deferred;
+}
+
+void XmlStreamWriter::writeDeferred(QXmlStreamWriter *writer,
+                                    QSharedPointer<const DeferredData> data) {
+  XmlStreamWriter *ours = nullptr;
+  bool deferring = false;
+  {
+    QMutexLocker locker(&writers_mutex);
+    ours = writers.value(writer, nullptr);
+    deferring = ours && ours->d_deferring;
+  }
+  if (!deferring) {
+    if (!data->write(writer) && ours) ours->d_deferred_error = true;
+    return;
+  }
+  ours->writeComment(QString::fromLatin1(placeholder(ours->d_deferred.size())));
+  ours->d_deferred << data;
+}
+
+QByteArray XmlStreamWriter::placeholder(int index) {
+  return "aproj-deferred " + QByteArray::number(index);
+}
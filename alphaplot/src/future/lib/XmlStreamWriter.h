@@ -1,17 +1,60 @@
 #ifndef XMLSTREAMWRITER_H
 #define XMLSTREAMWRITER_H
 
+#include <QList>
+#include <QSharedPointer>
 #include <QXmlStreamWriter>
 
 class XmlStreamWriter : public QXmlStreamWriter {
  public:
+  //! Bulk data whose elements may be written after the rest of the document
+  /**
+   * Implementations hold their own (implicitly shared) copy of the data, so
+   * write() may run on another thread while the aspect is being edited.
+   */
+  class DeferredData {
+   public:
+    virtual ~DeferredData() {}
+    //! Write the elements
+    /**
+     * \return false if the data could not be written
+     */
+    virtual bool write(QXmlStreamWriter *writer) const = 0;
+    //! Whether other holds the very same data, so write() gives the same
+    virtual bool sameAs(const DeferredData &other) const = 0;
+    //! Rough number of bytes write() produces
+    virtual qint64 sizeHint() const = 0;
+  };
+
   XmlStreamWriter();
   XmlStreamWriter(QIODevice* device);
   XmlStreamWriter(QByteArray* bytearray);
+  ~XmlStreamWriter();
 
   void writeFont(const QFont &font, const QColor &color);
   void writePen(const QPen &pen);
   void writeBrush(const QBrush &brush);
+
+  //! Collect deferred data instead of writing it
+  /**
+   * Data passed to writeDeferred() is then kept and only a placeholder()
+   * comment is written in its place.
+   */
+  void setDeferring(bool deferring);
+  //! Take the data collected so far, in the order of their placeholders
+  QList<QSharedPointer<const DeferredData> > takeDeferred();
+  //! Write data, or a placeholder for it if writer is deferring
+  static void writeDeferred(QXmlStreamWriter *writer,
+                            QSharedPointer<const DeferredData> data);
+  //! Whether some data passed to writeDeferred() could not be written
+  bool hasDeferredError() const { return d_deferred_error; }
+  //! The comment written in place of the index-th deferred data
+  static QByteArray placeholder(int index);
+
+ private:
+  QList<QSharedPointer<const DeferredData> > d_deferred;
+  bool d_deferring;
+  bool d_deferred_error;
 };
 
 #endif  // XMLSTREAMWRITER_H
@@ -353,6 +353,16 @@ bool MatrixView::isCellSelected(int row, int col) {
   return d_view_widget->selectionModel()->isSelected(d_model->index(row, col));
 }
 
+IntervalAttribute<bool> MatrixView::selectedCells(int col) {
+  // from the selection ranges, instead of asking for every cell
+  IntervalAttribute<bool> result;
+  foreach (const QItemSelectionRange &range,
+           d_view_widget->selectionModel()->selection())
+    if (range.left() <= col && col <= range.right())
+      result.setValue(Interval<int>(range.top(), range.bottom()));
+  return result;
+}
+
 void MatrixView::setCellSelected(int row, int col) {
   d_view_widget->selectionModel()->select(d_model->index(row, col),
                                           QItemSelectionModel::Select);
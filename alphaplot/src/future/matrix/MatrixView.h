@@ -49,6 +49,7 @@
 
 #include "MyWidget.h"
 #include "globals.h"
+#include "lib/IntervalAttribute.h"
 #include "ui_matrixcontroltabs.h"
 
 namespace future {
@@ -145,6 +146,8 @@ class MatrixView : public MyWidget {
   int lastSelectedRow(bool full = false);
   //! Return whether a cell is selected
   bool isCellSelected(int row, int col);
+  //! Return the selected rows of column 'col'
+  IntervalAttribute<bool> selectedCells(int col);
   //! Select a cell
   void setCellSelected(int row, int col);
   //! Select a range of cells
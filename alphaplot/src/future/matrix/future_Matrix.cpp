@@ -44,14 +44,58 @@
 #include <QtCore>
 #include <QtDebug>
 #include <QtGui>
+#include <algorithm>
+#include <cstring>
 
 #include "../core/IconLoader.h"
 #include "Matrix.h"
 #include "core/future_Folder.h"
 #include "lib/ActionManager.h"
 #include "lib/XmlStreamReader.h"
+#include "lib/XmlStreamWriter.h"
 #include "matrixcommands.h"
 
+namespace {
+//! Snapshot of the cells of a matrix for saving
+/**
+ * The cells are implicitly shared with the matrix until it changes them.
+ */
+class MatrixCells : public XmlStreamWriter::DeferredData {
+ public:
+  MatrixCells(const QVector<qreal> &data, int rows, int columns)
+      : d_data(data), d_rows(rows), d_columns(columns) {}
+
+  bool write(QXmlStreamWriter *writer) const override {
+    const qreal *cells = d_data.constData();
+    for (int col = 0; col < d_columns; col++)
+      for (int row = 0; row < d_rows; row++) {
+        writer->writeStartElement("cell");
+        writer->writeAttribute("row", QString::number(row));
+        writer->writeAttribute("column", QString::number(col));
+        writer->writeCharacters(QString::number(*cells++, 'e', 16));
+        writer->writeEndElement();
+      }
+    return !writer->hasError();
+  }
+
+  bool sameAs(const XmlStreamWriter::DeferredData &other) const override {
+    const MatrixCells *cells = dynamic_cast<const MatrixCells *>(&other);
+    return cells && cells->d_rows == d_rows &&
+           cells->d_columns == d_columns &&
+           cells->d_data.isSharedWith(d_data);
+  }
+
+  qint64 sizeHint() const override {
+    return static_cast<qint64>(d_rows) * d_columns * 70;
+  }
+
+ private:
+  QVector<qreal> d_data;
+  int d_rows;
+  int d_columns;
+};
+}  // namespace
+
 namespace future {
 
 #define WAIT_CURSOR QApplication::setOverrideCursor(QCursor(Qt::WaitCursor))
@@ -200,6 +244,18 @@ double Matrix::cell(int row, int col) const {
   return d_matrix_private->cell(row, col);
 }
 
+QVector<qreal> Matrix::data() const { return d_matrix_private->data(); }
+
+Matrix::Span Matrix::columnSpan(int col) const {
+  if (col < 0 || col >= columnCount()) return Span();
+  return d_matrix_private->columnSpan(col);
+}
+
+Matrix::Span Matrix::rowSpan(int row) const {
+  if (row < 0 || row >= rowCount()) return Span();
+  return d_matrix_private->rowSpan(row);
+}
+
 void Matrix::cutSelection() {
   if (!d_view) return;
   int first = d_view->firstSelectedRow();
@@ -820,6 +876,13 @@ void Matrix::setCell(int row, int col, double value) {
   exec(new MatrixSetCellValueCmd(d_matrix_private, row, col, value));
 }
 
+void Matrix::setCells(const QVector<qreal> &values) {
+  if (values.count() != rowCount() * columnCount()) return;
+  WAIT_CURSOR;
+  exec(new MatrixSetCellsCmd(d_matrix_private, values));
+  RESET_CURSOR;
+}
+
 void Matrix::importImageDialog() {
   QList<QByteArray> formats = QImageReader::supportedImageFormats();
   QString filter = tr("Images") + " (";
@@ -985,15 +1048,16 @@ void Matrix::save(QXmlStreamWriter *writer, const bool saveastemplate) const {
   writer->writeAttribute("y_end", QString::number(yEnd()));
   writer->writeEndElement();
 
-  if (!saveastemplate)
-    for (int col = 0; col < cols; col++)
-      for (int row = 0; row < rows; row++) {
-        writer->writeStartElement("cell");
-        writer->writeAttribute("row", QString::number(row));
-        writer->writeAttribute("column", QString::number(col));
-        writer->writeCharacters(QString::number(cell(row, col), 'e', 16));
-        writer->writeEndElement();
-      }
+  // the cells are written from a snapshot, which an autosave may do later on
+  // another thread; cells still in the project file are copied as they are
+  if (!saveastemplate && d_matrix_private->isPaged())
+    XmlStreamWriter::writeDeferred(
+        writer, QSharedPointer<const XmlStreamWriter::DeferredData>(
+                    new XmlPagedData(d_matrix_private->paged())));
+  else if (!saveastemplate)
+    XmlStreamWriter::writeDeferred(
+        writer, QSharedPointer<const XmlStreamWriter::DeferredData>(
+                    new MatrixCells(d_matrix_private->data(), rows, cols)));
   for (int col = 0; col < cols; col++) {
     writer->writeStartElement("column_width");
     writer->writeAttribute("column", QString::number(col));
@@ -1050,6 +1114,8 @@ bool Matrix::load(XmlStreamReader *reader) {
           ret_val = readCoordinatesElement(reader);
         else if (reader->name() == "cell")
           ret_val = readCellElement(reader);
+        else if (reader->name() == "paged")
+          d_matrix_private->setPaged(reader->readPagedElement());
         else if (reader->name() == "row_height")
           ret_val = readRowHeightElement(reader);
         else if (reader->name() == "column_width")
@@ -1406,35 +1472,49 @@ Matrix::Private::Private(Matrix *owner)
 }
 
 void Matrix::Private::insertColumns(int before, int count) {
+  pageIn();
   Q_ASSERT(before >= 0);
   Q_ASSERT(before <= d_column_count);
 
   emit d_owner->columnsAboutToBeInserted(before, count);
-  for (int i = 0; i < count; i++) {
-    d_data.insert(before + i, QVector<qreal>(d_row_count));
+  // the columns after 'before' move up in one block
+  d_data.insert(index(0, before), count * d_row_count, 0.0);
+  for (int i = 0; i < count; i++)
     d_column_widths.insert(before + i, Matrix::defaultColumnWidth());
-  }
 
   d_column_count += count;
   emit d_owner->columnsInserted(before, count);
 }
 
 void Matrix::Private::removeColumns(int first, int count) {
+  pageIn();
   emit d_owner->columnsAboutToBeRemoved(first, count);
   Q_ASSERT(first >= 0);
   Q_ASSERT(first + count <= d_column_count);
-  d_data.remove(first, count);
+  d_data.remove(index(0, first), count * d_row_count);
   for (int i = 0; i < count; i++) d_column_widths.removeAt(first);
   d_column_count -= count;
   emit d_owner->columnsRemoved(first, count);
 }
 
 void Matrix::Private::insertRows(int before, int count) {
+  pageIn();
   emit d_owner->rowsAboutToBeInserted(before, count);
   Q_ASSERT(before >= 0);
   Q_ASSERT(before <= d_row_count);
-  for (int col = 0; col < d_column_count; col++)
-    for (int i = 0; i < count; i++) d_data[col].insert(before + i, 0.0);
+  const int rows = d_row_count + count;
+  d_data.resize(d_column_count * rows);
+  // every column moves up by 'count' cells per column before it; starting
+  // with the last column, each block only moves onto cells already moved
+  qreal *data = d_data.data();
+  for (int col = d_column_count - 1; col >= 0; col--) {
+    qreal *from = data + static_cast<qint64>(col) * d_row_count;
+    qreal *to = data + static_cast<qint64>(col) * rows;
+    std::memmove(to + before + count, from + before,
+                 (d_row_count - before) * sizeof(qreal));
+    if (col > 0) std::memmove(to, from, before * sizeof(qreal));
+    std::fill(to + before, to + before + count, 0.0);
+  }
   for (int i = 0; i < count; i++)
     d_row_heights.insert(before + i, Matrix::defaultRowHeight());
 
@@ -1443,11 +1523,22 @@ void Matrix::Private::insertRows(int before, int count) {
 }
 
 void Matrix::Private::removeRows(int first, int count) {
+  pageIn();
   emit d_owner->rowsAboutToBeRemoved(first, count);
   Q_ASSERT(first >= 0);
   Q_ASSERT(first + count <= d_row_count);
-  for (int col = 0; col < d_column_count; col++)
-    d_data[col].remove(first, count);
+  const int rows = d_row_count - count;
+  // the reverse of insertRows(): starting with the first column, each block
+  // moves down onto cells which are not needed anymore
+  qreal *data = d_data.data();
+  for (int col = 0; col < d_column_count; col++) {
+    const qreal *from = data + static_cast<qint64>(col) * d_row_count;
+    qreal *to = data + static_cast<qint64>(col) * rows;
+    if (col > 0) std::memmove(to, from, first * sizeof(qreal));
+    std::memmove(to + first, from + first + count,
+                 (rows - first) * sizeof(qreal));
+  }
+  d_data.resize(d_column_count * rows);
   for (int i = 0; i < count; i++) d_row_heights.removeAt(first);
 
   d_row_count -= count;
@@ -1455,80 +1546,155 @@ void Matrix::Private::removeRows(int first, int count) {
 }
 
 double Matrix::Private::cell(int row, int col) const {
+  pageIn();
   Q_ASSERT(row >= 0 && row < d_row_count);
   Q_ASSERT(col >= 0 && col < d_column_count);
-  return d_data.at(col).at(row);
+  return d_data.at(index(row, col));
 }
 
 void Matrix::Private::setCell(int row, int col, double value) {
+  pageIn();
   Q_ASSERT(row >= 0 && row < d_row_count);
   Q_ASSERT(col >= 0 && col < d_column_count);
-  d_data[col][row] = value;
+  d_data[index(row, col)] = value;
   if (!d_block_change_signals) emit d_owner->dataChanged(row, col, row, col);
 }
 
+void Matrix::Private::setCells(const QVector<qreal> &values) {
+  pageIn();
+  Q_ASSERT(values.count() == d_row_count * d_column_count);
+  d_data = values;
+  if (!d_block_change_signals && d_row_count > 0 && d_column_count > 0)
+    emit d_owner->dataChanged(0, 0, d_row_count - 1, d_column_count - 1);
+}
+
+Matrix::Span Matrix::Private::columnSpan(int col) const {
+  pageIn();
+  Q_ASSERT(col >= 0 && col < d_column_count);
+  return Span(d_data.constData() + index(0, col), d_row_count, 1);
+}
+
+Matrix::Span Matrix::Private::rowSpan(int row) const {
+  pageIn();
+  Q_ASSERT(row >= 0 && row < d_row_count);
+  return Span(d_data.constData() + row, d_column_count, d_row_count);
+}
+
 QVector<qreal> Matrix::Private::columnCells(int col, int first_row,
-                                            int last_row) {
+                                            int last_row) const {
+  pageIn();
   Q_ASSERT(first_row >= 0 && first_row < d_row_count);
   Q_ASSERT(last_row >= 0 && last_row < d_row_count);
 
-  if (first_row == 0 && last_row == d_row_count - 1) return d_data.at(col);
-
-  QVector<qreal> result;
-  for (int i = first_row; i <= last_row; i++)
-    result.append(d_data.at(col).at(i));
+  QVector<qreal> result(last_row - first_row + 1);
+  const qreal *cells = d_data.constData() + index(first_row, col);
+  std::copy(cells, cells + result.size(), result.begin());
   return result;
 }
 
 void Matrix::Private::setColumnCells(int col, int first_row, int last_row,
                                      const QVector<qreal> &values) {
+  pageIn();
   Q_ASSERT(first_row >= 0 && first_row < d_row_count);
   Q_ASSERT(last_row >= 0 && last_row < d_row_count);
   Q_ASSERT(values.count() > last_row - first_row);
 
-  if (first_row == 0 && last_row == d_row_count - 1) {
-    d_data[col] = values;
-    d_data[col].resize(d_row_count);  // values may be larger
-    if (!d_block_change_signals)
-      emit d_owner->dataChanged(first_row, col, last_row, col);
-    return;
-  }
-
-  for (int i = first_row; i <= last_row; i++)
-    d_data[col][i] = values.at(i - first_row);
+  std::copy(values.constBegin(),
+            values.constBegin() + (last_row - first_row + 1),
+            d_data.begin() + index(first_row, col));
   if (!d_block_change_signals)
     emit d_owner->dataChanged(first_row, col, last_row, col);
 }
 
 QVector<qreal> Matrix::Private::rowCells(int row, int first_column,
-                                         int last_column) {
+                                         int last_column) const {
+  pageIn();
   Q_ASSERT(first_column >= 0 && first_column < d_column_count);
   Q_ASSERT(last_column >= 0 && last_column < d_column_count);
 
-  QVector<qreal> result;
+  QVector<qreal> result(last_column - first_column + 1);
+  const Span span = rowSpan(row);
   for (int i = first_column; i <= last_column; i++)
-    result.append(d_data.at(i).at(row));
+    result[i - first_column] = span.at(i);
   return result;
 }
 
 void Matrix::Private::setRowCells(int row, int first_column, int last_column,
                                   const QVector<qreal> &values) {
+  pageIn();
   Q_ASSERT(first_column >= 0 && first_column < d_column_count);
   Q_ASSERT(last_column >= 0 && last_column < d_column_count);
   Q_ASSERT(values.count() > last_column - first_column);
 
+  qreal *data = d_data.data();
   for (int i = first_column; i <= last_column; i++)
-    d_data[i][row] = values.at(i - first_column);
+    data[index(row, i)] = values.at(i - first_column);
   if (!d_block_change_signals)
     emit d_owner->dataChanged(row, first_column, row, last_column);
 }
 
 void Matrix::Private::clearColumn(int col) {
-  d_data[col].fill(0.0);
+  pageIn();
+  std::fill(d_data.begin() + index(0, col),
+            d_data.begin() + index(0, col + 1), 0.0);
   if (!d_block_change_signals)
     emit d_owner->dataChanged(0, col, d_row_count - 1, col);
 }
 
+void Matrix::Private::readPaged() const {
+  // the first thread to get here reads the cells, any other one waits until
+  // they are in place
+  QMutexLocker locker(&d_page_mutex);
+  if (d_page_state.loadAcquire() != 1) return;
+  // the cells were there all along as far as anybody else is concerned, so
+  // they are put in place quietly
+  QVector<qreal> &cells = const_cast<Private *>(this)->d_data;
+  qreal *data = cells.data();
+  QByteArray elements;
+  const bool read = d_paged.read(&elements);
+  XmlStreamReader reader(elements);
+  if (read && reader.readNextStartElement()) {
+    while (reader.readNextStartElement()) {
+      if (reader.name() != "cell") {
+        reader.skipCurrentElement();
+        continue;
+      }
+      bool row_ok, col_ok, value_ok;
+      const int row = reader.readAttributeInt("row", &row_ok);
+      const int col = reader.readAttributeInt("column", &col_ok);
+      const double value = reader.readElementText().toDouble(&value_ok);
+      if (!row_ok || !col_ok || !value_ok) {
+        reader.raiseError(QObject::tr("invalid cell"));
+        break;
+      }
+      if (row >= 0 && row < d_row_count && col >= 0 && col < d_column_count)
+        data[index(row, col)] = value;
+    }
+  }
+  if (!read || reader.hasError()) {
+    XmlPagedDataErrors::report(
+        QObject::tr("The cells of matrix %1 could not be read from %2, which "
+                    "was changed or truncated since the project was opened. "
+                    "The matrix is shown empty; its cells stay in the file as "
+                    "they are unless the matrix is changed.")
+            .arg(name(), d_paged.fileName()));
+    // cells read before the error are not trusted either
+    std::fill(cells.begin(), cells.end(), 0.0);
+    d_page_state.storeRelease(2);
+    return;
+  }
+  d_paged = XmlPagedData();
+  d_page_state.storeRelease(0);
+}
+
+void Matrix::Private::pageInForChange() {
+  readPaged();
+  QMutexLocker locker(&d_page_mutex);
+  if (d_page_state.loadAcquire() == 0) return;
+  d_paged = XmlPagedData();
+  d_page_state.storeRelease(0);
+}
+
 double Matrix::Private::xStart() const { return d_x_start; }
 
 double Matrix::Private::yStart() const { return d_y_start; }
@@ -32,6 +32,9 @@
 #ifndef FUTURE_MATRIX_H
 #define FUTURE_MATRIX_H
 
+#include <QAtomicInt>
+#include <QMutex>
+
 #ifndef LEGACY_CODE_0_2_x
 #include "core/AbstractScriptingEngine.h"
 #endif
@@ -65,6 +68,29 @@ class Matrix : public AbstractPart
   class Private;
   friend class Private;
 
+  //! Read-only view of the cells of a row or column
+  /**
+   * The cells are read from the matrix itself, so a span is valid only as
+   * long as the matrix is not changed. Consecutive cells lie stride() values
+   * apart: 1 for a column and rowCount() for a row.
+   */
+  class Span {
+   public:
+    Span() : d_data(nullptr), d_size(0), d_stride(1) {}
+    Span(const qreal *data, int size, int stride)
+        : d_data(data), d_size(size), d_stride(stride) {}
+
+    const qreal *data() const { return d_data; }
+    int size() const { return d_size; }
+    int stride() const { return d_stride; }
+    qreal at(int i) const { return d_data[static_cast<qint64>(i) * d_stride]; }
+
+   private:
+    const qreal *d_data;
+    int d_size;
+    int d_stride;
+  };
+
 /*!
  * \brief Constructor
  *
@@ -152,8 +178,21 @@ class Matrix : public AbstractPart
   void setPlotMenu(QMenu *menu);
   //! Return the value in the given cell
   double cell(int row, int col) const;
+  //! Return the values of all cells, column by column
+  /**
+   * The cells of column col start at index col * rowCount(). The vector is
+   * implicitly shared with the matrix, so taking it copies nothing until
+   * either of them changes.
+   */
+  QVector<qreal> data() const;
+  //! Return the cells of a column, read in place
+  Span columnSpan(int col) const;
+  //! Return the cells of a row, read in place
+  Span rowSpan(int row) const;
   //! Set the value of the cell
   void setCell(int row, int col, double value);
+  //! Set the values of all cells, column by column as returned by data()
+  void setCells(const QVector<qreal> &values);
   //! Return the values in the given cells as double vector
   QVector<qreal> columnCells(int col, int first_row, int last_row);
   //! Set the values in the given cells from a double vector
@@ -366,11 +405,13 @@ class Matrix : public AbstractPart
   commands only. Matrix may only call the reading functions to ensure
   that undo/redo is possible for all data changing operations.
 
-  The values of the matrix are stored as double precision values. They
-  are managed by QVector<double> objects. Although rows and columns
-  are equally important in a matrix, the columns are chosen to
-  be contiguous in memory to allow easier copying between
-  column and matrix data.
+  The values of the matrix are stored as double precision values in a
+  single QVector<double>, column by column: cell (row, col) is at index
+  col * rowCount() + row. Although rows and columns are equally important
+  in a matrix, the columns are chosen to be contiguous in memory to allow
+  easier copying between column and matrix data. Read as a row-major
+  array of columnCount() x rowCount() values, which is what GSL expects,
+  the buffer holds the transposed matrix.
   */
 class Matrix::Private {
  public:
@@ -412,13 +453,24 @@ class Matrix::Private {
   double cell(int row, int col) const;
   //! Set the value in the given cell
   void setCell(int row, int col, double value);
+  //! Return the values of all cells, column by column
+  const QVector<qreal> &data() const {
+    pageIn();
+    return d_data;
+  }
+  //! Set the values of all cells, column by column
+  void setCells(const QVector<qreal> &values);
+  //! Return the cells of a column, read in place
+  Matrix::Span columnSpan(int col) const;
+  //! Return the cells of a row, read in place
+  Matrix::Span rowSpan(int row) const;
   //! Return the values in the given cells as double vector
-  QVector<qreal> columnCells(int col, int first_row, int last_row);
+  QVector<qreal> columnCells(int col, int first_row, int last_row) const;
   //! Set the values in the given cells from a double vector
   void setColumnCells(int col, int first_row, int last_row,
                       const QVector<qreal> &values);
   //! Return the values in the given cells as double vector
-  QVector<qreal> rowCells(int row, int first_column, int last_column);
+  QVector<qreal> rowCells(int row, int first_column, int last_column) const;
   //! Set the values in the given cells from a double vector
   void setRowCells(int row, int first_column, int last_column,
                    const QVector<qreal> &values);
@@ -466,16 +518,57 @@ class Matrix::Private {
   void emitDataChanged(int top, int left, int bottom, int right) {
     emit d_owner->dataChanged(top, left, bottom, right);
   }
+  //! Leave the cells in the project file until they are first accessed
+  void setPaged(const XmlPagedData &paged) {
+    d_paged = paged;
+    d_page_state.storeRelease(paged.isNull() ? 0 : 1);
+  }
+  //! Return whether the cells are still in the project file
+  /**
+   * Cells which could not be read stay there too, so saving the project
+   * copies them unchanged rather than the zeros shown instead.
+   */
+  bool isPaged() const { return d_page_state.loadAcquire() != 0; }
+  //! Return the cells left in the project file
+  const XmlPagedData &paged() const { return d_paged; }
+  //! Read the cells from the project file if they are still there
+  /**
+   * Safe to call from several threads at once: one of them reads the
+   * cells, the others wait for it.
+   */
+  void pageIn() const {
+    if (d_page_state.loadAcquire() == 1) readPaged();
+  }
+  //! Read the cells from the project file before changing them
+  /**
+   * Cells which could not be read are given up on here: the zeros shown
+   * instead are what gets changed and saved from now on.
+   */
+  void pageIn() {
+    if (d_page_state.loadAcquire() != 0) pageInForChange();
+  }
 
  private:
+  void readPaged() const;
+  void pageInForChange();
+  //! Index of a cell in d_data
+  int index(int row, int col) const { return col * d_row_count + row; }
+
   //! The owner aspect
   Matrix *d_owner;
   //! The number of columns
   int d_column_count;
   //! The number of rows
   int d_row_count;
-  //! The matrix data
-  QVector<QVector<qreal> > d_data;
+  //! The matrix data, column by column
+  QVector<qreal> d_data;
+  //! Cells not read from the project file yet
+  mutable XmlPagedData d_paged;
+  //! 1 while the cells are paged, 2 if they could not be read; set after
+  //! d_data is filled
+  mutable QAtomicInt d_page_state;
+  //! Held while the cells are read
+  mutable QMutex d_page_mutex;
   //! Row widths
   QList<int> d_row_heights;
   //! Columns widths
@@ -417,6 +417,28 @@ void MatrixSetRowCellsCmd::undo() {
 // end of class MatrixSetRowCellsCmd
 ///////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////
+// class MatrixSetCellsCmd
+///////////////////////////////////////////////////////////////////////////
+MatrixSetCellsCmd::MatrixSetCellsCmd(future::Matrix::Private* private_obj,
+                                     const QVector<qreal>& values,
+                                     QUndoCommand* parent)
+    : QUndoCommand(parent), d_private_obj(private_obj), d_values(values) {
+  setText(QObject::tr("%1: set cell values").arg(d_private_obj->name()));
+}
+
+MatrixSetCellsCmd::~MatrixSetCellsCmd() {}
+
+void MatrixSetCellsCmd::redo() {
+  d_old_values = d_private_obj->data();
+  d_private_obj->setCells(d_values);
+}
+
+void MatrixSetCellsCmd::undo() { d_private_obj->setCells(d_old_values); }
+///////////////////////////////////////////////////////////////////////////
+// end of class MatrixSetCellsCmd
+///////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////
 // class MatrixTransposeCmd
 ///////////////////////////////////////////////////////////////////////////
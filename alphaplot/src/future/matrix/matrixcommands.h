@@ -380,6 +380,36 @@ class MatrixSetRowCellsCmd : public QUndoCommand {
 // end of class MatrixSetRowCellsCmd
 ///////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////
+// class MatrixSetCellsCmd
+///////////////////////////////////////////////////////////////////////////
+//! Set the values of all cells at once
+/**
+ * Both the new and the old values are implicitly shared with the matrix,
+ * so redo and undo swap buffers instead of copying cells.
+ */
+class MatrixSetCellsCmd : public QUndoCommand {
+ public:
+  MatrixSetCellsCmd(future::Matrix::Private* private_obj,
+                    const QVector<qreal>& values, QUndoCommand* parent = 0);
+  ~MatrixSetCellsCmd();
+
+  virtual void redo();
+  virtual void undo();
+
+ private:
+  //! The private object to modify
+  future::Matrix::Private* d_private_obj;
+  //! New cell values, column by column
+  QVector<qreal> d_values;
+  //! Backup of the changed values
+  QVector<qreal> d_old_values;
+};
+
+///////////////////////////////////////////////////////////////////////////
+// end of class MatrixSetCellsCmd
+///////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////
 // class MatrixTransposeCmd
 ///////////////////////////////////////////////////////////////////////////
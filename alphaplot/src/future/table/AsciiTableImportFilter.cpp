@@ -29,9 +29,15 @@
 
 #include "table/AsciiTableImportFilter.h"
 
+#include <QElapsedTimer>
+#include <QFile>
 #include <QLocale>
 #include <QStringList>
 #include <QTextStream>
+#include <QThread>
+#include <QtConcurrentRun>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <vector>
 
@@ -157,6 +163,309 @@ void readCols(QList<Column*>& cols, AlphaPlotTextStream& stream,
       cols.back()->setPlotDesignation(AlphaPlot::Y);
   }
 }
+
+// memory mapped, parallel reading of numeric data
+
+// white space as removed by QString::simplified() and QString::trimmed()
+inline bool isSpace(const char c) {
+  const uchar u = static_cast<uchar>(c);
+  return u == ' ' || (u >= '\t' && u <= '\r') || u == 0x85 || u == 0xa0;
+}
+
+// find the end of the line starting at p ('\n', '\r' or "\r\n" terminated)
+// and the start of the next line
+const char* lineEnd(const char* p, const char* end, const char** next) {
+  while (p < end && *p != '\n' && *p != '\r') p++;
+  if (p == end)
+    *next = end;
+  else if (*p == '\r' && p + 1 < end && p[1] == '\n')
+    *next = p + 2;
+  else
+    *next = p + 1;
+  return p;
+}
+
+// splits a line into fields the same way AlphaPlotTextStream::readRow() does
+struct LineSplitter {
+  QByteArray separator;
+  int whiteSpaceTreatment;
+  QByteArray buffer;
+  QVector<QPair<const char*, const char*> > fields;
+
+  LineSplitter(const QByteArray& sep, int treatment)
+      : separator(sep), whiteSpaceTreatment(treatment) {}
+
+  void split(const char* begin, const char* end) {
+    fields.clear();
+    if (whiteSpaceTreatment != AlphaPlotTextStream::none) {
+      while (begin < end && isSpace(*begin)) begin++;
+      while (end > begin && isSpace(end[-1])) end--;
+    }
+    if (whiteSpaceTreatment == AlphaPlotTextStream::simplify) {
+      buffer.resize(0);
+      for (const char* p = begin; p < end; p++) {
+        if (!isSpace(*p))
+          buffer.append(*p);
+        else if (!isSpace(p[-1]))  // p > begin, the line is trimmed
+          buffer.append(' ');
+      }
+      begin = buffer.constData();
+      end = begin + buffer.size();
+    }
+    const int n = separator.size();
+    const char* field = begin;
+    for (const char* p = begin; p + n <= end;) {
+      if (memcmp(p, separator.constData(), n) == 0) {
+        fields.append(qMakePair(field, p));
+        p += n;
+        field = p;
+      } else {
+        p++;
+      }
+    }
+    fields.append(qMakePair(field, end));
+  }
+
+  bool isEmptyRow() const {
+    return fields.size() == 1 && fields.at(0).first == fields.at(0).second;
+  }
+};
+
+// converts a field like QLocale::toDouble(), plain decimal numbers are
+// converted directly and everything else is handed to QLocale
+struct NumberParser {
+  QLocale locale;
+  char point;
+  bool fast;
+
+  explicit NumberParser(const QLocale& loc) : locale(loc), point('.') {
+    fast = loc.decimalPoint().unicode() < 0x80 &&
+           loc.negativeSign() == QLatin1Char('-') &&
+           loc.positiveSign() == QLatin1Char('+') &&
+           loc.exponential().toLower() == QLatin1Char('e');
+    if (fast) point = loc.decimalPoint().toLatin1();
+  }
+
+  double operator()(const char* begin, const char* end) const {
+    if (!fast) return slow(begin, end);
+    static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                   1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                   1e18, 1e19, 1e20, 1e21, 1e22};
+    const char* p = begin;
+    const char* e = end;
+    while (p < e && isSpace(*p)) p++;
+    while (e > p && isSpace(e[-1])) e--;
+    bool negative = false;
+    if (p < e && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+    quint64 mantissa = 0;
+    bool exact = true;
+    int exponent = 0;
+    const char* digits = p;
+    for (; p < e && *p >= '0' && *p <= '9'; p++) {
+      if (mantissa < (Q_UINT64_C(1) << 53))
+        mantissa = mantissa * 10 + (*p - '0');
+      else
+        exact = false;
+    }
+    if (p == digits) return slow(begin, end);
+    if (p < e && *p == point) {
+      digits = ++p;
+      for (; p < e && *p >= '0' && *p <= '9'; p++) {
+        if (mantissa < (Q_UINT64_C(1) << 53)) {
+          mantissa = mantissa * 10 + (*p - '0');
+          exponent--;
+        } else if (*p != '0') {
+          exact = false;
+        }
+      }
+      if (p == digits) return slow(begin, end);
+    }
+    if (p < e && (*p == 'e' || *p == 'E')) {
+      p++;
+      bool negexp = false;
+      if (p < e && (*p == '-' || *p == '+')) negexp = (*p++ == '-');
+      digits = p;
+      int exp = 0;
+      for (; p < e && *p >= '0' && *p <= '9'; p++)
+        if (exp < 10000) exp = exp * 10 + (*p - '0');
+      if (p == digits) return slow(begin, end);
+      exponent += negexp ? -exp : exp;
+    }
+    if (p != e) return slow(begin, end);
+    // exact if mantissa and power of ten are both exact doubles
+    if (!exact || mantissa > (Q_UINT64_C(1) << 53) || exponent < -22 ||
+        exponent > 22)
+      return precise(begin, end);
+    double value = static_cast<double>(mantissa);
+    value = (exponent < 0) ? value / pow10[-exponent] : value * pow10[exponent];
+    return negative ? -value : value;
+  }
+
+  double slow(const char* begin, const char* end) const {
+    return locale.toDouble(QString::fromLatin1(begin, int(end - begin)));
+  }
+
+  // a plain number which needs correct rounding of more digits
+  double precise(const char* begin, const char* end) const {
+    QByteArray number(begin, int(end - begin));
+    if (point != '.') number.replace(point, '.');
+    return number.toDouble();
+  }
+};
+
+struct MappedChunk {
+  const char* begin;
+  const char* end;
+  int first_row;
+  int rows;
+  QVector<QList<Interval<int> > > invalid;
+};
+
+// count the rows of a chunk, an unterminated last line is dropped if it is
+// empty like in readCols()
+int countRows(const char* begin, const char* end, LineSplitter& splitter) {
+  int rows = 0;
+  const char* next = begin;
+  while (next < end) {
+    const char* line = next;
+    const char* le = lineEnd(line, end, &next);
+    if (le == end) {
+      splitter.split(line, le);
+      if (splitter.isEmptyRow()) break;
+    }
+    rows++;
+  }
+  return rows;
+}
+
+void parseChunk(MappedChunk& chunk, QVector<double*> columns,
+                LineSplitter splitter, NumberParser parser) {
+  const int dataSize = columns.size();
+  chunk.invalid.resize(dataSize);
+  for (int i = 0; i < dataSize; i++) columns[i] += chunk.first_row;
+  const char* next = chunk.begin;
+  for (int r = 0; r < chunk.rows; r++) {
+    const char* line = next;
+    splitter.split(line, lineEnd(line, chunk.end, &next));
+    int i = 0;
+    for (; i < splitter.fields.size() && i < dataSize; ++i)
+      columns[i][r] =
+          parser(splitter.fields.at(i).first, splitter.fields.at(i).second);
+    // some rows might have too few columns
+    for (; i < dataSize; ++i) {
+      columns[i][r] = 0.0;
+      QList<Interval<int> >& list = chunk.invalid[i];
+      const int row = chunk.first_row + r;
+      if (!list.isEmpty() && list.last().end() == row - 1)
+        list.last().setEnd(row);
+      else
+        list.append(Interval<int>(row, row));
+    }
+  }
+}
+
+bool readColsMapped(QList<Column*>& cols, QFile& file,
+                    const AlphaPlotTextStream& stream, int ignoredLines,
+                    bool readColNames, QLocale locale, double* throughput) {
+  const QByteArray separator = stream.separator.toLatin1();
+  if (separator.isEmpty() ||
+      QString::fromLatin1(separator) != stream.separator)
+    return false;
+  const qint64 offset = file.pos();
+  const qint64 size = file.size();
+  if (size - offset <= 0) return false;
+  uchar* map = file.map(0, size);
+  if (!map) return false;
+
+  QElapsedTimer timer;
+  timer.start();
+  LineSplitter splitter(separator, stream.whiteSpaceTreatment);
+  const NumberParser parser(locale);
+  const char* p = reinterpret_cast<const char*>(map) + offset;
+  const char* end = reinterpret_cast<const char*>(map) + size;
+  const char* next = p;
+
+  // skip ignored lines
+  for (int i = 0; i < ignoredLines; i++) lineEnd(next, end, &next);
+
+  // read first row
+  const char* line = next;
+  splitter.split(line, lineEnd(line, end, &next));
+  const int dataSize = splitter.fields.size();
+  QStringList column_names;
+  QVector<double> first_row;
+  for (int i = 0; i < dataSize; i++) {
+    const QPair<const char*, const char*>& field = splitter.fields.at(i);
+    if (readColNames) {
+      column_names << QString::fromLatin1(field.first,
+                                          int(field.second - field.first));
+    } else {
+      column_names << QString::number(i + 1);
+      first_row << parser(field.first, field.second);
+    }
+  }
+
+  // split the rest at line boundaries, one chunk per thread
+  p = next;
+  const qint64 bytes = end - p;
+  const int threads = qBound(
+      1, int(bytes / (1 << 20)), qMax(1, QThread::idealThreadCount()));
+  QVector<MappedChunk> chunks;
+  for (int c = 0; c < threads && p < end; c++) {
+    MappedChunk chunk;
+    chunk.begin = p;
+    if (c == threads - 1) {
+      chunk.end = end;
+    } else {
+      lineEnd(qMin(end, p + qMax(qint64(1), bytes / threads)), end, &chunk.end);
+    }
+    p = chunk.end;
+    chunks << chunk;
+  }
+  QList<QFuture<int> > counts;
+  foreach (const MappedChunk& chunk, chunks)
+    counts << QtConcurrent::run(countRows, chunk.begin, chunk.end, splitter);
+  int rows = first_row.isEmpty() ? 0 : 1;
+  for (int c = 0; c < chunks.size(); c++) {
+    chunks[c].first_row = rows;
+    chunks[c].rows = counts[c].result();
+    rows += chunks[c].rows;
+  }
+
+  // parse the chunks straight into the preallocated columns
+  QVector<QVector<double> > data(dataSize);
+  QVector<double*> columns(dataSize);
+  for (int i = 0; i < dataSize; i++) {
+    data[i].resize(rows);
+    columns[i] = data[i].data();
+    if (!first_row.isEmpty()) columns[i][0] = first_row.at(i);
+  }
+  QList<QFuture<void> > parsed;
+  for (int c = 0; c < chunks.size(); c++)
+    parsed << QtConcurrent::run(parseChunk, std::ref(chunks[c]), columns,
+                                splitter, parser);
+  for (int c = 0; c < parsed.size(); c++) parsed[c].waitForFinished();
+  file.unmap(map);
+
+  for (int i = 0; i < dataSize; ++i) {
+    QList<Interval<int> > invalid;
+    foreach (const MappedChunk& chunk, chunks) invalid << chunk.invalid.at(i);
+    cols << new Column(
+        column_names.at(i),
+        std::unique_ptr<QVector<qreal> >(new QVector<qreal>(data[i])),
+        IntervalAttribute<bool>(invalid));
+    data[i] = QVector<double>();
+    if (i == 0)
+      cols.back()->setPlotDesignation(AlphaPlot::X);
+    else
+      cols.back()->setPlotDesignation(AlphaPlot::Y);
+  }
+
+  const double seconds = qMax(timer.nsecsElapsed() * 1e-9, 1e-9);
+  *throughput = (size - offset) / 1e6 / seconds;
+  return true;
+}
 }  // namespace
 
 AbstractAspect* AsciiTableImportFilter::importAspect(QIODevice& input) {
@@ -166,17 +475,25 @@ AbstractAspect* AsciiTableImportFilter::importAspect(QIODevice& input) {
   else if (d_trim_whitespace)
     stream.whiteSpaceTreatment = AlphaPlotTextStream::trim;
 
-  // skip ignored lines
-  for (int i = 0; i < d_ignored_lines; i++) stream.readRow();
-
   // build a Table from the gathered data
   QList<Column*> cols;
-  if (d_convert_to_numeric)
-    readCols<QVector<qreal> >(cols, stream, d_first_row_names_columns,
-                              d_numeric_locale);
-  else
-    readCols<QStringList>(cols, stream, d_first_row_names_columns,
-                          d_numeric_locale);
+  QFile* file = qobject_cast<QFile*>(&input);
+  d_mapped_throughput = 0.0;
+  bool mapped = d_convert_to_numeric && d_mapped_import && file &&
+                readColsMapped(cols, *file, stream, d_ignored_lines,
+                               d_first_row_names_columns, d_numeric_locale,
+                               &d_mapped_throughput);
+  if (!mapped) {
+    // skip ignored lines
+    for (int i = 0; i < d_ignored_lines; i++) stream.readRow();
+
+    if (d_convert_to_numeric)
+      readCols<QVector<qreal> >(cols, stream, d_first_row_names_columns,
+                                d_numeric_locale);
+    else
+      readCols<QStringList>(cols, stream, d_first_row_names_columns,
+                            d_numeric_locale);
+  }
 
   // renaming will be done by the kernel
   future::Table* result = new future::Table(0, 0, 0, tr("Table"));
@@ -55,6 +55,10 @@
  * Table's
  * type control tab.
  *
+ * Numeric imports from a file are parsed in parallel: the file is mapped into
+ * memory, split into chunks at line boundaries and every chunk is converted
+ * straight into the preallocated columns (see mapped_import).
+ *
  * TODO: port options GUI from ImportTableDialog
  */
 class AsciiTableImportFilter : public AbstractImportFilter {
@@ -68,7 +72,9 @@ class AsciiTableImportFilter : public AbstractImportFilter {
         d_trim_whitespace(false),
         d_simplify_whitespace(false),
         d_convert_to_numeric(false),
-        d_numeric_locale(QLocale::c()) {}
+        d_numeric_locale(QLocale::c()),
+        d_mapped_import(true),
+        d_mapped_throughput(0.0) {}
   virtual AbstractAspect* importAspect(QIODevice& input);
   virtual QStringList fileExtensions() const;
   virtual QString name() const { return QObject::tr("ASCII table"); }
@@ -106,6 +112,13 @@ class AsciiTableImportFilter : public AbstractImportFilter {
   Q_PROPERTY(
       QLocale numeric_locale READ numeric_locale WRITE set_numeric_locale)
 
+  //! Parse numeric imports from files with the memory mapped parallel reader
+  ACCESSOR(bool, mapped_import)
+  Q_PROPERTY(bool mapped_import READ mapped_import WRITE set_mapped_import)
+
+  //! MB/s the last importAspect() parsed, 0 if it didn't use the mapped reader
+  double mapped_throughput() const { return d_mapped_throughput; }
+
  private:
   int d_ignored_lines;
   QString d_separator;
@@ -114,6 +127,8 @@ class AsciiTableImportFilter : public AbstractImportFilter {
   bool d_simplify_whitespace;
   bool d_convert_to_numeric;
   QLocale d_numeric_locale;
+  bool d_mapped_import;
+  double d_mapped_throughput;
 };
 
 #endif  // ASCII_TABLE_IMPORT_FILTER_H
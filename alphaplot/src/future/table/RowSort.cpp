@@ -0,0 +1,161 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Row order of a table sort */
+
+#include "table/RowSort.h"
+
+#include <QPair>
+#include <QStringList>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+
+#include "core/column/Column.h"
+
+namespace {
+//! Minimum number of rows sorted by one thread
+const int min_sort_chunk_rows = 16384;
+
+//! One sort key copied out of its column
+struct SortKey {
+  AlphaPlot::ColumnDataType type;
+  QVector<double> values;
+  QVector<qint64> msecs;
+  QStringList texts;
+  //! Invalid rows (and NaN values), sorted last
+  QVector<bool> missing;
+};
+
+SortKey sortKey(const Column *col, int rows) {
+  SortKey key;
+  key.type = col->dataType();
+  key.missing.resize(rows);
+  const int col_rows = qMin(rows, col->rowCount());
+  for (int row = 0; row < rows; row++)
+    key.missing[row] = (row >= col_rows || col->isInvalid(row));
+  switch (key.type) {
+    case AlphaPlot::TypeDouble:
+      key.values.resize(rows);
+      for (int row = 0; row < col_rows; row++) {
+        key.values[row] = col->valueAt(row);
+        if (std::isnan(key.values.at(row))) key.missing[row] = true;
+      }
+      break;
+    case AlphaPlot::TypeString:
+      key.texts.reserve(rows);
+      for (int row = 0; row < rows; row++)
+        key.texts << (row < col_rows ? col->textAt(row) : QString());
+      break;
+    case AlphaPlot::TypeDateTime:
+    case AlphaPlot::TypeDay:
+    case AlphaPlot::TypeMonth:
+      key.msecs.resize(rows);
+      for (int row = 0; row < col_rows; row++)
+        key.msecs[row] = col->dateTimeMSecsAt(row);
+      break;
+  }
+  return key;
+}
+
+//! Three-way comparison of two rows neither of which is missing
+int compareRows(const SortKey &key, int a, int b) {
+  switch (key.type) {
+    case AlphaPlot::TypeDouble:
+      return (key.values.at(a) > key.values.at(b)) -
+             (key.values.at(a) < key.values.at(b));
+    case AlphaPlot::TypeString:
+      return key.texts.at(a).compare(key.texts.at(b));
+    default:
+      return (key.msecs.at(a) > key.msecs.at(b)) -
+             (key.msecs.at(a) < key.msecs.at(b));
+  }
+}
+
+//! Strict weak order of rows over all keys
+class RowLess {
+ public:
+  RowLess(const QVector<SortKey> &keys, bool ascending)
+      : d_keys(keys), d_ascending(ascending) {}
+  bool operator()(int a, int b) const {
+    for (const SortKey &key : d_keys) {
+      bool a_missing = key.missing.at(a);
+      bool b_missing = key.missing.at(b);
+      if (a_missing != b_missing) return b_missing;
+      if (a_missing) continue;
+      int order = compareRows(key, a, b);
+      if (order != 0) return d_ascending ? order < 0 : order > 0;
+    }
+    return false;
+  }
+
+ private:
+  const QVector<SortKey> &d_keys;
+  bool d_ascending;
+};
+}  // namespace
+
+namespace future {
+
+QVector<int> RowSort::permutation(const QList<const Column *> &keys, int rows,
+                                  bool ascending) {
+  QVector<int> permutation(rows);
+  for (int row = 0; row < rows; row++) permutation[row] = row;
+  if (keys.isEmpty() || rows < 2) return permutation;
+
+  QVector<SortKey> sort_keys;
+  foreach (const Column *key, keys) sort_keys << sortKey(key, rows);
+  RowLess less(sort_keys, ascending);
+  int *data = permutation.data();
+
+  // sort chunks of rows in parallel ...
+  const int threads = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+  const int count = qBound(1, rows / min_sort_chunk_rows, threads);
+  const int chunk_rows = (rows + count - 1) / count;
+  // [begin, end) of each sorted run
+  QVector<QPair<int, int> > runs;
+  for (int begin = 0; begin < rows; begin += chunk_rows)
+    runs << qMakePair(begin, qMin(begin + chunk_rows, rows));
+  QtConcurrent::blockingMap(runs, [&](const QPair<int, int> &run) {
+    std::stable_sort(data + run.first, data + run.second, less);
+  });
+
+  // ... then merge neighbouring runs pairwise, each pass in parallel;
+  // merging only neighbours keeps the sort stable
+  while (runs.size() > 1) {
+    QVector<QPair<int, int> > merged;
+    for (int i = 0; i + 1 < runs.size(); i += 2)
+      merged << qMakePair(runs.at(i).first, runs.at(i + 1).second);
+    QVector<int> middles;
+    for (int i = 0; i + 1 < runs.size(); i += 2) middles << runs.at(i).second;
+    QVector<int> pairs(merged.size());
+    for (int i = 0; i < pairs.size(); i++) pairs[i] = i;
+    QtConcurrent::blockingMap(pairs, [&](int i) {
+      std::inplace_merge(data + merged.at(i).first, data + middles.at(i),
+                         data + merged.at(i).second, less);
+    });
+    if (runs.size() % 2) merged << runs.last();
+    runs = merged;
+  }
+  return permutation;
+}
+
+bool RowSort::isIdentity(const QVector<int> &permutation) {
+  for (int row = 0; row < permutation.size(); row++)
+    if (permutation.at(row) != row) return false;
+  return true;
+}
+
+}  // namespace future
@@ -0,0 +1,50 @@
+/* This file is part of AlphaPlot.
+   Copyright 2022, Arun Narayanankutty <n.arun.lifescience@gmail.com>
+
+   AlphaPlot is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+   AlphaPlot is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with AlphaPlot.  If not, see <http://www.gnu.org/licenses/>.
+
+   Description : Row order of a table sort */
+
+#ifndef ROWSORT_H
+#define ROWSORT_H
+
+#include <QList>
+#include <QVector>
+
+class Column;
+
+namespace future {
+
+//! Computes the row order of a table sort
+/**
+ * The keys are copied into contiguous arrays once, then the row indices are
+ * sorted with a stable merge sort whose chunks and merges are spread over
+ * the global thread pool. The result is applied to the columns with
+ * Column::permuteRows().
+ */
+class RowSort {
+ public:
+  //! Return the sorted order of the rows 0 ... rows-1
+  /**
+   * Row k of the sorted columns is the former row permutation[k]. Later keys
+   * decide between rows whose earlier keys are equal; rows equal in all keys
+   * keep their order. Invalid rows and NaN sort last in both directions.
+   */
+  static QVector<int> permutation(const QList<const Column *> &keys, int rows,
+                                  bool ascending);
+  //! Return whether 'permutation' leaves all rows in place
+  static bool isIdentity(const QVector<int> &permutation);
+};
+
+}  // namespace future
+
+#endif  // ROWSORT_H
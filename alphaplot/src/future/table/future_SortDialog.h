@@ -54,6 +54,7 @@ class SortDialog : public QDialog {
 
  signals:
   void sort(Column* leading, QList<Column*> cols, bool ascending);
+  void sort(QList<Column*> keys, QList<Column*> cols, bool ascending);
 
  private:
   QList<Column*> d_columns_list;
@@ -64,6 +65,7 @@ class SortDialog : public QDialog {
     QComboBox* box_type;
     QComboBox* box_order;
     QComboBox* columns_list;
+    QComboBox* secondary_columns_list;
   } ui;
 };
 }  // namespace
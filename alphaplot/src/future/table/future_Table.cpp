@@ -75,6 +75,7 @@
 #include "core/datatypes/String2DoubleFilter.h"
 #include "core/datatypes/String2MonthFilter.h"
 #include "lib/ActionManager.h"
+#include "table/RowSort.h"
 #include "table/TableModel.h"
 #include "table/TableView.h"
 #include "table/future_SortDialog.h"
@@ -517,6 +518,13 @@ void Table::setFormulaForSelection() {
   d_view->showControlFormulaTab();
 }
 
+void Table::setAutoRecalculate(bool on) {
+  if (d_auto_recalculate == on) return;
+  d_auto_recalculate = on;
+  action_auto_recalculate->setChecked(on);
+  emit autoRecalculateChanged(on);
+}
+
 void Table::recalculateSelectedCells() {
   if (!d_view) return;
 #ifdef LEGACY_CODE_0_2_x
@@ -1092,6 +1100,7 @@ bool Table::fillProjectMenu(QMenu *menu) {
   menu->addSeparator();
   menu->addAction(action_set_formula);
   menu->addAction(action_recalculate);
+  menu->addAction(action_auto_recalculate);
   menu->addSeparator();
   menu->addAction(action_add_column);
   menu->addSeparator();
@@ -1175,6 +1184,10 @@ void Table::createActions() {
   action_recalculate->setShortcut(tr("Ctrl+Return"));
   actionManager()->addAction(action_recalculate, "recalculate");
 
+  action_auto_recalculate = new QAction(tr("Recalculate &Automatically"), this);
+  action_auto_recalculate->setCheckable(true);
+  actionManager()->addAction(action_auto_recalculate, "auto_recalculate");
+
   action_fill_row_numbers =
       new QAction(IconLoader::load("edit-row-number", IconLoader::LightDark),
                   tr("Row Numbers"), this);
@@ -1372,6 +1385,8 @@ void Table::connectActions() {
           SLOT(clearSelectedCells()));
   connect(action_recalculate, SIGNAL(triggered()), this,
           SLOT(recalculateSelectedCells()));
+  connect(action_auto_recalculate, SIGNAL(toggled(bool)), this,
+          SLOT(setAutoRecalculate(bool)));
   connect(action_fill_row_numbers, SIGNAL(triggered()), this,
           SLOT(fillSelectedCellsWithRowNumbers()));
   connect(action_fill_random, SIGNAL(triggered()), this,
@@ -1737,6 +1752,7 @@ QMenu *Table::createTableMenu(QMenu *append_to) {
   menu->addAction(action_toggle_comments);
   menu->addAction(action_toggle_tabbar);
   menu->addAction(action_formula_mode);
+  menu->addAction(action_auto_recalculate);
   menu->addSeparator();
   menu->addAction(action_select_all);
   menu->addAction(action_clear_table);
@@ -1873,6 +1889,8 @@ void Table::sortDialog(QList<Column *> cols) {
   sortd->setAttribute(Qt::WA_DeleteOnClose);
   connect(sortd, SIGNAL(sort(Column *, QList<Column *>, bool)), this,
           SLOT(sortColumns(Column *, QList<Column *>, bool)));
+  connect(sortd, SIGNAL(sort(QList<Column *>, QList<Column *>, bool)), this,
+          SLOT(sortColumns(QList<Column *>, QList<Column *>, bool)));
   sortd->setColumnsList(cols);
   sortd->exec();
 }
@@ -1880,221 +1898,38 @@ void Table::sortDialog(QList<Column *> cols) {
 void Table::sortColumns(Column *leading, QList<Column *> cols, bool ascending) {
   if (cols.isEmpty()) return;
 
-  // the normal QPair comparison does not work properly with descending
-  // sorting
-  // thefore we use our own compare functions
-  class CompareFunctions {
-   public:
-    static bool doubleLess(const QPair<double, int> &a,
-                           const QPair<double, int> &b) {
-      return a.first < b.first;
-    }
-    static bool doubleGreater(const QPair<double, int> &a,
-                              const QPair<double, int> &b) {
-      return a.first > b.first;
-    }
-    static bool QStringLess(const QPair<QString, int> &a,
-                            const QPair<QString, int> &b) {
-      return a < b;
-    }
-    static bool QStringGreater(const QPair<QString, int> &a,
-                               const QPair<QString, int> &b) {
-      return a > b;
-    }
-    static bool QDateTimeLess(const QPair<QDateTime, int> &a,
-                              const QPair<QDateTime, int> &b) {
-      return a < b;
-    }
-    static bool QDateTimeGreater(const QPair<QDateTime, int> &a,
-                                 const QPair<QDateTime, int> &b) {
-      return a > b;
-    }
-  };
+  if (leading) {
+    sortColumns(QList<Column *>() << leading, cols, ascending);
+    return;
+  }
 
   WAIT_CURSOR;
   beginMacro(tr("%1: sort column(s)").arg(name()));
+  // sort separately
+  foreach (Column *col, cols) {
+    QVector<int> permutation = RowSort::permutation(
+        QList<const Column *>() << col, col->rowCount(), ascending);
+    if (!RowSort::isIdentity(permutation)) col->permuteRows(permutation);
+  }
+  endMacro();
+  RESET_CURSOR;
+}
 
-  if (leading == nullptr)  // sort separately
-  {
-    for (int i = 0; i < cols.size(); i++) {
-      Column *col = cols.at(i);
-
-      if (col->dataType() == AlphaPlot::TypeDouble) {
-        int rows = col->rowCount();
-        QList<QPair<double, int> > map;
-
-        for (int j = 0; j < rows; j++)
-          map.append(QPair<double, int>(col->valueAt(j), j));
-
-        if (ascending)
-          std::stable_sort(map.begin(), map.end(),
-                           CompareFunctions::doubleLess);
-        else
-          std::stable_sort(map.begin(), map.end(),
-                           CompareFunctions::doubleGreater);
-
-        QListIterator<QPair<double, int> > it(map);
-        Column *temp_col = new Column("temp", col->columnMode());
-
-        int k = 0;
-        // put the values in the right order into temp_col
-        while (it.hasNext()) {
-          temp_col->copy(col, it.peekNext().second, k, 1);
-          temp_col->setMasked(col->isMasked(it.next().second));
-          k++;
-        }
-        // copy the sorted column
-        col->copy(temp_col, 0, 0, rows);
-        delete temp_col;
-      } else if (col->dataType() == AlphaPlot::TypeString) {
-        int rows = col->rowCount();
-        QList<QPair<QString, int> > map;
-
-        for (int j = 0; j < rows; j++)
-          map.append(QPair<QString, int>(col->textAt(j), j));
-
-        if (ascending)
-          std::stable_sort(map.begin(), map.end(),
-                           CompareFunctions::QStringLess);
-        else
-          std::stable_sort(map.begin(), map.end(),
-                           CompareFunctions::QStringGreater);
-
-        QListIterator<QPair<QString, int> > it(map);
-        Column *temp_col = new Column("temp", col->columnMode());
-
-        int k = 0;
-        // put the values in the right order into temp_col
-        while (it.hasNext()) {
-          temp_col->copy(col, it.peekNext().second, k, 1);
-          temp_col->setMasked(col->isMasked(it.next().second));
-          k++;
-        }
-        // copy the sorted column
-        col->copy(temp_col, 0, 0, rows);
-        delete temp_col;
-      } else if (col->dataType() == AlphaPlot::TypeDateTime) {
-        int rows = col->rowCount();
-        QList<QPair<QDateTime, int> > map;
-
-        for (int j = 0; j < rows; j++)
-          map.append(QPair<QDateTime, int>(col->dateTimeAt(j), j));
-
-        if (ascending)
-          std::stable_sort(map.begin(), map.end(),
-                           CompareFunctions::QDateTimeLess);
-        else
-          std::stable_sort(map.begin(), map.end(),
-                           CompareFunctions::QDateTimeGreater);
-
-        QListIterator<QPair<QDateTime, int> > it(map);
-        Column *temp_col = new Column("temp", col->columnMode());
-
-        int k = 0;
-        // put the values in the right order into temp_col
-        while (it.hasNext()) {
-          temp_col->copy(col, it.peekNext().second, k, 1);
-          temp_col->setMasked(col->isMasked(it.next().second));
-          k++;
-        }
-        // copy the sorted column
-        col->copy(temp_col, 0, 0, rows);
-        delete temp_col;
-      }
-    }
-
-  } else  // sort with leading column
-  {
-    if (leading->dataType() == AlphaPlot::TypeDouble) {
-      QList<QPair<double, int> > map;
-      int rows = leading->rowCount();
-
-      for (int i = 0; i < rows; i++)
-        map.append(QPair<double, int>(leading->valueAt(i), i));
-
-      if (ascending)
-        std::stable_sort(map.begin(), map.end(), CompareFunctions::doubleLess);
-      else
-        std::stable_sort(map.begin(), map.end(),
-                         CompareFunctions::doubleGreater);
-      QListIterator<QPair<double, int> > it(map);
-
-      for (int i = 0; i < cols.size(); i++) {
-        Column *temp_col = new Column("temp", cols.at(i)->columnMode());
-        it.toFront();
-        int j = 0;
-        // put the values in the right order into temp_col
-        while (it.hasNext()) {
-          temp_col->copy(cols.at(i), it.peekNext().second, j, 1);
-          temp_col->setMasked(cols.at(i)->isMasked(it.next().second));
-          j++;
-        }
-        // copy the sorted column
-        cols.at(i)->copy(temp_col, 0, 0, rows);
-        delete temp_col;
-      }
-    } else if (leading->dataType() == AlphaPlot::TypeString) {
-      QList<QPair<QString, int> > map;
-      int rows = leading->rowCount();
-
-      for (int i = 0; i < rows; i++)
-        map.append(QPair<QString, int>(leading->textAt(i), i));
-
-      if (ascending)
-        std::stable_sort(map.begin(), map.end(), CompareFunctions::QStringLess);
-      else
-        std::stable_sort(map.begin(), map.end(),
-                         CompareFunctions::QStringGreater);
-      QListIterator<QPair<QString, int> > it(map);
-
-      for (int i = 0; i < cols.size(); i++) {
-        Column *temp_col = new Column("temp", cols.at(i)->columnMode());
-        it.toFront();
-        int j = 0;
-        // put the values in the right order into temp_col
-        while (it.hasNext()) {
-          temp_col->copy(cols.at(i), it.peekNext().second, j, 1);
-          temp_col->setMasked(cols.at(i)->isMasked(it.next().second));
-          j++;
-        }
-        // copy the sorted column
-        cols.at(i)->copy(temp_col, 0, 0, rows);
-        delete temp_col;
-      }
-    } else if (leading->dataType() == AlphaPlot::TypeDateTime) {
-      QList<QPair<QDateTime, int> > map;
-      int rows = leading->rowCount();
-
-      for (int i = 0; i < rows; i++)
-        map.append(QPair<QDateTime, int>(leading->dateTimeAt(i), i));
+void Table::sortColumns(const QList<Column *> &keys, QList<Column *> cols,
+                        bool ascending) {
+  if (keys.isEmpty() || cols.isEmpty()) return;
 
-      if (ascending)
-        std::stable_sort(map.begin(), map.end(),
-                         CompareFunctions::QDateTimeLess);
-      else
-        std::stable_sort(map.begin(), map.end(),
-                         CompareFunctions::QDateTimeGreater);
-      QListIterator<QPair<QDateTime, int> > it(map);
-
-      for (int i = 0; i < cols.size(); i++) {
-        Column *temp_col = new Column("temp", cols.at(i)->columnMode());
-        it.toFront();
-        int j = 0;
-        // put the values in the right order into temp_col
-        while (it.hasNext()) {
-          temp_col->copy(cols.at(i), it.peekNext().second, j, 1);
-          temp_col->setMasked(cols.at(i)->isMasked(it.next().second));
-          j++;
-        }
-        // copy the sorted column
-        cols.at(i)->copy(temp_col, 0, 0, rows);
-        delete temp_col;
-      }
-    }
-  }
+  WAIT_CURSOR;
+  beginMacro(tr("%1: sort column(s)").arg(name()));
+  QList<const Column *> sort_keys;
+  foreach (Column *key, keys) sort_keys << key;
+  QVector<int> permutation =
+      RowSort::permutation(sort_keys, keys.first()->rowCount(), ascending);
+  if (!RowSort::isIdentity(permutation))
+    foreach (Column *col, cols) col->permuteRows(permutation);
   endMacro();
   RESET_CURSOR;
-}  // end of sortColumns()
+}
 
 QIcon Table::icon() const {
   return IconLoader::load("table", IconLoader::LightDark);
@@ -2132,13 +1967,27 @@ void Table::handlePlotDesignationChange(const AbstractColumn *col) {
 }
 
 void Table::handleDataChange(const AbstractColumn *col) {
+  bool ranged = (col == d_changed_column && d_changed_count > 0);
+  int first = d_changed_first;
+  int count = d_changed_count;
+  d_changed_column = nullptr;
   int index = columnIndex(static_cast<const Column *>(col));
   if (index != -1) {
     if (col->rowCount() > rowCount()) setRowCount(col->rowCount());
-    emit dataChanged(0, index, col->rowCount() - 1, index);
+    if (ranged)
+      emit dataChanged(first, index, first + count - 1, index);
+    else
+      emit dataChanged(0, index, col->rowCount() - 1, index);
   }
 }
 
+void Table::handleRowsChange(const AbstractColumn *col, int first, int count) {
+  // the column emits dataChanged() right after this signal
+  d_changed_column = col;
+  d_changed_first = first;
+  d_changed_count = count;
+}
+
 void Table::handleRowsAboutToBeInserted(const AbstractColumn *col, int before,
                                         int count) {
   int new_size = col->rowCount() + count;
@@ -2173,6 +2022,8 @@ void Table::connectColumn(const Column *col) {
           SLOT(handlePlotDesignationChange(const AbstractColumn *)));
   connect(col, SIGNAL(modeChanged(const AbstractColumn *)), this,
           SLOT(handleDataChange(const AbstractColumn *)));
+  connect(col, SIGNAL(rowsChanged(const AbstractColumn *, int, int)), this,
+          SLOT(handleRowsChange(const AbstractColumn *, int, int)));
   connect(col, SIGNAL(dataChanged(const AbstractColumn *)), this,
           SLOT(handleDataChange(const AbstractColumn *)));
   connect(col, SIGNAL(modeChanged(const AbstractColumn *)), this,
@@ -2222,6 +2073,7 @@ void Table::save(QXmlStreamWriter *writer, const bool saveastemplate) const {
   writeBasicAttributes(writer);
   writer->writeAttribute("columns", QString::number(cols));
   writer->writeAttribute("rows", QString::number(rows));
+  if (d_auto_recalculate) writer->writeAttribute("auto_recalculate", "true");
   writeCommentElement(writer);
 
   for (int col = 0; col < cols; col++)
@@ -2255,6 +2107,8 @@ bool Table::load(XmlStreamReader *reader) {
     }
 
     setRowCount(rows);
+    bool auto_recalculate = reader->readAttributeBool("auto_recalculate", &ok1);
+    setAutoRecalculate(ok1 && auto_recalculate);
     // read child elements
     while (!reader->atEnd()) {
       reader->readNext();
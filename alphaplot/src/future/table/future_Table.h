@@ -243,6 +243,8 @@ class Table : public AbstractPart
   }
   //! Return the text displayed in the given cell
   QString text(int row, int col);
+  //! Whether formulas are recalculated when the data they read changes
+  bool autoRecalculate() const { return d_auto_recalculate; }
   void setSelectionAs(AlphaPlot::PlotDesignation pd);
   void copy(Table *other);
 
@@ -295,6 +297,8 @@ class Table : public AbstractPart
 #endif
   void setFormulaForSelection();
   void recalculateSelectedCells();
+  //! Set whether formulas are recalculated when the data they read changes
+  void setAutoRecalculate(bool on);
   void fillSelectedCellsWithRowNumbers();
   void fillSelectedCellsWithRandomNumbers();
   void fillSelectedCellsWithCustomRandomNumbers();
@@ -331,6 +335,12 @@ class Table : public AbstractPart
    * If 'leading' is a null pointer, each column is sorted separately.
    */
   void sortColumns(Column *leading, QList<Column *> cols, bool ascending);
+  //! Sort the given list of columns together by several keys
+  /*
+   * Later keys only decide between rows whose earlier keys are equal.
+   */
+  void sortColumns(const QList<Column *> &keys, QList<Column *> cols,
+                   bool ascending);
   //! Show a context menu for the selected cells
   /**
    * \param pos global position of the event
@@ -400,6 +410,7 @@ class Table : public AbstractPart
   void handleRowsAboutToBeRemoved(const AbstractColumn *col, int first,
                                   int count);
   void handleRowsRemoved(const AbstractColumn *col, int first, int count);
+  void handleRowsChange(const AbstractColumn *col, int first, int count);
   //@}
   void adjustActionNames();
 
@@ -417,6 +428,7 @@ class Table : public AbstractPart
   void dataChanged(int top, int left, int bottom, int right);
   void headerDataChanged(Qt::Orientation orientation, int first, int last);
   void columnModeLocked(const QString &colname);
+  void autoRecalculateChanged(bool on);
 #ifdef LEGACY_CODE_0_2_x
   void recalculate();
   void requestRowStatistics();
@@ -442,6 +454,7 @@ class Table : public AbstractPart
   QAction *action_set_formula;
   QAction *action_clear_selection;
   QAction *action_recalculate;
+  QAction *action_auto_recalculate;
   QAction *action_fill_row_numbers;
   QAction *action_fill_random;
   QAction *action_fill_random_distribution;
@@ -491,6 +504,16 @@ class Table : public AbstractPart
 
   TableView *d_view;
   Private *d_table_private;
+  //! Rows announced by the last rowsChanged() of a column
+  /**
+   * handleDataChange() restricts the following dataChanged() signal to
+   * these rows, so that views and plots only update what has changed.
+   */
+  const AbstractColumn *d_changed_column = nullptr;
+  int d_changed_first = 0;
+  int d_changed_count = 0;
+  //! Whether formula columns follow changes of the columns they read
+  bool d_auto_recalculate = false;
 };
 
 /**
@@ -182,17 +182,46 @@
  * before actually evaluating code for the benefit of column(), cell() etc.
  * implementations.
  *
+ * The variable is thread local, so different instances may be evaluated
+ * concurrently from different threads (see Table::recalculate()); a single
+ * instance must still not be used by more than one thread at a time.
+ *
  * \sa tableColumnFunction(), tableColumn_Function(), tableColumn__Function(),
  * tableCellFunction()
  * \sa tableCell_Function(), matrixCellFunction()
  */
-MuParserScript *MuParserScript::s_currentInstance = nullptr;
+thread_local MuParserScript *MuParserScript::s_currentInstance = nullptr;
 
 MuParserScript::MuParserScript(ScriptingEnv *environment, const QString &code,
                                QObject *context, const QString &name)
-    : Script(environment, code, context, name) {
+    : Script(environment, code, context, name), m_bulkCompiled(false),
+      m_indirectReferences(false), m_tableReferences(false),
+      m_referencesResolved(false) {
+  initParser(m_parser);
+  initParser(m_bulkParser);
   m_parser.SetVarFactory(variableFactory, this);
 
+  // tell parser about table/matrix access functions
+  if (Context && Context->inherits("Table")) {
+    m_parser.DefineFun("column", tableColumnFunction, false);
+    m_parser.DefineFun("column_", tableColumn_Function, false);
+    m_parser.DefineFun("column__", tableColumn__Function, false);
+    m_parser.DefineFun("cell", tableCellFunction);
+    m_parser.DefineFun("cell_", tableCell_Function);
+  } else if (Context && Context->inherits("Matrix")) {
+    m_parser.DefineFun("cell", matrixCellFunction);
+    m_bulkParser.DefineFun("cell", matrixCellFunction);
+  }
+}
+
+/**
+ * \brief Define the operators, constants and mathematical functions shared by
+ * #m_parser and #m_bulkParser.
+ *
+ * Also used by parsers evaluating formulas outside of a script (FitModel), so
+ * they accept the same functions.
+ */
+void MuParserScript::initParser(mu::Parser &parser) {
   // redefine characters for operators to include ";"
   static const char opChars[] =
       // standard operator chars as defined in mu::Parser::InitCharSets()
@@ -201,43 +230,33 @@ MuParserScript::MuParserScript(ScriptingEnv *environment, const QString &code,
       "+-*^/?<>=#!$%&|~'_"
       // our additions
       ";";
-  m_parser.DefineOprtChars(opChars);
+  parser.DefineOprtChars(opChars);
   // work around muparser bug number 6
   // https://code.google.com/p/muparser/issues/detail?id=6
-  m_parser.DefineInfixOprtChars(opChars);
+  parser.DefineInfixOprtChars(opChars);
 
   // statement separation needs lower precedence than everything else;
   // assignment has precedence
   // -1, everything else defined in mu::Parser has non-negative precedence
-  m_parser.DefineOprt(";", statementSeparator, -2);
+  parser.DefineOprt(";", statementSeparator, -2);
 
   // aliases for _pi and _e
-  m_parser.DefineConst("pi", M_PI);
-  m_parser.DefineConst("Pi", M_PI);
-  m_parser.DefineConst("PI", M_PI);
-  m_parser.DefineConst("e", M_E);
-  m_parser.DefineConst("E", M_E);
+  parser.DefineConst("pi", M_PI);
+  parser.DefineConst("Pi", M_PI);
+  parser.DefineConst("PI", M_PI);
+  parser.DefineConst("e", M_E);
+  parser.DefineConst("E", M_E);
 
   // tell parser about mathematical functions
   for (const MuParserScripting::mathFunction *i =
            MuParserScripting::math_functions;
        i->name; i++)
     if (i->numargs == 1 && i->fun1 != nullptr)
-      m_parser.DefineFun(i->name, i->fun1);
+      parser.DefineFun(i->name, i->fun1);
     else if (i->numargs == 2 && i->fun2 != nullptr)
-      m_parser.DefineFun(i->name, i->fun2);
+      parser.DefineFun(i->name, i->fun2);
     else if (i->numargs == 3 && i->fun3 != nullptr)
-      m_parser.DefineFun(i->name, i->fun3);
-
-  // tell parser about table/matrix access functions
-  if (Context && Context->inherits("Table")) {
-    m_parser.DefineFun("column", tableColumnFunction, false);
-    m_parser.DefineFun("column_", tableColumn_Function, false);
-    m_parser.DefineFun("column__", tableColumn__Function, false);
-    m_parser.DefineFun("cell", tableCellFunction);
-    m_parser.DefineFun("cell_", tableCell_Function);
-  } else if (Context && Context->inherits("Matrix"))
-    m_parser.DefineFun("cell", matrixCellFunction);
+      parser.DefineFun(i->name, i->fun3);
 }
 
 /**
@@ -275,6 +294,7 @@ bool MuParserScript::setDouble(double value, const char *name) {
       emit_error(QString::fromLocal8Bit(e.GetMsg().c_str()), 0);
       return false;
     }
+    m_inputVariables << baName;
   } else
     // variable is known and only needs to be updated
     *entry = value;
@@ -333,18 +353,10 @@ double MuParserScript::tableColumnFunction(const char *columnPath) {
  * \sa tableCell_Function()
  */
 double MuParserScript::tableColumn_Function(double columnIndex) {
-  Table *thisTable = qobject_cast<Table *>(s_currentInstance->Context);
-  if (!thisTable)
-    // improving the error message would break translations
-    // TODO: change col() to column() for next minor release
-    throw mu::Parser::exception_type(
-        qPrintable(tr("col() works only on tables!")));
-  Column *column = thisTable->d_future_table->column(qRound(columnIndex) - 1);
-  if (!column)
-    throw mu::Parser::exception_type(
-        qPrintable(tr("There's no column %1 in table %2!")
-                       .arg(qRound(columnIndex))
-                       .arg(thisTable->objectName())));
+  // improving the error message would break translations
+  // TODO: change col() to column() for next minor release
+  Column *column = s_currentInstance->contextColumn(
+      qRound(columnIndex) - 1, tr("col() works only on tables!"));
   int row = qRound(s_currentInstance->m_variables["i"]) - 1;
   if (column->isInvalid(row)) throw new EmptySourceError();
   return column->valueAt(row);
@@ -427,16 +439,8 @@ double MuParserScript::tableCellFunction(const char *columnPath,
  * \sa tableColumn_Function()
  */
 double MuParserScript::tableCell_Function(double columnIndex, double rowIndex) {
-  Table *thisTable = qobject_cast<Table *>(s_currentInstance->Context);
-  if (!thisTable)
-    throw mu::Parser::exception_type(
-        qPrintable(tr("cell() works only on tables and matrices!")));
-  Column *column = thisTable->d_future_table->column(qRound(columnIndex) - 1);
-  if (!column)
-    throw mu::Parser::exception_type(
-        qPrintable(tr("There's no column %1 in table %2!")
-                       .arg(qRound(columnIndex))
-                       .arg(thisTable->objectName())));
+  Column *column = s_currentInstance->contextColumn(
+      qRound(columnIndex) - 1, tr("cell() works only on tables and matrices!"));
   int row = qRound(rowIndex) - 1;
   if (column->isInvalid(row)) throw new EmptySourceError();
   return column->valueAt(row);
@@ -486,6 +490,12 @@ double MuParserScript::matrixCellFunction(double rowIndex, double columnIndex) {
  * contain slashes and table names will follow in a future release.
  */
 Column *MuParserScript::resolveColumnPath(const QString &path) {
+  if (m_referencesResolved) {
+    Column *column = m_resolvedColumns.value(path);
+    if (column) return column;
+    throw mu::Parser::exception_type(qPrintable(m_unresolvedColumns.value(
+        path, tr("Couldn't find a column named %1.").arg(path))));
+  }
   Column *result = nullptr;
 
   // Split path into components.
@@ -573,6 +583,33 @@ Column *MuParserScript::resolveColumnPath(const QString &path) {
   return result;
 }
 
+/**
+ * \brief Look up the column with 0-based index \c index in the context table.
+ *
+ * Throws \c not_table_error if the context is no table.
+ */
+Column *MuParserScript::contextColumn(int index,
+                                      const QString &not_table_error) {
+  Column *column = nullptr;
+  QString tableName;
+  if (m_referencesResolved) {
+    column = m_contextColumns.value(index);
+    tableName = m_contextName;
+  } else {
+    Table *thisTable = qobject_cast<Table *>(Context);
+    if (!thisTable)
+      throw mu::Parser::exception_type(qPrintable(not_table_error));
+    column = thisTable->d_future_table->column(index);
+    tableName = thisTable->objectName();
+  }
+  if (!column)
+    throw mu::Parser::exception_type(
+        qPrintable(tr("There's no column %1 in table %2!")
+                       .arg(index + 1)
+                       .arg(tableName)));
+  return column;
+}
+
 /**
  * \brief Do in-place translation of overloaded functions.
  *
@@ -801,6 +838,59 @@ bool MuParserScript::compile(bool asFunction) {
     return false;
   }
 
+  // column("...") and cell("...", row) references, for columnReferences()
+  m_bulkColumnPaths.clear();
+  m_cellColumnPaths.clear();
+  m_indirectReferences = false;
+  m_tableReferences = false;
+  m_referencesResolved = false;
+  if (Context && Context->inherits("Table")) {
+    QRegExp cellReference(
+        "\\bcell\\s*\\(\\s*\"((?:[^\"\\\\]|\\\\.)*)\"\\s*,");
+    for (int pos = 0; (pos = cellReference.indexIn(intermediate, pos)) != -1;
+         pos += cellReference.matchedLength())
+      m_cellColumnPaths << cellReference.cap(1).replace("\\\"", "\"");
+    m_indirectReferences =
+        intermediate.contains(QRegExp("\\b(column_|column__|cell_)\\s*\\("));
+    m_tableReferences = intermediate.contains(QRegExp("\\bcolumn__\\s*\\("));
+  }
+
+  // expression for evalBulk(): column("...") references are read from arrays
+  // bound to the variables __column<index>; anything else accessing other
+  // rows (cell(), column_(), user variables) is left for eval() to handle
+  m_bulkCompiled = false;
+  if (Context && Context->inherits("Table")) {
+    QRegExp columnReference(
+        "\\bcolumn\\s*\\(\\s*\"((?:[^\"\\\\]|\\\\.)*)\"\\s*\\)");
+    QString bulk = intermediate;
+    int pos = 0;
+    while ((pos = columnReference.indexIn(bulk, pos)) != -1) {
+      // muParser only unescapes \" in string literals
+      QString path = columnReference.cap(1).replace("\\\"", "\"");
+      int index = m_bulkColumnPaths.indexOf(path);
+      if (index < 0) {
+        index = m_bulkColumnPaths.size();
+        m_bulkColumnPaths << path;
+      }
+      QString variable = QString("__column%1").arg(index);
+      bulk.replace(pos, columnReference.matchedLength(), variable);
+      pos += variable.length();
+    }
+    try {
+      m_bulkParser.SetExpr(qPrintable(bulk));
+      m_bulkCompiled = true;
+    } catch (mu::ParserError &) {
+    }
+  } else if (Context && Context->inherits("Matrix")) {
+    // cell() of a matrix reads the cells as they were before the formula
+    // is applied, so it works the same per cell and in bulk
+    try {
+      m_bulkParser.SetExpr(qPrintable(intermediate));
+      m_bulkCompiled = true;
+    } catch (mu::ParserError &) {
+    }
+  }
+
   compiled = isCompiled;
   return true;
 }
@@ -819,3 +909,169 @@ QVariant MuParserScript::eval() {
     return QVariant();
   }
 }
+
+/**
+ * \brief Collect the columns read by column("...") and cell("...", row).
+ *
+ * References that can't be resolved are skipped, evaluating the formula
+ * reports them. Returns false if the formula also addresses columns by index,
+ * since those can only be determined by evaluating it.
+ */
+bool MuParserScript::columnReferences(QList<Column *> *row_aligned,
+                                      QList<Column *> *any_row) {
+  if (compiled != Script::isCompiled && !compile()) return false;
+  if (m_indirectReferences) return false;
+  foreach (const QString &path, m_bulkColumnPaths) {
+    try {
+      *row_aligned << resolveColumnPath(path);
+    } catch (mu::ParserError &) {
+    }
+  }
+  foreach (const QString &path, m_cellColumnPaths) {
+    try {
+      *any_row << resolveColumnPath(path);
+    } catch (mu::ParserError &) {
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Look up the columns read by a table formula in advance.
+ *
+ * Resolves every column("...") and cell("...", row) path and takes a
+ * snapshot of the columns of the context table for column_() and cell_().
+ * Formulas reading other tables by index (column__()) can't be resolved
+ * this way. Paths that don't resolve keep their error message, which
+ * evaluating them reports as before.
+ */
+bool MuParserScript::resolveReferences() {
+  if (compiled != Script::isCompiled && !compile()) return false;
+  Table *table = qobject_cast<Table *>(Context);
+  if (!table || m_tableReferences) return false;
+  m_resolvedColumns.clear();
+  m_unresolvedColumns.clear();
+  foreach (const QString &path, m_bulkColumnPaths + m_cellColumnPaths) {
+    try {
+      m_resolvedColumns.insert(path, resolveColumnPath(path));
+    } catch (mu::ParserError &e) {
+      m_unresolvedColumns.insert(path,
+                                 QString::fromLocal8Bit(e.GetMsg().c_str()));
+    }
+  }
+  m_contextColumns.clear();
+  for (int i = 0; i < table->d_future_table->columnCount(); i++)
+    m_contextColumns << table->d_future_table->column(i);
+  m_contextName = table->objectName();
+  m_referencesResolved = true;
+  return true;
+}
+
+/**
+ * \brief Evaluate a column formula for many rows with one call into muParser.
+ *
+ * Uses the bulk mode of mu::ParserBase::Eval(): the row variable "i", the
+ * variables set by setDouble()/setInt() and every column("...") reference are
+ * bound to arrays holding one value per row, so neither a variable lookup in
+ * #m_variables nor a QVariant is needed per row. Rows reading an invalid
+ * source cell are set to 0, which is what the empty result eval() gives
+ * for them converts to.
+ *
+ * Returns false without emitting an error if the expression can't be handled
+ * this way (e.g. it uses cell(), column_() or assigns its own variables).
+ * Errors are reported by the per-row eval() the caller falls back to.
+ */
+bool MuParserScript::evalBulk(int first_row, QVector<double> &results) {
+  if (compiled != Script::isCompiled && !compile()) return false;
+  if (!m_bulkCompiled) return false;
+  const int count = results.size();
+  if (count == 0) return true;
+
+  // arrays bound to the bulk parser; kept alive until Eval() returns
+  QVector<QVector<double> > arrays(1 + m_inputVariables.size() +
+                                   m_bulkColumnPaths.size());
+  // rows reading an invalid source cell
+  QVector<bool> empty_source(count, false);
+  try {
+    m_bulkParser.ClearVar();
+    int k = 0;
+    QVector<double> &rows = arrays[k++];
+    rows.resize(count);
+    for (int r = 0; r < count; r++) rows[r] = first_row + r + 1;
+    m_bulkParser.DefineVar("i", rows.data());
+    foreach (const QByteArray &name, m_inputVariables) {
+      if (name == "i") continue;
+      QVector<double> &values = arrays[k++];
+      values.fill(m_variables.value(name), count);
+      m_bulkParser.DefineVar(name.constData(), values.data());
+    }
+    const int last_row = first_row + count - 1;
+    for (int c = 0; c < m_bulkColumnPaths.size(); c++) {
+      Column *column = resolveColumnPath(m_bulkColumnPaths.at(c));
+      if (!column) return false;
+      QVector<double> &values = arrays[k++];
+      values.fill(NAN, count);
+      int next = first_row;
+      foreach (Interval<int> run,
+               column->validIntervals(Interval<int>(first_row, last_row))) {
+        for (int r = next; r < run.start(); r++)
+          empty_source[r - first_row] = true;
+        for (int r = run.start(); r <= run.end(); r++)
+          values[r - first_row] = column->valueAt(r);
+        next = run.end() + 1;
+      }
+      for (int r = next; r <= last_row; r++) empty_source[r - first_row] = true;
+      m_bulkParser.DefineVar(
+          QString("__column%1").arg(c).toStdString(), values.data());
+    }
+    m_bulkParser.Eval(results.data(), count);
+  } catch (mu::ParserError &) {
+    return false;
+  }
+
+  for (int r = 0; r < count; r++)
+    if (empty_source.at(r)) results[r] = 0.0;
+  return true;
+}
+
+/**
+ * \brief Evaluate a formula for many values of some variables with one call
+ * into muParser.
+ *
+ * Like evalBulk(int, QVector<double> &), but the arrays bound to the bulk
+ * parser are given by the caller (e.g. the row and column variables of every
+ * cell of a matrix), so it doesn't depend on a table row. Formulas reading
+ * table columns are left to the other overload.
+ *
+ * Returns false without emitting an error if the expression can't be handled
+ * this way. Errors are reported by the per-cell eval() the caller falls back
+ * to.
+ */
+bool MuParserScript::evalBulk(
+    const QMap<QByteArray, QVector<double> > &variables,
+    QVector<double> &results) {
+  if (compiled != Script::isCompiled && !compile()) return false;
+  if (!m_bulkCompiled || !m_bulkColumnPaths.isEmpty()) return false;
+  const int count = results.size();
+  if (count == 0) return true;
+
+  // arrays bound to the bulk parser; copies, since the Code may assign to
+  // them, kept alive until Eval() returns
+  QMap<QByteArray, QVector<double> > arrays = variables;
+  foreach (const QByteArray &name, m_inputVariables)
+    if (!arrays.contains(name))
+      arrays[name].fill(m_variables.value(name), count);
+  try {
+    m_bulkParser.ClearVar();
+    for (auto it = arrays.begin(); it != arrays.end(); ++it) {
+      if (it.value().size() != count) return false;
+      m_bulkParser.DefineVar(it.key().constData(), it.value().data());
+    }
+    // see documentation of s_currentInstance for explanation
+    s_currentInstance = this;
+    m_bulkParser.Eval(results.data(), count);
+  } catch (mu::ParserError &) {
+    return false;
+  }
+  return true;
+}
@@ -31,7 +31,9 @@
 #define MU_PARSER_SCRIPT_H
 
 #include "Script.h"
+#include <QtCore/QHash>
 #include <QtCore/QMap>
+#include <QtCore/QStringList>
 #include <../../3rdparty/muparser/muParser.h>
 
 class QByteArray;
@@ -58,6 +60,14 @@ class MuParserScript : public Script {
     return setDouble(static_cast<double>(value), name);
   }
 
+ public:
+  bool evalBulk(int first_row, QVector<double> &results);
+  bool evalBulk(const QMap<QByteArray, QVector<double> > &variables,
+                QVector<double> &results);
+  bool columnReferences(QList<Column *> *row_aligned,
+                        QList<Column *> *any_row);
+  bool resolveReferences();
+  static void initParser(mu::Parser &parser);
 
  private:
   static double *variableFactory(const char *name, void *self);
@@ -72,13 +82,36 @@ class MuParserScript : public Script {
 
  protected:
   Column *resolveColumnPath(const QString &path);
+  Column *contextColumn(int index, const QString &not_table_error);
   bool translateLegacyFunctions(QString &input);
 
  private:
   mu::Parser m_parser;
   QMap<QByteArray, double> m_variables;
+  //! variables set from the C++ side with setDouble() or setInt()
+  QList<QByteArray> m_inputVariables;
+  //! parser for evalBulk(), column references replaced by array variables
+  //! (only the table and matrix formulas are compiled for it)
+  mu::Parser m_bulkParser;
+  bool m_bulkCompiled;
+  //! column paths referenced by the bulk expression as __column<index>
+  QStringList m_bulkColumnPaths;
+  //! column paths read by cell("...", row)
+  QStringList m_cellColumnPaths;
+  //! whether columns are also addressed by index (column_(), cell_(), ...)
+  bool m_indirectReferences;
+  //! whether columns of other tables are addressed by index (column__())
+  bool m_tableReferences;
+  //! set by resolveReferences(); the columns are then looked up in
+  //! #m_resolvedColumns and #m_contextColumns instead of the project
+  bool m_referencesResolved;
+  QHash<QString, Column *> m_resolvedColumns;
+  //! error messages of the column paths that couldn't be resolved
+  QHash<QString, QString> m_unresolvedColumns;
+  QList<Column *> m_contextColumns;
+  QString m_contextName;
 
-  static MuParserScript *s_currentInstance;
+  static thread_local MuParserScript *s_currentInstance;
 };
 
 #endif  // MU_PARSER_SCRIPT_H
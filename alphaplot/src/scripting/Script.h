@@ -31,7 +31,10 @@
 #ifndef SCRIPT_H
 #define SCRIPT_H
 
+#include <QByteArray>
+#include <QMap>
 #include <QVariant>
+#include <QVector>
 #include <QString>
 #include <QStringList>
 #include <QObject>
@@ -43,6 +46,7 @@
 #include "ScriptingEnv.h"
 
 class ApplicationWindow;
+class Column;
 
 //! A chunk of scripting code. Abstract.
 /**
@@ -71,6 +75,8 @@ class Script : public QObject {
   const QString name() const { return Name; }
   //! Return whether errors / exceptions are to be emitted or silently ignored
   bool emitErrors() const { return EmitErrors; }
+  //! Return the message of the last error, whether it was emitted or not
+  const QString lastError() const { return LastError; }
   //! Append to the code that will be executed when calling exec() or eval()
   virtual void addCode(const QString &code) {
     Code.append(code);
@@ -97,6 +103,55 @@ class Script : public QObject {
   }
   //! Set whether errors / exceptions are to be emitted or silently ignored
   void setEmitErrors(bool yes) { EmitErrors = yes; }
+  //! Evaluate the Code for a range of table rows at once
+  /**
+   * Fills 'results' with the values for the rows first_row + 1 ...
+   * first_row + results.size() of the row variable "i". Returns false if the
+   * implementation (or the Code) doesn't support this; callers then have to
+   * set "i" and call eval() for every row.
+   */
+  virtual bool evalBulk(int first_row, QVector<double> &results) {
+    Q_UNUSED(first_row);
+    Q_UNUSED(results);
+    return false;
+  }
+  //! Evaluate the Code for many values of some variables at once
+  /**
+   * 'variables' holds results.size() values for each of the variables it
+   * names; the other variables keep the value set with setDouble() or
+   * setInt(). Returns false if the implementation (or the Code) doesn't
+   * support this; callers then have to set the variables and call eval()
+   * for every set of values.
+   */
+  virtual bool evalBulk(const QMap<QByteArray, QVector<double> > &variables,
+                        QVector<double> &results) {
+    Q_UNUSED(variables);
+    Q_UNUSED(results);
+    return false;
+  }
+  //! Return the table columns read by the Code
+  /**
+   * Columns of which only the row being evaluated is read are appended to
+   * 'row_aligned', columns read at arbitrary rows to 'any_row'. Returns false
+   * if the implementation can't tell (e.g. because a column is addressed by
+   * a computed index); callers then have to assume any column may be read.
+   */
+  virtual bool columnReferences(QList<Column *> *row_aligned,
+                                QList<Column *> *any_row) {
+    Q_UNUSED(row_aligned);
+    Q_UNUSED(any_row);
+    return false;
+  }
+  //! Look up the objects the Code reads, to evaluate it on another thread
+  /**
+   * Afterwards eval() and evalBulk() don't access the context or the project
+   * any more (apart from reading the columns looked up here), so they may
+   * run on a worker thread while the context's thread waits. Such callers
+   * turn off emitting errors and report lastError() once the workers are
+   * done. Returns false if the implementation can't do this; the Code must
+   * then be evaluated on the thread of its context.
+   */
+  virtual bool resolveReferences() { return false; }
 
  public slots:
   //! Compile the Code. Return true if the implementation doesn't support
@@ -127,8 +182,10 @@ class Script : public QObject {
   QObject *Context;
   enum compileStatus { notCompiled, isCompiled, compileErr } compiled;
   bool EmitErrors;
+  QString LastError;
 
   void emit_error(const QString &message, int lineNumber) {
+    LastError = message;
     if (EmitErrors) emit error(message, Name, lineNumber);
   }
 };
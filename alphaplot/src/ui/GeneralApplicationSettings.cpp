@@ -7,6 +7,7 @@
 #include <QTranslator>
 
 #include "../core/IconLoader.h"
+#include "core/Project.h"
 #include "globals.h"
 #include "scripting/Script.h"
 #include "scripting/ScriptingEnv.h"
@@ -73,6 +74,7 @@ void ApplicationSettingsPage::Load() {
   ui->saveCheckBox->setChecked(autosave_);
   ui->saveSpinBox->setValue(autosavetime_);
   ui->undoSpinBox->setValue(undolimit_);
+  ui->binaryDataCheckBox->setChecked(binarydata_);
 #ifdef SEARCH_FOR_UPDATES
   ui->versionCheckBox->setChecked(autosearchupdates_);
 #endif
@@ -92,6 +94,7 @@ void ApplicationSettingsPage::LoadDefault() {
   ui->saveCheckBox->setChecked(true);
   ui->saveSpinBox->setValue(15);
   ui->undoSpinBox->setValue(10);
+  ui->binaryDataCheckBox->setChecked(false);
 #ifdef SEARCH_FOR_UPDATES
   ui->versionCheckBox->setChecked(false);
 #endif
@@ -120,6 +123,8 @@ void ApplicationSettingsPage::Save() {
   settings.setValue("AutoSearchUpdates", ui->versionCheckBox->isChecked());
 #endif
   settings.endGroup();
+  // read by the columns when saving a project
+  Project::setGlobal("binary_data", ui->binaryDataCheckBox->isChecked());
 
   emit generalapplicationsettingsupdate();
 }
@@ -140,6 +145,7 @@ bool ApplicationSettingsPage::settingsChangeCheck() {
       autosave_ != ui->saveCheckBox->isChecked() ||
       autosavetime_ != ui->saveSpinBox->value() ||
       undolimit_ != ui->undoSpinBox->value() ||
+      binarydata_ != ui->binaryDataCheckBox->isChecked() ||
       autosearchupdates_ != ui->versionCheckBox->isChecked()) {
     result = settingsChanged();
   }
@@ -171,6 +177,7 @@ void ApplicationSettingsPage::loadQsettingsValues() {
   autosearchupdates_ = settings.value("AutoSearchUpdates", false).toBool();
 #endif
   settings.endGroup();
+  binarydata_ = Project::global("binary_data").toBool();
 }
 
 void ApplicationSettingsPage::pickColor() {
@@ -34,6 +34,7 @@ class ApplicationSettingsPage : public SettingsPage {
   bool autosave_;
   int autosavetime_;
   int undolimit_;
+  bool binarydata_;
   QFont applicationfont_;
   bool autosearchupdates_;
 };
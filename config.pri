@@ -78,19 +78,19 @@ contains(PRESET, linux_all_dynamic) {
   INCLUDEPATH   = "$(HOME)/usr/include" $$INCLUDEPATH
   QMAKE_LIBDIR  = "$(HOME)/usr/lib" $$QMAKE_LIBDIR
 
-  LIBS         += -lGLU -lgsl -lgslcblas
+  LIBS         += -lGLU -lgsl -lgslcblas -lz
 }
 
 contains(PRESET, linux_static) {
   ### Link statically and dynamically against rest.
-  LIBS         += -lgsl -lgslcblas -lGLU
+  LIBS         += -lgsl -lgslcblas -lGLU -lz
 }
 
 contains(PRESET, linux_all_static) {
   ### mostly static linking, for self-contained binaries
   message(Build configuration: Linux all static)
 
-  LIBS         += /usr/lib/libgsl.a /usr/lib/libgslcblas.a
+  LIBS         += /usr/lib/libgsl.a /usr/lib/libgslcblas.a /usr/lib/libz.a
 }
 
 contains(PRESET, osx_dist) {
@@ -99,7 +99,7 @@ contains(PRESET, osx_dist) {
 
   INCLUDEPATH  += /usr/local/include
   QMAKE_LIBDIR += /usr/local/lib
-  LIBS         += -lgsl -lgslcblas
+  LIBS         += -lgsl -lgslcblas -lz
 }
 
 win32: {
@@ -112,6 +112,8 @@ win32: {
     INCLUDEPATH  += "$${LIBPATH}/gsl/include"
     LIBS         += "$${LIBPATH}/gsl/lib/libgsl.a"
     LIBS         += "$${LIBPATH}/gsl/lib/libgslcblas.a"
+    INCLUDEPATH  += "$${LIBPATH}/zlib/include"
+    LIBS         += "$${LIBPATH}/zlib/lib/libz.a"
   }
 }
 
@@ -122,7 +124,7 @@ mxe {
   QMAKE_CXXFLAGS +=-g
   DEFINES        += CONSOLE
     
-  LIBS           +=  -mwindows -lgsl -lgslcblas
+  LIBS           +=  -mwindows -lgsl -lgslcblas -lz
 
   # Qt libs specified here to get around a dependency bug in qmake
   LIBS += -lQt5OpenGL -lQt5Gui -lQt5Widgets -lQt5Network -lQt5Core -lQt5Svg
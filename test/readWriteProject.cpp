@@ -1,6 +1,17 @@
 #include "readWriteProject.h"
 #include "ApplicationWindow.h"
+#include "core/AprojHandler.h"
+#include "core/AutosaveEngine.h"
+#include "core/GzipDevice.h"
+#include "core/column/Column.h"
+#include "lib/XmlPagedData.h"
+#include "lib/XmlStreamReader.h"
+#include "lib/XmlStreamWriter.h"
 
+#include <QBuffer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -22,6 +33,201 @@ void ReadWriteProjectTest::readWriteProject() {
   QVERIFY(app1.get());
 }
 
+void ReadWriteProjectTest::binaryColumnData() {
+  const QVariant binary_data = Column::global("binary_data");
+  QList<QVector<qreal> > columns;
+  columns << (QVector<qreal>() << 1.5 << -2.0e300 << qQNaN() << qInf() << 0.0
+                               << 42.0);
+  // more rows than Column::save() encodes at once
+  QVector<qreal> many(100003);
+  for (int i = 0; i < many.size(); i++) many[i] = i * 0.5 - 17.0;
+  columns << many;
+
+  foreach (const QVector<qreal> &values, columns) {
+    Column column("x", AlphaPlot::Numeric);
+    column.replaceValues(0, values);
+    column.setInvalid(4);
+    column.setInvalid(values.size() - 1);
+    foreach (bool binary, QList<bool>() << false << true) {
+      Column::setGlobal("binary_data", binary);
+      QByteArray xml;
+      {
+        XmlStreamWriter writer(&xml);
+        column.save(&writer);
+      }
+      // without the setting the file stays readable by older versions
+      QCOMPARE(xml.contains("<data "), binary);
+      XmlStreamReader reader(xml);
+      QVERIFY(reader.readNextStartElement());
+      Column copy("x", AlphaPlot::Numeric);
+      QVERIFY(copy.load(&reader));
+      QCOMPARE(copy.rowCount(), values.size());
+      for (int i = 0; i < values.size(); i++) {
+        QCOMPARE(copy.isInvalid(i), i == 4 || i == values.size() - 1);
+        if (qIsNaN(values.at(i)))
+          QVERIFY(qIsNaN(copy.valueAt(i)));
+        else
+          QCOMPARE(copy.valueAt(i), values.at(i));
+      }
+    }
+  }
+  Column::setGlobal("binary_data",
+                    binary_data.isValid() ? binary_data : QVariant(false));
+}
+
+void ReadWriteProjectTest::mixedTimeSpecs() {
+  const QVariant binary_data = Column::global("binary_data");
+  const QDateTime local(QDate(2021, 3, 28), QTime(1, 30), Qt::LocalTime);
+  QList<QDateTime> date_times;
+  date_times << local << local.toUTC() << local.toOffsetFromUtc(19800)
+             << QDateTime() << local.addDays(200).toOffsetFromUtc(-3600);
+  Column column("t", AlphaPlot::DateTime);
+  column.replaceDateTimes(0, date_times);
+  Column copy("t", AlphaPlot::DateTime);
+  QVERIFY(copy.copy(&column));
+
+  // each cell keeps its time spec, in the column, its copies and the file
+  Column::setGlobal("binary_data", true);
+  QByteArray xml;
+  {
+    XmlStreamWriter writer(&xml);
+    copy.save(&writer);
+  }
+  XmlStreamReader reader(xml);
+  QVERIFY(reader.readNextStartElement());
+  Column loaded("t", AlphaPlot::DateTime);
+  QVERIFY(loaded.load(&reader));
+  QCOMPARE(loaded.rowCount(), date_times.size());
+  foreach (const Column *col, QList<const Column *>() << &column << &copy
+                                                       << &loaded)
+    for (int i = 0; i < date_times.size(); i++) {
+      const QDateTime dt = col->dateTimeAt(i);
+      QCOMPARE(dt.isValid(), date_times.at(i).isValid());
+      if (!dt.isValid()) continue;
+      QCOMPARE(dt.toMSecsSinceEpoch(), date_times.at(i).toMSecsSinceEpoch());
+      QCOMPARE(dt.timeSpec(), date_times.at(i).timeSpec());
+      QCOMPARE(dt.offsetFromUtc(), date_times.at(i).offsetFromUtc());
+    }
+  Column::setGlobal("binary_data",
+                    binary_data.isValid() ? binary_data : QVariant(false));
+}
+
+void ReadWriteProjectTest::compressedProjectFormat() {
+  // several chunks of GzipDevice and a piece of one
+  QByteArray xml;
+  for (int i = 0; xml.size() < (5 << 20) / 2; i++)
+    xml += "<row index=\"" + QByteArray::number(i) + "\">" +
+           QByteArray::number(i * 0.37, 'e', 16) + "</row>\n";
+
+  foreach (GzipDevice::Format format,
+           QList<GzipDevice::Format>() << GzipDevice::QCompress
+                                       << GzipDevice::Gzip) {
+    QBuffer file;
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    {
+      GzipDevice gzip(&file);
+      gzip.setFormat(format);
+      gzip.setThreads(4);
+      QVERIFY(gzip.open(QIODevice::WriteOnly));
+      QCOMPARE(gzip.write(xml), qint64(xml.size()));
+      gzip.close();
+      QVERIFY(gzip.flushed());
+    }
+    file.close();
+    // what versions before GzipDevice read compressed projects with
+    if (format == GzipDevice::QCompress)
+      QCOMPARE(qUncompress(file.data()), xml);
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    GzipDevice gzip(&file);
+    QVERIFY(gzip.open(QIODevice::ReadOnly));
+    QCOMPARE(gzip.readAll(), xml);
+  }
+
+  // projects saved by qCompress() keep opening
+  QBuffer file;
+  file.setData(qCompress(xml));
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  GzipDevice gzip(&file);
+  QVERIFY(gzip.open(QIODevice::ReadOnly));
+  QCOMPARE(gzip.readAll(), xml);
+}
+
+void ReadWriteProjectTest::pagedColumnData() {
+  Column column("x", AlphaPlot::Numeric);
+  column.replaceValues(0, QVector<qreal>() << 1.0 << 2.0 << 3.0);
+  QByteArray xml;
+  {
+    XmlStreamWriter writer(&xml);
+    column.save(&writer);
+  }
+  QTemporaryFile file;
+  QVERIFY(file.open());
+  QCOMPARE(file.write(xml), qint64(xml.size()));
+  QVERIFY(file.flush());
+
+  QByteArray document;
+  QList<XmlPagedData> paged;
+  QVERIFY(XmlPagedData::strip(file.fileName(), &document, &paged));
+  QCOMPARE(paged.size(), 1);
+  QCOMPARE(paged.at(0).rows(), 3);
+  QVERIFY(document.contains("<paged index=\"0\"/>"));
+  auto load = [&](Column *copy) {
+    XmlStreamReader reader(document);
+    reader.setPagedData(paged);
+    return reader.readNextStartElement() && copy->load(&reader);
+  };
+
+  // the rows are read on first access
+  Column copy("x", AlphaPlot::Numeric);
+  QVERIFY(load(&copy));
+  QCOMPARE(copy.rowCount(), 3);
+  QCOMPARE(copy.valueAt(2), 3.0);
+  QVERIFY(!copy.isInvalid(0));
+
+  // a file truncated meanwhile gives invalid rows, not zeros, and they are
+  // not saved in place of the data
+  Column truncated("x", AlphaPlot::Numeric);
+  QVERIFY(load(&truncated));
+  QVERIFY(file.resize(xml.size() / 2));
+  QCOMPARE(truncated.rowCount(), 3);
+  QVERIFY(truncated.isInvalid(0));
+  QVERIFY(truncated.isInvalid(2));
+  QByteArray saved;
+  XmlStreamWriter writer(&saved);
+  truncated.save(&writer);
+  QVERIFY(writer.hasDeferredError());
+}
+
+void ReadWriteProjectTest::autosaveProject() {
+  unique_ptr<ApplicationWindow> app(openAproj("testProject.aproj"));
+  QVERIFY(app.get());
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  foreach (const QString &name,
+           QStringList() << "autosave.aproj" << "autosave.aproj.gz") {
+    const QString filename = dir.filePath(name);
+    AprojHandler handler(app.get());
+    AutosaveEngine autosave;
+    QSignalSpy finished(&autosave, &AutosaveEngine::finished);
+    QVERIFY(autosave.start(&handler, app->projectFolder(), filename));
+    // only one autosave at a time
+    QVERIFY(!autosave.start(&handler, app->projectFolder(), filename));
+    QVERIFY(finished.wait(60000));
+    QCOMPARE(finished.at(0).at(0).toBool(), true);
+    QCOMPARE(finished.at(0).at(1).toString(), filename);
+
+    // a second run reuses the xml of the unchanged snapshots
+    QVERIFY(autosave.start(&handler, app->projectFolder(), filename));
+    QVERIFY(finished.wait(60000));
+    QCOMPARE(finished.at(1).at(0).toBool(), true);
+
+    unique_ptr<ApplicationWindow> app1(openAproj(filename));
+    QVERIFY(app1.get());
+  }
+}
+
 // Override showHelp() & chooseHelpFolder() to suppress documentation file
 // path not found error. Need to fix this later (importance : high)
 void ReadWriteProjectTest::showHelp() {}
@@ -5,6 +5,11 @@ class ReadWriteProjectTest : public ApplicationWindow {
   Q_OBJECT
  private slots:
   void readWriteProject();
+  void binaryColumnData();
+  void mixedTimeSpecs();
+  void compressedProjectFormat();
+  void pagedColumnData();
+  void autosaveProject();
 
   void showHelp();
   void chooseHelpFolder();